@@ -11,6 +11,8 @@
 #import "AGViewController.h"
 
 #include "AGAnalytics.h"
+#include "AGAudioRenderBenchmark.h"
+#include "AGAudioNodeBenchmark.h"
 
 extern "C" int shaperecst(int argc, const char** argv);
 
@@ -27,6 +29,30 @@ extern "C" int shaperecst(int argc, const char** argv);
     shaperecst(3, argv);
 }
 
+- (void)benchmarkAudioRender
+{
+    // patches bundled with the app, plus any copied into Documents/patches
+    NSMutableArray *paths = [NSMutableArray arrayWithArray:[[NSBundle mainBundle] pathsForResourcesOfType:@"json" inDirectory:@"patches"]];
+    NSString *documents = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) firstObject];
+    NSString *patchDir = [documents stringByAppendingPathComponent:@"patches"];
+    for(NSString *file in [[NSFileManager defaultManager] contentsOfDirectoryAtPath:patchDir error:NULL])
+    {
+        if([[file pathExtension] isEqualToString:@"json"])
+            [paths addObject:[patchDir stringByAppendingPathComponent:file]];
+    }
+    
+    std::vector<std::string> patchPaths;
+    for(NSString *path in paths)
+        patchPaths.push_back([path UTF8String]);
+    
+    AGAudioRenderBenchmark::runAll(patchPaths);
+}
+
+- (void)benchmarkAudioNodes
+{
+    AGAudioNodeBenchmark::runAll();
+}
+
 
 - (BOOL)application:(UIApplication *)application didFinishLaunchingWithOptions:(NSDictionary *)launchOptions
 {
@@ -41,6 +67,8 @@ extern "C" int shaperecst(int argc, const char** argv);
     AGAnalytics::instance().eventAppLaunch();
     
 //    [self testHWR];
+//    [self benchmarkAudioRender];
+//    [self benchmarkAudioNodes];
     
     return YES;
 }
@@ -56,6 +84,7 @@ extern "C" int shaperecst(int argc, const char** argv);
 {
     // Use this method to release shared resources, save user data, invalidate timers, and store enough application state information to restore your application to its current state in case it is terminated later. 
     // If your application supports background execution, this method is called instead of applicationWillTerminate: when the user quits.
+    [self.viewController saveChanges];
 }
 
 - (void)applicationWillEnterForeground:(UIApplication *)application
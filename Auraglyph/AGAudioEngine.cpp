@@ -0,0 +1,386 @@
+//
+//  AGAudioEngine.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGAudioEngine.h"
+#include "AGAudioManager.h"
+#include "AGAudioNode.h"
+#include "AGAudioRenderPlan.h"
+#include "AGAudioWorkerPool.h"
+#include "AGControlBus.h"
+#include "AGAudioProfiler.h"
+#include "CycleCounter.h"
+#include "RealtimeAllocGuard.h"
+#include "RealtimePool.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <vector>
+#include <memory>
+
+
+// everything the audio thread touches, rebuilt and swapped in as a whole
+// whenever anything changes; immutable once published
+struct AGAudioEngineSnapshot
+{
+    // shared between consecutive snapshots when only the event handlers,
+    // capturers, etc. changed; released on the UI thread when the snapshot
+    // is reclaimed
+    std::shared_ptr<AGAudioRenderPlan> plan;
+    // distinguishes snapshots from ones at the same address before them
+    uint64_t version;
+    // changes only when the event handlers do
+    uint64_t handlersVersion;
+    std::vector<AGAudioEventHandler *> eventHandlers;
+    std::vector<AGAudioCapturer *> capturers;
+    std::vector<AGAudioCapturer *> outputCapturers;
+    std::vector<AGAudioRateProcessor *> processors;
+};
+
+
+class AGAudioEngineOutputDestination : public AGAudioOutputDestination
+{
+public:
+
+    AGAudioEngineOutputDestination(AGAudioEngine *engine) :
+    m_engine(engine)
+    { }
+
+    void addOutput(AGAudioRenderer *renderer) override
+    {
+        m_engine->addRenderer(renderer);
+    }
+
+    void removeOutput(AGAudioRenderer *renderer) override
+    {
+        m_engine->removeRenderer(renderer);
+    }
+
+private:
+    AGAudioEngine *m_engine;
+};
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioEngine ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioEngine
+
+AGAudioEngine::AGAudioEngine(int numWorkers, bool realtime) :
+m_realtime(realtime), m_t(0),
+m_editDepth(0), m_publishPending(false), m_compilePending(false), m_handlersVersion(0),
+m_snapshotVersion(0), m_scheduledVersion(0)
+{
+    m_masterOut = new AGAudioEngineOutputDestination(this);
+    m_workerPool = new AGAudioWorkerPool(numWorkers, realtime);
+
+    m_inputBuffer.resize(AUDIO_BUFFER_MAX);
+    m_inputBuffer.clear();
+    m_outputBuffer.resize(AUDIO_BUFFER_MAX*NUM_OUTPUT_CHANNELS);
+    m_outputBuffer.clear();
+
+    // nodes draw memory they may resize while rendering from the pool; make
+    // sure it (and the control bus, which reserves its delivery queue) doesn't
+    // get created on the audio thread
+    RealtimePool::instance();
+    AGControlBus::instance();
+
+    _publishSnapshot(true);
+}
+
+AGAudioEngine::~AGAudioEngine()
+{
+    SAFE_DELETE(m_masterOut);
+    SAFE_DELETE(m_workerPool);
+}
+
+void AGAudioEngine::addRenderer(AGAudioRenderer *renderer)
+{
+    m_graphMutex.lock();
+    m_renderers.push_back(renderer);
+    m_graphMutex.unlock();
+
+    graphDidChange();
+}
+
+void AGAudioEngine::removeRenderer(AGAudioRenderer *renderer)
+{
+    m_graphMutex.lock();
+    m_renderers.remove(renderer);
+    m_graphMutex.unlock();
+
+    // renderers remove themselves as they're deleted
+    _publishSnapshot(true, true);
+}
+
+void AGAudioEngine::graphDidChange()
+{
+    _publishSnapshot(true);
+}
+
+void AGAudioEngine::beginGraphEdit()
+{
+    m_graphMutex.lock();
+    m_editDepth++;
+    m_graphMutex.unlock();
+}
+
+void AGAudioEngine::endGraphEdit()
+{
+    m_graphMutex.lock();
+    assert(m_editDepth > 0);
+    bool publish = --m_editDepth == 0 && m_publishPending;
+    m_graphMutex.unlock();
+
+    if(publish)
+        _publishSnapshot(false);
+}
+
+void AGAudioEngine::retire(const std::function<void ()> &free)
+{
+    // nothing renders while the graph is being edited
+    if(!m_realtime)
+    {
+        free();
+        return;
+    }
+
+    m_graphMutex.lock();
+    m_snapshot.retire(free);
+    m_graphMutex.unlock();
+
+    // once the audio thread has picked this up, it's done with free's object
+    _publishSnapshot(false);
+}
+
+void AGAudioEngine::reclaim()
+{
+    AtomicSnapshot<AGAudioEngineSnapshot>::FreeList ready;
+    m_graphMutex.lock();
+    m_snapshot.reclaim(ready);
+    m_graphMutex.unlock();
+
+    for(std::function<void ()> &free : ready)
+        free();
+}
+
+void AGAudioEngine::addCapturer(AGAudioCapturer *capturer)
+{
+    m_graphMutex.lock();
+    m_capturers.push_back(capturer);
+    m_graphMutex.unlock();
+
+    _publishSnapshot(false);
+}
+
+void AGAudioEngine::removeCapturer(AGAudioCapturer *capturer)
+{
+    m_graphMutex.lock();
+    m_capturers.remove(capturer);
+    m_graphMutex.unlock();
+
+    _publishSnapshot(false, true);
+}
+
+void AGAudioEngine::addOutputCapturer(AGAudioCapturer *capturer)
+{
+    m_graphMutex.lock();
+    m_outputCapturers.push_back(capturer);
+    m_graphMutex.unlock();
+
+    _publishSnapshot(false);
+}
+
+void AGAudioEngine::removeOutputCapturer(AGAudioCapturer *capturer)
+{
+    m_graphMutex.lock();
+    m_outputCapturers.remove(capturer);
+    m_graphMutex.unlock();
+
+    _publishSnapshot(false, true);
+}
+
+void AGAudioEngine::addEventHandler(AGAudioEventHandler *handler)
+{
+    m_graphMutex.lock();
+    // a handler listed twice would be scheduled twice, firing each event twice
+    assert(std::find(m_eventHandlers.begin(), m_eventHandlers.end(), handler) == m_eventHandlers.end());
+    m_eventHandlers.push_back(handler);
+    m_handlersVersion++;
+    m_graphMutex.unlock();
+
+    _publishSnapshot(false);
+}
+
+void AGAudioEngine::removeEventHandler(AGAudioEventHandler *handler)
+{
+    m_graphMutex.lock();
+    m_eventHandlers.remove(handler);
+    m_handlersVersion++;
+    m_graphMutex.unlock();
+
+    // the audio thread drops the handler's events on picking up the new
+    // snapshot, which this waits for
+    _publishSnapshot(false, true);
+}
+
+void AGAudioEngine::addAudioRateProcessor(AGAudioRateProcessor *processor)
+{
+    m_graphMutex.lock();
+    m_processors.push_back(processor);
+    m_graphMutex.unlock();
+
+    _publishSnapshot(false);
+}
+
+void AGAudioEngine::removeAudioRateProcessor(AGAudioRateProcessor *processor)
+{
+    m_graphMutex.lock();
+    m_processors.remove(processor);
+    m_graphMutex.unlock();
+
+    _publishSnapshot(false, true);
+}
+
+void AGAudioEngine::_publishSnapshot(bool compile, bool wait)
+{
+    AtomicSnapshot<AGAudioEngineSnapshot>::FreeList ready;
+    uint64_t version;
+
+    {
+        // publishing under the lock too keeps versions in the order the
+        // snapshots were built, whichever thread edits the graph
+        Mutex::Scope scope = m_graphMutex.inScope();
+
+        m_compilePending = m_compilePending || compile;
+        if(m_editDepth > 0 && !wait)
+        {
+            m_publishPending = true;
+            return;
+        }
+
+        AGAudioEngineSnapshot *current = m_snapshot.current();
+        AGAudioEngineSnapshot *snapshot = new AGAudioEngineSnapshot;
+
+        // plans are immutable, so reuse the current one unless connections changed
+        if(m_compilePending || current == NULL)
+            snapshot->plan.reset(AGAudioRenderPlan::compile(m_renderers));
+        else
+            snapshot->plan = current->plan;
+        m_compilePending = false;
+        m_publishPending = false;
+
+        snapshot->version = ++m_snapshotVersion;
+        snapshot->handlersVersion = m_handlersVersion;
+        snapshot->eventHandlers.assign(m_eventHandlers.begin(), m_eventHandlers.end());
+        snapshot->capturers.assign(m_capturers.begin(), m_capturers.end());
+        snapshot->outputCapturers.assign(m_outputCapturers.begin(), m_outputCapturers.end());
+        snapshot->processors.assign(m_processors.begin(), m_processors.end());
+
+        m_snapshot.publish(snapshot, ready);
+        version = m_snapshot.version();
+    }
+
+    // outside the lock, as freeing what was retired can mean deleting nodes
+    // that edit the graph themselves
+    for(std::function<void ()> &free : ready)
+        free();
+
+    // once this returns, the audio thread no longer references anything that
+    // was just removed, so callers are free to delete it
+    if(wait && m_realtime && m_snapshot.waitFor(version))
+        reclaim();
+}
+
+void AGAudioEngine::render(const float *input, float *output, int numFrames)
+{
+    RealtimeAllocGuard::Scope realtime;
+    
+    // no locks past this point. The snapshot, and anything retired before it
+    // was published, stay valid until release() below, after the bus has
+    // delivered any controls queued by nodes retired since
+    AGAudioEngineSnapshot *snapshot = m_snapshot.acquireUntilRelease();
+    
+    bool profiling = AGAudioProfiler::instance().enabled();
+    uint64_t start = profiling ? CycleCounter::now() : 0;
+
+    m_outputBuffer.clear();
+
+    _updateSchedule(snapshot);
+
+    if(input)
+        memcpy(m_inputBuffer, input, sizeof(float)*numFrames);
+    else
+        memset(m_inputBuffer, 0, sizeof(float)*numFrames);
+
+    for(auto processor : snapshot->processors)
+        processor->process(m_t);
+
+    // render up to each event in turn, so that the controls it pushes take
+    // effect from its exact sample
+    int offset = 0;
+    while(offset < numFrames)
+    {
+        sampletime t = m_t+offset;
+        while(m_scheduler.dispatchNext(t))
+            ;
+        AGControlBus::instance().deliver(t);
+
+        int frames = numFrames-offset;
+        if(!m_scheduler.empty() && m_scheduler.nextTime() < t+frames)
+            frames = (int) (m_scheduler.nextTime()-t);
+
+        for(AGAudioCapturer *capturer : snapshot->capturers)
+            capturer->captureAudio(m_inputBuffer+offset, frames);
+
+        snapshot->plan->render(t, m_outputBuffer+offset*NUM_OUTPUT_CHANNELS, frames, NUM_OUTPUT_CHANNELS, m_workerPool);
+
+        offset += frames;
+    }
+
+    memcpy(output, m_outputBuffer, sizeof(float)*numFrames*NUM_OUTPUT_CHANNELS);
+
+    m_t += numFrames;
+
+    for(AGAudioCapturer *capturer : snapshot->outputCapturers)
+        capturer->captureAudio(m_outputBuffer, numFrames);
+    
+    m_snapshot.release();
+    
+    if(profiling)
+        AGAudioProfiler::instance().recordBlock(start, CycleCounter::now(), numFrames);
+}
+
+void AGAudioEngine::_updateSchedule(AGAudioEngineSnapshot *snapshot)
+{
+    if(snapshot->handlersVersion != m_scheduledVersion)
+    {
+        // handlers may have been removed (and deleted); start over from the
+        // ones still registered
+        m_scheduler.clear();
+        for(AGAudioEventHandler *handler : snapshot->eventHandlers)
+        {
+            handler->m_needsReschedule.store(false, std::memory_order_relaxed);
+            handler->scheduleEvents(m_scheduler, m_t);
+        }
+        
+        m_scheduledVersion = snapshot->handlersVersion;
+    }
+    else
+    {
+        for(AGAudioEventHandler *handler : snapshot->eventHandlers)
+        {
+            if(handler->m_needsReschedule.load(std::memory_order_relaxed) &&
+               handler->m_needsReschedule.exchange(false, std::memory_order_acquire))
+            {
+                m_scheduler.cancel(handler);
+                handler->scheduleEvents(m_scheduler, m_t);
+            }
+        }
+    }
+}
+
@@ -0,0 +1,144 @@
+//
+//  AGAudioEngine.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include "AGAudioCapturer.h"
+#include "AGAudioOutputDestination.h"
+#include "Buffers.h"
+#include "Mutex.h"
+#include "AtomicSnapshot.h"
+#include "AGAudioEventScheduler.h"
+
+#include <functional>
+#include <list>
+
+class AGAudioRateProcessor;
+class AGAudioWorkerPool;
+struct AGAudioEngineSnapshot;
+
+//------------------------------------------------------------------------------
+// ### AGAudioEngine ###
+// Platform-independent core of the audio engine: owns the set of outputs,
+// event handlers, capturers and processors, publishes them to the audio
+// thread, and renders blocks of interleaved stereo on demand. Blocks are
+// split at scheduled events, so that these take effect on the exact sample.
+// AGAudioManager drives it from the device's audio callback; offline tools
+// drive it directly.
+//
+// Changes are published without waiting for the audio thread to pick them up,
+// except removing a capturer, event handler, etc., which the caller is about
+// to delete. That wait is normally a block or two, but while the audio thread
+// is stalled (e.g. the session was interrupted) each removal blocks for up to
+// 250 ms before giving up. Anything else the audio thread might still be
+// using, like a node just disconnected, is deleted through retire(), once it
+// can't be, without waiting.
+//
+// Edits may come from any thread (e.g. the autosave worker as well as the UI);
+// m_graphMutex serializes them, including publishing to the audio thread.
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioEngine
+
+class AGAudioEngine
+{
+public:
+
+    static const int NUM_OUTPUT_CHANNELS = 2;
+
+    /* offline engines render on the same thread that edits the graph, so
+       they never wait on the audio thread to pick up changes */
+    AGAudioEngine(int numWorkers, bool realtime = true);
+    ~AGAudioEngine();
+
+    AGAudioEngine(const AGAudioEngine &) = delete;
+
+    /* destination for output nodes, forwarding to add/removeRenderer */
+    AGAudioOutputDestination *masterOut() { return m_masterOut; }
+
+    void addRenderer(AGAudioRenderer *renderer);
+    void removeRenderer(AGAudioRenderer *renderer);
+    /* capturers receive each block of (mono) input */
+    void addCapturer(AGAudioCapturer *capturer);
+    void removeCapturer(AGAudioCapturer *capturer);
+    /* output capturers receive each rendered block of interleaved output */
+    void addOutputCapturer(AGAudioCapturer *capturer);
+    void removeOutputCapturer(AGAudioCapturer *capturer);
+    /* timers, sequencers, etc.; see AGAudioEventHandler */
+    void addEventHandler(AGAudioEventHandler *handler);
+    void removeEventHandler(AGAudioEventHandler *handler);
+    void addAudioRateProcessor(AGAudioRateProcessor *processor);
+    void removeAudioRateProcessor(AGAudioRateProcessor *processor);
+
+    /* recompile the render plan after connections or outputs change */
+    void graphDidChange();
+
+    /* batch graph changes (e.g. loading a document) until the matching
+       endGraphEdit(), then publish them together, compiling at most once.
+       Batches nest. */
+    void beginGraphEdit();
+    void endGraphEdit();
+
+    /* call free once the audio thread can no longer be using
+       anything removed from the graph before now, e.g. to delete a node
+       after disconnecting it; that includes delivering controls the node
+       queued. Offline engines call it right away. */
+    void retire(const std::function<void ()> &free);
+    /* free what has been retired and is no longer in use; done
+       on each change, and should also be done regularly (e.g. each frame) */
+    void reclaim();
+
+    /* render one block; input is mono and may be NULL, output is interleaved
+       stereo. Audio thread only; never locks or allocates. */
+    void render(const float *input, float *output, int numFrames);
+
+    /* sample time of the next block to be rendered */
+    sampletime time() const { return m_t; }
+
+private:
+
+    /* with wait, publish even in a batch, and return once the audio thread
+       has picked it up */
+    void _publishSnapshot(bool compile, bool wait = false);
+    void _updateSchedule(AGAudioEngineSnapshot *snapshot);
+
+    AGAudioOutputDestination *m_masterOut;
+    bool m_realtime;
+
+    sampletime m_t;
+
+    // UI-side state, and publishing m_snapshot; guarded by m_graphMutex,
+    // which the audio thread never takes
+    Mutex m_graphMutex;
+    std::list<AGAudioRenderer *> m_renderers;
+    std::list<AGAudioCapturer *> m_capturers;
+    std::list<AGAudioCapturer *> m_outputCapturers;
+    std::list<AGAudioEventHandler *> m_eventHandlers;
+    std::list<AGAudioRateProcessor *> m_processors;
+    // changes held back by a batch
+    int m_editDepth;
+    bool m_publishPending;
+    bool m_compilePending;
+    // changes to m_eventHandlers, which have to be rescheduled
+    uint64_t m_handlersVersion;
+
+    // audio-thread view of the above
+    AtomicSnapshot<AGAudioEngineSnapshot> m_snapshot;
+    uint64_t m_snapshotVersion;
+
+    // audio-thread state: pending events of the handlers in the snapshot
+    // whose handlersVersion is m_scheduledVersion
+    AGAudioEventScheduler m_scheduler;
+    uint64_t m_scheduledVersion;
+
+    // renders independent parts of the graph on other cores
+    AGAudioWorkerPool *m_workerPool;
+
+    Buffer<float> m_inputBuffer;
+    Buffer<float> m_outputBuffer;
+};
+
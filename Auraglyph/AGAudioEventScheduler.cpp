@@ -0,0 +1,66 @@
+//
+//  AGAudioEventScheduler.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGAudioEventScheduler.h"
+
+#include <algorithm>
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioEventScheduler ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioEventScheduler
+
+AGAudioEventScheduler::AGAudioEventScheduler(int capacity) :
+m_capacity(capacity), m_order(0)
+{
+    m_events.reserve(capacity);
+}
+
+bool AGAudioEventScheduler::post(sampletime t, AGAudioEventHandler *handler, int tag)
+{
+    if((int) m_events.size() >= m_capacity)
+        return false;
+
+    m_events.push_back({ t, m_order++, handler, tag });
+    std::push_heap(m_events.begin(), m_events.end(), _later);
+
+    return true;
+}
+
+void AGAudioEventScheduler::cancel(AGAudioEventHandler *handler)
+{
+    auto end = std::remove_if(m_events.begin(), m_events.end(), [handler](const Event &event) {
+        return event.handler == handler;
+    });
+    if(end == m_events.end())
+        return;
+
+    m_events.erase(end, m_events.end());
+    std::make_heap(m_events.begin(), m_events.end(), _later);
+}
+
+void AGAudioEventScheduler::clear()
+{
+    m_events.clear();
+}
+
+bool AGAudioEventScheduler::dispatchNext(sampletime t)
+{
+    if(m_events.empty() || m_events.front().time > t)
+        return false;
+
+    std::pop_heap(m_events.begin(), m_events.end(), _later);
+    Event event = m_events.back();
+    m_events.pop_back();
+
+    event.handler->handleEvent(*this, event.time, event.tag);
+
+    return true;
+}
+
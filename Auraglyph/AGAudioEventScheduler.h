@@ -0,0 +1,108 @@
+//
+//  AGAudioEventScheduler.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include "AGDef.h"
+
+#include <atomic>
+#include <vector>
+#include <stdint.h>
+
+class AGAudioEventScheduler;
+
+//------------------------------------------------------------------------------
+// ### AGAudioEventHandler ###
+// Anything that acts at exact sample times (timers, sequencers). Handlers are
+// registered with the audio engine, which has them post their upcoming events
+// to its scheduler and calls them back as each one falls due. The engine
+// splits the block being rendered at each event, so audio nodes see whatever
+// control the handler pushed from that sample on.
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioEventHandler
+
+class AGAudioEventHandler
+{
+public:
+    AGAudioEventHandler() : m_needsReschedule(false) { }
+    virtual ~AGAudioEventHandler() { }
+
+    /* post every pending event due at or after t. Called on the audio thread
+       when the handler is first registered, whenever the set of handlers
+       changes (which discards all posted events), and after reschedule() */
+    virtual void scheduleEvents(AGAudioEventScheduler &scheduler, sampletime t) = 0;
+    /* an event posted with tag has come due at t; events posted from here
+       must be later than t */
+    virtual void handleEvent(AGAudioEventScheduler &scheduler, sampletime t, int tag) = 0;
+
+    /* any thread: discard this handler's posted events and call
+       scheduleEvents() again before the next block, e.g. after its tempo
+       changes */
+    void reschedule() { m_needsReschedule.store(true, std::memory_order_release); }
+
+private:
+    friend class AGAudioEngine;
+    std::atomic<bool> m_needsReschedule;
+};
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioEventScheduler ###
+// Priority queue of timestamped events, earliest first, keyed on sample time.
+// Storage is reserved up front, so posting and dispatching never allocate;
+// audio thread only.
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioEventScheduler
+
+class AGAudioEventScheduler
+{
+public:
+    static const int DEFAULT_CAPACITY = 1024;
+
+    AGAudioEventScheduler(int capacity = DEFAULT_CAPACITY);
+
+    AGAudioEventScheduler(const AGAudioEventScheduler &) = delete;
+
+    /* events at the same time are dispatched in the order posted; returns
+       false (and drops the event) if the queue is full */
+    bool post(sampletime t, AGAudioEventHandler *handler, int tag = 0);
+    /* drop all events posted by handler */
+    void cancel(AGAudioEventHandler *handler);
+    void clear();
+
+    bool empty() const { return m_events.empty(); }
+    int size() const { return (int) m_events.size(); }
+    /* time of the earliest event; queue must not be empty */
+    sampletime nextTime() const { return m_events.front().time; }
+
+    /* if the earliest event is due at or before t, remove it and call its
+       handler; returns false if nothing was due */
+    bool dispatchNext(sampletime t);
+
+private:
+    struct Event
+    {
+        sampletime time;
+        // order posted, to break ties
+        uint64_t order;
+        AGAudioEventHandler *handler;
+        int tag;
+    };
+
+    // std heap order, so "less" means later
+    static bool _later(const Event &a, const Event &b)
+    {
+        return a.time > b.time || (a.time == b.time && a.order > b.order);
+    }
+
+    int m_capacity;
+    uint64_t m_order;
+    // binary heap
+    std::vector<Event> m_events;
+};
+
@@ -0,0 +1,211 @@
+//
+//  AGAudioFilterBank.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGAudioFilterBank.h"
+#include "spdsp.h"
+
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+
+static void _filter(AGAudioFilterBank::Kind kind, float *coeff, float *state, const float *target,
+                    const float *in, float *const *out, int stride, int nFrames)
+{
+    if(kind == AGAudioFilterBank::BIQUAD)
+        spv_biquad_bank(coeff, state, target, in, out[0], stride, nFrames);
+    else
+        spv_svf_bank(coeff, state, target, in, out, stride, nFrames);
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioFilterBank::Filter ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioFilterBank::Filter
+
+void AGAudioFilterBank::Filter::renderFilter(sampletime t, int nFrames)
+{
+    Kind kind = filterBankKind();
+    const float *input = beginFilter(t, nFrames);
+
+    float *output[MAX_OUTPUTS];
+    for(int o = 0; o < numOutputs(kind); o++)
+        output[o] = filterOutput(o);
+
+    _filter(kind, m_filterCoefficients, m_filterState, m_filterTargets, input, output, 1, nFrames);
+
+    _checkFilter(nFrames);
+    endFilter(nFrames);
+}
+
+int AGAudioFilterBank::Filter::filterTailFrames(float level) const
+{
+    // poles of the recursion z^2 + a1 z + a2; for the SVF (with no input,
+    // low += f*band; band += f*(-low - q*band)), from its state matrix
+    double a1, a2;
+    if(filterBankKind() == BIQUAD)
+    {
+        a1 = m_filterCoefficients[3];
+        a2 = m_filterCoefficients[4];
+    }
+    else
+    {
+        double f = m_filterCoefficients[0], q = m_filterCoefficients[1];
+        a1 = -(2 - f*f - f*q);
+        a2 = 1 - f*q;
+    }
+
+    // radius of the larger pole
+    double discriminant = a1*a1 - 4*a2;
+    double radius;
+    if(discriminant < 0)
+        radius = sqrt(a2);
+    else
+        radius = (fabs(a1) + sqrt(discriminant))/2;
+
+    if(!(radius < 1))
+        return -1;
+    if(radius < level)
+        return 2;
+
+    // plus the two samples of state
+    double frames = ceil(log(level)/log(radius)) + 2;
+    return frames < INT_MAX/2 ? (int) frames : -1;
+}
+
+void AGAudioFilterBank::Filter::resetFilter(const float *coefficients)
+{
+    Kind kind = filterBankKind();
+    for(int k = 0; k < numCoefficients(kind); k++)
+        m_filterCoefficients[k] = coefficients[k];
+    for(int k = 0; k < numStates(kind); k++)
+        m_filterState[k] = 0;
+}
+
+void AGAudioFilterBank::Filter::_checkFilter(int nFrames)
+{
+    Kind kind = filterBankKind();
+
+    bool bad = false;
+    for(int k = 0; k < numStates(kind); k++)
+        bad = bad || isbad(m_filterState[k]);
+
+    if(bad)
+    {
+        for(int k = 0; k < numStates(kind); k++)
+            m_filterState[k] = 0;
+        for(int o = 0; o < numOutputs(kind); o++)
+            memset(filterOutput(o), 0, sizeof(float)*nFrames);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioFilterBank ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioFilterBank
+
+AGAudioFilterBank::AGAudioFilterBank(Kind kind, const std::vector<Filter *> &filters)
+: m_kind(kind), m_filters(filters)
+{
+    // whole vectors, however wide (up to 8 lanes)
+    m_stride = (numFilters()+7) & ~7;
+
+    m_lanes.resize(numFilters());
+    m_inputs.resize(numFilters());
+    m_outputs.resize(numFilters());
+    m_coefficients.resize(MAX_COEFFICIENTS*m_stride);
+    m_state.resize(MAX_STATES*m_stride);
+    m_targets.resize(MAX_INTERVALS*MAX_COEFFICIENTS*m_stride);
+    m_input.resize(AUDIO_BUFFER_MAX*m_stride);
+    for(int o = 0; o < numOutputs(kind); o++)
+        m_output[o].resize(AUDIO_BUFFER_MAX*m_stride);
+
+    // padding lanes stay silent
+    m_coefficients.clear();
+    m_state.clear();
+    m_targets.clear();
+    m_input.clear();
+}
+
+void AGAudioFilterBank::render(sampletime t, int nFrames, const uint8_t *awake)
+{
+    int numFilters = (int) m_filters.size();
+    int nc = numCoefficients(m_kind);
+    int ns = numStates(m_kind);
+    int no = numOutputs(m_kind);
+    int numIntervals = (nFrames+SPV_BANK_INTERVAL-1)/SPV_BANK_INTERVAL;
+
+    int numLanes = 0;
+    for(int j = 0; j < numFilters; j++)
+    {
+        if(awake == NULL || awake[j])
+            m_lanes[numLanes++] = j;
+    }
+    if(numLanes == 0)
+        return;
+
+    // as few whole vectors as hold the lanes in use
+    int stride = (numLanes+7) & ~7;
+
+    // each node renders up to its filter, into its lane
+    for(int l = 0; l < numLanes; l++)
+    {
+        Filter *filter = m_filters[m_lanes[l]];
+        m_inputs[l] = filter->beginFilter(t, nFrames);
+
+        for(int k = 0; k < nc; k++)
+            m_coefficients[k*stride+l] = filter->m_filterCoefficients[k];
+        for(int k = 0; k < ns; k++)
+            m_state[k*stride+l] = filter->m_filterState[k];
+        for(int k = 0; k < numIntervals*nc; k++)
+            m_targets[k*stride+l] = filter->m_filterTargets[k];
+    }
+
+    // padding lanes stay silent (and finite), whatever the lanes held before
+    for(int l = numLanes; l < stride; l++)
+    {
+        for(int k = 0; k < nc; k++)
+            m_coefficients[k*stride+l] = 0;
+        for(int k = 0; k < ns; k++)
+            m_state[k*stride+l] = 0;
+        for(int k = 0; k < numIntervals*nc; k++)
+            m_targets[k*stride+l] = 0;
+    }
+
+    spv_interleave(m_input, stride, m_inputs.data(), numLanes, nFrames);
+
+    float *output[MAX_OUTPUTS];
+    for(int o = 0; o < no; o++)
+        output[o] = m_output[o];
+
+    _filter(m_kind, m_coefficients, m_state, m_targets, m_input, output, stride, nFrames);
+
+    // and back again
+    for(int o = 0; o < no; o++)
+    {
+        for(int l = 0; l < numLanes; l++)
+            m_outputs[l] = m_filters[m_lanes[l]]->filterOutput(o);
+
+        spv_deinterleave(m_outputs.data(), output[o], stride, numLanes, nFrames);
+    }
+
+    for(int l = 0; l < numLanes; l++)
+    {
+        Filter *filter = m_filters[m_lanes[l]];
+
+        for(int k = 0; k < nc; k++)
+            filter->m_filterCoefficients[k] = m_coefficients[k*stride+l];
+        for(int k = 0; k < ns; k++)
+            filter->m_filterState[k] = m_state[k*stride+l];
+
+        filter->_checkFilter(nFrames);
+        filter->endFilter(nFrames);
+    }
+}
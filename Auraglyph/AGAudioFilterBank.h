@@ -0,0 +1,129 @@
+//
+//  AGAudioFilterBank.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include "AGDef.h"
+#include "Buffers.h"
+#include "spvdsp.h"
+
+#include <vector>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// ### AGAudioFilterBank ###
+// Runs the recursive filters of many filter nodes at once, one filter per
+// SIMD lane (see spv_biquad_bank and spv_svf_bank). The render plan gathers
+// filter nodes of the same kind that don't depend on each other into banks;
+// each block, the bank has every node pull its inputs and work out its
+// coefficients, interleaves their inputs, filters them all together, and hands
+// the outputs back for the nodes to finish.
+//
+// Nodes keep their own coefficients and state between blocks, and render the
+// same way on their own (as a bank of one), so they can move in and out of
+// banks as the graph changes without a glitch.
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioFilterBank
+
+class AGAudioFilterBank
+{
+public:
+    enum Kind
+    {
+        BIQUAD,
+        SVF,
+    };
+
+    static const int MAX_COEFFICIENTS = 5;
+    static const int MAX_STATES = 2;
+    static const int MAX_OUTPUTS = 4;
+    // coefficient targets per block
+    static const int MAX_INTERVALS = (AUDIO_BUFFER_MAX+SPV_BANK_INTERVAL-1)/SPV_BANK_INTERVAL;
+    // fewest filters worth batching
+    static const int MIN_FILTERS = 4;
+
+    static int numCoefficients(Kind kind) { return kind == BIQUAD ? 5 : 2; }
+    static int numStates(Kind kind) { return 2; }
+    static int numOutputs(Kind kind) { return kind == BIQUAD ? 1 : 4; }
+
+    //--------------------------------------------------------------------------
+    // ### Filter ###
+    // Implemented by filter nodes that can run in a bank.
+    //--------------------------------------------------------------------------
+    class Filter
+    {
+    public:
+        virtual ~Filter() { }
+
+        virtual Kind filterBankKind() const = 0;
+
+        /* pull inputs for block t and fill in filterTargets() for each
+           interval of the block; returns the signal to filter */
+        virtual const float *beginFilter(sampletime t, int nFrames) = 0;
+        /* buffer for output o (of numOutputs(kind)) */
+        virtual float *filterOutput(int o) = 0;
+        /* outputs are filled in; finish the block (gain, etc.) */
+        virtual void endFilter(int nFrames) = 0;
+
+        /* begin, filter and end, outside of any bank */
+        void renderFilter(sampletime t, int nFrames);
+
+        /* frames for the filter's ringing to decay by level (e.g. 1e-5 for
+           -100 dB) with its current coefficients, or -1 if it doesn't */
+        int filterTailFrames(float level) const;
+
+    protected:
+        /* coefficients to reach by the end of interval (of SPV_BANK_INTERVAL frames) */
+        float *filterTargets(int interval) { return m_filterTargets+interval*numCoefficients(filterBankKind()); }
+        /* start from these coefficients, with cleared state */
+        void resetFilter(const float *coefficients);
+
+    private:
+        friend class AGAudioFilterBank;
+
+        /* clear state (and the block's output) if the filter has blown up */
+        void _checkFilter(int nFrames);
+
+        // carried from block to block
+        float m_filterCoefficients[MAX_COEFFICIENTS];
+        float m_filterState[MAX_STATES];
+        // this block's targets, interval by interval
+        float m_filterTargets[MAX_INTERVALS*MAX_COEFFICIENTS];
+    };
+
+    /* off the audio thread: bank of filters, all of the given kind */
+    AGAudioFilterBank(Kind kind, const std::vector<Filter *> &filters);
+    AGAudioFilterBank(const AGAudioFilterBank &) = delete;
+
+    Kind kind() const { return m_kind; }
+    int numFilters() const { return (int) m_filters.size(); }
+    Filter *filter(int i) const { return m_filters[i]; }
+
+    /* render block t of every filter, or with awake, only of filters j with
+       awake[j] set (packed into the fewest lanes); the others are untouched */
+    void render(sampletime t, int nFrames, const uint8_t *awake = NULL);
+
+private:
+    Kind m_kind;
+    std::vector<Filter *> m_filters;
+    // lanes, padded to a whole number of vectors
+    int m_stride;
+
+    // filter in each lane, and each lane's input and (one) output, for the
+    // block being rendered
+    std::vector<int> m_lanes;
+    std::vector<const float *> m_inputs;
+    std::vector<float *> m_outputs;
+
+    Buffer<float> m_coefficients;
+    Buffer<float> m_state;
+    Buffer<float> m_targets;
+    Buffer<float> m_input;
+    Buffer<float> m_output[MAX_OUTPUTS];
+};
+
@@ -14,9 +14,12 @@
 #include "AGAudioCapturer.h"
 #include "AGAudioOutputDestination.h"
 
+#include <functional>
+
 class AGAudioOutputNode;
 class AGAudioNode;
-class AGTimer;
+class AGAudioEventHandler;
+class AGAudioEngine;
 
 // audio-rate processor that does not actually generate audio
 class AGAudioRateProcessor
@@ -31,6 +34,7 @@ public:
 @interface AGAudioManager : NSObject
 
 @property (nonatomic) AGAudioOutputDestination *masterOut;
+@property (nonatomic, readonly) AGAudioEngine *engine;
 
 + (instancetype)instance;
 
@@ -38,11 +42,14 @@ public:
 - (void)removeRenderer:(AGAudioRenderer *)renderer;
 - (void)addCapturer:(AGAudioCapturer *)capturer;
 - (void)removeCapturer:(AGAudioCapturer *)capturer;
-- (void)addTimer:(AGTimer *)timer;
-- (void)removeTimer:(AGTimer *)timer;
+- (void)addEventHandler:(AGAudioEventHandler *)handler;
+- (void)removeEventHandler:(AGAudioEventHandler *)handler;
 - (void)addAudioRateProcessor:(AGAudioRateProcessor *)processor;
 - (void)removeAudioRateProcessor:(AGAudioRateProcessor *)processor;
 
+// recompile the audio render plan after connections or outputs change
+- (void)graphDidChange;
+
 - (void)startSessionRecording;
 - (void)stopSessionRecording;
 
@@ -71,6 +78,15 @@ public:
     void addCapturer(AGAudioCapturer *capturer);
     void removeCapturer(AGAudioCapturer *capturer);
     
+    void addEventHandler(AGAudioEventHandler *handler);
+    void removeEventHandler(AGAudioEventHandler *handler);
+    
+    void graphDidChange();
+    /* see AGAudioEngine */
+    void beginGraphEdit();
+    void endGraphEdit();
+    void retire(const std::function<void ()> &free);
+    
     AGAudioOutputDestination *masterOut();
     
 private:
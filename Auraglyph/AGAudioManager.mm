@@ -7,59 +7,42 @@
 //
 
 #import "AGAudioManager.h"
-#import "AGNode.h"
+#import "AGAudioEngine.h"
 #import "AGAudioNode.h"
-#import "AGTimer.h"
+#import "AGAudioWorkerPool.h"
 
 #import "mo_audio.h"
 
 #import "Mutex.h"
-#import "spstl.h"
 #import "AGAudioRecorder.h"
 
 
-
-class AGAudioManagerOutputDestination : public AGAudioOutputDestination
+// feeds the engine's output to the session recorder
+class AGAudioManagerSessionRecorder : public AGAudioCapturer
 {
 public:
+    AGAudioManagerSessionRecorder(AGAudioRecorder *recorder) : m_recorder(recorder) { }
     
-    AGAudioManagerOutputDestination(AGAudioManager *manager) :
-    m_manager(manager)
-    { }
-    
-    void addOutput(AGAudioRenderer *renderer) override
-    {
-        [m_manager addRenderer:renderer];
-    }
-    
-    virtual void removeOutput(AGAudioRenderer *renderer) override
+    void captureAudio(float *input, int numFrames) override
     {
-        [m_manager removeRenderer:renderer];
+        m_recorder->render(input, numFrames);
     }
     
 private:
-    AGAudioManager *m_manager;
+    AGAudioRecorder *m_recorder;
 };
 
 
 @interface AGAudioManager ()
 {
-    sampletime t;
+    AGAudioEngine *_engine;
     
-    list<AGAudioRenderer *> _renderers;
-    Mutex _renderersMutex;
-    list<AGAudioCapturer *> _capturers;
-    Mutex _capturersMutex;
-    list<AGTimer *> _timers;
-    Mutex _timersMutex;
-    list<AGAudioRateProcessor *> _processors;
-    Mutex _processorsMutex;
+    Mutex _recorderMutex;
+    AGAudioRecorder *_sessionRecorder;
+    AGAudioManagerSessionRecorder *_sessionRecorderCapturer;
     
     float _inputBuffer[1024];
     Buffer<float> _outputBuffer;
-    
-    Mutex _sessionRecorderMutex;
-    AGAudioRecorder *_sessionRecorder;
 }
 
 - (void)renderAudio:(Float32 *)buffer numFrames:(UInt32)numFrames;
@@ -88,9 +71,11 @@ static AGAudioManager *g_audioManager;
     {
         g_audioManager = self;
         
-        self.masterOut = new AGAudioManagerOutputDestination(self);
+        _engine = new AGAudioEngine(AGAudioWorkerPool::defaultNumWorkers());
+        self.masterOut = _engine->masterOut();
         
-        t = 0;
+        _sessionRecorder = NULL;
+        _sessionRecorderCapturer = NULL;
         
         _outputBuffer.resize(1024*2);
         _outputBuffer.clear();
@@ -106,118 +91,79 @@ static AGAudioManager *g_audioManager;
 
 - (void)dealloc
 {
-    SAFE_DELETE(self.masterOut);
+    self.masterOut = NULL;
+    SAFE_DELETE(_engine);
+}
+
+- (AGAudioEngine *)engine
+{
+    return _engine;
 }
 
 - (void)addRenderer:(AGAudioRenderer *)renderer
 {
-    _renderersMutex.lock();
-    _renderers.push_back(renderer);
-    _renderersMutex.unlock();
+    _engine->addRenderer(renderer);
 }
 
 - (void)removeRenderer:(AGAudioRenderer *)renderer
 {
-    _renderersMutex.lock();
-    _renderers.remove(renderer);
-    _renderersMutex.unlock();
+    _engine->removeRenderer(renderer);
+}
+
+- (void)graphDidChange
+{
+    _engine->graphDidChange();
 }
 
 - (void)addCapturer:(AGAudioCapturer *)capturer
 {
-    _capturersMutex.lock();
-    _capturers.push_back(capturer);
-    _capturersMutex.unlock();
+    _engine->addCapturer(capturer);
 }
 
 - (void)removeCapturer:(AGAudioCapturer *)capturer
 {
-    _capturersMutex.lock();
-    _capturers.remove(capturer);
-    _capturersMutex.unlock();
+    _engine->removeCapturer(capturer);
 }
 
-- (void)addTimer:(AGTimer *)timer
+- (void)addEventHandler:(AGAudioEventHandler *)handler
 {
-    _timersMutex.lock();
-    _timers.push_back(timer);
-    _timersMutex.unlock();
+    _engine->addEventHandler(handler);
 }
 
-- (void)removeTimer:(AGTimer *)timer
+- (void)removeEventHandler:(AGAudioEventHandler *)handler
 {
-    _timersMutex.lock();
-    _timers.remove(timer);
-    _timersMutex.unlock();
+    _engine->removeEventHandler(handler);
 }
 
 - (void)addAudioRateProcessor:(AGAudioRateProcessor *)processor
 {
-    _processorsMutex.lock();
-    _processors.push_back(processor);
-    _processorsMutex.unlock();
+    _engine->addAudioRateProcessor(processor);
 }
 
 - (void)removeAudioRateProcessor:(AGAudioRateProcessor *)processor
 {
-    _processorsMutex.lock();
-    _processors.remove(processor);
-    _processorsMutex.unlock();
+    _engine->removeAudioRateProcessor(processor);
 }
 
-
 - (void)renderAudio:(Float32 *)buffer numFrames:(UInt32)numFrames
 {
-    _outputBuffer.clear();
-    
-    _timersMutex.lock();
-    for(AGTimer *timer : _timers )
-    {
-        float tf = ((float)t)/((float)AGAudioNode::sampleRate());
-        float dtf = ((float)numFrames)/((float)AGAudioNode::sampleRate());
-        timer->checkTimer(tf, dtf);
-    };
-    _timersMutex.unlock();
-    
     for(int i = 0; i < numFrames; i++)
     {
         _inputBuffer[i] = buffer[i*2];
     }
     
-    _capturersMutex.lock();
-    for(AGAudioCapturer *capturer : _capturers)
-        capturer->captureAudio(_inputBuffer, numFrames);
-    _capturersMutex.unlock();
-    
-    _processorsMutex.lock();
-    for(auto processor : _processors)
-        processor->process(t);
-    _processorsMutex.unlock();
-    
-    _renderersMutex.lock();
-    for(AGAudioRenderer *renderer : _renderers)
-        renderer->renderAudio(t, NULL, _outputBuffer, numFrames, 0, 2);
-    _renderersMutex.unlock();
+    _engine->render(_inputBuffer, _outputBuffer, numFrames);
     
     for(int i = 0; i < numFrames; i++)
     {
         buffer[i*2] = _outputBuffer[i*2];
         buffer[i*2+1] = _outputBuffer[i*2+1];
     }
-    
-    t += numFrames;
-    
-    _sessionRecorderMutex.lock();
-    
-    if(_sessionRecorder)
-        _sessionRecorder->render(_outputBuffer, numFrames);
-    
-    _sessionRecorderMutex.unlock();
 }
 
 - (void)startSessionRecording
 {
-    _sessionRecorderMutex.lock();
+    _recorderMutex.lock();
     
     if(!_sessionRecorder)
     {
@@ -225,24 +171,27 @@ static AGAudioManager *g_audioManager;
         string file = AGAudioRecorder::pathForSessionRecording("m4a");
         NSLog(@"Starting session recording to %s", file.c_str());
         _sessionRecorder->startRecording(file, 2, AGAudioNode::sampleRate());
+        _sessionRecorderCapturer = new AGAudioManagerSessionRecorder(_sessionRecorder);
+        _engine->addOutputCapturer(_sessionRecorderCapturer);
     }
     
-    _sessionRecorderMutex.unlock();
+    _recorderMutex.unlock();
 }
 
 - (void)stopSessionRecording
 {
-    _sessionRecorder->closeRecording();
-    
-    _sessionRecorderMutex.lock();
+    _recorderMutex.lock();
     
     if(_sessionRecorder)
     {
-        delete _sessionRecorder;
-        _sessionRecorder = NULL;
+        // once removed, the audio thread is done with the recorder
+        _engine->removeOutputCapturer(_sessionRecorderCapturer);
+        _sessionRecorder->closeRecording();
+        SAFE_DELETE(_sessionRecorderCapturer);
+        SAFE_DELETE(_sessionRecorder);
     }
     
-    _sessionRecorderMutex.unlock();
+    _recorderMutex.unlock();
 }
 
 
@@ -285,6 +234,16 @@ void AGAudioManager_::removeAudioRateProcessor(AGAudioRateProcessor *processor)
     [m_audioManager removeAudioRateProcessor:processor];
 }
 
+void AGAudioManager_::addEventHandler(AGAudioEventHandler *handler)
+{
+    [m_audioManager addEventHandler:handler];
+}
+
+void AGAudioManager_::removeEventHandler(AGAudioEventHandler *handler)
+{
+    [m_audioManager removeEventHandler:handler];
+}
+
 void AGAudioManager_::addCapturer(AGAudioCapturer *capturer)
 {
     [m_audioManager addCapturer:capturer];
@@ -295,6 +254,26 @@ void AGAudioManager_::removeCapturer(AGAudioCapturer *capturer)
     [m_audioManager removeCapturer:capturer];
 }
 
+void AGAudioManager_::graphDidChange()
+{
+    [m_audioManager graphDidChange];
+}
+
+void AGAudioManager_::beginGraphEdit()
+{
+    m_audioManager.engine->beginGraphEdit();
+}
+
+void AGAudioManager_::endGraphEdit()
+{
+    m_audioManager.engine->endGraphEdit();
+}
+
+void AGAudioManager_::retire(const std::function<void ()> &free)
+{
+    m_audioManager.engine->retire(free);
+}
+
 AGAudioOutputDestination *AGAudioManager_::masterOut()
 {
     return m_audioManager.masterOut;
@@ -14,6 +14,8 @@
 #include "ShaderHelper.h"
 #include "AGStyle.h"
 #include "AGAudioRenderer.h"
+#include "AGAudioRenderPlan.h"
+#include "AGAudioProfiler.h"
 #include "Buffers.h"
 
 #include "gfx.h"
@@ -41,6 +43,11 @@ public:
         AUDIO_PARAM_LAST = AUDIO_PARAM_GAIN
     };
     
+    // level below which a block counts as silent (-100 dB)
+    static constexpr float SILENCE = 1.0e-5f;
+    // tailFrames() of a node that can sound without any input
+    static const int TAIL_INFINITE = -1;
+    
     static void initializeAudioNode();
     
     using AGNode::AGNode;
@@ -67,6 +74,24 @@ public:
     inline float gain() const { return param(AUDIO_PARAM_GAIN); }
     
     const float *lastOutputBuffer(int portNum) const { return m_outputBuffer[portNum]; }
+    /* true if every output of the last block was below SILENCE */
+    bool outputIsSilent() const { return m_outputSilent; }
+    /* true if the render plan skipped the last block */
+    bool isDormant() const { return m_dormant; }
+    
+    // called by the render plan before rendering each block
+    void setRenderStep(const AGAudioRenderPlan::Step *step)
+    {
+        m_renderInputs = step->inputs;
+        m_numRenderInputs = step->numInputs;
+        m_renderStep = step;
+    }
+    
+    /* overridden by nodes that render an internal subgraph */
+    virtual void subgraphOutputs(vector<AGAudioRenderer *> &outputs) { }
+    
+    /* render timings, recorded by the render plan while profiling is enabled */
+    AGAudioProfiler::History &profile() { return m_profile; }
     
     static int sampleRate() { return s_sampleRate; }
     static int bufferSize()
@@ -90,21 +115,97 @@ private:
     float m_radius;
     float m_portRadius;
     
+    AGAudioProfiler::History m_profile;
+    
+    // silence tracking, for the render plan to skip dormant nodes
+    friend class AGAudioRenderPlan;
+    bool m_outputSilent = false;
+    int m_silentInputFrames = 0;
+    bool m_dormant = false;
+    
+    /* render plan: true if the coming block of nFrames can be skipped, the
+       node's audio inputs and output being silent and its tail run out */
+    bool _dormant(int nFrames);
+    /* render plan: skip block t, leaving silence in the outputs */
+    void _skip(sampletime t);
+    /* render plan: block of nFrames rendered; note whether it was silent */
+    void _rendered(int nFrames);
+    
 protected:
     
     sampletime m_lastTime;
     
     vector<Buffer<float>> m_outputBuffer;
+    
+    // inbound connections as resolved by the current render plan
+    const AGAudioRenderPlan::Step *m_renderStep = NULL;
+    const AGAudioRenderPlan::Input *m_renderInputs = NULL;
+    int m_numRenderInputs = 0;
+    
+    // last known base (param or control) value of each input port, reused when
+    // the UI thread holds the node lock during a render
+    Buffer<float> m_inputPortBase;
 
     float ** m_inputPortBuffer; // XXX TODO: stretch goal; should we refactor this as a vector of Buffers? if our newfangled
                                 // output vector scheme works, then go for it!
     
+    // ports with nothing audio-rate connected are constant for the block, and
+    // their buffer is only filled with the base value if a node asks for it
+    struct InputPortState
+    {
+        bool constant;
+        // value/length of the constant fill currently in the buffer, if any
+        float filledValue;
+        int filledFrames;
+    };
+    Buffer<InputPortState> m_inputPortState;
+    int m_inputPortFrames = 0;
+    
     void allocatePortBuffers();
     void pullInputPorts(sampletime t, int nFrames);
+    int numRenderInputsForPort(int paramId, AGRate rate = RATE_NULL) const;
     void renderLast(float *output, int nFrames, int chanNum);
+    
+    /* true if the port holds inputPortValue() for the whole block, so that
+       nodes can use the scalar in place of the vector */
+    bool inputPortIsConstant(int paramId) const { return m_inputPortState[m_param2InputPort.at(paramId)].constant; }
+    float inputPortValue(int paramId) const { return m_inputPortBase[m_param2InputPort.at(paramId)]; }
+    /* per-sample values of the port for the current block */
     float *inputPortVector(int paramId);
+    /* buffer[i] *= port value, with a scalar multiply if the port is constant */
+    void scaleByInputPort(int paramId, float *buffer, int nFrames);
+    /* oscillator phase (cycles) for each frame of the block, advanced by the
+       freq port (Hz) plus the phase port, or, with audio-rate phase input,
+       following that instead, as the built-in oscillators do. Phases may
+       stray a little outside [0, 1) (see spv_phasor). Returns the block's
+       highest |freq| in cycles per sample, for band-limiting */
+    float renderPhase(float *phasev, float &phase, int freqParam, int phaseParam, int nFrames);
+    
+    /* frames the node's output may keep sounding once its audio inputs fall
+       silent (a delay's echoes, a filter's ringing), or TAIL_INFINITE if it
+       sounds on its own; once its inputs have been silent that long, and its
+       output too, the render plan skips it until an input sounds again.
+       Called on the render thread with the node locked, before the block's
+       inputs are pulled */
+    virtual int tailFrames() const { return TAIL_INFINITE; }
+    /* true if the node will output silence in the coming block whatever its
+       inputs, e.g. an envelope at rest; called as tailFrames() is */
+    virtual bool outputGated() const { return false; }
+    /* base (param or control) value the port will take in the coming block,
+       for tailFrames(); with the node locked */
+    float nextInputPortValue(int paramId) const;
+    /* frames for echoes through a delay of delayFrames, fed back with gain,
+       to fall below SILENCE; TAIL_INFINITE if they never do */
+    static int echoTailFrames(float delayFrames, float gain);
+    
+    float *_inputPortVector(int portNum);
 };
 
+inline AGAudioNode *AGAudioRenderPlan::Input::audioSrc() const
+{
+    return static_cast<AGAudioNode *>(src);
+}
+
 
 //------------------------------------------------------------------------------
 // ### AGAudioOutputNode ###
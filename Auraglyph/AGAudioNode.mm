@@ -13,6 +13,9 @@
 #include "AGAudioManager.h"
 #include "AGStyle.h"
 #include "spdsp.h"
+#include "spvdsp.h"
+
+#include <limits.h>
 
 
 //------------------------------------------------------------------------------
@@ -25,6 +28,7 @@ GLuint AGAudioNode::s_vertexArray = 0;
 GLuint AGAudioNode::s_vertexBuffer = 0;
 GLuint AGAudioNode::s_geoSize = 0;
 int AGAudioNode::s_sampleRate = 44100;
+constexpr float AGAudioNode::SILENCE;
 
 void AGAudioNode::initializeAudioNode()
 {
@@ -38,7 +42,7 @@ void AGAudioNode::initializeAudioNode()
         s_geoSize = 64;
         GLvertex3f *geo = new GLvertex3f[s_geoSize];
         float radius = 0.01*AGStyle::oldGlobalScale;
-        for(int i = 0; i < s_geoSize; i++)
+        for(int i = 0; i < (int) s_geoSize; i++)
         {
             float theta = 2*M_PI*((float)i)/((float)(s_geoSize));
             geo[i] = GLvertex3f(radius*cosf(theta), radius*sinf(theta), 0);
@@ -212,14 +216,21 @@ GLvertex3f AGAudioNode::relativePositionForOutputPort(int port) const
 
 void AGAudioNode::allocatePortBuffers()
 {
+    // sized for the largest block any caller may render, not just the
+    // hardware buffer size (offline renders and benchmarks use others)
     if(numInputPorts() > 0)
     {
         m_inputPortBuffer = new float*[numInputPorts()];
         for(int i = 0; i < numInputPorts(); i++)
         {
-            m_inputPortBuffer[i] = new float[bufferSize()];
-            memset(m_inputPortBuffer[i], 0, sizeof(float)*bufferSize());
+            m_inputPortBuffer[i] = new float[AUDIO_BUFFER_MAX];
+            memset(m_inputPortBuffer[i], 0, sizeof(float)*AUDIO_BUFFER_MAX);
         }
+        
+        m_inputPortBase.resize(numInputPorts());
+        m_inputPortBase.clear();
+        m_inputPortState.resize(numInputPorts());
+        m_inputPortState.clear();
     }
     else
     {
@@ -230,7 +241,7 @@ void AGAudioNode::allocatePortBuffers()
     m_outputBuffer.resize(numOutputPorts());
     for(int i = 0; i < numOutputPorts(); i++)
     {
-        m_outputBuffer[i].resize(bufferSize());
+        m_outputBuffer[i].resize(AUDIO_BUFFER_MAX);
         m_outputBuffer[i].clear();
     }
 
@@ -240,10 +251,10 @@ void AGAudioNode::pullInputPorts(sampletime t, int nFrames)
 {
 //    if(t <= m_lastTime) return;
     
-    this->lock();
-    
     if(m_inputPortBuffer != NULL)
     {
+        // params are atomics, set whole by the UI thread, so there's nothing
+        // to lock here
         for(int i = 0; i < numInputPorts(); i++)
         {
             float base = 0;
@@ -252,62 +263,82 @@ void AGAudioNode::pullInputPorts(sampletime t, int nFrames)
                 base = m_params.at(paramId);
             if(m_controlPortBuffer[i])
                 base = m_controlPortBuffer[i].getFloat();
-            
-            if(m_inputPortBuffer[i] != NULL)
-            {
-                // memset(m_inputPortBuffer[i], 0, nFrames*sizeof(float));
-                
-                for(int samp = 0; samp < nFrames; samp++)
-                    m_inputPortBuffer[i][samp] = base;
-            }
+            m_inputPortBase[i] = base;
         }
+        
+        // constant until an audio-rate input says otherwise; the base value
+        // is only written out on demand (see _inputPortVector)
+        for(int i = 0; i < numInputPorts(); i++)
+            m_inputPortState[i].constant = true;
+        m_inputPortFrames = nFrames;
     }
         
-    for(std::list<AGConnection *>::iterator c = m_inbound.begin(); c != m_inbound.end(); c++)
+    // inputs have already been rendered earlier in the plan
+    for(int c = 0; c < m_numRenderInputs; c++)
     {
-        AGConnection *conn = *c;
+        const AGAudioRenderPlan::Input &in = m_renderInputs[c];
         
-        assert(m_inputPortBuffer && m_inputPortBuffer[conn->dstPort()]);
+        assert(m_inputPortBuffer && m_inputPortBuffer[in.dstPort]);
         
-        if(conn->rate() == RATE_AUDIO)
+        if(in.rate == RATE_AUDIO)
         {
-            AGAudioRenderer *rndrr = dynamic_cast<AGAudioRenderer *>(conn->src());
-            AGAudioNode *node = dynamic_cast<AGAudioNode *>(rndrr);
-            if(node)
-                dbgprint_off("rendering '%s'\n", node->title().c_str());
-            rndrr->renderAudio(t, NULL, m_inputPortBuffer[conn->dstPort()], nFrames, conn->srcPort(), conn->src()->numOutputPorts());
+            InputPortState &state = m_inputPortState[in.dstPort];
+            if(state.constant)
+            {
+                spv_fill(m_inputPortBuffer[in.dstPort], m_inputPortBase[in.dstPort], nFrames);
+                state.constant = false;
+                state.filledFrames = 0;
+            }
+            
+            spv_add(m_inputPortBuffer[in.dstPort], in.audioSrc()->lastOutputBuffer(in.srcPort), nFrames);
         }
     }
+}
+
+int AGAudioNode::numRenderInputsForPort(int paramId, AGRate rate) const
+{
+    int portNum = m_param2InputPort[paramId];
+    if(portNum < 0) return 0;
     
-    this->unlock();
+    int numInputs = 0;
+    for(int c = 0; c < m_numRenderInputs; c++)
+    {
+        const AGAudioRenderPlan::Input &in = m_renderInputs[c];
+        if(in.dstPort == portNum && (rate == AGRate::RATE_NULL || in.rate == rate))
+            numInputs++;
+    }
+    
+    return numInputs;
 }
 
 void AGAudioNode::pullPortInput(int portId, int num, sampletime t, float *output, int nFrames)
 {
-    if(m_param2InputPort.count(portId) == 0) return;
-    
-    int portNum = m_param2InputPort.at(portId);
+    int portNum = m_param2InputPort[portId];
+    if(portNum < 0) return;
     
     int i = 0;
-    for(auto conn : m_inbound)
+    for(int c = 0; c < m_numRenderInputs; c++)
     {
-        if(conn->dstPort() == portNum)
+        const AGAudioRenderPlan::Input &in = m_renderInputs[c];
+        
+        if(in.dstPort == portNum)
         {
             if(i == num)
             {
-                if(conn->rate() == RATE_AUDIO)
+                if(in.rate == RATE_AUDIO)
                 {
-                    AGAudioRenderer *rndrr = dynamic_cast<AGAudioRenderer *>(conn->src());
-                    rndrr->renderAudio(t, NULL, output, nFrames, conn->srcPort(), conn->src()->numOutputPorts());
+                    spv_add(output, in.audioSrc()->lastOutputBuffer(in.srcPort), nFrames);
                 }
                 else
                 {
-                    // get last port value
-                    float val = conn->src()->lastControlOutput(conn->srcPort()).getFloat();
-                    //dbgprint("pullPortInput-control %i:%f\n", conn->srcPort(), val);
-                    //
-                    for(int i = 0; i < nFrames; i++)
-                        output[i] = val;
+                    // get last port value, or the port's base value if the
+                    // source is busy
+                    float val = m_inputPortBase.size ? m_inputPortBase[portNum] : 0;
+                    AGControl control;
+                    if(in.src->tryLastControlOutput(in.srcPort, control))
+                        val = control.getFloat();
+                    for(int samp = 0; samp < nFrames; samp++)
+                        output[samp] = val;
                 }
                 
                 break;
@@ -335,7 +366,145 @@ void AGAudioNode::renderLast(float *output, int nFrames, int chanNum)
 float *AGAudioNode::inputPortVector(int paramId)
 {
     assert(m_param2InputPort.count(paramId));
-    return m_inputPortBuffer[m_param2InputPort.at(paramId)];
+    return _inputPortVector(m_param2InputPort.at(paramId));
+}
+
+float *AGAudioNode::_inputPortVector(int portNum)
+{
+    InputPortState &state = m_inputPortState[portNum];
+    float value = m_inputPortBase[portNum];
+    
+    // a constant port keeps its fill from earlier blocks until the value
+    // changes, so static params cost nothing per block
+    if(state.constant && (state.filledFrames < m_inputPortFrames || state.filledValue != value))
+    {
+        spv_fill(m_inputPortBuffer[portNum], value, m_inputPortFrames);
+        state.filledValue = value;
+        state.filledFrames = m_inputPortFrames;
+    }
+    
+    return m_inputPortBuffer[portNum];
+}
+
+void AGAudioNode::scaleByInputPort(int paramId, float *buffer, int nFrames)
+{
+    if(inputPortIsConstant(paramId))
+        spv_scale(buffer, inputPortValue(paramId), nFrames);
+    else
+        spv_mul(buffer, inputPortVector(paramId), nFrames);
+}
+
+float AGAudioNode::renderPhase(float *phasev, float &phase, int freqParam, int phaseParam, int nFrames)
+{
+    float frequency;
+    
+    // per-sample phase increment
+    if(inputPortIsConstant(freqParam) && inputPortIsConstant(phaseParam))
+    {
+        frequency = inputPortValue(freqParam)/sampleRate();
+        spv_fill(phasev, frequency + inputPortValue(phaseParam), nFrames);
+    }
+    else
+    {
+        float *freqv = inputPortVector(freqParam);
+        frequency = spv_maxabs(freqv, nFrames)/sampleRate();
+        spv_fill(phasev, 0, nFrames);
+        spv_mac(phasev, freqv, 1.0f/sampleRate(), nFrames);
+        spv_add(phasev, inputPortVector(phaseParam), nFrames);
+    }
+    
+    if(inputPortIsConstant(phaseParam))
+    {
+        phase = spv_phasor(phasev, phasev, phase, nFrames);
+    }
+    else if(nFrames > 0)
+    {
+        // phase driven at audio rate: each sample's phase is just the
+        // previous sample's increment
+        float next = clipunit(phasev[nFrames-1]);
+        memmove(phasev+1, phasev, sizeof(float)*(nFrames-1));
+        phasev[0] = phase;
+        phase = next;
+    }
+    
+    return fabsf(frequency);
+}
+
+float AGAudioNode::nextInputPortValue(int paramId) const
+{
+    // as pullInputPorts will find it
+    int portNum = m_param2InputPort[paramId];
+    float base = 0;
+    if(m_params.count(paramId))
+        base = m_params.at(paramId);
+    if(portNum >= 0 && m_controlPortBuffer[portNum])
+        base = m_controlPortBuffer[portNum].getFloat();
+    return base;
+}
+
+int AGAudioNode::echoTailFrames(float delayFrames, float gain)
+{
+    gain = fabsf(gain);
+    if(!(gain < 1))
+        return TAIL_INFINITE;
+    
+    // the first pass through the delay, then one more per recirculation
+    double passes = 1;
+    if(gain > 0)
+        passes += ceil(log(SILENCE)/log(gain));
+    double frames = ceil(std::max(delayFrames, 0.0f)*passes);
+    
+    return frames < INT_MAX/2 ? (int) frames : TAIL_INFINITE;
+}
+
+bool AGAudioNode::_dormant(int nFrames)
+{
+    bool inputsSilent = true;
+    for(int c = 0; c < m_numRenderInputs && inputsSilent; c++)
+    {
+        const AGAudioRenderPlan::Input &in = m_renderInputs[c];
+        if(in.rate == RATE_AUDIO && !in.audioSrc()->m_outputSilent)
+            inputsSilent = false;
+    }
+    
+    if(!inputsSilent)
+        m_silentInputFrames = 0;
+    
+    bool dormant = false;
+    // a node that sounded last block renders at least once more; tails and
+    // gates only read params and the node's own render state, so need no lock
+    if(m_outputSilent)
+    {
+        int tail = inputsSilent ? tailFrames() : TAIL_INFINITE;
+        dormant = outputGated() || (tail != TAIL_INFINITE && m_silentInputFrames >= tail);
+    }
+    
+    if(inputsSilent && m_silentInputFrames < INT_MAX/2)
+        m_silentInputFrames += nFrames;
+    
+    return dormant;
+}
+
+void AGAudioNode::_skip(sampletime t)
+{
+    // silence is written once, and left in place while the node sleeps
+    if(!m_dormant)
+    {
+        for(Buffer<float> &buffer : m_outputBuffer)
+            buffer.clear();
+        m_dormant = true;
+    }
+    
+    m_lastTime = t;
+}
+
+void AGAudioNode::_rendered(int nFrames)
+{
+    m_dormant = false;
+    
+    m_outputSilent = true;
+    for(int i = 0; i < (int) m_outputBuffer.size() && m_outputSilent; i++)
+        m_outputSilent = spv_maxabs(m_outputBuffer[i], nFrames) < SILENCE;
 }
 
 #include "AGCompositeNode.h"
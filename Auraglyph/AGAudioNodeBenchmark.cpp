@@ -0,0 +1,746 @@
+//
+//  AGAudioNodeBenchmark.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGAudioNodeBenchmark.h"
+#include "AGAudioRenderPlan.h"
+#include "AGAudioFilterBank.h"
+#include "AGAudioNode.h"
+#include "AGCompositeNode.h"
+#include "AGControlNode.h"
+#include "AGControlBus.h"
+#include "AGConnection.h"
+#include "AGNode.h"
+#include "Buffers.h"
+
+#include "CycleCounter.h"
+#include "RealtimeAllocGuard.h"
+#include "spvdsp.h"
+
+#include <chrono>
+#include <list>
+#include <math.h>
+#include <stdio.h>
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioNodeBenchmark ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioNodeBenchmark
+
+std::string AGAudioNodeBenchmark::Result::name() const
+{
+    return type + "/" + std::to_string(blockSize) + (inputRate == RATE_AUDIO ? "/audio" : "/control");
+}
+
+const std::vector<int> &AGAudioNodeBenchmark::defaultBlockSizes()
+{
+    static const std::vector<int> s_blockSizes = { 64, 256, 1024 };
+    return s_blockSizes;
+}
+
+AGAudioNodeBenchmark::Result AGAudioNodeBenchmark::run(const AGNodeManifest *manifest, int blockSize, AGRate inputRate, double minTime)
+{
+    assert(blockSize > 0 && blockSize <= AUDIO_BUFFER_MAX);
+
+    Result result;
+    result.type = manifest->type();
+    result.blockSize = blockSize;
+    result.inputRate = inputRate;
+    result.iterations = 0;
+    result.nsPerSample = 0;
+    result.cyclesPerSample = 0;
+
+    AGAudioNode *node = dynamic_cast<AGAudioNode *>(AGNodeManager::audioNodeManager().createNodeType(manifest, GLvertex3f()));
+    if(node == NULL)
+        return result;
+    
+    // output nodes render interleaved stereo; everything else one channel per
+    // output port, so nodes without any (i.e. an empty composite) are skipped
+    bool sink = (dynamic_cast<AGAudioOutputNode *>(node) != NULL);
+    int nChans = sink ? 2 : node->numOutputPorts();
+    if(nChans == 0)
+    {
+        delete node;
+        return result;
+    }
+
+    // every input port is fed by the same driver: a sine for audio-rate inputs,
+    // or a control node whose output is pushed by hand each block
+    AGNode *driver = NULL;
+    if(node->numInputPorts() > 0)
+    {
+        if(inputRate == RATE_AUDIO)
+            driver = AGNodeManager::audioNodeManager().createNodeOfType("SineWave", GLvertex3f());
+        else
+            driver = AGNodeManager::controlNodeManager().createNodeOfType("Add", GLvertex3f());
+    }
+
+    std::list<AGConnection *> connections;
+    if(driver != NULL)
+    {
+        for(int port = 0; port < node->numInputPorts(); port++)
+            connections.push_back(AGConnection::connect(driver, 0, node, port));
+    }
+
+    // plan for the node and its driver, so that inputs are bound the same way
+    // as in a live graph; the node is rendered by hand so only it is timed
+    std::list<AGAudioRenderer *> outputs = { node };
+    AGAudioRenderPlan *plan = AGAudioRenderPlan::compile(outputs);
+
+    Buffer<float> output(AUDIO_BUFFER_MAX*std::max(nChans, 2));
+    Buffer<float> scratch(AUDIO_BUFFER_MAX);
+
+    // control values start from the port's parameter value, where it has one
+    std::vector<float> controlBase;
+    for(int port = 0; port < node->numInputPorts(); port++)
+    {
+        float base = 1;
+        for(int edit = 0; edit < node->numEditPorts(); edit++)
+        {
+            if(node->editPortInfo(edit).portId == node->inputPortInfo(port).portId)
+            {
+                AGParamValue value;
+                node->getEditPortValue(edit, value);
+                base = value;
+            }
+        }
+        controlBase.push_back(base);
+    }
+
+    sampletime t = 0;
+    long long block = 0;
+
+    auto renderBlocks = [&](long long numBlocks, double &ns, uint64_t &cycles) {
+        // as on the audio thread, so RT_ALLOC_GUARD builds flag allocations
+        RealtimeAllocGuard::Scope realtime;
+        
+        ns = 0;
+        cycles = 0;
+
+        for(long long i = 0; i < numBlocks; i++, block++, t += blockSize)
+        {
+            for(int s = 0; s < plan->numSteps(); s++)
+                plan->step(s).node->setRenderStep(&plan->step(s));
+
+            // drivers are rendered outside of the timed region
+            if(inputRate == RATE_AUDIO)
+            {
+                for(int s = 0; s < plan->numSteps(); s++)
+                {
+                    const AGAudioRenderPlan::Step &step = plan->step(s);
+                    if(step.node != node)
+                        step.node->renderAudio(t, NULL, scratch, blockSize, 0, step.node->numOutputPorts());
+                }
+            }
+            else if(driver != NULL)
+            {
+                // nudge the value each block so that nodes which cache anything
+                // derived from their inputs have to recompute it
+                float nudge = (block & 1) ? 1.01f : 1.0f;
+                driver->pushControl(0, AGControl(controlBase[block % controlBase.size()]*nudge));
+                AGControlBus::instance().deliver(t);
+            }
+
+            output.clear();
+
+            auto start = std::chrono::steady_clock::now();
+            uint64_t startCycles = CycleCounter::now();
+
+            node->renderAudio(t, NULL, output, blockSize, 0, nChans);
+
+            cycles += CycleCounter::now()-startCycles;
+            ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now()-start).count();
+        }
+    };
+
+    // warm up caches and any lazily initialized state
+    double ns = 0;
+    uint64_t cycles = 0;
+    renderBlocks(std::max(1, 4096/blockSize), ns, cycles);
+
+    // grow the iteration count until a run takes at least minTime
+    long long iterations = 1;
+    while(true)
+    {
+        renderBlocks(iterations, ns, cycles);
+
+        if(ns >= minTime*1e9 || iterations >= (1LL << 30))
+            break;
+
+        double multiplier = ns > 0 ? std::min(10.0, std::max(2.0, 1.4*minTime*1e9/ns)) : 10.0;
+        iterations = (long long) ceil(iterations*multiplier);
+    }
+
+    result.iterations = iterations;
+    result.nsPerSample = ns/((double) iterations*blockSize);
+    result.cyclesPerSample = ((double) cycles)/((double) iterations*blockSize);
+
+    delete plan;
+
+    for(AGConnection *connection : connections)
+    {
+        AGNode::disconnect(connection);
+        delete connection;
+    }
+    delete driver;
+    delete node;
+
+    return result;
+}
+
+std::vector<AGAudioNodeBenchmark::Result> AGAudioNodeBenchmark::runAll(const std::string &filter,
+                                                                      const std::vector<int> &blockSizes,
+                                                                      double minTime)
+{
+    std::vector<Result> results;
+
+    fprintf(stderr, "AGAudioNodeBenchmark: %i Hz, cycle counter: %s\n", AGAudioNode::sampleRate(), CycleCounter::name());
+    fprintf(stderr, "%-40s %14s %14s %12s\n", "benchmark", "ns/sample", "cycles/sample", "iterations");
+
+    for(const AGNodeManifest *manifest : AGNodeManager::audioNodeManager().nodeTypes())
+    {
+        if(filter.length() && manifest->type().find(filter) == std::string::npos)
+            continue;
+
+        for(AGRate inputRate : { RATE_AUDIO, RATE_CONTROL })
+        {
+            for(int blockSize : blockSizes)
+            {
+                Result result = run(manifest, blockSize, inputRate, minTime);
+                if(result.iterations == 0)
+                {
+                    fprintf(stderr, "%-40s %14s\n", result.name().c_str(), "skipped");
+                    continue;
+                }
+                
+                results.push_back(result);
+
+                fprintf(stderr, "%-40s %14.3f %14.3f %12lli\n", result.name().c_str(),
+                        result.nsPerSample, result.cyclesPerSample, result.iterations);
+            }
+        }
+    }
+
+    return results;
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioNodeBenchmark banks ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioNodeBenchmark banks
+
+std::string AGAudioNodeBenchmark::BankResult::name() const
+{
+    return type + "/" + std::to_string(numFilters) + "/" + std::to_string(blockSize);
+}
+
+AGAudioNodeBenchmark::BankResult AGAudioNodeBenchmark::runBank(const AGNodeManifest *manifest, int numFilters, int blockSize, double minTime)
+{
+    assert(blockSize > 0 && blockSize <= AUDIO_BUFFER_MAX && numFilters > 0);
+
+    BankResult result;
+    result.type = manifest->type();
+    result.numFilters = numFilters;
+    result.blockSize = blockSize;
+    result.nsSeparate = 0;
+    result.nsBanked = 0;
+    result.maxDifference = 0;
+
+    // two copies of the same graph: a sine through numFilters filters, each
+    // set a little differently, summed by an Add node; one is rendered with
+    // filter banks, the other without
+    struct Graph
+    {
+        std::list<AGNode *> nodes;
+        std::list<AGConnection *> connections;
+        AGAudioNode *sum;
+        AGAudioRenderPlan *plan;
+        Buffer<float> output;
+    } graphs[2];
+
+    for(int g = 0; g < 2; g++)
+    {
+        Graph &graph = graphs[g];
+        const AGNodeManager &nodeManager = AGNodeManager::audioNodeManager();
+
+        AGNode *driver = nodeManager.createNodeOfType("SineWave", GLvertex3f());
+        graph.sum = dynamic_cast<AGAudioNode *>(nodeManager.createNodeOfType("Add", GLvertex3f()));
+        graph.nodes.push_back(driver);
+        graph.nodes.push_back(graph.sum);
+
+        for(int j = 0; j < numFilters; j++)
+        {
+            AGNode *node = nodeManager.createNodeType(manifest, GLvertex3f());
+            graph.nodes.push_back(node);
+
+            for(int edit = 0; edit < node->numEditPorts(); edit++)
+            {
+                if(node->editPortInfo(edit).portId == AGAudioNode::AUDIO_PARAM_GAIN)
+                    continue;
+                // zero defaults (biquad coefficients) to small, stable values
+                AGParamValue value;
+                node->getEditPortValue(edit, value);
+                float v = value;
+                node->setEditPortValue(edit, v != 0 ? v*(1+0.05f*j) : 0.1f*(1+j%4));
+            }
+
+            graph.connections.push_back(AGConnection::connect(driver, 0, node, 0));
+            graph.connections.push_back(AGConnection::connect(node, 0, graph.sum, 0));
+        }
+
+        std::list<AGAudioRenderer *> outputs = { graph.sum };
+        graph.plan = AGAudioRenderPlan::compile(outputs, g == 1);
+        graph.output.resize(AUDIO_BUFFER_MAX);
+    }
+
+    sampletime t = 0;
+
+    // the sum renders as the plan's output; time the whole block
+    auto renderBlocks = [&](Graph &graph, sampletime t, long long numBlocks) {
+        RealtimeAllocGuard::Scope realtime;
+
+        auto start = std::chrono::steady_clock::now();
+        for(long long i = 0; i < numBlocks; i++, t += blockSize)
+        {
+            graph.output.clear();
+            graph.plan->render(t, graph.output, blockSize, 1);
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now()-start).count();
+    };
+
+    // same blocks through both, comparing as we go
+    for(int i = 0; i < std::max(1, 8192/blockSize); i++, t += blockSize)
+    {
+        for(Graph &graph : graphs)
+        {
+            graph.output.clear();
+            graph.plan->render(t, graph.output, blockSize, 1);
+        }
+        for(int f = 0; f < blockSize; f++)
+            result.maxDifference = std::max(result.maxDifference, fabsf(graphs[0].output[f]-graphs[1].output[f]));
+    }
+
+    double ns[2];
+    for(int g = 0; g < 2; g++)
+    {
+        long long iterations = 1;
+        while(true)
+        {
+            ns[g] = renderBlocks(graphs[g], t, iterations);
+            t += iterations*blockSize;
+
+            if(ns[g] >= minTime*1e9 || iterations >= (1LL << 30))
+                break;
+
+            double multiplier = ns[g] > 0 ? std::min(10.0, std::max(2.0, 1.4*minTime*1e9/ns[g])) : 10.0;
+            iterations = (long long) ceil(iterations*multiplier);
+        }
+        ns[g] /= (double) iterations*blockSize*numFilters;
+    }
+
+    result.nsSeparate = ns[0];
+    result.nsBanked = ns[1];
+
+    for(Graph &graph : graphs)
+    {
+        delete graph.plan;
+        for(AGConnection *connection : graph.connections)
+        {
+            AGNode::disconnect(connection);
+            delete connection;
+        }
+        for(AGNode *node : graph.nodes)
+            delete node;
+    }
+
+    return result;
+}
+
+std::vector<AGAudioNodeBenchmark::BankResult> AGAudioNodeBenchmark::runAllBanks(const std::string &filter,
+                                                                              const std::vector<int> &blockSizes,
+                                                                              double minTime)
+{
+    std::vector<BankResult> results;
+
+    fprintf(stderr, "AGAudioNodeBenchmark: filter banks, %i Hz, %s\n", AGAudioNode::sampleRate(), spv_isa());
+    fprintf(stderr, "%-40s %14s %14s %10s %12s\n", "benchmark", "separate ns", "banked ns", "speedup", "max diff");
+
+    for(const AGNodeManifest *manifest : AGNodeManager::audioNodeManager().nodeTypes())
+    {
+        if(filter.length() && manifest->type().find(filter) == std::string::npos)
+            continue;
+
+        AGNode *node = AGNodeManager::audioNodeManager().createNodeType(manifest, GLvertex3f());
+        bool bankable = dynamic_cast<AGAudioFilterBank::Filter *>(node) != NULL;
+        delete node;
+        if(!bankable)
+            continue;
+
+        for(int numFilters : { 4, 16, 32 })
+        {
+            for(int blockSize : blockSizes)
+            {
+                BankResult result = runBank(manifest, numFilters, blockSize, minTime);
+                results.push_back(result);
+
+                fprintf(stderr, "%-40s %14.3f %14.3f %9.2fx %12.3g\n", result.name().c_str(),
+                        result.nsSeparate, result.nsBanked,
+                        result.nsBanked > 0 ? result.nsSeparate/result.nsBanked : 0.0, result.maxDifference);
+            }
+        }
+    }
+
+    return results;
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioNodeBenchmark voices ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioNodeBenchmark voices
+
+std::string AGAudioNodeBenchmark::VoiceResult::name() const
+{
+    return "Voices/" + std::to_string(numVoices) + "/" + std::to_string(numNotes) + "/" + std::to_string(blockSize);
+}
+
+AGAudioNodeBenchmark::VoiceResult AGAudioNodeBenchmark::runVoices(int numVoices, int numNotes, int blockSize, double minTime)
+{
+    assert(blockSize > 0 && blockSize <= AUDIO_BUFFER_MAX);
+    assert(numVoices > 0 && numVoices <= AGAudioCompositeNode::MAX_VOICES);
+
+    VoiceResult result;
+    result.numVoices = numVoices;
+    result.numNotes = numNotes;
+    result.blockSize = blockSize;
+    result.numActiveVoices = 0;
+    result.nsPerSample = 0;
+    result.peak = 0;
+
+    const AGNodeManager &audioNodeManager = AGNodeManager::audioNodeManager();
+
+    // Voice pitch -> SineWave freq, SineWave -> ADSR -> Output, and Voice
+    // velocity -> ADSR trigger
+    AGNode *voice = AGNodeManager::controlNodeManager().createNodeOfType("Voice", GLvertex3f());
+    AGNode *sine = audioNodeManager.createNodeOfType("SineWave", GLvertex3f());
+    AGNode *adsr = audioNodeManager.createNodeOfType("ADSR", GLvertex3f());
+    AGNode *output = audioNodeManager.createNodeOfType("Output", GLvertex3f());
+    std::list<AGNode *> subnodes = { voice, sine, adsr, output };
+
+    std::list<AGConnection *> connections = {
+        AGConnection::connect(voice, 0, sine, 0),
+        AGConnection::connect(voice, 1, adsr, 2),
+        AGConnection::connect(sine, 0, adsr, 0),
+        AGConnection::connect(adsr, 0, output, 0),
+    };
+
+    AGAudioCompositeNode *composite = dynamic_cast<AGAudioCompositeNode *>(audioNodeManager.createNodeOfType("Composite", GLvertex3f()));
+    for(AGNode *node : subnodes)
+        composite->addSubnode(node);
+    dynamic_cast<AGAudioOutputNode *>(output)->setOutputDestination(composite);
+    composite->setParam(AGAudioCompositeNode::PARAM_VOICES, numVoices);
+
+    std::list<AGAudioRenderer *> outputs = { composite };
+    AGAudioRenderPlan *plan = AGAudioRenderPlan::compile(outputs);
+    Buffer<float> buffer(AUDIO_BUFFER_MAX);
+
+    // as MIDI Note In sends them: pitch (input port 1), then velocity (2)
+    sampletime t = 0;
+
+    auto play = [&](float pitch, float velocity) {
+        composite->receiveControl(1, AGControl(pitch));
+        composite->receiveControl(2, AGControl(velocity));
+        AGControlBus::instance().deliver(t);
+    };
+
+    auto renderBlocks = [&](long long numBlocks) {
+        RealtimeAllocGuard::Scope realtime;
+
+        auto start = std::chrono::steady_clock::now();
+        for(long long i = 0; i < numBlocks; i++, t += blockSize)
+        {
+            buffer.clear();
+            plan->render(t, buffer, blockSize, 1);
+            result.peak = std::max(result.peak, spv_maxabs(buffer, blockSize));
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now()-start).count();
+    };
+
+    // with no notes held, every voice plays a note and is released, and
+    // renders until its ADSR has finished
+    int numPlayed = numNotes > 0 ? numNotes : numVoices;
+    for(int n = 0; n < numPlayed; n++)
+        play(110*(n+1), 1);
+    renderBlocks(std::max(1, 4096/blockSize));
+    if(numNotes == 0)
+    {
+        for(int n = 0; n < numPlayed; n++)
+            play(110*(n+1), 0);
+        // release is 0.1 s
+        renderBlocks(AGAudioNode::sampleRate()/blockSize+1);
+    }
+
+    result.peak = 0;
+
+    long long iterations = 1;
+    double ns = 0;
+    while(true)
+    {
+        ns = renderBlocks(iterations);
+
+        if(ns >= minTime*1e9 || iterations >= (1LL << 30))
+            break;
+
+        double multiplier = ns > 0 ? std::min(10.0, std::max(2.0, 1.4*minTime*1e9/ns)) : 10.0;
+        iterations = (long long) ceil(iterations*multiplier);
+    }
+
+    result.nsPerSample = ns/((double) iterations*blockSize);
+    result.numActiveVoices = composite->numActiveVoices();
+
+    delete plan;
+    dynamic_cast<AGAudioOutputNode *>(output)->setOutputDestination(NULL);
+    delete composite;
+    for(AGConnection *connection : connections)
+    {
+        AGNode::disconnect(connection);
+        delete connection;
+    }
+    for(AGNode *node : subnodes)
+        delete node;
+
+    return result;
+}
+
+std::vector<AGAudioNodeBenchmark::VoiceResult> AGAudioNodeBenchmark::runAllVoices(const std::vector<int> &blockSizes,
+                                                                                double minTime)
+{
+    std::vector<VoiceResult> results;
+    int numVoices = AGAudioCompositeNode::MAX_VOICES;
+
+    fprintf(stderr, "AGAudioNodeBenchmark: polyphonic composite, %i Hz\n", AGAudioNode::sampleRate());
+    fprintf(stderr, "%-40s %14s %14s %10s\n", "benchmark", "ns/sample", "active voices", "peak");
+
+    for(int numNotes : { 0, 1, 4, 8, numVoices })
+    {
+        for(int blockSize : blockSizes)
+        {
+            VoiceResult result = runVoices(numVoices, numNotes, blockSize, minTime);
+            results.push_back(result);
+
+            fprintf(stderr, "%-40s %14.3f %14i %10.3f\n", result.name().c_str(),
+                    result.nsPerSample, result.numActiveVoices, result.peak);
+        }
+    }
+
+    return results;
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioNodeBenchmark silence ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioNodeBenchmark silence
+
+std::string AGAudioNodeBenchmark::SilenceResult::name() const
+{
+    return "Silence/" + std::to_string(numVoices) + "/" + std::to_string(numSounding) + "/" + std::to_string(blockSize);
+}
+
+static void _setEditPort(AGNode *node, const std::string &name, float value)
+{
+    for(int edit = 0; edit < node->numEditPorts(); edit++)
+    {
+        if(node->editPortInfo(edit).name == name)
+            node->setEditPortValue(edit, value);
+    }
+}
+
+AGAudioNodeBenchmark::SilenceResult AGAudioNodeBenchmark::runSilence(int numVoices, int numSounding, int blockSize, double minTime)
+{
+    assert(blockSize > 0 && blockSize <= AUDIO_BUFFER_MAX && numVoices > 0);
+
+    SilenceResult result;
+    result.numVoices = numVoices;
+    result.numSounding = numSounding;
+    result.blockSize = blockSize;
+    result.numNodes = 0;
+    result.numDormant = 0;
+    result.nsAll = 0;
+    result.nsSkipping = 0;
+    result.maxDifference = 0;
+
+    // two copies of the same patch: numVoices of SineWave -> ADSR -> LowPass
+    // -> Feedback, summed by an Add node, with a control node triggering each
+    // ADSR; one is rendered with every node, the other skipping dormant ones
+    struct Graph
+    {
+        std::list<AGNode *> nodes;
+        std::list<AGConnection *> connections;
+        std::vector<AGNode *> triggers;
+        AGAudioRenderPlan *plan;
+        Buffer<float> output;
+    } graphs[2];
+
+    for(int g = 0; g < 2; g++)
+    {
+        Graph &graph = graphs[g];
+        const AGNodeManager &nodeManager = AGNodeManager::audioNodeManager();
+
+        AGNode *sum = nodeManager.createNodeOfType("Add", GLvertex3f());
+        graph.nodes.push_back(sum);
+
+        for(int v = 0; v < numVoices; v++)
+        {
+            AGNode *sine = nodeManager.createNodeOfType("SineWave", GLvertex3f());
+            AGNode *adsr = nodeManager.createNodeOfType("ADSR", GLvertex3f());
+            AGNode *filter = nodeManager.createNodeOfType("LowPass", GLvertex3f());
+            AGNode *delay = nodeManager.createNodeOfType("Feedback", GLvertex3f());
+            AGNode *trigger = AGNodeManager::controlNodeManager().createNodeOfType("Add", GLvertex3f());
+            graph.nodes.insert(graph.nodes.end(), { sine, adsr, filter, delay, trigger });
+            graph.triggers.push_back(trigger);
+
+            _setEditPort(sine, "freq", 110*(1+v%16));
+            _setEditPort(filter, "freq", 1000);
+            // echoes die away in a third of a second
+            _setEditPort(delay, "delay", 0.05f);
+
+            graph.connections.insert(graph.connections.end(), {
+                AGConnection::connect(trigger, 0, adsr, 2),
+                AGConnection::connect(sine, 0, adsr, 0),
+                AGConnection::connect(adsr, 0, filter, 0),
+                AGConnection::connect(filter, 0, delay, 0),
+                AGConnection::connect(delay, 0, sum, 0),
+            });
+        }
+
+        std::list<AGAudioRenderer *> outputs = { dynamic_cast<AGAudioNode *>(sum) };
+        graph.plan = AGAudioRenderPlan::compile(outputs, true, g == 1);
+        graph.output.resize(AUDIO_BUFFER_MAX);
+    }
+
+    for(AGNode *node : graphs[1].nodes)
+    {
+        if(dynamic_cast<AGAudioNode *>(node) != NULL)
+            result.numNodes++;
+    }
+
+    sampletime t = 0;
+
+    auto renderBlocks = [&](Graph &graph, sampletime t, long long numBlocks) {
+        RealtimeAllocGuard::Scope realtime;
+
+        auto start = std::chrono::steady_clock::now();
+        for(long long i = 0; i < numBlocks; i++, t += blockSize)
+        {
+            graph.output.clear();
+            graph.plan->render(t, graph.output, blockSize, 1);
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now()-start).count();
+    };
+
+    // same blocks through both, comparing as we go
+    auto compareBlocks = [&](long long numBlocks) {
+        for(long long i = 0; i < numBlocks; i++, t += blockSize)
+        {
+            for(Graph &graph : graphs)
+            {
+                graph.output.clear();
+                graph.plan->render(t, graph.output, blockSize, 1);
+            }
+            for(int f = 0; f < blockSize; f++)
+                result.maxDifference = std::max(result.maxDifference, fabsf(graphs[0].output[f]-graphs[1].output[f]));
+        }
+    };
+
+    // every voice plays a note; all but numSounding are released, and left
+    // long enough for their release, filter and echoes to die away
+    for(Graph &graph : graphs)
+    {
+        for(AGNode *trigger : graph.triggers)
+            trigger->pushControl(0, AGControl(1));
+    }
+    AGControlBus::instance().deliver(t);
+    compareBlocks(AGAudioNode::sampleRate()/4/blockSize+1);
+    for(Graph &graph : graphs)
+    {
+        for(int v = numSounding; v < numVoices; v++)
+            graph.triggers[v]->pushControl(0, AGControl(0));
+    }
+    AGControlBus::instance().deliver(t);
+    compareBlocks(AGAudioNode::sampleRate()/blockSize+1);
+
+    double ns[2];
+    for(int g = 0; g < 2; g++)
+    {
+        long long iterations = 1;
+        while(true)
+        {
+            ns[g] = renderBlocks(graphs[g], t, iterations);
+            t += iterations*blockSize;
+
+            if(ns[g] >= minTime*1e9 || iterations >= (1LL << 30))
+                break;
+
+            double multiplier = ns[g] > 0 ? std::min(10.0, std::max(2.0, 1.4*minTime*1e9/ns[g])) : 10.0;
+            iterations = (long long) ceil(iterations*multiplier);
+        }
+        ns[g] /= (double) iterations*blockSize;
+    }
+
+    result.nsAll = ns[0];
+    result.nsSkipping = ns[1];
+
+    for(AGNode *node : graphs[1].nodes)
+    {
+        AGAudioNode *audioNode = dynamic_cast<AGAudioNode *>(node);
+        if(audioNode != NULL && audioNode->isDormant())
+            result.numDormant++;
+    }
+
+    for(Graph &graph : graphs)
+    {
+        delete graph.plan;
+        for(AGConnection *connection : graph.connections)
+        {
+            AGNode::disconnect(connection);
+            delete connection;
+        }
+        for(AGNode *node : graph.nodes)
+            delete node;
+    }
+
+    return result;
+}
+
+std::vector<AGAudioNodeBenchmark::SilenceResult> AGAudioNodeBenchmark::runAllSilence(const std::vector<int> &blockSizes,
+                                                                                    double minTime)
+{
+    std::vector<SilenceResult> results;
+    int numVoices = 64;
+
+    fprintf(stderr, "AGAudioNodeBenchmark: dormant nodes, %i Hz\n", AGAudioNode::sampleRate());
+    fprintf(stderr, "%-40s %14s %14s %10s %10s %12s\n", "benchmark", "all ns", "skipping ns", "speedup",
+            "dormant", "max diff");
+
+    for(int numSounding : { 0, 1, 4, 16, numVoices })
+    {
+        for(int blockSize : blockSizes)
+        {
+            SilenceResult result = runSilence(numVoices, numSounding, blockSize, minTime);
+            results.push_back(result);
+
+            fprintf(stderr, "%-40s %14.3f %14.3f %9.2fx %5i/%-4i %12.3g\n", result.name().c_str(),
+                    result.nsAll, result.nsSkipping, result.nsSkipping > 0 ? result.nsAll/result.nsSkipping : 0.0,
+                    result.numDormant, result.numNodes, result.maxDifference);
+        }
+    }
+
+    return results;
+}
@@ -0,0 +1,148 @@
+//
+//  AGAudioNodeBenchmark.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include "AGConnection.h"
+
+#include <string>
+#include <vector>
+
+class AGNodeManifest;
+
+//------------------------------------------------------------------------------
+// ### AGAudioNodeBenchmark ###
+// Micro-benchmarks the DSP of individual audio node types, in the manner of
+// Google Benchmark: each node type is instantiated on its own, with every
+// input port driven either by an audio-rate sine or by a control value that
+// changes each block, and its renderAudio() is timed at several block sizes
+// until enough time has accumulated for a stable per-sample cost.
+//
+// Filter node types that can run in an AGAudioFilterBank are also timed in
+// banks: a number of them filtering the same signal, at different settings,
+// rendered through a render plan with filter banks and without.
+//
+// Polyphonic composites are timed with different numbers of notes held, to
+// check that the cost follows the notes playing rather than the voices.
+//
+// Large patches of many voices, only some of them sounding, are timed with
+// dormant nodes skipped and without, to check that quiet voices cost little.
+//
+// Cycles are CycleCounter ticks: the CPU's timestamp counter on x86 and the
+// generic timer on ARM (which ticks slower than the core clock, so only
+// compare cycle counts taken on the same device).
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioNodeBenchmark
+
+class AGAudioNodeBenchmark
+{
+public:
+    struct Result
+    {
+        std::string type;
+        int blockSize;
+        AGRate inputRate;
+        long long iterations; // blocks rendered
+        double nsPerSample;
+        double cyclesPerSample;
+
+        /* e.g. "SineWave/256/audio" */
+        std::string name() const;
+    };
+
+    struct BankResult
+    {
+        std::string type;
+        int numFilters;
+        int blockSize;
+        // per filter, per sample
+        double nsSeparate;
+        double nsBanked;
+        // largest difference between the banked and separate renders
+        float maxDifference;
+
+        /* e.g. "LowPass/16/256" (type/filters/block size) */
+        std::string name() const;
+    };
+
+    struct VoiceResult
+    {
+        int numVoices;
+        int numNotes; // held
+        int blockSize;
+        int numActiveVoices; // rendered, as of the last block
+        double nsPerSample;
+        // of the composite's output, over the timed blocks
+        float peak;
+
+        /* e.g. "Voices/16/4/256" (voices/notes/block size) */
+        std::string name() const;
+    };
+
+    struct SilenceResult
+    {
+        int numVoices;
+        int numSounding;
+        int blockSize;
+        int numNodes;
+        int numDormant; // skipped, as of the last block
+        // per sample, for the whole patch
+        double nsAll;
+        double nsSkipping;
+        // largest difference between the two renders
+        float maxDifference;
+
+        /* e.g. "Silence/64/4/256" (voices/sounding/block size) */
+        std::string name() const;
+    };
+
+    static const std::vector<int> &defaultBlockSizes();
+
+    /* benchmark one node type at one block size, driving its inputs at the
+       given rate and running for at least minTime seconds; types with nothing
+       to render on their own (an empty composite) report 0 iterations */
+    static Result run(const AGNodeManifest *manifest, int blockSize, AGRate inputRate, double minTime = 0.25);
+
+    /* benchmark every type registered with the audio node manager whose name
+       contains filter (all if empty) at each block size and input rate, and
+       print a summary to stderr */
+    static std::vector<Result> runAll(const std::string &filter = "",
+                                      const std::vector<int> &blockSizes = defaultBlockSizes(),
+                                      double minTime = 0.25);
+
+    /* benchmark numFilters nodes of a filter type, separately and banked */
+    static BankResult runBank(const AGNodeManifest *manifest, int numFilters, int blockSize, double minTime = 0.25);
+
+    /* runBank() over every filter type whose name contains filter (all if
+       empty), for several bank sizes, and print a summary to stderr */
+    static std::vector<BankResult> runAllBanks(const std::string &filter = "",
+                                               const std::vector<int> &blockSizes = defaultBlockSizes(),
+                                               double minTime = 0.25);
+
+    /* benchmark a composite of numVoices voices (each a sine through an
+       ADSR) holding numNotes notes; with numNotes of 0, every voice has
+       played a note and been released */
+    static VoiceResult runVoices(int numVoices, int numNotes, int blockSize, double minTime = 0.25);
+
+    /* runVoices() with MAX_VOICES voices and a range of notes held, and
+       print a summary to stderr */
+    static std::vector<VoiceResult> runAllVoices(const std::vector<int> &blockSizes = defaultBlockSizes(),
+                                                 double minTime = 0.25);
+
+    /* benchmark a patch of numVoices voices (each a sine through an ADSR, a
+       low-pass filter and a feedback delay, summed), numSounding of them
+       held and the rest played and released, rendered with every node and
+       with dormant nodes skipped */
+    static SilenceResult runSilence(int numVoices, int numSounding, int blockSize, double minTime = 0.25);
+
+    /* runSilence() with 64 voices and a range of them sounding, and print a
+       summary to stderr */
+    static std::vector<SilenceResult> runAllSilence(const std::vector<int> &blockSizes = defaultBlockSizes(),
+                                                    double minTime = 0.25);
+};
+
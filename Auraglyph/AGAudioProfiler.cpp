@@ -0,0 +1,168 @@
+//
+//  AGAudioProfiler.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGAudioProfiler.h"
+#include "AGAudioNode.h"
+#include "CycleCounter.h"
+
+#include <algorithm>
+#include <set>
+#include <stdio.h>
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioProfiler::History ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioProfiler::History
+
+void AGAudioProfiler::History::copy(std::vector<Sample> &samples) const
+{
+    samples.clear();
+
+    uint64_t end = m_count.load(std::memory_order_acquire);
+    uint64_t begin = end > HISTORY_SIZE ? end-HISTORY_SIZE : 0;
+
+    samples.reserve(end-begin);
+    for(uint64_t i = begin; i < end; i++)
+        samples.push_back(m_samples[i%HISTORY_SIZE]);
+
+    // the writer may have lapped the oldest samples (and be partway through
+    // the next one) while we were copying
+    uint64_t after = m_count.load(std::memory_order_acquire);
+    uint64_t firstValid = after+1 > HISTORY_SIZE ? after+1-HISTORY_SIZE : 0;
+    if(firstValid > begin)
+        samples.erase(samples.begin(), samples.begin()+std::min<uint64_t>(firstValid-begin, samples.size()));
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioProfiler ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioProfiler
+
+AGAudioProfiler &AGAudioProfiler::instance()
+{
+    static AGAudioProfiler s_profiler;
+    return s_profiler;
+}
+
+AGAudioProfiler::Stats AGAudioProfiler::blockStats() const
+{
+    std::vector<Sample> samples;
+    m_blocks.copy(samples);
+    return _stats(samples);
+}
+
+AGAudioProfiler::Stats AGAudioProfiler::nodeStats(AGAudioNode *node) const
+{
+    std::vector<Sample> samples;
+    node->profile().copy(samples);
+    return _stats(samples);
+}
+
+AGAudioProfiler::Stats AGAudioProfiler::_stats(const std::vector<Sample> &samples)
+{
+    Stats stats;
+    stats.numBlocks = (int) samples.size();
+    stats.avgTime = 0;
+    stats.maxTime = 0;
+    stats.p99Time = 0;
+    stats.load = 0;
+
+    if(samples.size() == 0)
+        return stats;
+
+    double ticksPerUs = CycleCounter::ticksPerSecond()/1e6;
+
+    std::vector<uint32_t> durations;
+    durations.reserve(samples.size());
+    double totalTicks = 0;
+    double totalFrames = 0;
+    for(const Sample &sample : samples)
+    {
+        durations.push_back(sample.duration);
+        totalTicks += sample.duration;
+        totalFrames += sample.nFrames;
+    }
+
+    size_t p99 = std::min(durations.size()-1, (size_t) (durations.size()*0.99));
+    std::nth_element(durations.begin(), durations.begin()+p99, durations.end());
+
+    stats.avgTime = totalTicks/samples.size()/ticksPerUs;
+    stats.maxTime = *std::max_element(durations.begin(), durations.end())/ticksPerUs;
+    stats.p99Time = durations[p99]/ticksPerUs;
+    if(totalFrames > 0)
+        stats.load = (totalTicks/ticksPerUs)/(totalFrames/AGAudioNode::sampleRate()*1e6);
+
+    return stats;
+}
+
+bool AGAudioProfiler::writeTrace(const std::string &path, const std::vector<AGAudioNode *> &nodes) const
+{
+    FILE *file = fopen(path.c_str(), "w");
+    if(file == NULL)
+        return false;
+
+    std::vector<Sample> blocks;
+    m_blocks.copy(blocks);
+    std::vector<std::vector<Sample>> nodeSamples(nodes.size());
+    for(int i = 0; i < (int) nodes.size(); i++)
+        nodes[i]->profile().copy(nodeSamples[i]);
+
+    // timestamps are relative to the earliest sample
+    uint64_t origin = UINT64_MAX;
+    std::set<int> workers;
+    for(const Sample &sample : blocks)
+        origin = std::min(origin, sample.start);
+    for(auto &samples : nodeSamples)
+    {
+        for(const Sample &sample : samples)
+        {
+            origin = std::min(origin, sample.start);
+            workers.insert(sample.worker);
+        }
+    }
+
+    double ticksPerUs = CycleCounter::ticksPerSecond()/1e6;
+    bool first = true;
+    auto writeEvent = [&](const char *name, const std::string &uuid, const Sample &sample) {
+        fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"audio\",\"ph\":\"X\",\"pid\":1,\"tid\":%i,"
+                "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frames\":%i%s%s%s}}",
+                first ? "" : ",", name, sample.worker,
+                (sample.start-origin)/ticksPerUs, sample.duration/ticksPerUs, sample.nFrames,
+                uuid.length() ? ",\"uuid\":\"" : "", uuid.c_str(), uuid.length() ? "\"" : "");
+        first = false;
+    };
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    // worker 0 is the audio thread
+    workers.insert(0);
+    for(int worker : workers)
+    {
+        std::string name = worker == 0 ? "audio" : "worker " + std::to_string(worker);
+        fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",", worker, name.c_str());
+        first = false;
+    }
+
+    for(const Sample &sample : blocks)
+        writeEvent("block", "", sample);
+    for(int i = 0; i < (int) nodes.size(); i++)
+    {
+        for(const Sample &sample : nodeSamples[i])
+            writeEvent(nodes[i]->type().c_str(), nodes[i]->uuid(), sample);
+    }
+
+    fprintf(file, "\n]}\n");
+
+    bool success = (ferror(file) == 0);
+    fclose(file);
+
+    return success;
+}
@@ -0,0 +1,105 @@
+//
+//  AGAudioProfiler.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+class AGAudioNode;
+
+//------------------------------------------------------------------------------
+// ### AGAudioProfiler ###
+// Per-node DSP load. While enabled, the render plan reads the cycle counter
+// around each node it renders and appends the timing to that node's History,
+// and the engine does the same for each audio callback as a whole. Histories
+// are fixed-size rings written only by whichever thread renders the node in a
+// given block, so recording is wait-free and never allocates; any other
+// thread can read statistics or export a Chrome trace from them.
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioProfiler
+
+class AGAudioProfiler
+{
+public:
+    // number of blocks kept per node (~3 s at 256 frames)
+    static const int HISTORY_SIZE = 512;
+
+    struct Sample
+    {
+        uint64_t start; // CycleCounter ticks
+        uint32_t duration; // CycleCounter ticks
+        uint16_t nFrames;
+        int16_t worker;
+    };
+
+    // timings of the most recent blocks; single writer, any number of readers
+    class History
+    {
+    public:
+        History() : m_count(0) { }
+
+        /* render thread */
+        void record(uint64_t start, uint64_t end, int nFrames, int worker)
+        {
+            uint64_t count = m_count.load(std::memory_order_relaxed);
+            Sample &sample = m_samples[count%HISTORY_SIZE];
+            sample.start = start;
+            sample.duration = (uint32_t) (end-start);
+            sample.nFrames = (uint16_t) nFrames;
+            sample.worker = (int16_t) worker;
+            m_count.store(count+1, std::memory_order_release);
+        }
+
+        /* copy out the recorded samples, oldest first, skipping any that were
+           overwritten while copying */
+        void copy(std::vector<Sample> &samples) const;
+
+    private:
+        Sample m_samples[HISTORY_SIZE];
+        std::atomic<uint64_t> m_count;
+    };
+
+    struct Stats
+    {
+        int numBlocks;
+        // per block (us)
+        double avgTime;
+        double maxTime;
+        double p99Time;
+        // average share of the time available to render each block (0-1)
+        double load;
+    };
+
+    static AGAudioProfiler &instance();
+
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /* render thread: time of one whole audio callback */
+    void recordBlock(uint64_t start, uint64_t end, int nFrames) { m_blocks.record(start, end, nFrames, 0); }
+
+    /* statistics over the recorded history of the audio callback / of a node */
+    Stats blockStats() const;
+    Stats nodeStats(AGAudioNode *node) const;
+
+    /* write the recorded history of the audio callback and the given nodes as
+       Chrome trace event JSON (chrome://tracing, ui.perfetto.dev) */
+    bool writeTrace(const std::string &path, const std::vector<AGAudioNode *> &nodes) const;
+
+private:
+    AGAudioProfiler() : m_enabled(false) { }
+
+    static Stats _stats(const std::vector<Sample> &samples);
+
+    std::atomic<bool> m_enabled;
+    History m_blocks;
+};
+
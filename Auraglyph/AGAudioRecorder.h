@@ -6,10 +6,12 @@
 //  Copyright © 2017 Spencer Salazar. All rights reserved.
 //
 
-#pragma mark once
+#pragma once
 
+#include <atomic>
 #include <string>
-#include <CoreAudio/CoreAudioTypes.h>
+#include <vector>
+#include <stdint.h>
 #include "SampleCircularBuffer.h"
 
 #ifdef __OBJC__
@@ -18,29 +20,76 @@
 typedef void EZRecorder;
 #endif
 
+namespace stk { class FileWrite; }
 class Thread;
-class Signal;
+
+//------------------------------------------------------------------------------
+// ### AGAudioRecorder ###
+// Records interleaved audio from the audio thread to a file. render() only
+// copies the block into a lock-free ring of a few seconds, never waiting or
+// signalling; a writer thread polls the ring and writes it out in batches of
+// BATCH_SECONDS, so the disk sees a few large writes per second rather than
+// one per block. If the writer falls further behind than the ring holds, the
+// blocks that don't fit are dropped whole and counted as overruns.
+//
+// Records to M4A (or WAV, in the headless build).
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioRecorder
 
 class AGAudioRecorder
 {
 public:
-    AGAudioRecorder();
+    static const int DEFAULT_CAPACITY_SECONDS = 8;
+    static constexpr float BATCH_SECONDS = 0.25f;
+    static const int POLL_MS = 20;
+
+    /* capacity of the ring, in seconds of audio */
+    AGAudioRecorder(float capacitySeconds = DEFAULT_CAPACITY_SECONDS);
     ~AGAudioRecorder();
-    
-    void startRecording(const std::string &filename, int numChannels, int srate);
+    AGAudioRecorder(const AGAudioRecorder &) = delete;
+
+    /* off the audio thread; false if the file can't be opened */
+    bool startRecording(const std::string &filename, int numChannels, int srate);
+    /* audio thread: record a block of nFrames interleaved frames */
     void render(float *buffer, int nFrames);
+    /* off the audio thread, once it has stopped calling render(); writes out
+       whatever is left in the ring */
     void closeRecording();
-    
+
+    /* blocks dropped for want of room in the ring, and their frames */
+    uint64_t numOverruns() const { return m_numOverruns.load(std::memory_order_relaxed); }
+    uint64_t numFramesDropped() const { return m_numFramesDropped.load(std::memory_order_relaxed); }
+    /* frames written to the file */
+    uint64_t numFramesWritten() const { return m_numFramesWritten.load(std::memory_order_relaxed); }
+    /* most frames the ring has held at once, i.e. how far the writer has
+       fallen behind */
+    int maxFramesQueued() const { return m_maxFramesQueued.load(std::memory_order_relaxed); }
+    int capacityFrames() const { return m_numChannels > 0 ? m_buffer.capacity()/m_numChannels : 0; }
+
     static std::string pathForSessionRecording(const std::string &extension);
-    
+
 private:
-    int mChannels;
-    EZRecorder *m_recorder = NULL;
-    SampleCircularBuffer *m_buffer = NULL;
-    
-    float *m_recorderBuffer = NULL;
-    
+    bool _openFile(const std::string &filename);
+    void _writeFile(float *samples, int nFrames);
+    void _closeFile();
+    /* writer thread: write out up to a batch; returns the frames written */
+    int _writeBatch();
+
+    float m_capacitySeconds;
+    int m_numChannels = 0;
+    int m_sampleRate = 0;
+
+    SampleCircularBuffer m_buffer;
+    // a batch, as the writer thread takes it from the ring
+    std::vector<float> m_batch;
     Thread *m_thread = NULL;
-    bool m_go = false;
-    Signal *m_signal = NULL;
+    std::atomic<bool> m_go;
+
+    EZRecorder *m_recorder = NULL;
+    stk::FileWrite *m_file = NULL;
+
+    std::atomic<uint64_t> m_numOverruns;
+    std::atomic<uint64_t> m_numFramesDropped;
+    std::atomic<uint64_t> m_numFramesWritten;
+    std::atomic<int> m_maxFramesQueued;
 };
@@ -9,15 +9,21 @@
 #include "AGAudioRecorder.h"
 #include "AGFileManager.h"
 
+#ifndef AG_HEADLESS
+#include <CoreAudio/CoreAudioTypes.h>
 #import <EZAudioiOS/EZRecorder.h>
 #import <EZAudioiOS/EZAudioUtilities.h>
 #import "NSString+STLString.h"
+#else
+#include "FileWrite.h"
+#endif // AG_HEADLESS
+
 #include <time.h>
+#include <unistd.h>
 
 #include "Thread.h"
-#include "Signal.h"
 
-#define RECORDER_BUFFER_SIZE (2048)
+constexpr float AGAudioRecorder::BATCH_SECONDS;
 
 std::string AGAudioRecorder::pathForSessionRecording(const std::string &extension)
 {
@@ -25,21 +31,17 @@ std::string AGAudioRecorder::pathForSessionRecording(const std::string &extensio
     tm *tm = localtime(&t);
     char buf[256];
     strftime(buf, 255, "%Y-%m-%d %H-%M-%S", tm);
-    
+
     return AGFileManager::instance().userDataDirectory() + "/Auraglyph Session " + buf + "." + extension;
 }
 
-AGAudioRecorder::AGAudioRecorder()
+AGAudioRecorder::AGAudioRecorder(float capacitySeconds)
+: m_capacitySeconds(capacitySeconds), m_go(false),
+m_numOverruns(0), m_numFramesDropped(0), m_numFramesWritten(0), m_maxFramesQueued(0)
 {
+#ifndef AG_HEADLESS
     [EZAudioUtilities setShouldExitOnCheckResultFail:NO];
-    
-    m_recorder = nil;
-    m_buffer = new SampleCircularBuffer;
-    m_buffer->initialize(RECORDER_BUFFER_SIZE);
-    m_recorderBuffer = new float[RECORDER_BUFFER_SIZE];
-    
-    m_thread = new Thread;
-    m_signal = new Signal;
+#endif // AG_HEADLESS
 }
 
 AGAudioRecorder::~AGAudioRecorder()
@@ -47,76 +49,155 @@ AGAudioRecorder::~AGAudioRecorder()
     closeRecording();
 }
 
-void AGAudioRecorder::startRecording(const std::string &filename, int numChannels, int srate)
+bool AGAudioRecorder::startRecording(const std::string &filename, int numChannels, int srate)
 {
-    mChannels = numChannels;
-    
-    NSURL *url = [NSURL fileURLWithPath:[NSString stringWithSTLString:filename]];
-    
-    AudioStreamBasicDescription description;
-    description.mSampleRate = srate;
-    description.mFormatID = kAudioFormatLinearPCM;
-    description.mFormatFlags = kAudioFormatFlagIsFloat | kAudioFormatFlagIsPacked;
-    description.mBytesPerPacket = sizeof(float)*numChannels;
-    description.mFramesPerPacket = 1;
-    description.mBytesPerFrame = sizeof(float)*numChannels;
-    description.mChannelsPerFrame = numChannels;
-    description.mBitsPerChannel = sizeof(float)*8;
-    
-    m_recorder = [[EZRecorder alloc] initWithURL:url
-                                    clientFormat:description
-                                        fileType:EZRecorderFileTypeM4A];
-    
+    m_numChannels = numChannels;
+    m_sampleRate = srate;
+
+    if(!_openFile(filename))
+        return false;
+
+    // allocated (and touched) up front, so the audio thread never faults in
+    // a fresh page
+    m_buffer.initialize((int) (m_capacitySeconds*srate)*numChannels);
+    m_batch.resize((int) (BATCH_SECONDS*srate)*numChannels);
+
     m_go = true;
+    m_thread = new Thread;
     m_thread->start([this](){
-        m_signal->start();
-        
-        while(m_go)
+        while(m_go.load(std::memory_order_acquire))
         {
-            m_signal->wait();
-            if(!m_go)
-                break;
-            
-            int num = m_buffer->get(m_recorderBuffer, RECORDER_BUFFER_SIZE);
-            int nFrames = num/mChannels;
-            
-            assert(nFrames*mChannels == num); // no half-frames plz
-            
-            AudioBufferList bufferList;
-            bufferList.mNumberBuffers = 1;
-            bufferList.mBuffers[0].mData = m_recorderBuffer;
-            bufferList.mBuffers[0].mDataByteSize = sizeof(float)*num;
-            bufferList.mBuffers[0].mNumberChannels = mChannels;
-            
-            [m_recorder appendDataFromBufferList:&bufferList withBufferSize:nFrames];
+            // wait for a whole batch, rather than writing every block
+            if(m_buffer.numAvailable() < (int) m_batch.size())
+                usleep(POLL_MS*1000);
+            else
+                _writeBatch();
         }
+
+        // the rest, once the audio thread has stopped
+        while(_writeBatch() > 0);
     });
+
+    return true;
 }
 
 void AGAudioRecorder::render(float *buffer, int nFrames)
 {
-    assert(nFrames*mChannels < RECORDER_BUFFER_SIZE);
-    
-    int numSamples = nFrames*mChannels;
-    int numPut = m_buffer->put(buffer, numSamples);
-    assert(numSamples == numPut); // buffer overflow
-    m_signal->signal();
+    if(!m_go.load(std::memory_order_relaxed))
+        return;
+
+    int numSamples = nFrames*m_numChannels;
+    if(m_buffer.put(buffer, numSamples) != numSamples)
+    {
+        // the writer is more than the ring behind
+        m_numOverruns.fetch_add(1, std::memory_order_relaxed);
+        m_numFramesDropped.fetch_add(nFrames, std::memory_order_relaxed);
+        return;
+    }
+
+    int numQueued = (m_buffer.capacity()-m_buffer.numFree())/m_numChannels;
+    if(numQueued > m_maxFramesQueued.load(std::memory_order_relaxed))
+        m_maxFramesQueued.store(numQueued, std::memory_order_relaxed);
 }
 
 void AGAudioRecorder::closeRecording()
 {
-    m_go = false;
-    if(m_signal)
-        m_signal->signal();
+    m_go.store(false, std::memory_order_release);
     if(m_thread)
         m_thread->wait();
-    
-    SAFE_DELETE(m_signal);
     SAFE_DELETE(m_thread);
-    
+
+    _closeFile();
+
+    m_buffer.cleanup();
+    m_batch = std::vector<float>();
+}
+
+int AGAudioRecorder::_writeBatch()
+{
+    // puts are whole blocks, so the ring only ever holds whole frames
+    int num = m_buffer.get(m_batch.data(), (int) m_batch.size());
+    int nFrames = num/m_numChannels;
+
+    if(nFrames > 0)
+    {
+        _writeFile(m_batch.data(), nFrames);
+        m_numFramesWritten.fetch_add(nFrames, std::memory_order_relaxed);
+    }
+
+    return nFrames;
+}
+
+#ifndef AG_HEADLESS
+
+bool AGAudioRecorder::_openFile(const std::string &filename)
+{
+    NSURL *url = [NSURL fileURLWithPath:[NSString stringWithSTLString:filename]];
+
+    AudioStreamBasicDescription description;
+    description.mSampleRate = m_sampleRate;
+    description.mFormatID = kAudioFormatLinearPCM;
+    description.mFormatFlags = kAudioFormatFlagIsFloat | kAudioFormatFlagIsPacked;
+    description.mBytesPerPacket = sizeof(float)*m_numChannels;
+    description.mFramesPerPacket = 1;
+    description.mBytesPerFrame = sizeof(float)*m_numChannels;
+    description.mChannelsPerFrame = m_numChannels;
+    description.mBitsPerChannel = sizeof(float)*8;
+
+    m_recorder = [[EZRecorder alloc] initWithURL:url
+                                    clientFormat:description
+                                        fileType:EZRecorderFileTypeM4A];
+
+    return m_recorder != nil;
+}
+
+void AGAudioRecorder::_writeFile(float *samples, int nFrames)
+{
+    AudioBufferList bufferList;
+    bufferList.mNumberBuffers = 1;
+    bufferList.mBuffers[0].mData = samples;
+    bufferList.mBuffers[0].mDataByteSize = sizeof(float)*nFrames*m_numChannels;
+    bufferList.mBuffers[0].mNumberChannels = m_numChannels;
+
+    [m_recorder appendDataFromBufferList:&bufferList withBufferSize:nFrames];
+}
+
+void AGAudioRecorder::_closeFile()
+{
     [m_recorder closeAudioFile];
     m_recorder = nil;
-    
-    SAFE_DELETE_ARRAY(m_recorderBuffer);
-    SAFE_DELETE(m_buffer);
 }
+
+#else
+
+bool AGAudioRecorder::_openFile(const std::string &filename)
+{
+    stk::Stk::setSampleRate(m_sampleRate);
+
+    m_file = new stk::FileWrite;
+    try {
+        m_file->open(filename, m_numChannels, stk::FileWrite::FILE_WAV, stk::Stk::STK_FLOAT32);
+    } catch(const stk::StkError &error) {
+        SAFE_DELETE(m_file);
+        return false;
+    }
+
+    return true;
+}
+
+void AGAudioRecorder::_writeFile(float *samples, int nFrames)
+{
+    stk::StkFrames frames(nFrames, m_numChannels);
+    for(int i = 0; i < nFrames*m_numChannels; i++)
+        frames[i] = samples[i];
+    m_file->write(frames);
+}
+
+void AGAudioRecorder::_closeFile()
+{
+    if(m_file)
+        m_file->close();
+    SAFE_DELETE(m_file);
+}
+
+#endif // AG_HEADLESS
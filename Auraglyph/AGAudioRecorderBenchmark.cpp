@@ -0,0 +1,191 @@
+//
+//  AGAudioRecorderBenchmark.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGAudioRecorderBenchmark.h"
+#include "AGAudioRecorder.h"
+#include "AGAudioNode.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+
+static const int NUM_CHANNELS = 2;
+// the pattern counts frames modulo this, which float holds exactly
+static const int PATTERN_PERIOD = 1 << 20;
+
+static float _pattern(uint64_t frame, int channel)
+{
+    float value = (float) (frame % PATTERN_PERIOD)/PATTERN_PERIOD;
+    return channel == 0 ? value : -value;
+}
+
+// read back the samples of a float WAV file, checking them against the
+// pattern; the data is read to the end of the file rather than trusting the
+// header's size, which overflows past 2 GB
+static bool _verify(const std::string &path, uint64_t &numFramesRead, uint64_t &numMismatches)
+{
+    numFramesRead = 0;
+    numMismatches = 0;
+
+    FILE *file = fopen(path.c_str(), "rb");
+    if(file == NULL)
+        return false;
+
+    char riff[12];
+    bool found = false;
+    if(fread(riff, 1, 12, file) == 12 && memcmp(riff, "RIFF", 4) == 0 && memcmp(riff+8, "WAVE", 4) == 0)
+    {
+        char id[4];
+        uint32_t size;
+        while(fread(id, 1, 4, file) == 4 && fread(&size, 4, 1, file) == 1)
+        {
+            if(memcmp(id, "data", 4) == 0)
+            {
+                found = true;
+                break;
+            }
+            fseek(file, size + (size & 1), SEEK_CUR);
+        }
+    }
+
+    if(found)
+    {
+        std::vector<float> frames(65536*NUM_CHANNELS);
+        size_t num;
+        while((num = fread(frames.data(), sizeof(float)*NUM_CHANNELS, frames.size()/NUM_CHANNELS, file)) > 0)
+        {
+            for(size_t i = 0; i < num; i++)
+            {
+                uint64_t frame = numFramesRead + i;
+                if(frames[i*NUM_CHANNELS] != _pattern(frame, 0) ||
+                   frames[i*NUM_CHANNELS+1] != _pattern(frame, 1))
+                    numMismatches++;
+            }
+            numFramesRead += num;
+        }
+    }
+
+    fclose(file);
+
+    return found;
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioRecorderBenchmark ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioRecorderBenchmark
+
+AGAudioRecorderBenchmark::Result AGAudioRecorderBenchmark::run(const std::string &path, double seconds, double speed,
+                                                               int numLoadThreads, int blockSize)
+{
+    using namespace std::chrono;
+
+    Result result;
+    memset(&result, 0, sizeof(Result));
+    result.speed = speed;
+    result.numLoadThreads = numLoadThreads;
+    result.blockSize = blockSize;
+
+    int srate = AGAudioNode::sampleRate();
+    AGAudioRecorder recorder;
+    if(!recorder.startRecording(path, NUM_CHANNELS, srate))
+    {
+        fprintf(stderr, "AGAudioRecorderBenchmark: unable to write %s\n", path.c_str());
+        return result;
+    }
+    result.capacitySeconds = (double) recorder.capacityFrames()/srate;
+
+    // keep the cores busy
+    std::atomic<bool> loading(true);
+    std::vector<std::thread> loadThreads;
+    for(int i = 0; i < numLoadThreads; i++)
+    {
+        loadThreads.emplace_back([&loading, i]() {
+            volatile double sink = 0;
+            for(double x = i; loading.load(std::memory_order_relaxed); x += 1e-3)
+                sink = sink + sin(x)*cos(x);
+        });
+    }
+
+    // whole blocks
+    uint64_t numFrames = ((uint64_t) (seconds*srate) + blockSize-1)/blockSize*blockSize;
+    std::vector<float> buffer(blockSize*NUM_CHANNELS);
+    double maxRender = 0;
+
+    // the audio thread, as AGAudioManager's capturer calls the recorder
+    std::thread audioThread([&]() {
+        auto start = steady_clock::now();
+
+        for(uint64_t frame = 0; frame < numFrames; frame += blockSize)
+        {
+            for(int i = 0; i < blockSize; i++)
+                for(int c = 0; c < NUM_CHANNELS; c++)
+                    buffer[i*NUM_CHANNELS+c] = _pattern(frame+i, c);
+
+            auto renderStart = steady_clock::now();
+            recorder.render(buffer.data(), blockSize);
+            maxRender = std::max(maxRender, duration<double>(steady_clock::now()-renderStart).count());
+
+            auto due = start + duration<double>((double) (frame+blockSize)/(srate*speed));
+            std::this_thread::sleep_until(due);
+        }
+
+        double elapsed = duration<double>(steady_clock::now()-start).count();
+        result.realtimeFactor = (double) numFrames/srate/elapsed;
+    });
+
+    audioThread.join();
+    loading = false;
+    for(std::thread &thread : loadThreads)
+        thread.join();
+
+    recorder.closeRecording();
+
+    result.seconds = (double) numFrames/srate;
+    result.maxQueuedSeconds = (double) recorder.maxFramesQueued()/srate;
+    result.maxRenderMicros = maxRender*1e6;
+    result.numOverruns = recorder.numOverruns();
+    result.numFramesDropped = recorder.numFramesDropped();
+    result.numFramesWritten = recorder.numFramesWritten();
+
+    if(!_verify(path, result.numFramesRead, result.numMismatches))
+        fprintf(stderr, "AGAudioRecorderBenchmark: unable to read back %s\n", path.c_str());
+    result.fileBytes = result.numFramesRead*NUM_CHANNELS*sizeof(float);
+
+    unlink(path.c_str());
+
+    return result;
+}
+
+void AGAudioRecorderBenchmark::runAll(const std::string &path, double seconds, double speed)
+{
+    int numLoadThreads = std::max(1, (int) std::thread::hardware_concurrency());
+    Result result = run(path, seconds, speed, numLoadThreads);
+
+    fprintf(stderr, "AGAudioRecorderBenchmark: %.0f s at %.1fx real time, %i load threads, %i frame blocks, %.1f s ring\n",
+            result.seconds, result.speed, result.numLoadThreads, result.blockSize, result.capacitySeconds);
+    fprintf(stderr, "%10s %10s %10s %10s %10s %10s %10s %10s %10s\n", "x realtime", "max queued",
+            "max render", "overruns", "dropped", "written", "read back", "mismatches", "file");
+    fprintf(stderr, "%10.1f %9.2fs %8.1fus %10llu %10llu %10llu %10llu %10llu %9.1fM\n",
+            result.realtimeFactor, result.maxQueuedSeconds, result.maxRenderMicros,
+            (unsigned long long) result.numOverruns, (unsigned long long) result.numFramesDropped,
+            (unsigned long long) result.numFramesWritten, (unsigned long long) result.numFramesRead,
+            (unsigned long long) result.numMismatches, result.fileBytes/1.0e6);
+
+    bool clean = result.numOverruns == 0 && result.numMismatches == 0 &&
+        result.numFramesRead == (uint64_t) llround(result.seconds*AGAudioNode::sampleRate());
+    fprintf(stderr, "AGAudioRecorderBenchmark: %s\n", clean ? "no frames dropped" : "FRAMES DROPPED OR CORRUPT");
+}
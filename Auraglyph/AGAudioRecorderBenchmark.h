@@ -0,0 +1,53 @@
+//
+//  AGAudioRecorderBenchmark.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include <string>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// ### AGAudioRecorderBenchmark ###
+// Records a long session through AGAudioRecorder under CPU load, to check that
+// nothing is dropped. An "audio thread" feeds it stereo blocks of a counting
+// pattern, paced to real time (or some multiple of it), while other threads
+// spin to keep every core busy; afterwards the file is read back and checked
+// frame by frame against the pattern.
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioRecorderBenchmark
+
+class AGAudioRecorderBenchmark
+{
+public:
+    struct Result
+    {
+        double seconds; // recorded
+        double speed; // multiple of real time the blocks were fed at
+        int numLoadThreads;
+        int blockSize;
+        double realtimeFactor; // seconds recorded per second taken
+        double capacitySeconds; // of the recorder's ring
+        double maxQueuedSeconds; // most the ring held
+        double maxRenderMicros; // longest call to render()
+        uint64_t numOverruns;
+        uint64_t numFramesDropped;
+        uint64_t numFramesWritten;
+        uint64_t numFramesRead; // back from the file
+        uint64_t numMismatches; // frames read back that don't match
+        size_t fileBytes;
+    };
+
+    /* record seconds of audio to path, fed at speed times real time in
+       blocks of blockSize frames, with numLoadThreads threads spinning
+       alongside; then read it back, check it, and remove it */
+    static Result run(const std::string &path, double seconds, double speed = 1,
+                      int numLoadThreads = 1, int blockSize = 256);
+
+    /* run with a load thread per core, printing a summary to stderr */
+    static void runAll(const std::string &path, double seconds, double speed = 1);
+};
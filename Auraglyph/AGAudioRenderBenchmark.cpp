@@ -0,0 +1,149 @@
+//
+//  AGAudioRenderBenchmark.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGAudioRenderBenchmark.h"
+#include "AGAudioRenderPlan.h"
+#include "AGAudioWorkerPool.h"
+#include "AGAudioNode.h"
+#include "AGConnection.h"
+#include "AGDocument.h"
+#include "AGNode.h"
+
+#include <chrono>
+#include <list>
+#include <map>
+#include <stdio.h>
+
+
+// collects the patch's output nodes instead of sending them to the audio manager
+class AGAudioRenderBenchmarkDestination : public AGAudioOutputDestination
+{
+public:
+    void addOutput(AGAudioRenderer *renderer) override { m_outputs.push_back(renderer); }
+    void removeOutput(AGAudioRenderer *renderer) override { m_outputs.remove(renderer); }
+    
+    std::list<AGAudioRenderer *> m_outputs;
+};
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioRenderBenchmark ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioRenderBenchmark
+
+AGAudioRenderBenchmark::Result AGAudioRenderBenchmark::run(const std::string &path, int numBlocks, int numWorkers)
+{
+    Result result;
+    result.path = path;
+    result.numNodes = 0;
+    result.numClusters = 0;
+    result.numRootClusters = 0;
+    result.numThreads = 1;
+    result.serialTime = 0;
+    result.parallelTime = 0;
+    
+    AGDocument doc;
+    doc.loadFromPath(path);
+    
+    AGAudioRenderBenchmarkDestination destination;
+    std::map<std::string, AGNode *> uuid2node;
+    std::list<AGConnection *> connections;
+    
+    doc.recreate([&](const AGDocument::Node &docNode) {
+        AGNode *node = AGNodeManager::createNode(docNode);
+        if(node == NULL)
+            return;
+        
+        uuid2node[node->uuid()] = node;
+        
+        if(node->type() == "Output")
+        {
+            AGAudioOutputNode *outputNode = dynamic_cast<AGAudioOutputNode *>(node);
+            if(outputNode)
+                outputNode->setOutputDestination(&destination);
+        }
+    }, [&](const AGDocument::Connection &docConnection) {
+        if(uuid2node.count(docConnection.srcUuid) && uuid2node.count(docConnection.dstUuid))
+        {
+            AGNode *srcNode = uuid2node[docConnection.srcUuid];
+            AGNode *dstNode = uuid2node[docConnection.dstUuid];
+            if(docConnection.dstPort >= 0 && docConnection.dstPort < dstNode->numInputPorts() &&
+               docConnection.srcPort >= 0 && docConnection.srcPort < srcNode->numOutputPorts())
+                connections.push_back(AGConnection::connect(srcNode, docConnection.srcPort,
+                                                            dstNode, docConnection.dstPort));
+        }
+    }, [](const AGDocument::Freedraw &docFreedraw) { });
+    
+    AGAudioRenderPlan *plan = AGAudioRenderPlan::compile(destination.m_outputs);
+    AGAudioWorkerPool pool(numWorkers < 0 ? AGAudioWorkerPool::defaultNumWorkers() : numWorkers);
+    
+    result.numNodes = plan->numSteps();
+    result.numClusters = plan->numClusters();
+    result.numRootClusters = plan->numRootClusters();
+    result.numThreads = pool.numThreads();
+    
+    int nFrames = AGAudioNode::bufferSize();
+    Buffer<float> output(nFrames*2);
+    sampletime t = 0;
+    
+    auto timeBlocks = [&](AGAudioWorkerPool *_pool) {
+        // warm up caches and the pool's threads
+        for(int i = 0; i < numBlocks/10; i++, t += nFrames)
+        {
+            output.clear();
+            plan->render(t, output, nFrames, 2, _pool);
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        for(int i = 0; i < numBlocks; i++, t += nFrames)
+        {
+            output.clear();
+            plan->render(t, output, nFrames, 2, _pool);
+        }
+        auto elapsed = std::chrono::steady_clock::now()-start;
+        
+        return std::chrono::duration<double, std::micro>(elapsed).count()/numBlocks;
+    };
+    
+    result.serialTime = timeBlocks(NULL);
+    result.parallelTime = timeBlocks(&pool);
+    
+    delete plan;
+    
+    for(AGConnection *connection : connections)
+    {
+        AGNode::disconnect(connection);
+        delete connection;
+    }
+    for(auto kv : uuid2node)
+        delete kv.second;
+    
+    return result;
+}
+
+std::vector<AGAudioRenderBenchmark::Result> AGAudioRenderBenchmark::runAll(const std::vector<std::string> &paths, int numBlocks)
+{
+    std::vector<Result> results;
+    
+    fprintf(stderr, "AGAudioRenderBenchmark: %i blocks of %i frames\n", numBlocks, AGAudioNode::bufferSize());
+    fprintf(stderr, "%-32s %6s %8s %6s %8s %12s %12s %8s\n",
+            "patch", "nodes", "clusters", "roots", "threads", "serial (us)", "parallel (us)", "speedup");
+    
+    for(const std::string &path : paths)
+    {
+        Result result = run(path, numBlocks);
+        results.push_back(result);
+        
+        std::string name = path.substr(path.find_last_of('/')+1);
+        fprintf(stderr, "%-32s %6i %8i %6i %8i %12.2f %12.2f %7.2fx\n",
+                name.c_str(), result.numNodes, result.numClusters, result.numRootClusters,
+                result.numThreads, result.serialTime, result.parallelTime, result.speedup());
+    }
+    
+    return results;
+}
@@ -0,0 +1,43 @@
+//
+//  AGAudioRenderBenchmark.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// ### AGAudioRenderBenchmark ###
+// Loads patches into a private graph (not connected to the audio manager) and
+// times rendering them serially and on an AGAudioWorkerPool.
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioRenderBenchmark
+
+class AGAudioRenderBenchmark
+{
+public:
+    struct Result
+    {
+        std::string path;
+        int numNodes;
+        int numClusters;
+        int numRootClusters;
+        int numThreads;
+        // average wall time per block (us)
+        double serialTime;
+        double parallelTime;
+        
+        double speedup() const { return parallelTime > 0 ? serialTime/parallelTime : 0; }
+    };
+    
+    /* benchmark one patch file; numWorkers < 0 selects the default pool size */
+    static Result run(const std::string &path, int numBlocks = 2000, int numWorkers = -1);
+    
+    /* benchmark each patch file and print a summary to stderr */
+    static std::vector<Result> runAll(const std::vector<std::string> &paths, int numBlocks = 2000);
+};
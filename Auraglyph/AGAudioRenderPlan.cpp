@@ -0,0 +1,491 @@
+//
+//  AGAudioRenderPlan.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGAudioRenderPlan.h"
+#include "AGAudioNode.h"
+#include "AGAudioProfiler.h"
+#include "CycleCounter.h"
+
+#include <map>
+#include <functional>
+#include <algorithm>
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioRenderPlan ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioRenderPlan
+
+AGAudioRenderPlan::AGAudioRenderPlan()
+: m_renderTime(0), m_renderFrames(0), m_profiling(false), m_skipDormant(true)
+{
+    m_scratch.resize(AUDIO_BUFFER_MAX);
+}
+
+AGAudioRenderPlan *AGAudioRenderPlan::compile(const std::list<AGAudioRenderer *> &outputs, bool filterBanks,
+                                              bool skipDormant)
+{
+    AGAudioRenderPlan *plan = new AGAudioRenderPlan;
+    plan->m_skipDormant = skipDormant;
+
+    enum VisitState { VISITING, VISITED };
+    std::map<AGAudioNode *, VisitState> state;
+    std::vector<int> firstInput;
+    std::vector<int> firstSubgraphOutput;
+
+    // depth-first post-order traversal upstream from each output, so that every
+    // node is scheduled after all of its audio-rate inputs
+    std::function<void (AGAudioNode *, bool)> visit = [&](AGAudioNode *node, bool sink) {
+        auto it = state.find(node);
+        // already scheduled, or a feedback cycle back to a node on the stack;
+        // in the latter case the dependent node reads the previous block's output,
+        // same as the old recursive renderer did via renderLast()
+        if(it != state.end())
+            return;
+
+        state[node] = VISITING;
+
+        node->lock();
+        std::list<AGConnection *> inbound = node->inbound();
+        node->unlock();
+
+        for(AGConnection *conn : inbound)
+        {
+            if(conn->rate() == RATE_AUDIO)
+                visit(static_cast<AGAudioNode *>(conn->src()), false);
+        }
+
+        // nodes hosting a subgraph render it themselves, so the subgraph must
+        // be scheduled first
+        std::vector<AGAudioRenderer *> subgraphOutputs;
+        node->subgraphOutputs(subgraphOutputs);
+        for(AGAudioRenderer *subgraphOutput : subgraphOutputs)
+        {
+            AGAudioNode *subgraphNode = dynamic_cast<AGAudioNode *>(subgraphOutput);
+            if(subgraphNode)
+                visit(subgraphNode, true);
+        }
+
+        // pointers are filled in once the plan's arrays are complete
+        Step step;
+        step.node = node;
+        step.inputs = NULL;
+        step.numInputs = 0;
+        step.subgraphOutputs = NULL;
+        step.numSubgraphOutputs = (int) subgraphOutputs.size();
+        step.sink = sink;
+        step.bank = NULL;
+        step.banked = false;
+        step.bankIndex = -1;
+        
+        firstInput.push_back((int) plan->m_inputs.size());
+        firstSubgraphOutput.push_back((int) plan->m_subgraphOutputs.size());
+        
+        for(AGConnection *conn : inbound)
+        {
+            Input input;
+            input.src = conn->src();
+            input.srcPort = conn->srcPort();
+            input.dstPort = conn->dstPort();
+            input.rate = conn->rate();
+            plan->m_inputs.push_back(input);
+            step.numInputs++;
+        }
+        
+        plan->m_subgraphOutputs.insert(plan->m_subgraphOutputs.end(),
+                                       subgraphOutputs.begin(), subgraphOutputs.end());
+        
+        plan->m_steps.push_back(step);
+        state[node] = VISITED;
+    };
+
+    for(AGAudioRenderer *output : outputs)
+    {
+        plan->m_outputs.push_back(output);
+
+        AGAudioNode *outputNode = dynamic_cast<AGAudioNode *>(output);
+        plan->m_outputNodes.push_back(outputNode);
+        if(outputNode)
+            visit(outputNode, true);
+    }
+
+    for(int i = 0; i < (int) plan->m_steps.size(); i++)
+    {
+        Step &step = plan->m_steps[i];
+        step.inputs = plan->m_inputs.data()+firstInput[i];
+        step.subgraphOutputs = plan->m_subgraphOutputs.data()+firstSubgraphOutput[i];
+    }
+    
+    if(filterBanks)
+        plan->_batchFilters();
+    plan->_cluster();
+    
+    dbgprint("AGAudioRenderPlan: compiled %lu nodes, %lu inputs, %lu clusters (%lu roots), %lu filter banks\n",
+             plan->m_steps.size(), plan->m_inputs.size(),
+             plan->m_clusters.size(), plan->m_rootClusters.size(), plan->m_banks.size());
+
+    return plan;
+}
+
+void AGAudioRenderPlan::_dependencies(std::vector<std::vector<int>> &dependents,
+                                      std::vector<std::vector<int>> &dependencies) const
+{
+    int numSteps = (int) m_steps.size();
+    
+    std::map<AGNode *, int> stepIndex;
+    for(int i = 0; i < numSteps; i++)
+        stepIndex[m_steps[i].node] = i;
+    
+    // dependency edges between steps; these always run from an earlier step
+    // to a later one
+    dependents.assign(numSteps, std::vector<int>());
+    dependencies.assign(numSteps, std::vector<int>());
+    auto addEdge = [&](int from, int to) {
+        if(from == to) return;
+        if(std::find(dependents[from].begin(), dependents[from].end(), to) != dependents[from].end()) return;
+        dependents[from].push_back(to);
+        dependencies[to].push_back(from);
+    };
+    
+    for(int i = 0; i < numSteps; i++)
+    {
+        const Step &step = m_steps[i];
+        
+        for(int j = 0; j < step.numInputs; j++)
+        {
+            const Input &in = step.inputs[j];
+            if(in.rate != RATE_AUDIO)
+                continue;
+            auto it = stepIndex.find(in.src);
+            if(it == stepIndex.end())
+                continue;
+            
+            // a feedback source is scheduled later and read as of the previous
+            // block, so it must not overwrite its output until the reader is done
+            if(it->second < i)
+                addEdge(it->second, i);
+            else
+                addEdge(i, it->second);
+        }
+        
+        for(int j = 0; j < step.numSubgraphOutputs; j++)
+        {
+            auto it = stepIndex.find(dynamic_cast<AGAudioNode *>(step.subgraphOutputs[j]));
+            if(it != stepIndex.end())
+                addEdge(it->second, i);
+        }
+    }
+}
+
+void AGAudioRenderPlan::_batchFilters()
+{
+    int numSteps = (int) m_steps.size();
+    
+    std::vector<std::vector<int>> dependents;
+    std::vector<std::vector<int>> dependencies;
+    _dependencies(dependents, dependencies);
+    
+    // depth of each step; steps at the same depth can't depend on each other
+    std::vector<int> depth(numSteps, 0);
+    for(int i = 0; i < numSteps; i++)
+    {
+        for(int dependency : dependencies[i])
+            depth[i] = std::max(depth[i], depth[dependency]+1);
+    }
+    
+    // filters by depth and kind
+    std::map<std::pair<int, AGAudioFilterBank::Kind>, std::vector<int>> groups;
+    for(int i = 0; i < numSteps; i++)
+    {
+        if(m_steps[i].sink)
+            continue;
+        AGAudioFilterBank::Filter *filter = dynamic_cast<AGAudioFilterBank::Filter *>(m_steps[i].node);
+        if(filter != NULL)
+            groups[std::make_pair(depth[i], filter->filterBankKind())].push_back(i);
+    }
+    
+    std::vector<int> bankOf(numSteps, -1);
+    for(auto &group : groups)
+    {
+        if(group.second.size() < AGAudioFilterBank::MIN_FILTERS)
+            continue;
+        
+        std::vector<AGAudioFilterBank::Filter *> filters;
+        std::vector<AGAudioNode *> nodes;
+        for(int i : group.second)
+        {
+            filters.push_back(dynamic_cast<AGAudioFilterBank::Filter *>(m_steps[i].node));
+            nodes.push_back(m_steps[i].node);
+            bankOf[i] = (int) m_banks.size();
+        }
+        
+        m_banks.emplace_back(new AGAudioFilterBank(group.first.second, filters));
+        m_bankNodes.push_back(nodes);
+        m_bankAwake.push_back(std::vector<uint8_t>(nodes.size(), 1));
+    }
+    
+    if(m_banks.size() == 0)
+        return;
+    
+    // order by depth, so that each bank's dependencies all come before its
+    // first member, and its dependents after its last
+    std::vector<int> order(numSteps);
+    for(int i = 0; i < numSteps; i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return depth[a] < depth[b]; });
+    
+    std::vector<Step> steps;
+    std::vector<bool> rendered(m_banks.size(), false);
+    for(int i : order)
+    {
+        Step step = m_steps[i];
+        int bank = bankOf[i];
+        if(bank >= 0)
+        {
+            step.bank = m_banks[bank].get();
+            step.banked = rendered[bank];
+            step.bankIndex = bank;
+            rendered[bank] = true;
+        }
+        steps.push_back(step);
+    }
+    
+    m_steps.swap(steps);
+}
+
+void AGAudioRenderPlan::_cluster()
+{
+    int numSteps = (int) m_steps.size();
+    
+    std::vector<std::vector<int>> stepDependents;
+    std::vector<std::vector<int>> stepDependencies;
+    _dependencies(stepDependents, stepDependencies);
+    
+    // a bank runs as a unit, at its first step; its other steps take no part
+    std::map<AGAudioFilterBank *, int> bankStep;
+    std::vector<int> unit(numSteps);
+    for(int i = 0; i < numSteps; i++)
+    {
+        unit[i] = i;
+        if(m_steps[i].bank != NULL)
+        {
+            if(!m_steps[i].banked)
+                bankStep[m_steps[i].bank] = i;
+            unit[i] = bankStep[m_steps[i].bank];
+        }
+    }
+    
+    // edges between units; banks are ordered after all of their members'
+    // dependencies and before their dependents, so these still run forwards
+    std::vector<std::vector<int>> dependents(numSteps);
+    std::vector<std::vector<int>> dependencies(numSteps);
+    for(int i = 0; i < numSteps; i++)
+    {
+        for(int dependent : stepDependents[i])
+        {
+            int from = unit[i], to = unit[dependent];
+            if(from == to) continue;
+            if(std::find(dependents[from].begin(), dependents[from].end(), to) != dependents[from].end()) continue;
+            dependents[from].push_back(to);
+            dependencies[to].push_back(from);
+        }
+    }
+    
+    // extend a chain when a step's only dependency has no other dependents
+    std::vector<int> clusterOf(numSteps);
+    std::vector<std::vector<int>> clusters;
+    for(int i = 0; i < numSteps; i++)
+    {
+        if(m_steps[i].banked)
+            continue;
+        
+        if(dependencies[i].size() == 1 && dependents[dependencies[i][0]].size() == 1)
+        {
+            clusterOf[i] = clusterOf[dependencies[i][0]];
+            clusters[clusterOf[i]].push_back(i);
+        }
+        else
+        {
+            clusterOf[i] = (int) clusters.size();
+            clusters.push_back(std::vector<int>(1, i));
+        }
+    }
+    
+    for(int c = 0; c < (int) clusters.size(); c++)
+    {
+        Cluster cluster;
+        cluster.firstStep = (int) m_clusterSteps.size();
+        cluster.numSteps = (int) clusters[c].size();
+        m_clusterSteps.insert(m_clusterSteps.end(), clusters[c].begin(), clusters[c].end());
+        
+        // only a chain's head has outside dependencies, and only its tail has
+        // outside dependents
+        cluster.numDependencies = (int) dependencies[clusters[c].front()].size();
+        cluster.firstDependent = (int) m_clusterDependents.size();
+        cluster.numDependents = 0;
+        for(int dependent : dependents[clusters[c].back()])
+        {
+            m_clusterDependents.push_back(clusterOf[dependent]);
+            cluster.numDependents++;
+        }
+        
+        if(cluster.numDependencies == 0)
+            m_rootClusters.push_back(c);
+        
+        m_clusters.push_back(cluster);
+    }
+    
+    m_pending.reset(new std::atomic<int>[m_clusters.size()]);
+}
+
+void AGAudioRenderPlan::render(sampletime t, float *output, int nFrames, int nChans, AGAudioWorkerPool *pool)
+{
+    // bind each node to its step in this plan
+    for(const Step &step : m_steps)
+        step.node->setRenderStep(&step);
+    
+    m_renderTime = t;
+    m_renderFrames = nFrames;
+    m_profiling = AGAudioProfiler::instance().enabled();
+    
+    // in parallel only if the workers can't hold up a real-time caller
+    if(pool != NULL && pool->numThreads() > 1 && pool->realtimeSafe() && m_clusters.size() > 1)
+    {
+        for(int c = 0; c < (int) m_clusters.size(); c++)
+            m_pending[c].store(m_clusters[c].numDependencies, std::memory_order_relaxed);
+        
+        pool->run(this, (int) m_clusters.size(), m_rootClusters.data(), (int) m_rootClusters.size());
+    }
+    else
+    {
+        for(const Step &step : m_steps)
+        {
+            if(!step.banked)
+                _renderStep(step, m_scratch, 0);
+        }
+    }
+    
+    // outputs are rendered on the audio thread (worker 0)
+    for(int i = 0; i < (int) m_outputs.size(); i++)
+    {
+        if(m_profiling && m_outputNodes[i] != NULL)
+        {
+            uint64_t start = CycleCounter::now();
+            m_outputs[i]->renderAudio(t, NULL, output, nFrames, 0, nChans);
+            m_outputNodes[i]->profile().record(start, CycleCounter::now(), nFrames, 0);
+        }
+        else
+        {
+            m_outputs[i]->renderAudio(t, NULL, output, nFrames, 0, nChans);
+        }
+    }
+}
+
+void AGAudioRenderPlan::_renderStep(const Step &step, float *scratch, int worker)
+{
+    if(step.sink)
+        return;
+    
+    if(step.bank)
+    {
+        _renderBank(step, worker);
+        return;
+    }
+    
+    AGAudioNode *node = step.node;
+    if(m_skipDormant && node->_dormant(m_renderFrames))
+    {
+        node->_skip(m_renderTime);
+        return;
+    }
+    
+    if(m_profiling)
+    {
+        uint64_t start = CycleCounter::now();
+        node->renderAudio(m_renderTime, NULL, scratch, m_renderFrames, 0, node->numOutputPorts());
+        node->profile().record(start, CycleCounter::now(), m_renderFrames, worker);
+    }
+    else
+    {
+        node->renderAudio(m_renderTime, NULL, scratch, m_renderFrames, 0, node->numOutputPorts());
+    }
+    
+    if(m_skipDormant)
+        node->_rendered(m_renderFrames);
+}
+
+void AGAudioRenderPlan::_renderBank(const Step &step, int worker)
+{
+    AGAudioFilterBank &bank = *step.bank;
+    const std::vector<AGAudioNode *> &nodes = m_bankNodes[step.bankIndex];
+    std::vector<uint8_t> &awake = m_bankAwake[step.bankIndex];
+    int numFilters = bank.numFilters();
+    
+    // only the members that are awake take a lane
+    int numAwake = numFilters;
+    if(m_skipDormant)
+    {
+        numAwake = 0;
+        for(int j = 0; j < numFilters; j++)
+        {
+            awake[j] = !nodes[j]->_dormant(m_renderFrames);
+            if(awake[j])
+                numAwake++;
+            else
+                nodes[j]->_skip(m_renderTime);
+        }
+        
+        if(numAwake == 0)
+            return;
+    }
+    
+    if(m_profiling)
+    {
+        // split the bank's time evenly between its awake members
+        uint64_t start = CycleCounter::now();
+        bank.render(m_renderTime, m_renderFrames, awake.data());
+        uint64_t end = CycleCounter::now();
+        
+        for(int j = 0, n = 0; j < numFilters; j++)
+        {
+            if(!awake[j])
+                continue;
+            nodes[j]->profile().record(start+(end-start)*n/numAwake, start+(end-start)*(n+1)/numAwake,
+                                       m_renderFrames, worker);
+            n++;
+        }
+    }
+    else
+    {
+        bank.render(m_renderTime, m_renderFrames, awake.data());
+    }
+    
+    if(m_skipDormant)
+    {
+        for(int j = 0; j < numFilters; j++)
+        {
+            if(awake[j])
+                nodes[j]->_rendered(m_renderFrames);
+        }
+    }
+}
+
+void AGAudioRenderPlan::runTask(int task, int worker, AGAudioWorkerPool &pool)
+{
+    const Cluster &cluster = m_clusters[task];
+    
+    for(int i = 0; i < cluster.numSteps; i++)
+        _renderStep(m_steps[m_clusterSteps[cluster.firstStep+i]], pool.scratch(worker), worker);
+    
+    for(int i = 0; i < cluster.numDependents; i++)
+    {
+        int dependent = m_clusterDependents[cluster.firstDependent+i];
+        if(m_pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            pool.spawn(worker, dependent);
+    }
+}
@@ -0,0 +1,152 @@
+//
+//  AGAudioRenderPlan.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include "AGConnection.h"
+#include "AGAudioRenderer.h"
+#include "Buffers.h"
+#include "AGAudioWorkerPool.h"
+#include "AGAudioFilterBank.h"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <vector>
+#include <stdint.h>
+
+class AGNode;
+class AGAudioNode;
+
+//------------------------------------------------------------------------------
+// ### AGAudioRenderPlan ###
+// Flat, topologically ordered execution plan for the audio graph.
+// Compiled on the UI thread whenever connections or outputs change; the audio
+// thread then renders each node exactly once per block by walking the plan,
+// instead of recursively pulling inputs from the output nodes. A compiled plan
+// is immutable, so it can be handed to the audio thread without locking.
+//
+// The plan is also split into clusters: chains of steps with no branching,
+// linked to other clusters by their dependencies. Independent clusters can be
+// rendered in parallel on an AGAudioWorkerPool, joined before the outputs.
+//
+// Filter nodes of the same kind that don't depend on each other are rendered
+// together in an AGAudioFilterBank. To line them up, the plan is then ordered
+// by depth (longest path from a node with no dependencies) instead of in plain
+// depth-first order, and each bank is rendered at its first member's step.
+//
+// Nodes whose audio inputs have been silent for longer than their tail (see
+// AGAudioNode::tailFrames) are skipped, leaving silence in their outputs, until
+// an input sounds again; banks only filter their members that are awake.
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioRenderPlan
+
+class AGAudioRenderPlan : private AGAudioWorkerPool::Job
+{
+public:
+
+    // resolved inbound connection of a scheduled node
+    struct Input
+    {
+        AGNode *src;
+        int srcPort;
+        int dstPort;
+        AGRate rate;
+        
+        // only valid for RATE_AUDIO inputs (defined in AGAudioNode.h)
+        inline AGAudioNode *audioSrc() const;
+    };
+
+    // a node, its inbound connections, and its subgraph outputs (if any)
+    struct Step
+    {
+        AGAudioNode *node;
+        const Input *inputs;
+        int numInputs;
+        AGAudioRenderer * const *subgraphOutputs;
+        int numSubgraphOutputs;
+        // sinks (output nodes) are rendered by their owner, not the plan
+        bool sink;
+        // filter bank the node is rendered in, if any; the bank is rendered
+        // at its first step, and its other steps are skipped (banked)
+        AGAudioFilterBank *bank;
+        bool banked;
+        // index of the bank in the plan, or -1
+        int bankIndex;
+    };
+
+    /* compile a plan for everything upstream of the given outputs; with
+       filterBanks, independent filters are gathered into AGAudioFilterBanks,
+       and with skipDormant, nodes fallen silent are skipped */
+    static AGAudioRenderPlan *compile(const std::list<AGAudioRenderer *> &outputs, bool filterBanks = true,
+                                      bool skipDormant = true);
+
+    /* render one block: every scheduled node in order, then the outputs;
+       independent clusters are spread across the pool if one is given */
+    void render(sampletime t, float *output, int nFrames, int nChans,
+                AGAudioWorkerPool *pool = NULL);
+
+    int numSteps() const { return (int) m_steps.size(); }
+    const Step &step(int i) const { return m_steps[i]; }
+    
+    int numClusters() const { return (int) m_clusters.size(); }
+    /* number of clusters with no dependencies, i.e. available parallelism at the start of a block */
+    int numRootClusters() const { return (int) m_rootClusters.size(); }
+    
+    int numFilterBanks() const { return (int) m_banks.size(); }
+
+private:
+    AGAudioRenderPlan();
+    
+    // chain of steps, and the clusters that wait on it
+    struct Cluster
+    {
+        int firstStep; // into m_clusterSteps
+        int numSteps;
+        int firstDependent; // into m_clusterDependents
+        int numDependents;
+        int numDependencies;
+    };
+    
+    /* dependency edges between steps, in the current order */
+    void _dependencies(std::vector<std::vector<int>> &dependents, std::vector<std::vector<int>> &dependencies) const;
+    void _batchFilters();
+    void _cluster();
+    void _renderStep(const Step &step, float *scratch, int worker);
+    void _renderBank(const Step &step, int worker);
+    void runTask(int task, int worker, AGAudioWorkerPool &pool) override;
+
+    std::vector<Step> m_steps;
+    std::vector<Input> m_inputs;
+    std::vector<AGAudioRenderer *> m_subgraphOutputs;
+    std::vector<AGAudioRenderer *> m_outputs;
+    // m_outputs that are nodes (else NULL), for profiling
+    std::vector<AGAudioNode *> m_outputNodes;
+
+    std::vector<Cluster> m_clusters;
+    std::vector<int> m_clusterSteps;
+    std::vector<int> m_clusterDependents;
+    std::vector<int> m_rootClusters;
+    
+    std::vector<std::unique_ptr<AGAudioFilterBank>> m_banks;
+    // each bank's nodes, in the bank's order, and which are awake this block
+    std::vector<std::vector<AGAudioNode *>> m_bankNodes;
+    std::vector<std::vector<uint8_t>> m_bankAwake;
+    // dependencies left per cluster in the block being rendered
+    std::unique_ptr<std::atomic<int>[]> m_pending;
+    
+    // block being rendered
+    sampletime m_renderTime;
+    int m_renderFrames;
+    bool m_profiling;
+    bool m_skipDormant;
+    
+    // destination for the (unused) accumulated output of scheduled nodes
+    Buffer<float> m_scratch;
+};
+
@@ -0,0 +1,239 @@
+//
+//  AGAudioWorkerPool.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGAudioWorkerPool.h"
+#include "AGDef.h"
+#include "RealtimeAllocGuard.h"
+
+#include <chrono>
+#include <new>
+#include <thread>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// how long an idle worker keeps looking for work before parking (us); long
+// enough to catch the next job of the same callback, well short of the next
+// callback
+static const int IDLE_SPIN_US = 50;
+
+
+static inline int64_t _nowUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioWorkerPool::Worker ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioWorkerPool::Worker
+
+void *AGAudioWorkerPool::Worker::operator new(size_t size)
+{
+    void *p = NULL;
+    if(posix_memalign(&p, alignof(Worker), size) != 0)
+        throw std::bad_alloc();
+    return p;
+}
+
+void AGAudioWorkerPool::Worker::operator delete(void *p)
+{
+    free(p);
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioWorkerPool ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioWorkerPool
+
+int AGAudioWorkerPool::defaultNumWorkers(int maxWorkers)
+{
+    int numCores = (int) std::thread::hardware_concurrency();
+    int numWorkers = numCores-1;
+    if(numWorkers < 0) numWorkers = 0;
+    if(numWorkers > maxWorkers) numWorkers = maxWorkers;
+    return numWorkers;
+}
+
+AGAudioWorkerPool::AGAudioWorkerPool(int numWorkers, bool realtime) :
+m_realtime(realtime), m_numRealtime(0),
+m_job(NULL), m_remaining(0), m_generation(0), m_quit(false),
+m_numParked(0)
+{
+    // worker 0 is whichever thread calls run()
+    for(int i = 0; i < numWorkers+1; i++)
+    {
+        Worker *worker = new Worker;
+        worker->scratch.resize(AUDIO_BUFFER_MAX);
+        worker->scratch.clear();
+        m_workers.push_back(worker);
+    }
+
+    for(int i = 1; i < (int) m_workers.size(); i++)
+        m_workers[i]->thread.start([this, i](){ _workerLoop(i); });
+}
+
+AGAudioWorkerPool::~AGAudioWorkerPool()
+{
+    m_quit = true;
+    // parked or not, each takes at most one post to see m_quit
+    for(int i = 1; i < (int) m_workers.size(); i++)
+        m_wake.post();
+
+    for(int i = 1; i < (int) m_workers.size(); i++)
+        m_workers[i]->thread.wait();
+
+    for(Worker *worker : m_workers)
+        delete worker;
+    m_workers.clear();
+}
+
+void AGAudioWorkerPool::run(Job *job, int numTasks, const int *readyTasks, int numReady)
+{
+    if(numTasks == 0)
+        return;
+
+    m_remaining.store(numTasks, std::memory_order_relaxed);
+    m_job.store(job, std::memory_order_release);
+
+    for(int i = 0; i < numReady; i++)
+        spawn(0, readyTasks[i]);
+
+    // new generation, then wake whoever parked before seeing it (see _park)
+    m_generation.fetch_add(1, std::memory_order_seq_cst);
+    int numParked = m_numParked.exchange(0, std::memory_order_seq_cst);
+    for(int i = 0; i < numParked; i++)
+        m_wake.post();
+
+    // help out until every task has finished. Whatever is left is in flight
+    // on workers at (at least) this thread's priority (see realtimeSafe()),
+    // so keep at it rather than park and wait to be woken
+    while(m_remaining.load(std::memory_order_acquire) > 0)
+    {
+        if(!_runOne(0))
+            sched_yield();
+    }
+
+    m_job.store(NULL, std::memory_order_release);
+}
+
+void AGAudioWorkerPool::spawn(int worker, int task)
+{
+    // deques are sized well above any plan's width; fall back to running the
+    // task inline rather than dropping it
+    if(!m_workers[worker]->tasks.push(task))
+    {
+        Job *job = m_job.load(std::memory_order_acquire);
+        job->runTask(task, worker, *this);
+        m_remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+bool AGAudioWorkerPool::_runOne(int worker)
+{
+    int task;
+    bool found = m_workers[worker]->tasks.pop(task);
+
+    // steal, starting from the next worker over so thieves spread out
+    for(int i = 1; !found && i < (int) m_workers.size(); i++)
+        found = m_workers[(worker+i) % m_workers.size()]->tasks.steal(task);
+
+    if(!found)
+        return false;
+
+    Job *job = m_job.load(std::memory_order_acquire);
+    job->runTask(task, worker, *this);
+    m_remaining.fetch_sub(1, std::memory_order_acq_rel);
+
+    return true;
+}
+
+void AGAudioWorkerPool::_workerLoop(int worker)
+{
+    if(m_realtime)
+    {
+        // match the audio thread as closely as the platform allows; if it
+        // won't, the audio thread mustn't wait on us
+        sched_param param;
+        param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+        int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if(err == 0)
+            m_numRealtime.fetch_add(1, std::memory_order_release);
+        else
+            fprintf(stderr, "AGAudioWorkerPool: unable to make worker %i real-time (%s); rendering serially\n",
+                    worker, strerror(err));
+    }
+    
+    RealtimeAllocGuard::Scope realtime;
+
+    unsigned lastGeneration = m_generation.load(std::memory_order_acquire);
+    int64_t idleSince = -1;
+
+    while(!m_quit.load(std::memory_order_relaxed))
+    {
+        if(_runOne(worker))
+        {
+            idleSince = -1;
+            continue;
+        }
+
+        // stay hot while a job is in flight or one just started
+        unsigned generation = m_generation.load(std::memory_order_acquire);
+        if(generation != lastGeneration ||
+           m_job.load(std::memory_order_acquire) != NULL)
+        {
+            lastGeneration = generation;
+            idleSince = -1;
+            sched_yield();
+            continue;
+        }
+
+        int64_t now = _nowUs();
+        if(idleSince < 0)
+            idleSince = now;
+        if(now - idleSince < IDLE_SPIN_US)
+            sched_yield();
+        else
+        {
+            _park(lastGeneration);
+            idleSince = -1;
+        }
+    }
+}
+
+void AGAudioWorkerPool::_park(unsigned lastGeneration)
+{
+    // count ourselves parked before checking for a new job; run() bumps the
+    // generation before taking the count, so either it sees us and posts, or
+    // we see its job and don't wait
+    m_numParked.fetch_add(1, std::memory_order_seq_cst);
+
+    if(m_generation.load(std::memory_order_seq_cst) == lastGeneration &&
+       !m_quit.load(std::memory_order_seq_cst))
+    {
+        m_wake.wait();
+        return;
+    }
+
+    // take ourselves back off the count, unless run() already took it (and
+    // so has posted once for us)
+    int numParked = m_numParked.load(std::memory_order_relaxed);
+    while(numParked > 0)
+    {
+        if(m_numParked.compare_exchange_weak(numParked, numParked-1, std::memory_order_seq_cst))
+            return;
+    }
+
+    m_wake.wait();
+}
+
@@ -0,0 +1,102 @@
+//
+//  AGAudioWorkerPool.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include "Thread.h"
+#include "Buffers.h"
+#include "Semaphore.h"
+#include "WorkStealingDeque.h"
+
+#include <atomic>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// ### AGAudioWorkerPool ###
+// Pool of real-time worker threads for rendering independent parts of the
+// audio graph in parallel. The audio thread submits a job and participates in
+// it as worker 0; each worker has its own deque of ready tasks and steals from
+// the others when it runs dry. Workers spin briefly once a job is done and
+// then park until run() wakes them; run() itself never parks. Nothing here
+// locks or allocates once started.
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioWorkerPool
+
+class AGAudioWorkerPool
+{
+public:
+
+    class Job
+    {
+    public:
+        virtual ~Job() { }
+        /* run one task; call pool.spawn() for any tasks it makes ready */
+        virtual void runTask(int task, int worker, AGAudioWorkerPool &pool) = 0;
+    };
+
+    /* one worker per core beyond the audio thread, up to maxWorkers */
+    static int defaultNumWorkers(int maxWorkers = 3);
+
+    /* realtime pools give their workers real-time priority, for running jobs
+       from the audio thread */
+    AGAudioWorkerPool(int numWorkers, bool realtime = true);
+    ~AGAudioWorkerPool();
+
+    AGAudioWorkerPool(const AGAudioWorkerPool &) = delete;
+
+    /* number of threads that run tasks, including the calling thread */
+    int numThreads() const { return (int) m_workers.size(); }
+
+    /* whether the audio thread may wait on the workers: each has started with
+       real-time priority, or the pool isn't realtime (e.g. rendering offline)
+       and so has no priority to invert. Workers report on stderr if the
+       platform refuses them real-time priority (e.g. without privileges);
+       jobs should then be run serially instead. */
+    bool realtimeSafe() const { return !m_realtime || m_numRealtime.load(std::memory_order_acquire) == numThreads()-1; }
+
+    /* run a job to completion of numTasks tasks, starting from the ready ones */
+    void run(Job *job, int numTasks, const int *readyTasks, int numReady);
+
+    /* queue a task that has become ready; only from within Job::runTask */
+    void spawn(int worker, int task);
+
+    /* per-worker block-sized scratch buffer */
+    float *scratch(int worker) { return m_workers[worker]->scratch; }
+
+private:
+
+    struct Worker
+    {
+        Thread thread;
+        WorkStealingDeque<int> tasks;
+        Buffer<float> scratch;
+
+        // the deque is cache-line aligned, which new doesn't honor before C++17
+        static void *operator new(size_t size);
+        static void operator delete(void *p);
+    };
+
+    void _workerLoop(int worker);
+    bool _runOne(int worker);
+    void _park(unsigned lastGeneration);
+
+    std::vector<Worker *> m_workers;
+    const bool m_realtime;
+    // workers running at real-time priority
+    std::atomic<int> m_numRealtime;
+
+    std::atomic<Job *> m_job;
+    std::atomic<int> m_remaining;
+    std::atomic<unsigned> m_generation;
+    std::atomic<bool> m_quit;
+
+    // workers parked on m_wake, which run() takes to post to them
+    std::atomic<int> m_numParked;
+    Semaphore m_wake;
+};
+
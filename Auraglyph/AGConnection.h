@@ -13,6 +13,7 @@
 #include "AGUserInterface.h"
 #include "AGDocument.h"
 #include "AGControl.h"
+#include "AGSpatialIndex.h"
 
 #include "Geometry.h"
 #include "Animation.h"
@@ -39,8 +40,12 @@ public:
     
     static AGConnection *connect(AGNode *src, int srcPort, AGNode *dst, int dstPort);
     static AGConnection *connect(const AGDocument::Connection &docConnection);
+    /* connect nodes that aren't on the canvas (like a composite's voices);
+       the connection isn't registered with AGGraphManager, and the caller
+       tells the audio engine once it's done changing the graph */
+    static AGConnection *connectPrivate(AGNode *src, int srcPort, AGNode *dst, int dstPort);
     
-    AGConnection(AGNode * src, int srcPort, AGNode * dst, int dstPort, const string &uuid = "");
+    AGConnection(AGNode * src, int srcPort, AGNode * dst, int dstPort, const string &uuid = "", bool isPrivate = false);
     ~AGConnection();
     
     virtual void update(float t, float dt);
@@ -51,6 +56,10 @@ public:
     virtual void touchUp(const GLvertex3f &t);
     
     virtual AGInteractiveObject *hitTest(const GLvertex3f &t);
+    /* how close a touch has to be to hit the connection */
+    static float hitDistance();
+    /* the line between the nodes' ports, where they are now */
+    AGBoundingBox hitBounds() const;
     
     const string &uuid() const { return m_uuid; }
     AGNode * src() const { return m_src; }
@@ -59,6 +68,7 @@ public:
     int srcPort() const { return m_srcPort; }
     
     AGRate rate() { return m_rate; }
+    bool isPrivate() const { return m_private; }
     
     void controlActivate(const AGControl &ctrl);
     
@@ -95,6 +105,7 @@ private:
 //    powcurvef m_alpha;
     
     const AGRate m_rate;
+    const bool m_private;
     
     list<float> m_flares;
     GLvertex3f m_flareGeo[4];
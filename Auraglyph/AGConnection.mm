@@ -66,6 +66,14 @@ AGConnection *AGConnection::connect(AGNode *src, int srcPort, AGNode *dst, int d
     return conn;
 }
 
+AGConnection *AGConnection::connectPrivate(AGNode *src, int srcPort, AGNode *dst, int dstPort)
+{
+    AGConnection *conn = new AGConnection(src, srcPort, dst, dstPort, "", true);
+    conn->init();
+    
+    return conn;
+}
+
 AGConnection *AGConnection::connect(const AGDocument::Connection &docConnection)
 {
     AGGraphManager &graphManager = AGGraphManager::instance();
@@ -86,12 +94,14 @@ AGConnection *AGConnection::connect(const AGDocument::Connection &docConnection)
         return nullptr;
 }
 
-AGConnection::AGConnection(AGNode * src, int srcPort, AGNode * dst, int dstPort, const string &uuid) :
-m_src(src), m_srcPort(srcPort), m_dst(dst), m_dstPort(dstPort),
+AGConnection::AGConnection(AGNode * src, int srcPort, AGNode * dst, int dstPort, const string &uuid, bool isPrivate) :
+m_uuid(uuid.length() > 0 ? uuid : makeUUID()),
+m_geoSize(0),
+m_src(src), m_dst(dst), m_dstPort(dstPort), m_srcPort(srcPort),
+m_hit(false), m_stretch(false), m_stretchPoint(0.25, GLvertex3f()), m_active(true),
 m_rate((src->rate() == RATE_AUDIO && dst->rate() == RATE_AUDIO) ? RATE_AUDIO : RATE_CONTROL),
-m_geoSize(0), m_hit(false), m_stretch(false), m_active(true),
-m_stretchPoint(0.25, GLvertex3f()), m_controlVisScale(0.07, 0),
-m_uuid(uuid.length() > 0 ? uuid : makeUUID())
+m_private(isPrivate),
+m_controlVisScale(0.07, 0)
 {
     initalize();
     
@@ -169,12 +179,9 @@ void AGConnection::update(float t, float dt)
     }
     
     float flareSpeed = 2;
-    itmap(m_flares, ^(float &f){
+    for(float &f : m_flares)
         f += dt*flareSpeed*(0.25f+(1.0f+cosf(M_PI*(f-0.1)))/2.0f);
-    });
-    itfilter(m_flares, ^bool (float &f){
-        return f >= 1;
-    });
+    m_flares.remove_if([](float f) { return f >= 1; });
     
     // relax to zero
     m_controlVisScale = 0;
@@ -357,12 +364,29 @@ AGInteractiveObject *AGConnection::hitTest(const GLvertex3f &_t)
     GLvertex2f p1 = GLvertex2f(m_inTerminal.x, m_inTerminal.y);
     GLvertex2f t = GLvertex2f(_t.x, _t.y);
     
-    if(pointOnLine(t, p0, p1, 0.005*AGStyle::oldGlobalScale))
+    if(pointOnLine(t, p0, p1, hitDistance()))
         return this;
     
     return NULL;
 }
 
+float AGConnection::hitDistance()
+{
+    return 0.005*AGStyle::oldGlobalScale;
+}
+
+AGBoundingBox AGConnection::hitBounds() const
+{
+    // the terminals catch up to the nodes on the next update, so go by the
+    // nodes
+    GLvertex2f in = m_dst->positionForInboundConnection(const_cast<AGConnection *>(this)).xy();
+    GLvertex2f out = m_src->positionForOutboundConnection(const_cast<AGConnection *>(this)).xy();
+    
+    AGBoundingBox bounds(in, in);
+    bounds.unite(out);
+    return bounds;
+}
+
 void AGConnection::controlActivate(const AGControl &ctrl)
 {
 //    // immediately pop up to "1"
@@ -396,7 +420,7 @@ void AGConnection::controlActivate(const AGControl &ctrl)
 //            m_controlVisScale = 1+log10(fabsf(ctrl.vfloat)+0.00001);
             break;
         case AGControl::TYPE_STRING:
-            m_controlVisScale = ctrl.vstring.length() > 0 ? 1 : 0;
+            m_controlVisScale = ctrl.stringValue().length() > 0 ? 1 : 0;
             break;
     }
     
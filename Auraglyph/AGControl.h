@@ -11,7 +11,10 @@
 
 #include <string>
 #include <float.h>
+#include <limits.h>
 #include <sstream>
+#include <stdint.h>
+#include <type_traits>
 
 using namespace std;
 
@@ -25,87 +28,55 @@ const static float AGFloat_Max = FLT_MAX;
 const static int AGInt_Min = INT_MIN;
 const static float AGInt_Max = INT_MAX;
 
+//------------------------------------------------------------------------------
+// ### AGStringTable ###
+// Interns the strings carried by controls, so that a control only holds a
+// small handle to its string and can be copied as plain data. Strings are
+// kept for the life of the program; 0 is always the empty string.
+//------------------------------------------------------------------------------
+#pragma mark - AGStringTable
+
+typedef uint32_t AGStringId;
+
+class AGStringTable
+{
+public:
+    /* any thread: handle for str, adding it to the table (which takes a lock
+       and allocates) if it hasn't been seen before */
+    static AGStringId intern(const AGString &str);
+    /* any thread, without locking or allocating */
+    static const AGString &lookup(AGStringId id);
+};
+
+
+//------------------------------------------------------------------------------
+// ### AGControl ###
+// A control value: nothing, a bit, an int, a float or a string. Trivially
+// copyable (strings are AGStringTable handles), so controls can be memcpy'd
+// through queues and kept in flat arrays.
+//------------------------------------------------------------------------------
+#pragma mark - AGControl
+
 class AGControl
 {
 public:
-    AGControl() : type(TYPE_NONE) { }
+    AGControl() : type(TYPE_NONE), vint(0) { }
     AGControl(AGBit b) : type(TYPE_BIT), vbit(b) { }
     AGControl(AGInt i) : type(TYPE_INT), vint(i) { }
     AGControl(AGFloat f) : type(TYPE_FLOAT), vfloat(f) { }
-    AGControl(const AGString &s) : type(TYPE_STRING), vstring(s) { }
-
-    AGControl(const AGControl &ctl) : type(ctl.type)
-    {
-        switch(type)
-        {
-            case TYPE_NONE:
-                break;
-            case TYPE_BIT:
-                vbit = ctl.vbit;
-                break;
-            case TYPE_INT:
-                vint = ctl.vint;
-                break;
-            case TYPE_FLOAT:
-                vfloat = ctl.vfloat;
-                break;
-            case TYPE_STRING:
-                vstring = ctl.vstring;
-                break;
-        }
-    }
-    
-    AGControl operator=(const AGControl &ctl)
-    {
-        if(&ctl != this)
-        {
-            type = ctl.type;
-            
-            switch(type)
-            {
-                case TYPE_NONE:
-                    break;
-                case TYPE_BIT:
-                    vbit = ctl.vbit;
-                    break;
-                case TYPE_INT:
-                    vint = ctl.vint;
-                    break;
-                case TYPE_FLOAT:
-                    vfloat = ctl.vfloat;
-                    break;
-                case TYPE_STRING:
-                    vstring = ctl.vstring;
-                    break;
-            }
-        }
-        
-        return *this;
-    }
+    AGControl(const AGString &s) : type(TYPE_STRING), vstring(AGStringTable::intern(s)) { }
+    // otherwise string literals would convert to AGBit
+    AGControl(const char *s) : type(TYPE_STRING), vstring(AGStringTable::intern(s)) { }
     
-    AGControl(AGControl && ctl) : type(ctl.type)
+    /* string control from an already interned string */
+    static AGControl withStringId(AGStringId id)
     {
-        switch(type)
-        {
-            case TYPE_NONE:
-                break;
-            case TYPE_BIT:
-                vbit = ctl.vbit;
-                break;
-            case TYPE_INT:
-                vint = ctl.vint;
-                break;
-            case TYPE_FLOAT:
-                vfloat = ctl.vfloat;
-                break;
-            case TYPE_STRING:
-                vstring = ctl.vstring;
-                break;
-        }
+        AGControl control;
+        control.type = TYPE_STRING;
+        control.vstring = id;
+        return control;
     }
     
-    ~AGControl() { }
-    
     enum Type
     {
         TYPE_NONE,
@@ -122,10 +93,9 @@ public:
         AGBit vbit;
         AGInt vint;
         AGFloat vfloat;
+        AGStringId vstring;
     };
     
-    AGString vstring;
-    
     
     AGFloat getFloat() const
     {
@@ -164,6 +134,8 @@ public:
             case TYPE_INT:    return vint;
             case TYPE_FLOAT:  return (int) vfloat;
         }
+        
+        return 0;
     }
     
     void mapTo(AGInt &v) const { v = getInt(); }
@@ -175,37 +147,38 @@ public:
         switch(type)
         {
             case TYPE_NONE:   return 0;
-            case TYPE_STRING: return vstring.size() ? 1 : 0;
+            case TYPE_STRING: return vstring != 0;
             case TYPE_BIT:    return vbit;
             case TYPE_INT:    return vint ? 1 : 0;
             case TYPE_FLOAT:  return vfloat ? 1 : 0;
         }
+        
+        return 0;
     }
     
     void mapTo(AGBit &v) const { v = getBit(); }
     
     // operator AGBit() const { return getBit(); }
     
+    /* the string of a string control (empty for other types); doesn't
+       allocate */
+    const AGString &stringValue() const
+    {
+        return AGStringTable::lookup(type == TYPE_STRING ? vstring : 0);
+    }
+    
+    /* any type, as text, into buf; doesn't allocate. Returns the length of
+       the full text, as snprintf() */
+    int format(char *buf, size_t size) const;
+    
     AGString getString() const
     {
-        switch(type)
-        {
-            case TYPE_NONE:   return "";
-            case TYPE_STRING: return vstring;
-            case TYPE_BIT:    return vbit ? "1" : "0";
-            case TYPE_INT:
-            {
-                stringstream str;
-                str << vint;
-                return str.str();
-            }
-            case TYPE_FLOAT:
-            {
-                stringstream str;
-                str << vfloat;
-                return str.str();
-            }
-        }
+        if(type == TYPE_STRING)
+            return stringValue();
+        
+        char buf[32];
+        format(buf, sizeof(buf));
+        return buf;
     }
     
     void mapTo(AGString &v) const
@@ -224,4 +197,7 @@ public:
     }
 };
 
+static_assert(std::is_trivially_copyable<AGControl>::value, "AGControl must be plain data");
+static_assert(sizeof(AGControl) <= 16, "AGControl should stay compact");
+
 #endif /* defined(__Auragraph__AGControl__) */
@@ -7,3 +7,117 @@
 //
 
 #include "AGControl.h"
+#include "Mutex.h"
+
+#include <atomic>
+#include <unordered_map>
+#include <assert.h>
+#include <stdio.h>
+
+
+//------------------------------------------------------------------------------
+// ### AGStringTable ###
+//------------------------------------------------------------------------------
+#pragma mark - AGStringTable
+
+// strings are stored in fixed-size chunks that never move, so lookups can
+// index straight into them while new strings are being added
+static const int STRING_CHUNK_SIZE = 256;
+static const int STRING_MAX_CHUNKS = 4096;
+
+struct AGStringTableStorage
+{
+    AGStringTableStorage() : size(0)
+    {
+        for(int i = 0; i < STRING_MAX_CHUNKS; i++)
+            chunks[i].store(NULL, std::memory_order_relaxed);
+        
+        // 0 is the empty string
+        chunks[0].store(new AGString[STRING_CHUNK_SIZE], std::memory_order_relaxed);
+        ids[""] = 0;
+        size.store(1, std::memory_order_release);
+    }
+    
+    std::atomic<AGString *> chunks[STRING_MAX_CHUNKS];
+    std::atomic<uint32_t> size;
+    
+    // writers only
+    Mutex mutex;
+    std::unordered_map<AGString, AGStringId> ids;
+};
+
+static AGStringTableStorage &_storage()
+{
+    static AGStringTableStorage s_storage;
+    return s_storage;
+}
+
+AGStringId AGStringTable::intern(const AGString &str)
+{
+    AGStringTableStorage &storage = _storage();
+    storage.mutex.lock();
+    
+    auto i = storage.ids.find(str);
+    if(i != storage.ids.end())
+    {
+        AGStringId id = i->second;
+        storage.mutex.unlock();
+        return id;
+    }
+    
+    uint32_t id = storage.size.load(std::memory_order_relaxed);
+    int chunk = id/STRING_CHUNK_SIZE;
+    if(chunk >= STRING_MAX_CHUNKS)
+    {
+        storage.mutex.unlock();
+        fprintf(stderr, "AGStringTable: table full, dropping '%s'\n", str.c_str());
+        return 0;
+    }
+    
+    AGString *strings = storage.chunks[chunk].load(std::memory_order_relaxed);
+    if(strings == NULL)
+    {
+        strings = new AGString[STRING_CHUNK_SIZE];
+        storage.chunks[chunk].store(strings, std::memory_order_relaxed);
+    }
+    
+    strings[id%STRING_CHUNK_SIZE] = str;
+    storage.ids[str] = id;
+    // publishes the string (and its chunk) to lookup()
+    storage.size.store(id+1, std::memory_order_release);
+    
+    storage.mutex.unlock();
+    
+    return id;
+}
+
+const AGString &AGStringTable::lookup(AGStringId id)
+{
+    AGStringTableStorage &storage = _storage();
+    
+    if(id >= storage.size.load(std::memory_order_acquire))
+        id = 0;
+    
+    return storage.chunks[id/STRING_CHUNK_SIZE].load(std::memory_order_relaxed)[id%STRING_CHUNK_SIZE];
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGControl ###
+//------------------------------------------------------------------------------
+#pragma mark - AGControl
+
+int AGControl::format(char *buf, size_t size) const
+{
+    switch(type)
+    {
+        case TYPE_NONE:   return snprintf(buf, size, "%s", "");
+        case TYPE_BIT:    return snprintf(buf, size, "%s", vbit ? "1" : "0");
+        case TYPE_INT:    return snprintf(buf, size, "%i", vint);
+        // 6 significant digits, as ostream prints floats
+        case TYPE_FLOAT:  return snprintf(buf, size, "%g", vfloat);
+        case TYPE_STRING: return snprintf(buf, size, "%s", stringValue().c_str());
+    }
+    
+    return snprintf(buf, size, "%s", "");
+}
@@ -0,0 +1,154 @@
+//
+//  AGControlBus.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGControlBus.h"
+#include "AGNode.h"
+
+#include <algorithm>
+
+
+// set on whichever thread calls deliver()
+static thread_local bool s_isDeliveryThread = false;
+
+
+//------------------------------------------------------------------------------
+// ### AGControlBus ###
+//------------------------------------------------------------------------------
+#pragma mark - AGControlBus
+
+AGControlBus &AGControlBus::instance()
+{
+    static AGControlBus s_bus;
+    return s_bus;
+}
+
+AGControlBus::AGControlBus() :
+m_order(0), m_delivering(false), m_time(0), m_depth(0),
+m_now(0), m_ticks(0), m_numDelivered(0), m_numDropped(0)
+{
+    m_pending.reserve(PENDING_CAPACITY);
+}
+
+void AGControlBus::post(AGNode *src, int port, const AGControl &control)
+{
+    if(!s_isDeliveryThread)
+    {
+        if(!m_queue.push({ m_now.load(std::memory_order_relaxed), src, port, src->controlRank(), 0, control }))
+            _dropped();
+    }
+    else if(m_delivering)
+    {
+        // pushed by a receiver; goes out this tick, after its sender
+        if(m_depth+1 >= MAX_DEPTH)
+            _dropped();
+        else
+            _queue({ m_time, src, port, src->controlRank(), m_depth+1, control });
+    }
+    else
+    {
+        // pushed by an event handler or the like on the delivering thread
+        if(!m_localQueue.push({ m_now.load(std::memory_order_relaxed), src, port, src->controlRank(), 0, control }))
+            _dropped();
+    }
+}
+
+void AGControlBus::deliver(sampletime t)
+{
+    s_isDeliveryThread = true;
+    m_now.store(t, std::memory_order_relaxed);
+
+    _drain();
+
+    m_delivering = true;
+    while(m_pending.size())
+    {
+        std::pop_heap(m_pending.begin(), m_pending.end(), _later);
+        AGControlMessage message = m_pending.back().message;
+        m_pending.pop_back();
+
+        _dispatch(message);
+    }
+    m_delivering = false;
+
+    m_ticks.fetch_add(1, std::memory_order_release);
+}
+
+void AGControlBus::removeNode(AGNode *node)
+{
+    // off the delivering thread, node is freed through the audio engine's
+    // retire(), which holds it until a block has been rendered (and its
+    // controls delivered) entirely after the node was retired
+    if(!s_isDeliveryThread)
+        return;
+    
+    // nothing else delivers, so just pull node's controls out of the way
+    _drain();
+    
+    auto end = std::remove_if(m_pending.begin(), m_pending.end(), [node](const Pending &pending) {
+        return pending.message.src == node;
+    });
+    if(end != m_pending.end())
+    {
+        m_pending.erase(end, m_pending.end());
+        std::make_heap(m_pending.begin(), m_pending.end(), _later);
+    }
+}
+
+void AGControlBus::_queue(const AGControlMessage &message)
+{
+    if(m_pending.size() >= PENDING_CAPACITY)
+    {
+        _dropped();
+        return;
+    }
+
+    m_pending.push_back({ message, m_order++ });
+    std::push_heap(m_pending.begin(), m_pending.end(), _later);
+}
+
+void AGControlBus::_drain()
+{
+    AGControlMessage message;
+    while(m_localQueue.pop(message))
+        _queue(message);
+    while(m_queue.pop(message))
+        _queue(message);
+}
+
+void AGControlBus::_dispatch(const AGControlMessage &message)
+{
+    AGNode *src = message.src;
+    int port = message.port;
+    const AGControl &control = message.control;
+
+    m_time = message.time;
+    m_depth = message.depth;
+
+    AGNode::ControlOutputs *outputs = src->m_controlOutputs.load(std::memory_order_acquire);
+    if(port < outputs->numPorts)
+        outputs->last[port].store(control, std::memory_order_relaxed);
+
+    // src's tables are immutable, and they (with the connections and nodes
+    // they point to) are only deleted once the audio thread has moved on to
+    // a newer engine snapshot, so nothing here locks
+    const AGNode::ControlTable *table = src->m_controlTable.load(std::memory_order_acquire);
+    if(port >= table->numPorts)
+        return;
+
+    int begin = table->first[port];
+    int end = table->first[port+1];
+    for(int i = begin; i < end; i++)
+    {
+        const AGNode::ControlTarget &target = table->targets[i];
+        target.dst->receiveControl_internal(target.dstPort, control);
+        target.connection->controlActivate(control);
+    }
+
+    m_numDelivered.fetch_add(end-begin, std::memory_order_relaxed);
+}
+
@@ -0,0 +1,135 @@
+//
+//  AGControlBus.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include "AGDef.h"
+#include "AGControl.h"
+#include "LockFreeQueue.h"
+
+#include <atomic>
+#include <vector>
+#include <stdint.h>
+
+class AGNode;
+
+//------------------------------------------------------------------------------
+// ### AGControlMessage ###
+// A control pushed from one of a node's output ports, as it travels through
+// the bus. Plain data, so it can be copied through lock-free queues.
+//------------------------------------------------------------------------------
+#pragma mark - AGControlMessage
+
+struct AGControlMessage
+{
+    // sample time the control was pushed at
+    sampletime time;
+    AGNode *src;
+    int port;
+    // src's control rank when pushed; lower ranks are delivered first
+    int rank;
+    // number of nodes the control has passed through during this tick
+    int depth;
+    AGControl control;
+};
+
+
+//------------------------------------------------------------------------------
+// ### AGControlBus ###
+// Carries control from the nodes that push it to the nodes connected
+// downstream. Pushing only queues the control; once per tick (each audio
+// block, or part of a block when events split it) the audio thread delivers
+// everything queued to the receiving nodes, lowest control rank first, so
+// that a node downstream of several others sees all of their controls for
+// that tick in the order the graph implies. Controls pushed by receivers are
+// delivered in the same tick, until a chain passes through MAX_DEPTH nodes;
+// past that (only possible in a feedback loop) they are dropped rather than
+// recursing forever.
+//
+// Any thread can push. Other threads share a multi-producer queue; the
+// delivering thread gets its own single-producer lane. Queues and the delivery
+// heap are fixed-size, so nothing allocates, and controls that don't fit are
+// dropped and counted.
+//------------------------------------------------------------------------------
+#pragma mark - AGControlBus
+
+class AGControlBus
+{
+public:
+    static const int QUEUE_CAPACITY = 4096;
+    static const int PENDING_CAPACITY = 16384;
+    static const int MAX_DEPTH = 32;
+
+    static AGControlBus &instance();
+
+    AGControlBus();
+    AGControlBus(const AGControlBus &) = delete;
+
+    /* any thread: queue control, pushed from src's port, for delivery at the
+       next tick (or this one, if pushed by a node receiving control) */
+    void post(AGNode *src, int port, const AGControl &control);
+
+    /* deliver everything queued, with t as the current sample time. Always
+       called from the same thread (the audio thread, normally) */
+    void deliver(sampletime t);
+
+    /* before node is deleted: on the delivering thread, drop anything queued
+       from it. Elsewhere this doesn't wait; the node must be freed through
+       AGAudioEngine::retire(), which outlasts anything it queued */
+    void removeNode(AGNode *node);
+
+    /* number of deliver() calls completed */
+    uint64_t ticks() const { return m_ticks.load(std::memory_order_acquire); }
+    /* controls handed to a receiving node */
+    uint64_t numDelivered() const { return m_numDelivered.load(std::memory_order_relaxed); }
+    /* controls lost to full queues or feedback loops */
+    uint64_t numDropped() const { return m_numDropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Pending
+    {
+        AGControlMessage message;
+        // order queued, to break ties
+        uint64_t order;
+    };
+
+    // std heap order, so "less" means later
+    static bool _later(const Pending &a, const Pending &b)
+    {
+        if(a.message.time != b.message.time)
+            return a.message.time > b.message.time;
+        if(a.message.rank != b.message.rank)
+            return a.message.rank > b.message.rank;
+        return a.order > b.order;
+    }
+
+    void _queue(const AGControlMessage &message);
+    void _drain();
+    void _dispatch(const AGControlMessage &message);
+    void _dropped() { m_numDropped.fetch_add(1, std::memory_order_relaxed); }
+
+    MPSCQueue<AGControlMessage, QUEUE_CAPACITY> m_queue;
+    SPSCQueue<AGControlMessage, QUEUE_CAPACITY> m_localQueue;
+
+    // delivery thread only
+    std::vector<Pending> m_pending;
+    uint64_t m_order;
+    bool m_delivering;
+    // message being delivered
+    sampletime m_time;
+    int m_depth;
+
+    // time stamp for controls pushed from other threads
+    std::atomic<sampletime> m_now;
+    // completed deliveries
+    std::atomic<uint64_t> m_ticks;
+
+    std::atomic<uint64_t> m_numDelivered;
+    std::atomic<uint64_t> m_numDropped;
+};
+
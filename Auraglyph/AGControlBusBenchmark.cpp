@@ -0,0 +1,169 @@
+//
+//  AGControlBusBenchmark.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGControlBusBenchmark.h"
+#include "AGControlBus.h"
+#include "AGControlNode.h"
+#include "AGConnection.h"
+#include "AGNode.h"
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <thread>
+#include <sched.h>
+#include <stdio.h>
+
+
+//------------------------------------------------------------------------------
+// ### AGControlBusBenchmark ###
+//------------------------------------------------------------------------------
+#pragma mark - AGControlBusBenchmark
+
+std::string AGControlBusBenchmark::Result::name() const
+{
+    return std::to_string(numProducers) + "x" + std::to_string(fanOut) + "x" + std::to_string(depth);
+}
+
+AGControlBusBenchmark::Result AGControlBusBenchmark::run(int numProducers, int fanOut, int depth, double minTime)
+{
+    assert(numProducers >= 0 && fanOut > 0 && depth > 0 && depth < AGControlBus::MAX_DEPTH);
+
+    AGControlBus &bus = AGControlBus::instance();
+    const AGNodeManager &nodeManager = AGNodeManager::controlNodeManager();
+
+    // one source per producer (or just one, pushed by the delivering thread)
+    int numSources = std::max(numProducers, 1);
+    std::vector<AGNode *> sources;
+    std::list<AGNode *> nodes;
+    std::list<AGConnection *> connections;
+
+    for(int i = 0; i < numSources; i++)
+    {
+        AGNode *source = nodeManager.createNodeOfType("Add", GLvertex3f());
+        sources.push_back(source);
+        nodes.push_back(source);
+
+        for(int j = 0; j < fanOut; j++)
+        {
+            AGNode *prev = source;
+            for(int k = 0; k < depth; k++)
+            {
+                AGNode *node = nodeManager.createNodeOfType("Add", GLvertex3f());
+                nodes.push_back(node);
+                connections.push_back(AGConnection::connect(prev, 0, node, 0));
+                prev = node;
+            }
+        }
+    }
+
+    // deliver anything left over from setup
+    sampletime t = 0;
+    bus.deliver(t++);
+
+    // producers push in bursts, then wait for the next tick to take them;
+    // sized so that two bursts from each (one can land while a tick is under
+    // way) fit the queue, and their fan-out fits the bus's delivery heap
+    int burst = std::min(AGControlBus::QUEUE_CAPACITY/(2*numSources),
+                         AGControlBus::PENDING_CAPACITY/(2*numSources*fanOut));
+    burst = std::max(1, burst);
+    std::atomic<bool> running(true);
+    std::atomic<unsigned long long> numPushed(0);
+    std::vector<std::thread> producers;
+
+    for(int i = 0; i < numProducers; i++)
+    {
+        producers.emplace_back([&, i] {
+            AGNode *source = sources[i];
+            unsigned long long pushed = 0;
+            while(running.load(std::memory_order_relaxed))
+            {
+                uint64_t ticks = bus.ticks();
+                for(int j = 0; j < burst; j++)
+                    source->pushControl(0, AGControl((float) j));
+                pushed += burst;
+
+                while(bus.ticks() == ticks && running.load(std::memory_order_relaxed))
+                    sched_yield();
+            }
+            numPushed.fetch_add(pushed);
+        });
+    }
+
+    uint64_t startDelivered = bus.numDelivered();
+    uint64_t startDropped = bus.numDropped();
+    unsigned long long pushed = 0;
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0;
+
+    for(long long i = 0; seconds < minTime; i++)
+    {
+        if(numProducers == 0)
+        {
+            for(int j = 0; j < burst; j++)
+                sources[0]->pushControl(0, AGControl((float) j));
+            pushed += burst;
+        }
+
+        bus.deliver(t++);
+
+        // don't read the clock every tick
+        if((i & 15) == 0)
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+    }
+
+    uint64_t delivered = bus.numDelivered()-startDelivered;
+
+    running.store(false);
+    for(std::thread &producer : producers)
+        producer.join();
+    bus.deliver(t++);
+
+    Result result;
+    result.numProducers = numProducers;
+    result.fanOut = fanOut;
+    result.depth = depth;
+    result.seconds = seconds;
+    result.numPushed = pushed+numPushed.load();
+    result.numDelivered = delivered;
+    result.numDropped = bus.numDropped()-startDropped;
+    result.deliveredPerSecond = delivered/seconds;
+
+    for(AGConnection *connection : connections)
+    {
+        AGNode::disconnect(connection);
+        delete connection;
+    }
+    for(AGNode *node : nodes)
+        delete node;
+
+    return result;
+}
+
+std::vector<AGControlBusBenchmark::Result> AGControlBusBenchmark::runAll(double minTime)
+{
+    std::vector<Result> results;
+
+    fprintf(stderr, "AGControlBusBenchmark: producers x fan-out x depth\n");
+    fprintf(stderr, "%-40s %14s %14s %12s\n", "benchmark", "msgs/s", "ns/msg", "dropped");
+
+    for(int numProducers : { 0, 1, 4 })
+    {
+        for(std::pair<int, int> shape : { std::make_pair(1, 1), std::make_pair(8, 4) })
+        {
+            Result result = run(numProducers, shape.first, shape.second, minTime);
+            results.push_back(result);
+
+            fprintf(stderr, "%-40s %14.0f %14.3f %12llu\n", result.name().c_str(), result.deliveredPerSecond,
+                    result.deliveredPerSecond > 0 ? 1e9/result.deliveredPerSecond : 0.0, result.numDropped);
+        }
+    }
+
+    return results;
+}
+
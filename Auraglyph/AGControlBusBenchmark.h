@@ -0,0 +1,49 @@
+//
+//  AGControlBusBenchmark.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// ### AGControlBusBenchmark ###
+// Measures how many controls per second AGControlBus can hand to receiving
+// nodes. Each producer pushes from its own control node, which fans out to a
+// number of chains of control "Add" nodes, so every push is delivered
+// fanOut*depth times. Producers run on their own threads, pushing as fast as
+// the bus drains them, while the calling thread delivers; with no producer
+// threads, the delivering thread pushes for itself between ticks.
+//------------------------------------------------------------------------------
+#pragma mark - AGControlBusBenchmark
+
+class AGControlBusBenchmark
+{
+public:
+    struct Result
+    {
+        int numProducers;
+        int fanOut;
+        int depth;
+        double seconds;
+        unsigned long long numPushed; // by producers
+        unsigned long long numDelivered;
+        unsigned long long numDropped;
+        double deliveredPerSecond;
+
+        /* e.g. "4x8x4" (producers x fan-out x depth) */
+        std::string name() const;
+    };
+
+    /* run one configuration for at least minTime seconds */
+    static Result run(int numProducers, int fanOut, int depth, double minTime = 0.25);
+
+    /* run a standard set of configurations and print a summary to stderr */
+    static std::vector<Result> runAll(double minTime = 0.25);
+};
+
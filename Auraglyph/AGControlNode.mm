@@ -11,15 +11,20 @@
 #include "AGNode.h"
 #include "AGArrayNode.h"
 #include "AGControlSequencerNode.h"
+#include "AGControlVoiceNode.h"
 #include "AGTimer.h"
 #include "spstl.h"
 #include "AGStyle.h"
+
+// device sensors, touch and MIDI are not available to headless builds
+#ifndef AG_HEADLESS
 #include "AGControlOrientationNode.h"
 #include "AGControlGestureNode.h"
 
 // XXX new for MIDI input
 #include "AGControlMidiNoteIn.h"
 #include "AGControlMidiCCIn.h"
+#endif // AG_HEADLESS
 
 //------------------------------------------------------------------------------
 // ### AGControlNode ###
@@ -260,7 +265,9 @@ public:
         m_lastTime = 0;
         m_value = false;
         
-        m_timer = AGTimer(param(PARAM_INTERVAL), ^(AGTimer *) {
+        // fires on the audio thread, to the sample
+        m_timer.setInterval(param(PARAM_INTERVAL));
+        m_timer.setAction([this](AGTimer *) {
             // flip
             m_value = !m_value;
             pushControl(0, AGControl(m_value));
@@ -610,7 +617,9 @@ public:
     {
         float interval = 0.01;
         
-        m_timer = AGTimer(interval, ^(AGTimer *) {
+        m_timer.setInterval(interval);
+        m_timer.setAction([this](AGTimer *) {
+            m_slew = m_target.load(std::memory_order_relaxed);
             m_slew.interp();
             pushControl(0, AGControl(m_slew));
         });
@@ -625,13 +634,14 @@ public:
 
     virtual void receiveControl(int port, const AGControl &control) override
     {
-        float t = control.getFloat();
-        m_slew = t;
+        // slewed on the UI thread, by the timer
+        m_target.store(control.getFloat(), std::memory_order_relaxed);
     }
     
 private:
     AGTimer m_timer;
     slewf m_slew;
+    std::atomic<float> m_target{0};
 };
 
 //------------------------------------------------------------------------------
@@ -738,16 +748,16 @@ public:
             return {
                 { PARAM_IN_HOT, "hot in", true, false, .type = AGControl::TYPE_INT,
                     .doc = "Hot inlet." },
-                { PARAM_IN_COLD, "cold in", true, true, .type = AGControl::TYPE_INT,
-                    .mode = AGPortInfo::LIN, .doc = "Cold inlet." },
+                { PARAM_IN_COLD, "cold in", true, true, .mode = AGPortInfo::LIN,
+                    .type = AGControl::TYPE_INT, .doc = "Cold inlet." },
             };
         };
         
         vector<AGPortInfo> _editPortInfo() const override
         {
             return {
-                { PARAM_IN_COLD, "cold in", true, true, .type = AGControl::TYPE_INT,
-                    .mode = AGPortInfo::LIN,.doc = "Cold inlet." },
+                { PARAM_IN_COLD, "cold in", true, true, .mode = AGPortInfo::LIN,
+                    .type = AGControl::TYPE_INT, .doc = "Cold inlet." },
             };
         };
         
@@ -794,13 +804,15 @@ public:
         }
         else if(port == 1)
         {
-            testVal = control.getInt();
-            setEditPortValue(0, AGParamValue(testVal));            
+            int val = control.getInt();
+            testVal = val;
+            setEditPortValue(0, AGParamValue(val));
         }
     }
     
 private:
-    int testVal = 0;
+    // set by the UI thread when edited
+    std::atomic<int> testVal{0};
 };
 
 //------------------------------------------------------------------------------
@@ -873,7 +885,7 @@ public:
                 {  radius*0.9f, -radius*0.2f, 0 }, {  radius*0.2f, -radius*0.2f, 0 },
             };
             
-            for(int i = 0; i < lines.size(); i++)
+            for(int i = 0; i < (int) lines.size(); i++)
             {
                 GLvertex3f vert = lines[i];
                 iconGeo.push_back(vert);
@@ -938,14 +950,19 @@ const AGNodeManager &AGNodeManager::controlNodeManager()
         nodeTypes.push_back(new AGControlAddNode::Manifest);
         nodeTypes.push_back(new AGControlMultiplyNode::Manifest);
 
+#ifndef AG_HEADLESS
         nodeTypes.push_back(new AGControlOrientationNode::Manifest);
         nodeTypes.push_back(new AGControlGestureNode::Manifest);
+#endif // AG_HEADLESS
         
         nodeTypes.push_back(new AGControlSlewNode::Manifest);
         nodeTypes.push_back(new AGControlRandomNode::Manifest);
         
+#ifndef AG_HEADLESS
         nodeTypes.push_back(new AGControlMidiNoteIn::Manifest);
         nodeTypes.push_back(new AGControlMidiCCIn::Manifest);
+#endif // AG_HEADLESS
+        nodeTypes.push_back(new AGControlVoiceNode::Manifest);
         nodeTypes.push_back(new AGControlComparisonEQNode::Manifest);
         nodeTypes.push_back(new AGControlGateNode::Manifest);
         
@@ -11,8 +11,11 @@
 
 #include <string>
 #include <map>
+#include <set>
 #include <vector>
 #include <list>
+#include <functional>
+#include <stdio.h>
 
 #include "Geometry.h"
 
@@ -28,6 +31,12 @@ class AGConnection;
 class AGDocument
 {
 public:
+    /* JSON, or AGDocumentBinary's compact container; either loads the same */
+    enum Format { FORMAT_JSON, FORMAT_BINARY };
+    
+    static const char *const JSON_EXTENSION;
+    static const char *const BINARY_EXTENSION;
+    
     struct ParamValue
     {
         ParamValue() : type(INT), i(0), f(0) { }
@@ -89,11 +98,18 @@ public:
     void loadFromPath(const string &path);
     void save() const;
     void saveTo(const string &title);
-    void saveToPath(const string &path) const;
+    /* either format is recognized when loading */
+    void saveToPath(const string &path, Format format = FORMAT_JSON) const;
+    
+    /* FORMAT_BINARY if path has BINARY_EXTENSION, otherwise FORMAT_JSON */
+    static Format formatForPath(const string &path);
+    /* read only the name of the document at path, skipping the rest; false if
+       it can't be read */
+    static bool loadName(const string &path, vector<vector<GLvertex2f>> &name);
     
-    void recreate(void (^createNode)(const Node &node),
-                  void (^createConnection)(const Connection &connection),
-                  void (^createFreedraw)(const Freedraw &freedraw));
+    void recreate(const std::function<void (const Node &node)> &createNode,
+                  const std::function<void (const Connection &connection)> &createConnection,
+                  const std::function<void (const Freedraw &freedraw)> &createFreedraw);
     
     void addNode(const Node &node);
     void updateNode(const string &uuid, const Node &update);
@@ -109,6 +125,31 @@ public:
     void setName(const std::vector<std::vector<GLvertex2f>>& name);
     const std::vector<std::vector<GLvertex2f>>& name();
     
+    /* what was added, updated or removed, to bring another copy of a
+       document up to date without copying the rest of it */
+    struct Changes
+    {
+        map<string, Node> nodes;
+        set<string> removedNodes;
+        map<string, Connection> connections;
+        set<string> removedConnections;
+        map<string, Freedraw> freedraws;
+        set<string> removedFreedraws;
+        bool hasName = false;
+        std::vector<std::vector<GLvertex2f>> name;
+        
+        bool empty() const;
+        /* fold in changes made after these */
+        void merge(Changes &&later);
+    };
+    
+    /* true if anything was added, updated or removed since the last
+       takeChanges() (loading doesn't count) */
+    bool isDirty() const;
+    /* copies of whatever changed since the last call */
+    Changes takeChanges();
+    void applyChanges(const Changes &changes);
+    
 //    static Node makeNode(AGAudioNode *);
 //    static Node makeNode(AGControlNode *);
 //    static Connection makeConnection(AGConnection *);
@@ -117,11 +158,22 @@ public:
     static bool existsForTitle(const string &title);
     
 private:
+    friend class AGDocumentBinary;
+    
+    bool _loadJSON(FILE *file, const string &path);
+    bool _saveJSON(FILE *file) const;
+    
     string m_title;
     std::vector<std::vector<GLvertex2f>> m_name;
     map<string, Node> m_nodes;
     map<string, Connection> m_connections;
     map<string, Freedraw> m_freedraws;
+    
+    // uuids of whatever changed since takeChanges()
+    set<string> m_dirtyNodes;
+    set<string> m_dirtyConnections;
+    set<string> m_dirtyFreedraws;
+    bool m_dirtyName;
 };
 
 
@@ -11,10 +11,20 @@
 #include "AGNode.h"
 #include "AGConnection.h"
 #include "AGControl.h"
+#include "AGDocumentBinary.h"
+#include "AGJSON.h"
 
 #include "spstl.h"
+#ifndef AG_HEADLESS
 #include "NSString+STLString.h"
+#endif // AG_HEADLESS
 
+#include <stdio.h>
+#include <unistd.h>
+
+
+// document paths come from Foundation; headless builds provide their own
+#ifndef AG_HEADLESS
 
 static NSString *filenameForTitle(string title)
 {
@@ -23,6 +33,8 @@ static NSString *filenameForTitle(string title)
     return [[basePath stringByAppendingPathComponent:[NSString stringWithCString:title.c_str() encoding:NSUTF8StringEncoding]] stringByAppendingPathExtension:@"json"];
 }
 
+#endif // AG_HEADLESS
+
 
 AGDocument::ParamValue::ParamValue(const AGParamValue &value)
 {
@@ -65,7 +77,7 @@ AGDocument::ParamValue::operator AGParamValue() const
 
 
 AGDocument::AGDocument() :
-m_title("") { }
+m_title(""), m_dirtyName(false) { }
 
 AGDocument::~AGDocument()
 { }
@@ -73,41 +85,49 @@ AGDocument::~AGDocument()
 void AGDocument::addNode(const Node &node)
 {
     m_nodes[node.uuid] = node;
+    m_dirtyNodes.insert(node.uuid);
 }
 
 void AGDocument::updateNode(const string &uuid, const Node &update)
 {
     m_nodes[uuid] = update;
+    m_dirtyNodes.insert(uuid);
 }
 
 void AGDocument::removeNode(const string &uuid)
 {
     m_nodes.erase(uuid);
+    m_dirtyNodes.insert(uuid);
 }
 
 void AGDocument::addConnection(const Connection &connection)
 {
     m_connections[connection.uuid] = connection;
+    m_dirtyConnections.insert(connection.uuid);
 }
 
 void AGDocument::removeConnection(const string &uuid)
 {
     m_connections.erase(uuid);
+    m_dirtyConnections.insert(uuid);
 }
 
 void AGDocument::addFreedraw(const Freedraw &freedraw)
 {
     m_freedraws[freedraw.uuid] = freedraw;
+    m_dirtyFreedraws.insert(freedraw.uuid);
 }
 
 void AGDocument::updateFreedraw(const string &uuid, const Freedraw &update)
 {
     m_freedraws[uuid] = update;
+    m_dirtyFreedraws.insert(uuid);
 }
 
 void AGDocument::removeFreedraw(const string &uuid)
 {
     m_freedraws.erase(uuid);
+    m_dirtyFreedraws.insert(uuid);
 }
 
 void AGDocument::create()
@@ -118,6 +138,7 @@ void AGDocument::create()
 void AGDocument::setName(const std::vector<std::vector<GLvertex2f>>& name)
 {
     m_name = name;
+    m_dirtyName = true;
 }
 
 const std::vector<std::vector<GLvertex2f>>& AGDocument::name()
@@ -125,6 +146,112 @@ const std::vector<std::vector<GLvertex2f>>& AGDocument::name()
     return m_name;
 }
 
+//------------------------------------------------------------------------------
+// ### AGDocument::Changes ###
+//------------------------------------------------------------------------------
+#pragma mark - AGDocument::Changes
+
+// changes to one kind of entity: an update replaces an earlier removal, and a
+// removal an earlier update
+template<class T>
+static void _mergeChanges(map<string, T> &updated, set<string> &removed,
+                          map<string, T> &&laterUpdated, set<string> &&laterRemoved)
+{
+    for(auto &kv : laterUpdated)
+    {
+        removed.erase(kv.first);
+        updated[kv.first] = std::move(kv.second);
+    }
+    
+    for(auto &uuid : laterRemoved)
+    {
+        updated.erase(uuid);
+        removed.insert(uuid);
+    }
+}
+
+// copy each dirty uuid's entity, or note its removal if it's gone
+template<class T>
+static void _takeChanges(const map<string, T> &entities, set<string> &dirty,
+                         map<string, T> &updated, set<string> &removed)
+{
+    for(auto &uuid : dirty)
+    {
+        auto entity = entities.find(uuid);
+        if(entity != entities.end())
+            updated.insert(*entity);
+        else
+            removed.insert(uuid);
+    }
+    
+    dirty.clear();
+}
+
+template<class T>
+static void _applyChanges(map<string, T> &entities, const map<string, T> &updated, const set<string> &removed)
+{
+    for(auto &uuid : removed)
+        entities.erase(uuid);
+    for(auto &kv : updated)
+        entities[kv.first] = kv.second;
+}
+
+bool AGDocument::Changes::empty() const
+{
+    return nodes.empty() && removedNodes.empty() &&
+        connections.empty() && removedConnections.empty() &&
+        freedraws.empty() && removedFreedraws.empty() &&
+        !hasName;
+}
+
+void AGDocument::Changes::merge(Changes &&later)
+{
+    _mergeChanges(nodes, removedNodes, std::move(later.nodes), std::move(later.removedNodes));
+    _mergeChanges(connections, removedConnections, std::move(later.connections), std::move(later.removedConnections));
+    _mergeChanges(freedraws, removedFreedraws, std::move(later.freedraws), std::move(later.removedFreedraws));
+    
+    if(later.hasName)
+    {
+        hasName = true;
+        name = std::move(later.name);
+    }
+}
+
+bool AGDocument::isDirty() const
+{
+    return m_dirtyNodes.size() || m_dirtyConnections.size() || m_dirtyFreedraws.size() || m_dirtyName;
+}
+
+AGDocument::Changes AGDocument::takeChanges()
+{
+    Changes changes;
+    
+    _takeChanges(m_nodes, m_dirtyNodes, changes.nodes, changes.removedNodes);
+    _takeChanges(m_connections, m_dirtyConnections, changes.connections, changes.removedConnections);
+    _takeChanges(m_freedraws, m_dirtyFreedraws, changes.freedraws, changes.removedFreedraws);
+    
+    if(m_dirtyName)
+    {
+        changes.hasName = true;
+        changes.name = m_name;
+        m_dirtyName = false;
+    }
+    
+    return changes;
+}
+
+void AGDocument::applyChanges(const Changes &changes)
+{
+    _applyChanges(m_nodes, changes.nodes, changes.removedNodes);
+    _applyChanges(m_connections, changes.connections, changes.removedConnections);
+    _applyChanges(m_freedraws, changes.freedraws, changes.removedFreedraws);
+    
+    if(changes.hasName)
+        m_name = changes.name;
+}
+
+#ifndef AG_HEADLESS
+
 void AGDocument::load(const string &title)
 {
     m_title = title;
@@ -133,247 +260,455 @@ void AGDocument::load(const string &title)
     loadFromPath([filename stlString]);
 }
 
-void AGDocument::loadFromPath(const string &path)
+void AGDocument::save() const
+{
+    NSString *filepath = filenameForTitle(m_title);
+    saveToPath([filepath stlString]);
+}
+
+void AGDocument::saveTo(const string &title)
 {
-    NSData *data = [NSData dataWithContentsOfFile:[NSString stringWithSTLString:path]];
-    NSDictionary *doc = [NSJSONSerialization JSONObjectWithData:data options:0 error:NULL];
+    m_title = title;
+    save();
+}
+
+#endif // AG_HEADLESS
+
+// a connection as listed in a node's inbound or outbound array, whose
+// destination port may be named; resolved to a port number once the whole
+// document is read, as the destination node may come later in it
+struct AGDocumentPendingConnection
+{
+    AGDocument::Connection connection;
+    string dstPortName;
+};
+
+static void _loadConnections(AGJSONReader &reader, const string &uuid, bool inbound,
+                             vector<AGDocumentPendingConnection> &connections)
+{
+    string key;
+    reader.beginArray();
+    while(reader.nextElement())
+    {
+        AGDocumentPendingConnection pending;
+        AGDocument::Connection &c = pending.connection;
+        c.srcPort = 0;
+        c.dstPort = 0;
+        if(inbound)
+            c.dstUuid = uuid;
+        else
+            c.srcUuid = uuid;
+        
+        reader.beginObject();
+        while(reader.nextKey(key))
+        {
+            if(key == "uuid") c.uuid = reader.stringValue();
+            else if(key == "src" && inbound) c.srcUuid = reader.stringValue();
+            else if(key == "dst" && !inbound) c.dstUuid = reader.stringValue();
+            else if(key == "srcPort") c.srcPort = reader.intValue();
+            else if(key == "dstPort")
+            {
+                if(reader.peek() == AGJSONReader::STRING)
+                    reader.readString(pending.dstPortName);
+                else
+                    c.dstPort = reader.intValue();
+            }
+            else reader.skip();
+        }
+        
+        connections.push_back(pending);
+    }
+}
+
+static void _loadParams(AGJSONReader &reader, map<string, AGDocument::ParamValue> &params)
+{
+    typedef AGDocument::ParamValue ParamValue;
     
-    if(doc)
+    string name, key;
+    reader.beginObject();
+    while(reader.nextKey(name))
     {
-        for(NSString *key in doc)
+        ParamValue pv;
+        string type;
+        // the value, as whichever type it turns out to be
+        double number = 0;
+        
+        reader.beginObject();
+        while(reader.nextKey(key))
         {
-            NSDictionary *dict = doc[key];
-            NSString *object = dict[@"object"];
-            
-            if([object isEqualToString:@"node"])
+            if(key == "type") type = reader.stringValue();
+            else if(key == "value")
             {
-                Node n;
-                n.uuid = [key stlString];
-                n._class = (AGDocument::Node::Class) [dict[@"class"] intValue];
-                n.type = [dict[@"type"] stlString];
-                n.x = [dict[@"x"] floatValue]; n.y = [dict[@"y"] floatValue]; n.z = [dict[@"z"] floatValue];
-                
-                if([dict objectForKey:@"params"])
-                {
-                    for(NSString *param in dict[@"params"])
-                    {
-                        ParamValue pv;
-                        
-                        NSDictionary *value = dict[@"params"][param];
-                        if([value[@"type"] isEqualToString:@"bit"]) { pv.type = ParamValue::BIT; pv.i = [value[@"value"] intValue]?1:0; }
-                        else if([value[@"type"] isEqualToString:@"int"]) { pv.type = ParamValue::INT; pv.i = [value[@"value"] intValue]; }
-                        else if([value[@"type"] isEqualToString:@"float"]) { pv.type = ParamValue::FLOAT; pv.f = [value[@"value"] floatValue]; }
-                        else if([value[@"type"] isEqualToString:@"string"]) { pv.type = ParamValue::STRING; pv.s = [value[@"value"] UTF8String]; }
-                        else if([value[@"type"] isEqualToString:@"array_float"])
-                        {
-                            pv.type = ParamValue::FLOAT_ARRAY;
-                            for(id v in value[@"value"])
-                                pv.fa.push_back([v floatValue]);
-                        }
-                        else assert(0); // unhandled
-                        
-                        n.params[[param UTF8String]] = pv;
-                    }
-                }
-                
-                if([dict objectForKey:@"inbound"])
-                {
-                    for(NSDictionary *conn in dict[@"inbound"])
-                    {
-                        Connection c;
-                        
-                        c.uuid = [conn[@"uuid"] stlString];
-                        c.srcUuid = [conn[@"src"] stlString];
-                        if([conn objectForKey:@"srcPort"])
-                            c.srcPort = [[conn objectForKey:@"srcPort"] intValue];
-                        else
-                            c.srcPort = 0;
-                        c.dstUuid = n.uuid;
-                        if([conn[@"dstPort"] isKindOfClass:[NSString class]])
-                        {
-                            int dstPort = AGNodeManager::portNumberForPortName(n._class, n.type, [conn[@"dstPort"] stlString]);
-                            if(dstPort == -1)
-                                continue;
-                            c.dstPort = dstPort;
-                        }
-                        else
-                            c.dstPort = [conn[@"dstPort"] intValue];
-                        
-                        m_connections[c.uuid] = c;
-                    }
-                }
-                
-                if([dict objectForKey:@"outbound"])
+                switch(reader.peek())
                 {
-                    for(NSDictionary *conn in dict[@"outbound"])
-                    {
-                        Connection c;
-                        
-                        NSDictionary *dstNode = doc[conn[@"dst"]];
-                        AGDocument::Node::Class dstClass = (AGDocument::Node::Class) [dstNode[@"class"] intValue];
-                        string dstType = [dstNode[@"type"] stlString];
-                        
-                        c.uuid = [conn[@"uuid"] stlString];
-                        c.srcUuid = n.uuid;
-                        if([conn objectForKey:@"srcPort"])
-                            c.srcPort = [[conn objectForKey:@"srcPort"] intValue];
-                        else
-                            c.srcPort = 0;
-                        c.dstUuid = [conn[@"dst"] stlString];
-                        if([conn[@"dstPort"] isKindOfClass:[NSString class]])
-                        {
-                            int dstPort = AGNodeManager::portNumberForPortName(dstClass, dstType, [conn[@"dstPort"] stlString]);
-                            if(dstPort == -1)
-                                continue;
-                            c.dstPort = dstPort;
-                        }
-                        else
-                            c.dstPort = [conn[@"dstPort"] intValue];
-                        
-                        m_connections[c.uuid] = c;
-                    }
+                    case AGJSONReader::ARRAY:
+                        reader.beginArray();
+                        while(reader.nextElement())
+                            pv.fa.push_back(reader.floatValue());
+                        break;
+                    case AGJSONReader::STRING:
+                        reader.readString(pv.s);
+                        number = atof(pv.s.c_str());
+                        break;
+                    default:
+                        number = reader.floatValue();
+                        break;
                 }
-                
-                m_nodes[n.uuid] = n;
             }
-            else if([object isEqualToString:@"connection"])
-            {
-                Connection c;
-                
-                c.uuid = [key stlString];
-                c.srcUuid = [dict[@"src"] stlString];
-                c.dstUuid = [dict[@"dst"] stlString];
-                c.dstPort = [dict[@"dstPort"] intValue];
-                
-                m_connections[c.uuid] = c;
-            }
-            else if([object isEqualToString:@"freedraw"])
+            else reader.skip();
+        }
+        
+        if(type == "bit") { pv.type = ParamValue::BIT; pv.i = ((int) number)?1:0; }
+        else if(type == "int") { pv.type = ParamValue::INT; pv.i = (int) number; }
+        else if(type == "float") { pv.type = ParamValue::FLOAT; pv.f = (float) number; }
+        else if(type == "string") { pv.type = ParamValue::STRING; }
+        else if(type == "array_float") { pv.type = ParamValue::FLOAT_ARRAY; }
+        else assert(0); // unhandled
+        
+        params[name] = pv;
+    }
+}
+
+// the name's figures, as arrays of alternating x and y
+static void _loadFigures(AGJSONReader &reader, vector<vector<GLvertex2f>> &figures)
+{
+    reader.beginArray();
+    while(reader.nextElement())
+    {
+        figures.push_back(vector<GLvertex2f>());
+        vector<GLvertex2f> &figure = figures.back();
+        GLvertex2f pt;
+        bool odd = false;
+        reader.beginArray();
+        while(reader.nextElement())
+        {
+            if(!odd) pt.x = reader.floatValue();
+            else { pt.y = reader.floatValue(); figure.push_back(pt); }
+            odd = !odd;
+        }
+    }
+}
+
+const char *const AGDocument::JSON_EXTENSION = "json";
+const char *const AGDocument::BINARY_EXTENSION = "agpatch";
+
+AGDocument::Format AGDocument::formatForPath(const string &path)
+{
+    size_t dot = path.rfind('.');
+    if(dot != string::npos && path.compare(dot+1, string::npos, BINARY_EXTENSION) == 0)
+        return FORMAT_BINARY;
+    return FORMAT_JSON;
+}
+
+bool AGDocument::loadName(const string &path, vector<vector<GLvertex2f>> &name)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if(file == NULL)
+        return false;
+    
+    char magic[4];
+    size_t size = fread(magic, 1, sizeof(magic), file);
+    if(AGDocumentBinary::isBinary(magic, size))
+    {
+        fclose(file);
+        return AGDocumentBinary::readName(path, name);
+    }
+    
+    rewind(file);
+    
+    // skip everything but the name's object
+    AGJSONReader reader(file);
+    vector<vector<GLvertex2f>> figures;
+    bool found = false;
+    string uuid, key, object;
+    reader.beginObject();
+    while(!found && reader.nextKey(uuid))
+    {
+        object.clear();
+        figures.clear();
+        reader.beginObject();
+        while(reader.nextKey(key))
+        {
+            if(key == "object") object = reader.stringValue();
+            else if(key == "figures") _loadFigures(reader, figures);
+            else reader.skip();
+        }
+        
+        found = object == "name";
+    }
+    
+    fclose(file);
+    
+    if(!reader.ok())
+        return false;
+    if(found)
+        name.swap(figures);
+    else
+        name.clear();
+    return true;
+}
+
+void AGDocument::loadFromPath(const string &path)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if(file == NULL)
+    {
+        fprintf(stderr, "AGDocument::load: error: unable to open '%s'\n", path.c_str());
+        return;
+    }
+    
+    // whatever the extension, binary documents are known by their magic
+    char magic[4];
+    size_t size = fread(magic, 1, sizeof(magic), file);
+    if(AGDocumentBinary::isBinary(magic, size))
+    {
+        fclose(file);
+        if(!AGDocumentBinary::read(*this, path))
+            fprintf(stderr, "AGDocument::load: error: unable to read '%s'\n", path.c_str());
+        return;
+    }
+    
+    rewind(file);
+    _loadJSON(file, path);
+    fclose(file);
+}
+
+bool AGDocument::_loadJSON(FILE *file, const string &path)
+{
+    AGJSONReader reader(file);
+    
+    // nothing is kept unless the whole file reads
+    map<string, Node> nodes;
+    map<string, Connection> connections;
+    map<string, Freedraw> freedraws;
+    vector<vector<GLvertex2f>> name;
+    bool hasName = false;
+    vector<AGDocumentPendingConnection> pending;
+    
+    string uuid, key, object;
+    reader.beginObject();
+    while(reader.nextKey(uuid))
+    {
+        // members come in any order, so read them all and then see what
+        // kind of object they made
+        Node n;
+        n.uuid = uuid;
+        n._class = Node::AUDIO;
+        n.x = n.y = n.z = 0;
+        Connection c;
+        c.uuid = uuid;
+        c.srcPort = 0;
+        c.dstPort = 0;
+        Freedraw f;
+        vector<vector<GLvertex2f>> figures;
+        bool hasFigures = false;
+        object.clear();
+        size_t numPending = pending.size();
+        
+        reader.beginObject();
+        while(reader.nextKey(key))
+        {
+            if(key == "object") object = reader.stringValue();
+            else if(key == "class") n._class = (Node::Class) reader.intValue();
+            else if(key == "type") n.type = reader.stringValue();
+            else if(key == "x") n.x = reader.floatValue();
+            else if(key == "y") n.y = reader.floatValue();
+            else if(key == "z") n.z = reader.floatValue();
+            else if(key == "params") _loadParams(reader, n.params);
+            else if(key == "inbound") _loadConnections(reader, uuid, true, pending);
+            else if(key == "outbound") _loadConnections(reader, uuid, false, pending);
+            else if(key == "src") c.srcUuid = reader.stringValue();
+            else if(key == "dst") c.dstUuid = reader.stringValue();
+            else if(key == "dstPort") c.dstPort = reader.intValue();
+            else if(key == "points")
             {
-                Freedraw f;
-                
-                f.uuid = [key stlString];
-                f.x = [dict[@"x"] floatValue]; f.y = [dict[@"y"] floatValue]; f.z = [dict[@"z"] floatValue];
-                f.points.reserve([dict[@"points"] count]);
-                for(NSNumber *num in dict[@"points"])
-                    f.points.push_back([num floatValue]);
-                
-                m_freedraws[f.uuid] = f;
+                reader.beginArray();
+                while(reader.nextElement())
+                    f.points.push_back(reader.floatValue());
             }
-            else if([object isEqualToString:@"name"])
+            else if(key == "figures")
             {
-                if(dict[@"figures"])
-                {
-                    m_name.clear();
-                    NSArray* figures = dict[@"figures"];
-                    NSUInteger numFigures = figures.count;
-                    m_name.reserve(numFigures);
-                    for(int i = 0; i < numFigures; i++)
-                    {
-                        NSArray *figure = figures[i];
-                        m_name.push_back(vector<GLvertex2f>());
-                        NSUInteger numPts = figure.count;
-                        m_name[i].reserve(numPts/2);
-                        for(NSUInteger j = 0; j < numPts && j+1 < numPts; j += 2)
-                        {
-                            float x = [figure[j] floatValue];
-                            float y = [figure[j+1] floatValue];
-                            m_name[i].push_back(GLvertex2f(x, y));
-                        }
-                    }
-                }
+                hasFigures = true;
+                _loadFigures(reader, figures);
             }
-            else
+            else reader.skip();
+        }
+        
+        if(object == "node")
+        {
+            nodes[uuid] = n;
+        }
+        else if(object == "connection")
+        {
+            connections[uuid] = c;
+        }
+        else if(object == "freedraw")
+        {
+            f.uuid = uuid;
+            f.x = n.x; f.y = n.y; f.z = n.z;
+            freedraws[uuid] = f;
+        }
+        else if(object == "name")
+        {
+            if(hasFigures)
             {
-                NSLog(@"AGDocument::load: error: unhandled object '%@'", object);
+                name.swap(figures);
+                hasName = true;
             }
         }
+        else if(reader.ok())
+        {
+            fprintf(stderr, "AGDocument::load: error: unhandled object '%s'\n", object.c_str());
+        }
+        
+        // only nodes list connections
+        if(object != "node")
+            pending.resize(numPending);
     }
+    
+    if(!reader.ok() || !reader.atEnd())
+    {
+        fprintf(stderr, "AGDocument::load: error: unable to read '%s' (%s)\n", path.c_str(),
+                reader.ok() ? "trailing characters" : reader.error().c_str());
+        return false;
+    }
+    
+    for(auto &kv : connections)
+        m_connections[kv.first] = std::move(kv.second);
+    // those listed by nodes (which know their source port) win over the
+    // same connection saved on its own
+    for(AGDocumentPendingConnection &p : pending)
+    {
+        Connection &c = p.connection;
+        if(p.dstPortName.size())
+        {
+            auto dstNode = nodes.find(c.dstUuid);
+            Node::Class dstClass = dstNode != nodes.end() ? dstNode->second._class : Node::AUDIO;
+            const string &dstType = dstNode != nodes.end() ? dstNode->second.type : string();
+            int dstPort = AGNodeManager::portNumberForPortName(dstClass, dstType, p.dstPortName);
+            if(dstPort == -1)
+                continue;
+            c.dstPort = dstPort;
+        }
+        
+        m_connections[c.uuid] = c;
+    }
+    
+    for(auto &kv : nodes)
+        m_nodes[kv.first] = std::move(kv.second);
+    for(auto &kv : freedraws)
+        m_freedraws[kv.first] = std::move(kv.second);
+    if(hasName)
+        m_name.swap(name);
+    
+    return true;
 }
 
-void AGDocument::save() const
-{
-    NSString *filepath = filenameForTitle(m_title);
-    saveToPath([filepath stlString]);
-}
-
-void AGDocument::saveTo(const string &title)
+void AGDocument::saveToPath(const std::string &path, Format format) const
 {
-    m_title = title;
-    save();
+    // written alongside and moved into place, so a failed save leaves the
+    // last one intact
+    string tmpPath = path + ".tmp";
+    FILE *file = fopen(tmpPath.c_str(), "wb");
+    if(file == NULL)
+    {
+        fprintf(stderr, "AGDocument::save: error: unable to write '%s'\n", tmpPath.c_str());
+        return;
+    }
+    
+    bool written = format == FORMAT_BINARY ? AGDocumentBinary::write(*this, file) : _saveJSON(file);
+    written = fclose(file) == 0 && written;
+    if(!written || rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        fprintf(stderr, "AGDocument::save: error: unable to write '%s'\n", path.c_str());
+        unlink(tmpPath.c_str());
+    }
 }
 
-void AGDocument::saveToPath(const std::string &path) const
+bool AGDocument::_saveJSON(FILE *file) const
 {
-    NSMutableDictionary *doc = [NSMutableDictionary new];
+    AGJSONWriter writer(file);
+    writer.beginObject();
     
     for(const pair<const string, Node> &val : m_nodes)
     {
         const string &uuid = val.first;
         const Node &node = val.second;
         
-        NSMutableDictionary *params = [NSMutableDictionary new];
+        writer.key(uuid);
+        writer.beginObject();
+        writer.key("object"); writer.value("node");
+        writer.key("class"); writer.value((int) node._class);
+        writer.key("type"); writer.value(node.type);
+        writer.key("x"); writer.value(node.x);
+        writer.key("y"); writer.value(node.y);
+        writer.key("z"); writer.value(node.z);
+        
+        writer.key("params");
+        writer.beginObject();
         for(const pair<const string, ParamValue> &param : node.params)
         {
-            NSString *serialType = nil;
-            id serialValue = nil;
+            if(param.second.type == ParamValue::NONE)
+            {
+                assert(0);
+                continue;
+            }
             
+            writer.key(param.first);
+            writer.beginObject();
             switch(param.second.type)
             {
-                case ParamValue::BIT: serialValue = @(param.second.i?1:0); serialType = @"bit"; break;
-                case ParamValue::INT: serialValue = @(param.second.i); serialType = @"int"; break;
-                case ParamValue::FLOAT: serialValue = @(param.second.f); serialType = @"float"; break;
-                case ParamValue::STRING: serialValue = [NSString stringWithSTLString:param.second.s]; serialType = @"string"; break;
+                case ParamValue::BIT: writer.key("type"); writer.value("bit"); writer.key("value"); writer.value(param.second.i?1:0); break;
+                case ParamValue::INT: writer.key("type"); writer.value("int"); writer.key("value"); writer.value(param.second.i); break;
+                case ParamValue::FLOAT: writer.key("type"); writer.value("float"); writer.key("value"); writer.value(param.second.f); break;
+                case ParamValue::STRING: writer.key("type"); writer.value("string"); writer.key("value"); writer.value(param.second.s); break;
                 case ParamValue::FLOAT_ARRAY:
-                    serialType = @"array_float";
-                    serialValue = [NSMutableArray arrayWithCapacity:param.second.fa.size()];
+                    writer.key("type"); writer.value("array_float");
+                    writer.key("value");
+                    writer.beginArray();
                     for(const float &f : param.second.fa)
-                    {
-                        [serialValue addObject:@(f)];
-                    }
+                        writer.value(f);
+                    writer.endArray();
                     break;
                 case ParamValue::NONE:
-                    assert(0);
                     break;
             }
-            
-            [params setObject:@{ @"type": serialType, @"value": serialValue }
-                       forKey:[NSString stringWithSTLString:param.first]];
-        };
+            writer.endObject();
+        }
+        writer.endObject();
         
-        NSMutableArray *inbound = [NSMutableArray arrayWithCapacity:node.inbound.size()];
+        writer.key("inbound");
+        writer.beginArray();
         for(const Connection &conn : node.inbound)
         {
             const string &dstPort = AGNodeManager::portNameForPortNumber(node._class, node.type, conn.dstPort);
             assert(dstPort.size() > 0);
-            [inbound addObject:@{ @"uuid": [NSString stringWithSTLString:conn.uuid],
-                                  @"src": [NSString stringWithSTLString:conn.srcUuid],
-                                  @"srcPort": @(conn.srcPort),
-                                  @"dstPort": [NSString stringWithSTLString:dstPort],
-                                  }];
+            writer.beginObject();
+            writer.key("uuid"); writer.value(conn.uuid);
+            writer.key("src"); writer.value(conn.srcUuid);
+            writer.key("srcPort"); writer.value(conn.srcPort);
+            writer.key("dstPort"); writer.value(dstPort);
+            writer.endObject();
         }
-    
-        NSMutableArray *outbound = [NSMutableArray arrayWithCapacity:node.outbound.size()];
+        writer.endArray();
+        
+        writer.key("outbound");
+        writer.beginArray();
         for(const Connection &conn : node.outbound)
         {
             const Node &dstNode = m_nodes.at(conn.dstUuid);
             const string &dstPort = AGNodeManager::portNameForPortNumber(dstNode._class, dstNode.type, conn.dstPort);
             assert(dstPort.size() > 0);
-            [outbound addObject:@{ @"uuid": [NSString stringWithSTLString:conn.uuid],
-                                   @"dst": [NSString stringWithSTLString:conn.dstUuid],
-                                   @"srcPort": @(conn.srcPort),
-                                   @"dstPort": [NSString stringWithSTLString:dstPort],
-                                   }];
+            writer.beginObject();
+            writer.key("uuid"); writer.value(conn.uuid);
+            writer.key("dst"); writer.value(conn.dstUuid);
+            writer.key("srcPort"); writer.value(conn.srcPort);
+            writer.key("dstPort"); writer.value(dstPort);
+            writer.endObject();
         }
+        writer.endArray();
         
-        [doc setObject:@{ @"object": @"node",
-                          @"class": @((int) node._class),
-                          @"type": [NSString stringWithSTLString:node.type],
-                          @"x": @(node.x), @"y": @(node.y), @"z": @(node.z),
-                          @"params": params,
-                          @"inbound": inbound,
-                          @"outbound": outbound
-                          }
-                forKey:[NSString stringWithSTLString:uuid]];
+        writer.endObject();
     }
     
     for(const pair<const string, Connection> &val : m_connections)
@@ -381,56 +716,60 @@ void AGDocument::saveToPath(const std::string &path) const
         const string &uuid = val.first;
         const Connection &conn = val.second;
         
-        [doc setObject:@{ @"object": @"connection",
-                          @"src": [NSString stringWithSTLString:conn.srcUuid],
-                          @"dst": [NSString stringWithSTLString:conn.dstUuid],
-                          @"dstPort": [NSString stringWithFormat:@"%i", conn.dstPort],
-                          }
-                forKey:[NSString stringWithSTLString:uuid]];
-    };
+        writer.key(uuid);
+        writer.beginObject();
+        writer.key("object"); writer.value("connection");
+        writer.key("src"); writer.value(conn.srcUuid);
+        writer.key("dst"); writer.value(conn.dstUuid);
+        writer.key("dstPort"); writer.value(std::to_string(conn.dstPort));
+        writer.endObject();
+    }
     
     for(const pair<const string, Freedraw> &val : m_freedraws)
     {
         const string &uuid = val.first;
         const Freedraw &fd = val.second;
         
-        NSMutableArray *points = [NSMutableArray arrayWithCapacity:fd.points.size()];
+        writer.key(uuid);
+        writer.beginObject();
+        writer.key("object"); writer.value("freedraw");
+        writer.key("x"); writer.value(fd.x);
+        writer.key("y"); writer.value(fd.y);
+        writer.key("z"); writer.value(fd.z);
+        writer.key("points");
+        writer.beginArray();
         for(const float &f : fd.points)
-            [points addObject:@(f)];
-        
-        [doc setObject:@{ @"object": @"freedraw",
-                          @"x": @(fd.x), @"y": @(fd.y), @"z": @(fd.z),
-                          @"points": points,
-                          }
-                forKey:[NSString stringWithSTLString:uuid]];
-    };
+            writer.value(f);
+        writer.endArray();
+        writer.endObject();
+    }
     
-    NSMutableArray *name = [NSMutableArray arrayWithCapacity:m_name.size()];
-    for(int i = 0; i < m_name.size(); i++)
+    writer.key("name");
+    writer.beginObject();
+    writer.key("object"); writer.value("name");
+    writer.key("figures");
+    writer.beginArray();
+    for(const vector<GLvertex2f> &figure : m_name)
     {
-        NSMutableArray *figure = [NSMutableArray arrayWithCapacity:m_name[i].size()*2];
-        for(int j = 0; j < m_name[i].size(); j++)
+        writer.beginArray();
+        for(const GLvertex2f &pt : figure)
         {
-            [figure addObject:@(m_name[i][j].x)];
-            [figure addObject:@(m_name[i][j].y)];
+            writer.value(pt.x);
+            writer.value(pt.y);
         }
-        [name addObject:figure];
+        writer.endArray();
     }
+    writer.endArray();
+    writer.endObject();
     
-    [doc setObject:@{ @"object": @"name", @"figures": name }
-            forKey:@"name"];
+    writer.endObject();
     
-    NSData *data = [NSJSONSerialization dataWithJSONObject:doc
-                                                   options:NSJSONWritingPrettyPrinted
-                                                     error:NULL];
-    NSString *filepath = [NSString stringWithSTLString:path];
-    NSLog(@"Saving to %@", filepath);
-    [data writeToFile:filepath atomically:YES];
+    return writer.flush();
 }
 
-void AGDocument::recreate(void (^createNode)(const Node &node),
-                          void (^createConnection)(const Connection &connection),
-                          void (^createFreedraw)(const Freedraw &freedraw))
+void AGDocument::recreate(const std::function<void (const Node &node)> &createNode,
+                          const std::function<void (const Connection &connection)> &createConnection,
+                          const std::function<void (const Freedraw &freedraw)> &createFreedraw)
 {
     for(const pair<const string, Node> &kv : m_nodes)
         createNode(kv.second);
@@ -441,12 +780,16 @@ void AGDocument::recreate(void (^createNode)(const Node &node),
 }
 
 
+#ifndef AG_HEADLESS
+
 bool AGDocument::existsForTitle(const string &title)
 {
     NSString *filename = filenameForTitle(title);
     return [[NSFileManager defaultManager] fileExistsAtPath:filename isDirectory:NULL];
 }
 
+#endif // AG_HEADLESS
+
 void AGDocument::Node::saveParam(const string &name, int p)
 {
     params[name] = AGDocument::ParamValue(p);
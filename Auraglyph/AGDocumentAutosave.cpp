@@ -0,0 +1,139 @@
+//
+//  AGDocumentAutosave.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGDocumentAutosave.h"
+#include "Thread.h"
+#include "AGDef.h"
+
+#include <unistd.h>
+
+
+constexpr double AGDocumentAutosave::QUIET_SECONDS;
+constexpr double AGDocumentAutosave::MAX_DELAY_SECONDS;
+
+AGDocumentAutosave::AGDocumentAutosave() :
+m_go(false), m_numSubmits(0), m_numWrites(0), m_lastWriteSeconds(0)
+{ }
+
+AGDocumentAutosave::~AGDocumentAutosave()
+{
+    stop();
+}
+
+void AGDocumentAutosave::start(const std::string &path, const AGDocument &doc, AGDocument::Format format)
+{
+    stop();
+
+    m_path = path;
+    m_format = format;
+    m_document = doc;
+
+    m_go = true;
+    m_thread = new Thread;
+    m_thread->start([this](){
+        while(m_go.load(std::memory_order_acquire))
+        {
+            usleep(POLL_MS*1000);
+
+            if(_isDue())
+                _writePending();
+        }
+    });
+}
+
+void AGDocumentAutosave::stop()
+{
+    if(m_thread == NULL)
+        return;
+
+    m_go.store(false, std::memory_order_release);
+    m_thread->wait();
+    SAFE_DELETE(m_thread);
+
+    // whatever was submitted since the worker last wrote
+    _writePending();
+
+    m_document = AGDocument();
+}
+
+void AGDocumentAutosave::submit(AGDocument::Changes &&changes)
+{
+    if(changes.empty())
+        return;
+
+    Clock::time_point now = Clock::now();
+
+    m_pendingMutex.lock();
+
+    if(!m_hasPending)
+    {
+        m_hasPending = true;
+        m_firstSubmit = now;
+    }
+    m_lastSubmit = now;
+    m_pending.merge(std::move(changes));
+
+    m_pendingMutex.unlock();
+
+    m_numSubmits.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AGDocumentAutosave::saveSoon()
+{
+    m_pendingMutex.lock();
+    m_saveSoon = true;
+    m_pendingMutex.unlock();
+}
+
+void AGDocumentAutosave::flush()
+{
+    _writePending();
+}
+
+bool AGDocumentAutosave::_isDue()
+{
+    using namespace std::chrono;
+
+    Clock::time_point now = Clock::now();
+
+    Mutex::Scope scope = m_pendingMutex.inScope();
+
+    if(!m_hasPending)
+        return false;
+
+    return m_saveSoon ||
+        duration<double>(now-m_lastSubmit).count() >= QUIET_SECONDS ||
+        duration<double>(now-m_firstSubmit).count() >= MAX_DELAY_SECONDS;
+}
+
+void AGDocumentAutosave::_writePending()
+{
+    using namespace std::chrono;
+
+    // one write at a time, whichever thread it's on
+    Mutex::Scope writeScope = m_writeMutex.inScope();
+
+    // take what's queued, so the main thread never waits on the write
+    AGDocument::Changes changes;
+    m_pendingMutex.lock();
+    std::swap(changes, m_pending);
+    m_hasPending = false;
+    m_saveSoon = false;
+    m_pendingMutex.unlock();
+
+    if(changes.empty())
+        return;
+
+    Clock::time_point start = Clock::now();
+
+    m_document.applyChanges(changes);
+    m_document.saveToPath(m_path, m_format);
+
+    m_lastWriteSeconds.store(duration<double>(Clock::now()-start).count(), std::memory_order_relaxed);
+    m_numWrites.fetch_add(1, std::memory_order_relaxed);
+}
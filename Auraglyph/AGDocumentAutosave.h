@@ -0,0 +1,94 @@
+//
+//  AGDocumentAutosave.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include "AGDocument.h"
+#include "Mutex.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+class Thread;
+
+//------------------------------------------------------------------------------
+// ### AGDocumentAutosave ###
+// Keeps a document's file up to date as it's edited, without writing on the
+// main thread. The main thread submits only what changed (from
+// AGDocument::takeChanges()); a worker thread folds changes into its own copy
+// of the document and writes the whole copy once edits settle. The write
+// goes to a temporary file that is then renamed over the original. Bursts of
+// edits, like dragging a node, are coalesced into one write.
+//------------------------------------------------------------------------------
+#pragma mark - AGDocumentAutosave
+
+class AGDocumentAutosave
+{
+public:
+    /* wait this long after the last edit before writing... */
+    static constexpr double QUIET_SECONDS = 1.0;
+    /* ...but write a steady stream of edits at least this often */
+    static constexpr double MAX_DELAY_SECONDS = 5.0;
+    static const int POLL_MS = 50;
+
+    AGDocumentAutosave();
+    ~AGDocumentAutosave();
+    AGDocumentAutosave(const AGDocumentAutosave &) = delete;
+
+    /* save changes to path from now on; doc is what was last saved there.
+       Stops saving to any previous path first. */
+    void start(const std::string &path, const AGDocument &doc,
+               AGDocument::Format format = AGDocument::FORMAT_JSON);
+    /* write anything submitted, then stop */
+    void stop();
+    bool isRunning() const { return m_thread != NULL; }
+    const std::string &path() const { return m_path; }
+
+    /* main thread: queue changes to write once edits settle */
+    void submit(AGDocument::Changes &&changes);
+    /* have the worker write what's queued without waiting for edits to
+       settle */
+    void saveSoon();
+    /* write what's queued on the calling thread, returning once it's written */
+    void flush();
+
+    int numSubmits() const { return m_numSubmits.load(std::memory_order_relaxed); }
+    int numWrites() const { return m_numWrites.load(std::memory_order_relaxed); }
+    /* how long the last write took, in seconds */
+    double lastWriteSeconds() const { return m_lastWriteSeconds.load(std::memory_order_relaxed); }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    /* worker thread: true if queued changes should be written now */
+    bool _isDue();
+    void _writePending();
+
+    std::string m_path;
+    AGDocument::Format m_format = AGDocument::FORMAT_JSON;
+
+    Thread *m_thread = NULL;
+    std::atomic<bool> m_go;
+
+    // queued changes, and when they were queued
+    Mutex m_pendingMutex;
+    AGDocument::Changes m_pending;
+    bool m_hasPending = false;
+    bool m_saveSoon = false;
+    Clock::time_point m_firstSubmit;
+    Clock::time_point m_lastSubmit;
+
+    // the worker's copy, as last written
+    Mutex m_writeMutex;
+    AGDocument m_document;
+
+    std::atomic<int> m_numSubmits;
+    std::atomic<int> m_numWrites;
+    std::atomic<double> m_lastWriteSeconds;
+};
@@ -0,0 +1,453 @@
+//
+//  AGDocumentBenchmark.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGDocumentBenchmark.h"
+#include "AGDocument.h"
+#include "AGDocumentAutosave.h"
+#include "AGDocumentIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+
+static size_t _fileSize(const std::string &path)
+{
+    struct stat st;
+    if(stat(path.c_str(), &st) != 0)
+        return 0;
+    return st.st_size;
+}
+
+static std::string _float(float f)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.9g", f);
+    return buf;
+}
+
+// seconds per call of fn, called repeatedly for at least minTime
+template<class Fn>
+static double _time(double minTime, Fn fn)
+{
+    using namespace std::chrono;
+
+    int num = 0;
+    auto start = steady_clock::now();
+    double elapsed = 0;
+    while(elapsed < minTime)
+    {
+        fn();
+        num++;
+        elapsed = duration<double>(steady_clock::now()-start).count();
+    }
+
+    return elapsed/num;
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGDocumentBenchmark ###
+//------------------------------------------------------------------------------
+#pragma mark - AGDocumentBenchmark
+
+std::string AGDocumentBenchmark::describe(AGDocument &doc)
+{
+    std::string text;
+
+    doc.recreate([&](const AGDocument::Node &node) {
+        text += "node " + node.uuid + " " + std::to_string(node._class) + " " + node.type + " " +
+            _float(node.x) + " " + _float(node.y) + " " + _float(node.z) + "\n";
+        for(auto &param : node.params)
+        {
+            const AGDocument::ParamValue &pv = param.second;
+            text += "  " + param.first + " " + std::to_string(pv.type) + " ";
+            switch(pv.type)
+            {
+                case AGDocument::ParamValue::BIT:
+                case AGDocument::ParamValue::INT: text += std::to_string(pv.i); break;
+                case AGDocument::ParamValue::FLOAT: text += _float(pv.f); break;
+                case AGDocument::ParamValue::STRING: text += pv.s; break;
+                case AGDocument::ParamValue::FLOAT_ARRAY:
+                    for(float f : pv.fa)
+                        text += _float(f) + ",";
+                    break;
+                default: break;
+            }
+            text += "\n";
+        }
+    }, [&](const AGDocument::Connection &conn) {
+        text += "connection " + conn.uuid + " " + conn.srcUuid + " " + conn.dstUuid + " " +
+            std::to_string(conn.dstPort) + "\n";
+    }, [&](const AGDocument::Freedraw &freedraw) {
+        text += "freedraw " + freedraw.uuid + " " + _float(freedraw.x) + " " + _float(freedraw.y) + " " +
+            _float(freedraw.z) + " ";
+        for(float f : freedraw.points)
+            text += _float(f) + ",";
+        text += "\n";
+    });
+
+    for(auto &figure : doc.name())
+    {
+        text += "figure ";
+        for(auto &pt : figure)
+            text += _float(pt.x) + "," + _float(pt.y) + ",";
+        text += "\n";
+    }
+
+    return text;
+}
+
+
+AGDocumentBenchmark::Result AGDocumentBenchmark::run(const std::string &path, const std::string &tmpPath, double minTime)
+{
+    Result result;
+    size_t slash = path.rfind('/');
+    result.name = slash == std::string::npos ? path : path.substr(slash+1);
+    result.numNodes = result.numConnections = result.numFreedraws = 0;
+
+    AGDocument doc;
+    doc.loadFromPath(path);
+    doc.recreate([&](const AGDocument::Node &) { result.numNodes++; },
+                 [&](const AGDocument::Connection &) { result.numConnections++; },
+                 [&](const AGDocument::Freedraw &) { result.numFreedraws++; });
+    std::string original = describe(doc);
+
+    std::string jsonPath = tmpPath;
+    std::string binaryPath = tmpPath + "." + AGDocument::BINARY_EXTENSION;
+
+    result.jsonSavesPerSecond = 1/_time(minTime, [&]() { doc.saveToPath(jsonPath, AGDocument::FORMAT_JSON); });
+    result.binarySavesPerSecond = 1/_time(minTime, [&]() { doc.saveToPath(binaryPath, AGDocument::FORMAT_BINARY); });
+    result.jsonBytes = _fileSize(jsonPath);
+    result.binaryBytes = _fileSize(binaryPath);
+
+    result.jsonLoadsPerSecond = 1/_time(minTime, [&]() { AGDocument loaded; loaded.loadFromPath(jsonPath); });
+    result.binaryLoadsPerSecond = 1/_time(minTime, [&]() { AGDocument loaded; loaded.loadFromPath(binaryPath); });
+
+    // JSON to binary and back again
+    AGDocument fromBinary;
+    fromBinary.loadFromPath(binaryPath);
+    fromBinary.saveToPath(jsonPath, AGDocument::FORMAT_JSON);
+    AGDocument fromJSON;
+    fromJSON.loadFromPath(jsonPath);
+    result.roundTrip = describe(fromBinary) == original && describe(fromJSON) == original;
+
+    unlink(jsonPath.c_str());
+    unlink(binaryPath.c_str());
+
+    return result;
+}
+
+static void _makeLarge(AGDocument &doc, int numNodes, int numFreedraws, int numPoints)
+{
+    char uuid[64];
+
+    for(int i = 0; i < numNodes; i++)
+    {
+        AGDocument::Node node;
+        snprintf(uuid, sizeof(uuid), "00000000-0000-0000-0000-%012d", i);
+        node.uuid = uuid;
+        node._class = i%2 ? AGDocument::Node::CONTROL : AGDocument::Node::AUDIO;
+        node.type = i%2 ? "Timer" : "SineWave";
+        node.x = i*1.5f; node.y = -i*0.25f; node.z = 0.1f;
+        node.saveParam("freq", 220.0f + i);
+        node.saveParam("gain", 0.5f);
+        node.saveParam("steps", std::vector<float>(16, 0.25f));
+        doc.addNode(node);
+
+        AGDocument::Connection conn;
+        snprintf(uuid, sizeof(uuid), "00000000-0000-0000-0001-%012d", i);
+        conn.uuid = uuid;
+        snprintf(uuid, sizeof(uuid), "00000000-0000-0000-0000-%012d", i);
+        conn.srcUuid = uuid;
+        snprintf(uuid, sizeof(uuid), "00000000-0000-0000-0000-%012d", (i+1)%numNodes);
+        conn.dstUuid = uuid;
+        conn.srcPort = 0;
+        conn.dstPort = 0;
+        doc.addConnection(conn);
+    }
+
+    for(int i = 0; i < numFreedraws; i++)
+    {
+        AGDocument::Freedraw freedraw;
+        snprintf(uuid, sizeof(uuid), "00000000-0000-0000-0002-%012d", i);
+        freedraw.uuid = uuid;
+        freedraw.x = i; freedraw.y = -i; freedraw.z = 0;
+        for(int j = 0; j < numPoints; j++)
+        {
+            freedraw.points.push_back(j*0.37f);
+            freedraw.points.push_back(j*-0.11f);
+            freedraw.points.push_back(0);
+        }
+        doc.addFreedraw(freedraw);
+    }
+
+    // a handwritten-looking name
+    std::vector<std::vector<GLvertex2f>> name(8);
+    for(int f = 0; f < (int) name.size(); f++)
+        for(int j = 0; j < 200; j++)
+            name[f].push_back(GLvertex2f(f*20 + 10*sinf(j*0.1f), 10*cosf(j*0.13f)));
+    doc.setName(name);
+}
+
+static std::string _nodeUUID(int i)
+{
+    char uuid[64];
+    snprintf(uuid, sizeof(uuid), "00000000-0000-0000-0000-%012d", i);
+    return uuid;
+}
+
+bool AGDocumentBenchmark::writeLarge(const std::string &path, int numNodes, int numFreedraws, int numPoints)
+{
+    AGDocument doc;
+    _makeLarge(doc, numNodes, numFreedraws, numPoints);
+    doc.saveToPath(path);
+
+    return _fileSize(path) > 0;
+}
+
+std::vector<AGDocumentBenchmark::Result> AGDocumentBenchmark::runAll(const std::vector<std::string> &paths,
+                                                                     const std::string &tmpDir, double minTime)
+{
+    std::string pid = std::to_string(getpid());
+    std::string tmpPath = tmpDir + "/agbench-" + pid + ".json";
+    std::string largePath = tmpDir + "/agbench-" + pid + "-large.json";
+
+    std::vector<Result> results;
+    for(const std::string &path : paths)
+        results.push_back(run(path, tmpPath, minTime));
+
+    if(writeLarge(largePath, 5000, 500, 500))
+    {
+        results.push_back(run(largePath, tmpPath, minTime));
+        results.back().name = "(generated)";
+    }
+    unlink(largePath.c_str());
+
+    fprintf(stderr, "%-20s %6s %6s %6s %10s %10s %10s %10s %10s %10s %6s\n", "document", "nodes", "conns",
+            "draws", "JSON size", "loads/s", "saves/s", "bin size", "loads/s", "saves/s", "same");
+    for(const Result &result : results)
+    {
+        fprintf(stderr, "%-20s %6i %6i %6i %9.1fK %10.1f %10.1f %9.1fK %10.1f %10.1f %6s\n",
+                result.name.c_str(), result.numNodes, result.numConnections, result.numFreedraws,
+                result.jsonBytes/1.0e3, result.jsonLoadsPerSecond, result.jsonSavesPerSecond,
+                result.binaryBytes/1.0e3, result.binaryLoadsPerSecond, result.binarySavesPerSecond,
+                result.roundTrip ? "yes" : "NO");
+    }
+
+    return results;
+}
+
+AGDocumentBenchmark::AutosaveResult AGDocumentBenchmark::runAutosave(const std::string &path, int numNodes)
+{
+    using namespace std::chrono;
+    typedef steady_clock Clock;
+
+    AutosaveResult result;
+    result.numNodes = numNodes;
+
+    AGDocument doc;
+    _makeLarge(doc, numNodes, 50, 200);
+
+    // as saving was: every node copied into a new document, then written
+    const int numFullSaves = 10;
+    double fullSaveTotal = 0;
+    result.fullSaveMaxMs = 0;
+    for(int i = 0; i < numFullSaves; i++)
+    {
+        auto start = Clock::now();
+        AGDocument copy;
+        doc.recreate([&](const AGDocument::Node &node) { copy.addNode(node); },
+                     [&](const AGDocument::Connection &) { },
+                     [&](const AGDocument::Freedraw &freedraw) { copy.addFreedraw(freedraw); });
+        copy.setName(doc.name());
+        copy.saveToPath(path);
+        double ms = duration<double, std::milli>(Clock::now()-start).count();
+        fullSaveTotal += ms;
+        result.fullSaveMaxMs = std::max(result.fullSaveMaxMs, ms);
+    }
+    result.fullSaveMeanMs = fullSaveTotal/numFullSaves;
+
+    // each node as it would be serialized
+    std::vector<AGDocument::Node> nodes;
+    doc.recreate([&](const AGDocument::Node &node) { nodes.push_back(node); },
+                 [&](const AGDocument::Connection &) { },
+                 [&](const AGDocument::Freedraw &) { });
+    doc.takeChanges();
+
+    AGDocumentAutosave autosave;
+    autosave.start(path, doc);
+
+    // drag a node, leave it, then change a few nodes' parameters every frame,
+    // and leave them; each burst is written once it settles
+    const double frameSeconds = 1.0/60.0;
+    const int numFrames = 60*5;
+    double frameTotal = 0;
+    result.frameMaxMs = 0;
+    auto nextFrame = Clock::now();
+    for(int frame = 0; frame < numFrames; frame++)
+    {
+        double t = frame*frameSeconds;
+        auto start = Clock::now();
+
+        if(t < 1)
+        {
+            AGDocument::Node &node = nodes[0];
+            node.x += 0.01f;
+            doc.updateNode(node.uuid, node);
+        }
+        else if(t >= 2.5 && t < 3)
+        {
+            for(int i = 0; i < 10; i++)
+            {
+                AGDocument::Node &node = nodes[(frame*10+i)%numNodes];
+                node.saveParam("gain", (float) (frame%100)/100.0f);
+                doc.updateNode(node.uuid, node);
+            }
+        }
+
+        if(doc.isDirty())
+            autosave.submit(doc.takeChanges());
+
+        double ms = duration<double, std::milli>(Clock::now()-start).count();
+        frameTotal += ms;
+        result.frameMaxMs = std::max(result.frameMaxMs, ms);
+
+        nextFrame += duration_cast<Clock::duration>(duration<double>(frameSeconds));
+        std::this_thread::sleep_until(nextFrame);
+    }
+    result.numFrames = numFrames;
+    result.frameMeanMs = frameTotal/numFrames;
+
+    // and once more, removing a node, written on stopping
+    doc.removeNode(_nodeUUID(numNodes-1));
+    autosave.submit(doc.takeChanges());
+    autosave.stop();
+    result.numWrites = autosave.numWrites();
+    result.lastWriteMs = autosave.lastWriteSeconds()*1000;
+
+    // against the edited document saved directly
+    std::string expectedPath = path + ".expected";
+    doc.saveToPath(expectedPath);
+    AGDocument saved, expected;
+    saved.loadFromPath(path);
+    expected.loadFromPath(expectedPath);
+    result.same = describe(saved) == describe(expected);
+    unlink(path.c_str());
+    unlink(expectedPath.c_str());
+
+    fprintf(stderr, "autosaving %i nodes, %i frames at 60 fps (main thread, ms)\n", numNodes, numFrames);
+    fprintf(stderr, "%-24s %8s %8s\n", "", "mean", "max");
+    fprintf(stderr, "%-24s %8.3f %8.3f\n", "full save", result.fullSaveMeanMs, result.fullSaveMaxMs);
+    fprintf(stderr, "%-24s %8.3f %8.3f\n", "autosave, per frame", result.frameMeanMs, result.frameMaxMs);
+    fprintf(stderr, "background writes: %i (last %.1f ms); loads back the same: %s\n",
+            result.numWrites, result.lastWriteMs, result.same ? "yes" : "NO");
+
+    return result;
+}
+
+AGDocumentBenchmark::LibraryResult AGDocumentBenchmark::runLibrary(const std::string &dir, int numDocuments)
+{
+    using namespace std::chrono;
+    typedef steady_clock Clock;
+
+    LibraryResult result;
+    result.numDocuments = numDocuments;
+
+    mkdir(dir.c_str(), 0755);
+    // beside the documents, not among them, as in the app
+    std::string indexPath = dir + ".index";
+    auto isDocument = [](const std::string &filename) {
+        return filename.size() > 5 && filename.compare(filename.size()-5, 5, ".json") == 0;
+    };
+
+    // small patches, each with its own name
+    AGDocument doc;
+    _makeLarge(doc, 20, 5, 50);
+    std::vector<std::string> paths(numDocuments);
+    std::vector<AGDocumentIndex::Name> names(numDocuments);
+    for(int i = 0; i < numDocuments; i++)
+    {
+        char filename[32];
+        snprintf(filename, sizeof(filename), "/%06d.json", i);
+        paths[i] = dir + filename;
+        names[i] = doc.name();
+        names[i][0][0] = GLvertex2f(i, -i);
+        doc.setName(names[i]);
+        doc.saveToPath(paths[i]);
+    }
+    // until the directory's time can be trusted
+    std::this_thread::sleep_for(duration<double>(AGDocumentIndex::MTIME_SLACK_SECONDS));
+
+    auto start = Clock::now();
+    for(const std::string &path : paths)
+    {
+        AGDocument loaded;
+        loaded.loadFromPath(path);
+    }
+    result.loadAllMs = duration<double, std::milli>(Clock::now()-start).count();
+
+    unlink(indexPath.c_str());
+    start = Clock::now();
+    {
+        AGDocumentIndex index(indexPath, dir);
+        index.refresh(isDocument);
+        result.buildMs = duration<double, std::milli>(Clock::now()-start).count();
+        result.buildNamesRead = index.numNamesRead();
+    }
+
+    // as the load dialog opens: the first three rows
+    start = Clock::now();
+    {
+        AGDocumentIndex index(indexPath, dir);
+        index.refresh(isDocument);
+        for(int i = 0; i < std::min(3, index.count()); i++)
+            index.name(i);
+        result.openMs = duration<double, std::milli>(Clock::now()-start).count();
+        result.openNamesRead = index.numNamesRead();
+        result.openPagesDecoded = index.numPagesDecoded();
+
+        result.same = index.count() == numDocuments;
+        for(int i = 0; i < index.count() && result.same; i++)
+            result.same = paths[i] == dir + "/" + index.filename(i) && index.name(i) == names[i];
+    }
+
+    names[0][0][0] = GLvertex2f(-1, -1);
+    doc.setName(names[0]);
+    doc.saveToPath(paths[0]);
+    start = Clock::now();
+    {
+        AGDocumentIndex index(indexPath, dir);
+        index.refresh(isDocument);
+        for(int i = 0; i < std::min(3, index.count()); i++)
+            index.name(i);
+        result.changedMs = duration<double, std::milli>(Clock::now()-start).count();
+        result.changedNamesRead = index.numNamesRead();
+
+        result.same = result.same && index.count() > 0 && index.name(0) == names[0];
+    }
+
+    for(const std::string &path : paths)
+        unlink(path.c_str());
+    unlink(indexPath.c_str());
+    rmdir(dir.c_str());
+
+    fprintf(stderr, "library of %i documents (ms)\n", numDocuments);
+    fprintf(stderr, "%-28s %10.3f\n", "loading every document", result.loadAllMs);
+    fprintf(stderr, "%-28s %10.3f  (%i names read)\n", "index, built", result.buildMs, result.buildNamesRead);
+    fprintf(stderr, "%-28s %10.3f  (%i names read, %i pages decoded)\n", "index, opened unchanged",
+            result.openMs, result.openNamesRead, result.openPagesDecoded);
+    fprintf(stderr, "%-28s %10.3f  (%i names read)\n", "index, one document changed", result.changedMs, result.changedNamesRead);
+    fprintf(stderr, "indexed names match: %s\n", result.same ? "yes" : "NO");
+
+    return result;
+}
@@ -0,0 +1,102 @@
+//
+//  AGDocumentBenchmark.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+class AGDocument;
+
+//------------------------------------------------------------------------------
+// ### AGDocumentBenchmark ###
+// Times loading and saving patch documents, as JSON and in AGDocumentBinary's
+// format, reporting the size and throughput of each, and checks that a
+// document converted to either loads back the same as the original.
+//------------------------------------------------------------------------------
+#pragma mark - AGDocumentBenchmark
+
+class AGDocumentBenchmark
+{
+public:
+    struct Result
+    {
+        std::string name;
+        int numNodes;
+        int numConnections;
+        int numFreedraws;
+        size_t jsonBytes;
+        double jsonLoadsPerSecond;
+        double jsonSavesPerSecond;
+        size_t binaryBytes;
+        double binaryLoadsPerSecond;
+        double binarySavesPerSecond;
+        bool roundTrip; // saved in each format and loaded back unchanged
+    };
+
+    /* load the document at path, then load and save it in each format
+       repeatedly for at least minTime seconds each (saving to tmpPath and
+       tmpPath with BINARY_EXTENSION) */
+    static Result run(const std::string &path, const std::string &tmpPath, double minTime);
+
+    /* write a document of numNodes nodes, as many connections, and
+       numFreedraws freedraws of numPoints points each, to path */
+    static bool writeLarge(const std::string &path, int numNodes, int numFreedraws, int numPoints);
+
+    /* everything in doc, as text, to compare documents by; connections'
+       source ports are left out, as JSON doesn't save them for connections
+       that nodes don't list */
+    static std::string describe(AGDocument &doc);
+
+    /* run each of paths, and a large generated document, printing a summary to
+       stderr; files are written in tmpDir */
+    static std::vector<Result> runAll(const std::vector<std::string> &paths, const std::string &tmpDir, double minTime);
+    
+    struct AutosaveResult
+    {
+        int numNodes;
+        // saving the whole document on the main thread, as edits used to be
+        double fullSaveMeanMs;
+        double fullSaveMaxMs;
+        // the main thread's part of autosaving, per 60 fps frame
+        int numFrames;
+        double frameMeanMs;
+        double frameMaxMs;
+        // the worker's
+        int numWrites;
+        double lastWriteMs;
+        bool same; // the autosaved file loads back as edited
+    };
+    
+    /* edit a generated document of numNodes nodes for a few seconds of 60 fps
+       frames, in bursts, with AGDocumentAutosave writing it to path; prints a
+       summary to stderr */
+    static AutosaveResult runAutosave(const std::string &path, int numNodes);
+    
+    struct LibraryResult
+    {
+        int numDocuments;
+        // reading every document in full, as listing the library used to
+        double loadAllMs;
+        // AGDocumentIndex, with no index yet
+        double buildMs;
+        int buildNamesRead;
+        // opened again with nothing changed, showing the first page
+        double openMs;
+        int openNamesRead;
+        int openPagesDecoded;
+        // opened again after one document is re-saved
+        double changedMs;
+        int changedNamesRead;
+        bool same; // indexed names are the documents' names
+    };
+    
+    /* write numDocuments generated documents to dir, then list them as the
+       library does; prints a summary to stderr */
+    static LibraryResult runLibrary(const std::string &dir, int numDocuments);
+};
@@ -0,0 +1,406 @@
+//
+//  AGDocumentBinary.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGDocumentBinary.h"
+
+#include <set>
+#include <unordered_map>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+static_assert(sizeof(AGDocumentBinary::NodeRecord) == 32, "NodeRecord layout");
+static_assert(sizeof(AGDocumentBinary::ParamRecord) == 28, "ParamRecord layout");
+static_assert(sizeof(AGDocumentBinary::ConnectionRecord) == 20, "ConnectionRecord layout");
+static_assert(sizeof(AGDocumentBinary::FreedrawRecord) == 24, "FreedrawRecord layout");
+
+// size of each section's records
+static const size_t s_recordSize[AGDocumentBinary::NUM_SECTIONS] = {
+    sizeof(AGDocumentBinary::StringRecord),
+    1,
+    sizeof(AGDocumentBinary::NodeRecord),
+    sizeof(AGDocumentBinary::ParamRecord),
+    sizeof(AGDocumentBinary::ConnectionRecord),
+    sizeof(AGDocumentBinary::FreedrawRecord),
+    sizeof(AGDocumentBinary::FigureRecord),
+    sizeof(float),
+};
+
+
+//------------------------------------------------------------------------------
+// ### AGDocumentBinaryWriter ###
+// Collects the sections in memory, then writes them out in one go.
+//------------------------------------------------------------------------------
+#pragma mark - AGDocumentBinaryWriter
+
+class AGDocumentBinaryWriter
+{
+public:
+    uint32_t string(const std::string &str)
+    {
+        auto it = m_stringIndex.find(str);
+        if(it != m_stringIndex.end())
+            return it->second;
+
+        uint32_t index = (uint32_t) m_strings.size();
+        m_strings.push_back({ (uint32_t) m_stringData.size(), (uint32_t) str.size() });
+        m_stringData.insert(m_stringData.end(), str.begin(), str.end());
+        m_stringData.push_back('\0');
+        m_stringIndex[str] = index;
+        return index;
+    }
+
+    template<class Iterator>
+    uint32_t floats(Iterator begin, Iterator end)
+    {
+        uint32_t first = (uint32_t) m_floats.size();
+        m_floats.insert(m_floats.end(), begin, end);
+        return first;
+    }
+
+    bool write(FILE *file)
+    {
+        AGDocumentBinary::Header header;
+        memset(&header, 0, sizeof(header));
+        header.magic = AGDocumentBinary::MAGIC;
+        header.version = AGDocumentBinary::VERSION;
+        header.numSections = AGDocumentBinary::NUM_SECTIONS;
+
+        const void *data[AGDocumentBinary::NUM_SECTIONS] = {
+            m_strings.data(), m_stringData.data(), nodes.data(), params.data(),
+            connections.data(), freedraws.data(), figures.data(), m_floats.data(),
+        };
+        const size_t counts[AGDocumentBinary::NUM_SECTIONS] = {
+            m_strings.size(), m_stringData.size(), nodes.size(), params.size(),
+            connections.size(), freedraws.size(), figures.size(), m_floats.size(),
+        };
+
+        size_t offset = sizeof(header);
+        for(int s = 0; s < AGDocumentBinary::NUM_SECTIONS; s++)
+        {
+            header.sections[s].offset = (uint32_t) offset;
+            header.sections[s].count = (uint32_t) counts[s];
+            offset = _align(offset + counts[s]*s_recordSize[s]);
+        }
+
+        static const char padding[4] = { 0, 0, 0, 0 };
+        bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+        for(int s = 0; s < AGDocumentBinary::NUM_SECTIONS && written; s++)
+        {
+            size_t size = counts[s]*s_recordSize[s];
+            if(size)
+                written = fwrite(data[s], size, 1, file) == 1;
+            if(written && _align(size) != size)
+                written = fwrite(padding, _align(size)-size, 1, file) == 1;
+        }
+
+        return written;
+    }
+
+    std::vector<AGDocumentBinary::NodeRecord> nodes;
+    std::vector<AGDocumentBinary::ParamRecord> params;
+    std::vector<AGDocumentBinary::ConnectionRecord> connections;
+    std::vector<AGDocumentBinary::FreedrawRecord> freedraws;
+    std::vector<AGDocumentBinary::FigureRecord> figures;
+
+private:
+    static size_t _align(size_t size) { return (size+3) & ~(size_t) 3; }
+
+    std::unordered_map<std::string, uint32_t> m_stringIndex;
+    std::vector<AGDocumentBinary::StringRecord> m_strings;
+    std::vector<char> m_stringData;
+    std::vector<float> m_floats;
+};
+
+
+//------------------------------------------------------------------------------
+// ### AGDocumentBinary ###
+//------------------------------------------------------------------------------
+#pragma mark - AGDocumentBinary
+
+bool AGDocumentBinary::isBinary(const char *data, size_t size)
+{
+    uint32_t magic;
+    if(size < sizeof(magic))
+        return false;
+    memcpy(&magic, data, sizeof(magic));
+    return magic == MAGIC;
+}
+
+bool AGDocumentBinary::write(const AGDocument &doc, FILE *file)
+{
+    AGDocumentBinaryWriter writer;
+
+    std::set<std::string> connectionUuids;
+    auto writeConnection = [&](const AGDocument::Connection &conn) {
+        if(connectionUuids.count(conn.uuid))
+            return;
+        connectionUuids.insert(conn.uuid);
+        writer.connections.push_back({ writer.string(conn.uuid), writer.string(conn.srcUuid),
+            writer.string(conn.dstUuid), conn.srcPort, conn.dstPort });
+    };
+
+    for(const auto &kv : doc.m_nodes)
+    {
+        const AGDocument::Node &node = kv.second;
+
+        NodeRecord record;
+        record.uuid = writer.string(kv.first);
+        record.type = writer.string(node.type);
+        record._class = node._class;
+        record.x = node.x; record.y = node.y; record.z = node.z;
+        record.firstParam = (uint32_t) writer.params.size();
+        record.numParams = (uint32_t) node.params.size();
+        writer.nodes.push_back(record);
+
+        for(const auto &param : node.params)
+        {
+            const AGDocument::ParamValue &value = param.second;
+            ParamRecord paramRecord;
+            paramRecord.name = writer.string(param.first);
+            paramRecord.type = value.type;
+            paramRecord.i = value.i;
+            paramRecord.f = value.f;
+            paramRecord.s = writer.string(value.s);
+            paramRecord.firstFloat = writer.floats(value.fa.begin(), value.fa.end());
+            paramRecord.numFloats = (uint32_t) value.fa.size();
+            writer.params.push_back(paramRecord);
+        }
+
+        // as when loading JSON, those listed by nodes win
+        for(const AGDocument::Connection &conn : node.inbound)
+            writeConnection(conn);
+        for(const AGDocument::Connection &conn : node.outbound)
+            writeConnection(conn);
+    }
+
+    for(const auto &kv : doc.m_connections)
+        writeConnection(kv.second);
+
+    for(const auto &kv : doc.m_freedraws)
+    {
+        const AGDocument::Freedraw &freedraw = kv.second;
+        writer.freedraws.push_back({ writer.string(kv.first), freedraw.x, freedraw.y, freedraw.z,
+            writer.floats(freedraw.points.begin(), freedraw.points.end()), (uint32_t) freedraw.points.size() });
+    }
+
+    for(const std::vector<GLvertex2f> &figure : doc.m_name)
+    {
+        // GLvertex2f is a pair of floats
+        const float *points = (const float *) figure.data();
+        writer.figures.push_back({ writer.floats(points, points + figure.size()*2), (uint32_t) figure.size()*2 });
+    }
+
+    return writer.write(file);
+}
+
+bool AGDocumentBinary::read(AGDocument &doc, const std::string &path)
+{
+    Mapping mapping;
+    if(!mapping.open(path))
+        return false;
+
+    for(uint32_t n = 0; n < mapping.count(NODES); n++)
+    {
+        const NodeRecord &record = mapping.node(n);
+
+        AGDocument::Node &node = doc.m_nodes[mapping.stlString(record.uuid)];
+        node = AGDocument::Node();
+        node.uuid = mapping.stlString(record.uuid);
+        node.type = mapping.stlString(record.type);
+        node._class = (AGDocument::Node::Class) record._class;
+        node.x = record.x; node.y = record.y; node.z = record.z;
+
+        for(uint32_t p = record.firstParam; p < record.firstParam+record.numParams; p++)
+        {
+            const ParamRecord &paramRecord = mapping.param(p);
+            AGDocument::ParamValue &value = node.params[mapping.stlString(paramRecord.name)];
+            value.type = (AGDocument::ParamValue::Type) paramRecord.type;
+            value.i = paramRecord.i;
+            value.f = paramRecord.f;
+            value.s = mapping.stlString(paramRecord.s);
+            const float *floats = mapping.floats(paramRecord.firstFloat);
+            value.fa.assign(floats, floats + paramRecord.numFloats);
+        }
+    }
+
+    for(uint32_t c = 0; c < mapping.count(CONNECTIONS); c++)
+    {
+        const ConnectionRecord &record = mapping.connection(c);
+
+        AGDocument::Connection &conn = doc.m_connections[mapping.stlString(record.uuid)];
+        conn.uuid = mapping.stlString(record.uuid);
+        conn.srcUuid = mapping.stlString(record.srcUuid);
+        conn.dstUuid = mapping.stlString(record.dstUuid);
+        conn.srcPort = record.srcPort;
+        conn.dstPort = record.dstPort;
+    }
+
+    for(uint32_t f = 0; f < mapping.count(FREEDRAWS); f++)
+    {
+        const FreedrawRecord &record = mapping.freedraw(f);
+
+        AGDocument::Freedraw &freedraw = doc.m_freedraws[mapping.stlString(record.uuid)];
+        freedraw.uuid = mapping.stlString(record.uuid);
+        freedraw.x = record.x; freedraw.y = record.y; freedraw.z = record.z;
+        const float *points = mapping.floats(record.firstFloat);
+        freedraw.points.assign(points, points + record.numFloats);
+    }
+
+    _readName(mapping, doc.m_name);
+
+    return true;
+}
+
+bool AGDocumentBinary::readName(const std::string &path, std::vector<std::vector<GLvertex2f>> &name)
+{
+    Mapping mapping;
+    if(!mapping.open(path))
+        return false;
+
+    _readName(mapping, name);
+
+    return true;
+}
+
+void AGDocumentBinary::_readName(const Mapping &mapping, std::vector<std::vector<GLvertex2f>> &name)
+{
+    name.resize(mapping.count(FIGURES));
+    for(uint32_t f = 0; f < mapping.count(FIGURES); f++)
+    {
+        const FigureRecord &record = mapping.figure(f);
+        const GLvertex2f *points = (const GLvertex2f *) mapping.floats(record.firstFloat);
+        name[f].assign(points, points + record.numFloats/2);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGDocumentBinary::Mapping ###
+//------------------------------------------------------------------------------
+#pragma mark - AGDocumentBinary::Mapping
+
+bool AGDocumentBinary::Mapping::open(const std::string &path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(Header))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping holds the file open
+    ::close(fd);
+    if(data == MAP_FAILED)
+        return false;
+
+    m_data = (const char *) data;
+    m_size = st.st_size;
+    m_header = (const Header *) m_data;
+
+    if(!_validate())
+    {
+        close();
+        return false;
+    }
+
+    m_stringData = _records<char>(STRING_DATA);
+
+    return true;
+}
+
+void AGDocumentBinary::Mapping::close()
+{
+    if(m_data)
+        munmap((void *) m_data, m_size);
+    m_data = NULL;
+    m_size = 0;
+    m_header = NULL;
+    m_stringData = NULL;
+}
+
+bool AGDocumentBinary::Mapping::_validate()
+{
+    if(m_header->magic != MAGIC || m_header->version < 1 || m_header->version > VERSION ||
+       m_header->numSections < NUM_SECTIONS ||
+       sizeof(Header) + (uint64_t) (m_header->numSections-NUM_SECTIONS)*sizeof(SectionRecord) > m_size)
+        return false;
+
+    for(int s = 0; s < NUM_SECTIONS; s++)
+    {
+        const SectionRecord &section = m_header->sections[s];
+        if(section.offset % 4 != 0 ||
+           (uint64_t) section.offset + (uint64_t) section.count*s_recordSize[s] > m_size)
+            return false;
+    }
+
+    uint32_t numStrings = count(STRINGS);
+    uint32_t numStringData = count(STRING_DATA);
+    uint32_t numParams = count(PARAMS);
+    uint32_t numFloats = count(FLOATS);
+    const char *stringData = _records<char>(STRING_DATA);
+
+    auto validString = [&](uint32_t i) { return i < numStrings; };
+    auto validFloats = [&](uint32_t first, uint32_t num) { return (uint64_t) first + num <= numFloats; };
+
+    for(uint32_t i = 0; i < numStrings; i++)
+    {
+        const StringRecord &record = _records<StringRecord>(STRINGS)[i];
+        if((uint64_t) record.offset + record.length >= numStringData || stringData[record.offset+record.length] != '\0')
+            return false;
+    }
+
+    for(uint32_t i = 0; i < count(NODES); i++)
+    {
+        const NodeRecord &record = node(i);
+        if(!validString(record.uuid) || !validString(record.type) ||
+           (uint64_t) record.firstParam + record.numParams > numParams)
+            return false;
+    }
+
+    for(uint32_t i = 0; i < numParams; i++)
+    {
+        const ParamRecord &record = param(i);
+        if(!validString(record.name) || !validString(record.s) || !validFloats(record.firstFloat, record.numFloats) ||
+           record.type < AGDocument::ParamValue::NONE || record.type > AGDocument::ParamValue::FLOAT_ARRAY)
+            return false;
+    }
+
+    for(uint32_t i = 0; i < count(CONNECTIONS); i++)
+    {
+        const ConnectionRecord &record = connection(i);
+        if(!validString(record.uuid) || !validString(record.srcUuid) || !validString(record.dstUuid))
+            return false;
+    }
+
+    for(uint32_t i = 0; i < count(FREEDRAWS); i++)
+    {
+        const FreedrawRecord &record = freedraw(i);
+        if(!validString(record.uuid) || !validFloats(record.firstFloat, record.numFloats))
+            return false;
+    }
+
+    for(uint32_t i = 0; i < count(FIGURES); i++)
+    {
+        const FigureRecord &record = figure(i);
+        if(!validFloats(record.firstFloat, record.numFloats))
+            return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,186 @@
+//
+//  AGDocumentBinary.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include "AGDocument.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+//------------------------------------------------------------------------------
+// ### AGDocumentBinary ###
+// Compact binary container for AGDocuments, an alternative to JSON for
+// drawing-heavy patches. After a fixed header comes a table of sections, each
+// a flat array of fixed-size records (or of floats, or chars), so a reader
+// maps the file and indexes straight into it rather than parsing:
+//
+//     Header       magic, version, and the offset and count of each section
+//     STRINGS      { offset, length } into STRING_DATA, for every string
+//     STRING_DATA  the strings (UUIDs, types, param names), each once, each
+//                  followed by a NUL
+//     NODES        NodeRecord
+//     PARAMS       ParamRecord, each node's contiguous
+//     CONNECTIONS  ConnectionRecord
+//     FREEDRAWS    FreedrawRecord
+//     FIGURES      FigureRecord, for the name glyphs
+//     FLOATS       every float array (freedraw points, array params, figure
+//                  points as x, y pairs), end to end
+//
+// Everything is 4-byte aligned and little-endian. The version changes only
+// when existing records do; new sections can be added to the end of the table
+// without changing it, as readers ignore sections past those they know.
+// Connections listed by nodes (inbound and outbound) are stored with the
+// others, as loading JSON merges them.
+//------------------------------------------------------------------------------
+#pragma mark - AGDocumentBinary
+
+class AGDocumentBinary
+{
+public:
+    static const uint32_t MAGIC = 0x42504741; // "AGPB"
+    static const uint32_t VERSION = 1;
+
+    enum Section
+    {
+        STRINGS,
+        STRING_DATA,
+        NODES,
+        PARAMS,
+        CONNECTIONS,
+        FREEDRAWS,
+        FIGURES,
+        FLOATS,
+        NUM_SECTIONS,
+    };
+
+    struct SectionRecord
+    {
+        uint32_t offset; // bytes from the start of the file
+        uint32_t count; // of records
+    };
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t numSections;
+        SectionRecord sections[NUM_SECTIONS];
+    };
+
+    struct StringRecord
+    {
+        uint32_t offset; // into STRING_DATA
+        uint32_t length;
+    };
+
+    struct NodeRecord
+    {
+        uint32_t uuid; // string
+        uint32_t type; // string
+        int32_t _class;
+        float x, y, z;
+        uint32_t firstParam;
+        uint32_t numParams;
+    };
+
+    struct ParamRecord
+    {
+        uint32_t name; // string
+        int32_t type; // AGDocument::ParamValue::Type
+        int32_t i;
+        float f;
+        uint32_t s; // string
+        uint32_t firstFloat; // FLOAT_ARRAY's
+        uint32_t numFloats;
+    };
+
+    struct ConnectionRecord
+    {
+        uint32_t uuid; // string
+        uint32_t srcUuid; // string
+        uint32_t dstUuid; // string
+        int32_t srcPort;
+        int32_t dstPort;
+    };
+
+    struct FreedrawRecord
+    {
+        uint32_t uuid; // string
+        float x, y, z;
+        uint32_t firstFloat;
+        uint32_t numFloats;
+    };
+
+    struct FigureRecord
+    {
+        uint32_t firstFloat;
+        uint32_t numFloats; // twice the number of points
+    };
+
+    /* true if the first bytes of a file are a binary document's */
+    static bool isBinary(const char *data, size_t size);
+
+    /* write doc to an open file; false if anything couldn't be written */
+    static bool write(const AGDocument &doc, FILE *file);
+    /* read the binary document at path into doc; false (leaving doc as it
+       was) if it can't be mapped or isn't valid */
+    static bool read(AGDocument &doc, const std::string &path);
+    /* read just the name of the binary document at path */
+    static bool readName(const std::string &path, std::vector<std::vector<GLvertex2f>> &name);
+
+    //--------------------------------------------------------------------------
+    // ### AGDocumentBinary::Mapping ###
+    // A binary document mapped into memory, checked once when opened so its
+    // records can then be read in place without further checks. Strings are
+    // NUL-terminated in the mapping, and float arrays are pointers into it.
+    //--------------------------------------------------------------------------
+    class Mapping
+    {
+    public:
+        Mapping() { }
+        ~Mapping() { close(); }
+        Mapping(const Mapping &) = delete;
+
+        /* map and check the file at path; false if it can't be or isn't a
+           valid binary document */
+        bool open(const std::string &path);
+        void close();
+
+        size_t size() const { return m_size; }
+
+        uint32_t count(Section section) const { return m_header->sections[section].count; }
+        const NodeRecord &node(uint32_t i) const { return _records<NodeRecord>(NODES)[i]; }
+        const ParamRecord &param(uint32_t i) const { return _records<ParamRecord>(PARAMS)[i]; }
+        const ConnectionRecord &connection(uint32_t i) const { return _records<ConnectionRecord>(CONNECTIONS)[i]; }
+        const FreedrawRecord &freedraw(uint32_t i) const { return _records<FreedrawRecord>(FREEDRAWS)[i]; }
+        const FigureRecord &figure(uint32_t i) const { return _records<FigureRecord>(FIGURES)[i]; }
+
+        const char *string(uint32_t i) const { return m_stringData + _records<StringRecord>(STRINGS)[i].offset; }
+        uint32_t stringLength(uint32_t i) const { return _records<StringRecord>(STRINGS)[i].length; }
+        std::string stlString(uint32_t i) const { return std::string(string(i), stringLength(i)); }
+        const float *floats(uint32_t first) const { return _records<float>(FLOATS) + first; }
+
+    private:
+        template<class T>
+        const T *_records(Section section) const
+        {
+            return (const T *) (m_data + m_header->sections[section].offset);
+        }
+
+        bool _validate();
+
+        const char *m_data = NULL;
+        size_t m_size = 0;
+        const Header *m_header = NULL;
+        const char *m_stringData = NULL;
+    };
+
+private:
+    static void _readName(const Mapping &mapping, std::vector<std::vector<GLvertex2f>> &name);
+};
@@ -0,0 +1,394 @@
+//
+//  AGDocumentIndex.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGDocumentIndex.h"
+#include "AGDocument.h"
+
+#include <algorithm>
+#include <chrono>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+constexpr double AGDocumentIndex::MTIME_SLACK_SECONDS;
+
+static_assert(sizeof(AGDocumentIndex::Header) == 56, "Header layout");
+static_assert(sizeof(AGDocumentIndex::EntryRecord) == 32, "EntryRecord layout");
+static_assert(sizeof(AGDocumentIndex::FigureRecord) == 8, "FigureRecord layout");
+
+// size of each section's records
+static const size_t s_recordSize[AGDocumentIndex::NUM_SECTIONS] = {
+    sizeof(AGDocumentIndex::EntryRecord),
+    sizeof(AGDocumentIndex::FigureRecord),
+    sizeof(float),
+    1,
+};
+
+// sections start on 8 bytes, for EntryRecord's 64-bit fields
+static size_t _align(size_t size) { return (size+7) & ~(size_t) 7; }
+
+static int64_t _mtime(const struct stat &st)
+{
+#ifdef __APPLE__
+    return (int64_t) st.st_mtimespec.tv_sec*1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    return (int64_t) st.st_mtim.tv_sec*1000000000 + st.st_mtim.tv_nsec;
+#endif
+}
+
+
+AGDocumentIndex::AGDocumentIndex(const std::string &indexPath, const std::string &directory) :
+m_indexPath(indexPath), m_directory(directory)
+{
+    _map();
+}
+
+AGDocumentIndex::~AGDocumentIndex()
+{
+    _unmap();
+}
+
+void AGDocumentIndex::refresh(const std::function<bool (const std::string &filename)> &isDocument)
+{
+    m_numNamesRead = 0;
+
+    // stat the directory before reading it, so that anything changed while
+    // it's read is seen next time
+    struct stat st;
+    if(stat(m_directory.c_str(), &st) != 0)
+    {
+        fprintf(stderr, "AGDocumentIndex::refresh: error: unable to stat '%s'\n", m_directory.c_str());
+        return;
+    }
+
+    int64_t directoryMtime = _mtime(st);
+    if(m_header != NULL && m_header->directoryMtime == directoryMtime)
+        return;
+
+    DIR *dir = opendir(m_directory.c_str());
+    if(dir == NULL)
+    {
+        fprintf(stderr, "AGDocumentIndex::refresh: error: unable to open '%s'\n", m_directory.c_str());
+        return;
+    }
+
+    std::map<std::string, Pending> found;
+    while(struct dirent *dirent = readdir(dir))
+    {
+        std::string filename = dirent->d_name;
+        if(!isDocument(filename))
+            continue;
+
+        std::string path = m_directory + "/" + filename;
+        if(stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+            continue;
+
+        found[filename] = { filename, _mtime(st), (int64_t) st.st_size, Name() };
+    }
+    closedir(dir);
+
+    // times too recent to trust are left out, so they won't match next time
+    using namespace std::chrono;
+    int64_t now = duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+    int64_t racy = now - (int64_t) (MTIME_SLACK_SECONDS*1e9);
+    if(directoryMtime > racy)
+        directoryMtime = 0;
+
+    std::vector<Pending> entries;
+    entries.reserve(found.size());
+
+    // documents already indexed keep their place, and their names if they
+    // haven't changed
+    for(int i = 0; i < count(); i++)
+    {
+        auto it = found.find(filename(i));
+        if(it == found.end())
+            continue;
+
+        Pending &entry = it->second;
+        if(entry.mtime == mtime(i) && entry.size == size(i))
+        {
+            _decodeName(i, entry.name);
+        }
+        else
+        {
+            AGDocument::loadName(m_directory + "/" + entry.filename, entry.name);
+            m_numNamesRead++;
+        }
+
+        if(entry.mtime > racy)
+            entry.mtime = 0;
+        entries.push_back(std::move(entry));
+        found.erase(it);
+    }
+
+    // new documents after those, oldest first
+    std::vector<Pending> added;
+    added.reserve(found.size());
+    for(auto &it : found)
+        added.push_back(std::move(it.second));
+    std::stable_sort(added.begin(), added.end(), [](const Pending &a, const Pending &b) {
+        return a.mtime < b.mtime;
+    });
+
+    for(Pending &entry : added)
+    {
+        AGDocument::loadName(m_directory + "/" + entry.filename, entry.name);
+        m_numNamesRead++;
+        if(entry.mtime > racy)
+            entry.mtime = 0;
+        entries.push_back(std::move(entry));
+    }
+
+    _rebuild(entries, directoryMtime);
+}
+
+const AGDocumentIndex::Name &AGDocumentIndex::name(int i)
+{
+    int page = i/PAGE_SIZE;
+
+    auto it = m_pages.find(page);
+    if(it == m_pages.end())
+    {
+        if(m_pages.size() >= MAX_PAGES)
+        {
+            m_pages.erase(m_pageOrder.front());
+            m_pageOrder.pop_front();
+        }
+
+        std::vector<Name> &names = m_pages[page];
+        int first = page*PAGE_SIZE;
+        int last = std::min(first+PAGE_SIZE, count());
+        names.resize(last-first);
+        for(int j = first; j < last; j++)
+            _decodeName(j, names[j-first]);
+
+        m_pageOrder.push_back(page);
+        m_numPagesDecoded++;
+
+        return names[i-first];
+    }
+
+    return it->second[i-page*PAGE_SIZE];
+}
+
+int AGDocumentIndex::find(const std::string &filename) const
+{
+    for(int i = 0; i < count(); i++)
+    {
+        if(_entry(i).filenameLength == filename.size() &&
+           memcmp(this->filename(i), filename.data(), filename.size()) == 0)
+            return i;
+    }
+
+    return -1;
+}
+
+void AGDocumentIndex::setNames(const std::map<std::string, Name> &names)
+{
+    if(m_header == NULL)
+        return;
+
+    bool changed = false;
+    std::vector<Pending> entries(count());
+    for(int i = 0; i < count(); i++)
+    {
+        Pending &entry = entries[i];
+        entry.filename = filename(i);
+        entry.mtime = mtime(i);
+        entry.size = size(i);
+        _decodeName(i, entry.name);
+
+        auto it = names.find(entry.filename);
+        if(entry.name.size() == 0 && it != names.end() && it->second.size() > 0)
+        {
+            entry.name = it->second;
+            changed = true;
+        }
+    }
+
+    if(changed)
+        _rebuild(entries, m_header->directoryMtime);
+}
+
+bool AGDocumentIndex::_map()
+{
+    int fd = ::open(m_indexPath.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(Header))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping holds the file open
+    ::close(fd);
+    if(data == MAP_FAILED)
+        return false;
+
+    m_data = (const char *) data;
+    m_size = st.st_size;
+    m_mapped = true;
+    m_header = (const Header *) m_data;
+
+    if(!_validate())
+    {
+        fprintf(stderr, "AGDocumentIndex::_map: error: '%s' isn't a valid index; rebuilding it\n", m_indexPath.c_str());
+        _unmap();
+        return false;
+    }
+
+    return true;
+}
+
+void AGDocumentIndex::_unmap()
+{
+    if(m_mapped)
+        munmap((void *) m_data, m_size);
+    m_data = NULL;
+    m_size = 0;
+    m_mapped = false;
+    m_buffer.clear();
+    m_header = NULL;
+    m_pages.clear();
+    m_pageOrder.clear();
+}
+
+bool AGDocumentIndex::_validate()
+{
+    if(m_header->magic != MAGIC || m_header->version < 1 || m_header->version > VERSION ||
+       m_header->numSections < NUM_SECTIONS ||
+       sizeof(Header) + (uint64_t) (m_header->numSections-NUM_SECTIONS)*sizeof(SectionRecord) > m_size)
+        return false;
+
+    for(int s = 0; s < NUM_SECTIONS; s++)
+    {
+        const SectionRecord &section = m_header->sections[s];
+        if(section.offset % 8 != 0 ||
+           (uint64_t) section.offset + (uint64_t) section.count*s_recordSize[s] > m_size)
+            return false;
+    }
+
+    uint32_t numFigures = m_header->sections[FIGURES].count;
+    uint32_t numFloats = m_header->sections[FLOATS].count;
+    uint32_t numStrings = m_header->sections[STRINGS].count;
+    const char *strings = _strings();
+
+    for(int i = 0; i < count(); i++)
+    {
+        const EntryRecord &record = _entry(i);
+        if((uint64_t) record.filename + record.filenameLength >= numStrings ||
+           strings[record.filename+record.filenameLength] != '\0' ||
+           (uint64_t) record.firstFigure + record.numFigures > numFigures)
+            return false;
+    }
+
+    for(uint32_t i = 0; i < numFigures; i++)
+    {
+        const FigureRecord &record = _records<FigureRecord>(FIGURES)[i];
+        if((uint64_t) record.firstFloat + record.numFloats > numFloats)
+            return false;
+    }
+
+    return true;
+}
+
+void AGDocumentIndex::_decodeName(int i, Name &name) const
+{
+    const EntryRecord &entry = _entry(i);
+    const FigureRecord *figures = _records<FigureRecord>(FIGURES) + entry.firstFigure;
+    const float *floats = _records<float>(FLOATS);
+
+    name.resize(entry.numFigures);
+    for(uint32_t f = 0; f < entry.numFigures; f++)
+    {
+        const GLvertex2f *points = (const GLvertex2f *) (floats + figures[f].firstFloat);
+        name[f].assign(points, points + figures[f].numFloats/2);
+    }
+}
+
+void AGDocumentIndex::_rebuild(std::vector<Pending> &entries, int64_t directoryMtime)
+{
+    std::vector<EntryRecord> records;
+    std::vector<FigureRecord> figures;
+    std::vector<float> floats;
+    std::vector<char> strings;
+
+    records.reserve(entries.size());
+    for(const Pending &entry : entries)
+    {
+        records.push_back({ entry.mtime, entry.size,
+            (uint32_t) strings.size(), (uint32_t) entry.filename.size(),
+            (uint32_t) figures.size(), (uint32_t) entry.name.size() });
+        strings.insert(strings.end(), entry.filename.begin(), entry.filename.end());
+        strings.push_back('\0');
+
+        for(const std::vector<GLvertex2f> &figure : entry.name)
+        {
+            figures.push_back({ (uint32_t) floats.size(), (uint32_t) figure.size()*2 });
+            for(const GLvertex2f &point : figure)
+            {
+                floats.push_back(point.x);
+                floats.push_back(point.y);
+            }
+        }
+    }
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.directoryMtime = directoryMtime;
+    header.numSections = NUM_SECTIONS;
+
+    const void *data[NUM_SECTIONS] = { records.data(), figures.data(), floats.data(), strings.data() };
+    const size_t counts[NUM_SECTIONS] = { records.size(), figures.size(), floats.size(), strings.size() };
+
+    size_t offset = sizeof(header);
+    for(int s = 0; s < NUM_SECTIONS; s++)
+    {
+        header.sections[s].offset = (uint32_t) offset;
+        header.sections[s].count = (uint32_t) counts[s];
+        offset = _align(offset + counts[s]*s_recordSize[s]);
+    }
+
+    // the new index is kept in memory, so it's there even if it can't be saved
+    std::vector<char> buffer(offset, 0);
+    memcpy(buffer.data(), &header, sizeof(header));
+    for(int s = 0; s < NUM_SECTIONS; s++)
+    {
+        if(counts[s])
+            memcpy(buffer.data() + header.sections[s].offset, data[s], counts[s]*s_recordSize[s]);
+    }
+
+    std::string tmpPath = m_indexPath + ".tmp";
+    FILE *file = fopen(tmpPath.c_str(), "wb");
+    bool written = file != NULL && fwrite(buffer.data(), buffer.size(), 1, file) == 1;
+    if(file != NULL && fclose(file) != 0)
+        written = false;
+    if(!written || rename(tmpPath.c_str(), m_indexPath.c_str()) != 0)
+    {
+        fprintf(stderr, "AGDocumentIndex::_rebuild: error: unable to write '%s'\n", m_indexPath.c_str());
+        remove(tmpPath.c_str());
+    }
+
+    _unmap();
+    m_buffer.swap(buffer);
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    m_header = (const Header *) m_data;
+}
@@ -0,0 +1,174 @@
+//
+//  AGDocumentIndex.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include "Geometry.h"
+
+#include <functional>
+#include <list>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// ### AGDocumentIndex ###
+// Catalog of the document library, saved so that browsing the library doesn't
+// mean loading every document. For each document it keeps the file's
+// modification time and size and the glyphs of its name. Like
+// AGDocumentBinary, it's a header followed by sections of fixed-size records,
+// read in place from a mapping of the file:
+//
+//     Header     magic, version, the documents directory's modification
+//                time when indexed, and the offset and count of each section
+//     ENTRIES    EntryRecord, in library order
+//     FIGURES    FigureRecord, each entry's contiguous
+//     FLOATS     figure points, as x, y pairs
+//     STRINGS    filenames, each followed by a NUL
+//
+// Names are decoded a page of entries at a time, as they're asked for, so
+// opening the library costs what's shown rather than what's there.
+//
+// refresh() checks the index against the directory. Documents are saved by
+// renaming a new file into place, which modifies the directory, so if the
+// directory's modification time is the one indexed, nothing else is looked
+// at. Otherwise each document is stat'd and only those new or changed since
+// are read, and for their names alone. Modification times only go so fine,
+// so a directory or document modified within MTIME_SLACK_SECONDS of being
+// indexed could be modified again without its time changing; its time is
+// left out of the index, so it's checked again next time.
+//------------------------------------------------------------------------------
+#pragma mark - AGDocumentIndex
+
+class AGDocumentIndex
+{
+public:
+    static const uint32_t MAGIC = 0x58444741; // "AGDX"
+    static const uint32_t VERSION = 1;
+    /* names are decoded this many entries at a time... */
+    static const int PAGE_SIZE = 16;
+    /* ...and this many pages are kept decoded */
+    static const int MAX_PAGES = 8;
+    /* coarsest modification time resolution expected, e.g. HFS+'s 1 s */
+    static constexpr double MTIME_SLACK_SECONDS = 2.0;
+
+    typedef std::vector<std::vector<GLvertex2f>> Name;
+
+    enum Section
+    {
+        ENTRIES,
+        FIGURES,
+        FLOATS,
+        STRINGS,
+        NUM_SECTIONS,
+    };
+
+    struct SectionRecord
+    {
+        uint32_t offset; // bytes from the start of the file
+        uint32_t count; // of records
+    };
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        int64_t directoryMtime; // nanoseconds
+        uint32_t numSections;
+        uint32_t reserved;
+        SectionRecord sections[NUM_SECTIONS];
+    };
+
+    struct EntryRecord
+    {
+        int64_t mtime; // nanoseconds
+        int64_t size;
+        uint32_t filename; // offset into STRINGS
+        uint32_t filenameLength;
+        uint32_t firstFigure;
+        uint32_t numFigures;
+    };
+
+    struct FigureRecord
+    {
+        uint32_t firstFloat;
+        uint32_t numFloats; // twice the number of points
+    };
+
+    /* the index saved at indexPath, of the documents in directory; opened
+       here, but not checked against the directory until refresh() */
+    AGDocumentIndex(const std::string &indexPath, const std::string &directory);
+    ~AGDocumentIndex();
+    AGDocumentIndex(const AGDocumentIndex &) = delete;
+
+    /* bring the index up to date with the directory, where isDocument picks
+       out documents by filename, saving it if anything changed */
+    void refresh(const std::function<bool (const std::string &filename)> &isDocument);
+
+    int count() const { return m_header ? (int) m_header->sections[ENTRIES].count : 0; }
+    const char *filename(int i) const { return _strings() + _entry(i).filename; }
+    int64_t mtime(int i) const { return _entry(i).mtime; }
+    int64_t size(int i) const { return _entry(i).size; }
+    /* entry i's name, decoding its page if needed; valid until a name on
+       another page is decoded, or the index is refreshed */
+    const Name &name(int i);
+    /* the entry of filename, or -1 */
+    int find(const std::string &filename) const;
+
+    /* names for documents that don't have one of their own (e.g. from an
+       older library), saved with the index */
+    void setNames(const std::map<std::string, Name> &names);
+
+    /* documents read for their names by the last refresh() */
+    int numNamesRead() const { return m_numNamesRead; }
+    /* pages of names decoded since opening */
+    int numPagesDecoded() const { return m_numPagesDecoded; }
+
+private:
+    struct Pending
+    {
+        std::string filename;
+        int64_t mtime;
+        int64_t size;
+        Name name;
+    };
+
+    template<class T>
+    const T *_records(Section section) const
+    {
+        return (const T *) (m_data + m_header->sections[section].offset);
+    }
+
+    const EntryRecord &_entry(int i) const { return _records<EntryRecord>(ENTRIES)[i]; }
+    const char *_strings() const { return _records<char>(STRINGS); }
+
+    bool _map();
+    void _unmap();
+    bool _validate();
+    void _decodeName(int i, Name &name) const;
+    /* replace the index with entries, saving it */
+    void _rebuild(std::vector<Pending> &entries, int64_t directoryMtime);
+
+    std::string m_indexPath;
+    std::string m_directory;
+
+    // the index, mapped from disk or as last rebuilt
+    const char *m_data = NULL;
+    size_t m_size = 0;
+    bool m_mapped = false;
+    std::vector<char> m_buffer;
+    const Header *m_header = NULL;
+
+    // decoded names, by page, most recently decoded last
+    std::map<int, std::vector<Name>> m_pages;
+    std::list<int> m_pageOrder;
+
+    int m_numNamesRead = 0;
+    int m_numPagesDecoded = 0;
+};
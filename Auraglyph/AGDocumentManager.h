@@ -10,12 +10,14 @@
 #define AGDocumentManager_h
 
 #include "AGDocument.h"
+#include "AGDocumentIndex.h"
 
 #include "Geometry.h"
 
 #include <string>
 #include <vector>
 #include <list>
+#include <map>
 
 
 class AGDocumentManager
@@ -24,23 +26,21 @@ public:
     
     static AGDocumentManager &instance();
     
-    struct DocumentListing
-    {
-        std::string filename;
-        std::vector<std::vector<GLvertex2f>> name;
-    };
-    
     std::string save(const std::vector<std::vector<GLvertex2f>> &name, const AGDocument &doc);
     void update(const std::string &, const AGDocument &doc);
     AGDocument load(const std::string &);
-    const std::vector<DocumentListing> &list();
+    /* where a document in the library is saved, e.g. to autosave it */
+    std::string pathForFilename(const std::string &filename);
+    /* the documents in the library, as of now */
+    AGDocumentIndex &library();
     
 private:
     
-    std::vector<DocumentListing> *m_list;
+    AGDocumentIndex *m_library = NULL;
     
-    void _loadList(bool force = false);
-    void _saveList();
+    AGDocumentIndex &_library();
+    /* names from the document list kept before the library was indexed */
+    std::map<std::string, AGDocumentIndex::Name> _loadLegacyList();
 };
 
 
@@ -11,6 +11,7 @@
 #include "sputil.h"
 #include "AGFileManager.h"
 #include <set>
+#include <unistd.h>
 
 
 std::string documentLibraryPath()
@@ -20,12 +21,29 @@ std::string documentLibraryPath()
     return [docLibraryPath stlString];
 }
 
+std::string documentIndexPath()
+{
+    NSString *libraryPath = [NSSearchPathForDirectoriesInDomains(NSLibraryDirectory, NSUserDomainMask, YES) objectAtIndex:0];
+    NSString *indexPath = [libraryPath stringByAppendingPathComponent:@"documents.index"];
+    return [indexPath stlString];
+}
+
 std::string documentDirectory()
 {
     NSString *documentPath = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) objectAtIndex:0];
     return [documentPath stlString];
 }
 
+bool isDocumentFilename(const std::string &filename)
+{
+    if(!AGFileManager::instance().fileHasExtension(filename, AGDocument::JSON_EXTENSION) &&
+       !AGFileManager::instance().fileHasExtension(filename, AGDocument::BINARY_EXTENSION))
+        return false;
+    if(filename == "nodes.json")
+        return false;
+    return true;
+}
+
 
 AGDocumentManager &AGDocumentManager::instance()
 {
@@ -36,236 +54,154 @@ AGDocumentManager &AGDocumentManager::instance()
 
 std::string AGDocumentManager::save(const std::vector<std::vector<GLvertex2f>> &name, const AGDocument &doc)
 {
-    _loadList();
-    
     std::string filename = makeUUID() + ".json";
     std::string filepath = documentDirectory() + "/" + filename;
     
     doc.saveToPath(filepath);
     
-    m_list->push_back({filename, name});
-    
-    _saveList();
+    // the library reads names from the documents themselves; if this one
+    // didn't have it, give it to the library instead
+    AGDocumentIndex &library = this->library();
+    int i = library.find(filename);
+    if(i >= 0 && library.name(i).size() == 0)
+        library.setNames({ { filename, name } });
     
     return filename;
 }
 
 void AGDocumentManager::update(const std::string &filename, const AGDocument &doc)
 {
-    std::string filepath = documentDirectory() + "/" + filename;
-    doc.saveToPath(filepath);
+    doc.saveToPath(pathForFilename(filename));
+}
+
+std::string AGDocumentManager::pathForFilename(const std::string &filename)
+{
+    return documentDirectory() + "/" + filename;
 }
 
 AGDocument AGDocumentManager::load(const std::string &filename)
 {
-    std::string filepath = documentDirectory() + "/" + filename;
+    std::string filepath = pathForFilename(filename);
     AGDocument doc;
     doc.loadFromPath(filepath);
     
     // set name, if needed
     if(doc.name().size() == 0)
     {
-        // find this doc in listing
-        for(auto listing : *m_list)
-        {
-            if(listing.filename == filename)
-            {
-                doc.setName(listing.name);
-                break;
-            }
-        }
+        // find this doc in the library
+        AGDocumentIndex &library = _library();
+        int i = library.find(filename);
+        if(i >= 0)
+            doc.setName(library.name(i));
     }
     
     return doc;
 }
 
-const std::vector<AGDocumentManager::DocumentListing> &AGDocumentManager::list()
+AGDocumentIndex &AGDocumentManager::library()
 {
-    _loadList(true);
-    return *m_list;
+    AGDocumentIndex &library = _library();
+    library.refresh(isDocumentFilename);
+    return library;
 }
 
-void AGDocumentManager::_loadList(bool force)
+AGDocumentIndex &AGDocumentManager::_library()
 {
-    if(m_list == NULL || force)
+    if(m_library == NULL)
     {
-        /* load cached file list */
+        std::string indexPath = documentIndexPath();
+        bool isNew = access(indexPath.c_str(), F_OK) != 0;
         
-        NSString *libraryPath = [NSString stringWithSTLString:documentLibraryPath()];
-        NSFileManager *fileManager = [NSFileManager defaultManager];
+        m_library = new AGDocumentIndex(indexPath, documentDirectory());
+        m_library->refresh(isDocumentFilename);
         
-        if(![fileManager fileExistsAtPath:libraryPath])
-        {
-            // library file doesn't exist - use default (empty) library
-            m_list = new std::vector<DocumentListing>;
-            return;
-        }
-        
-        NSError *error = nil;
-        // read data from disk
-        NSData *data = [NSData dataWithContentsOfFile:libraryPath
-                                              options:0 error:&error];
-        if(error != nil)
-        {
-            NSLog(@"error: loading document list: %@", error);
-            return;
-        }
-        
-        if(data == nil)
-        {
-            NSLog(@"error: loading document list");
-            return;
-        }
-        
-        NSArray *listObj = [NSJSONSerialization JSONObjectWithData:data
-                                                           options:0
-                                                             error:&error];
-        if(error != nil)
-        {
-            NSLog(@"error: deserializing document list: %@", error);
-            return;
-        }
-        
-        if(listObj == nil)
-        {
-            NSLog(@"error: deserializing document list");
-            return;
-        }
+        // documents listed before the library was indexed may only have
+        // their names in the old list
+        if(isNew)
+            m_library->setNames(_loadLegacyList());
+    }
+    
+    return *m_library;
+}
+
+std::map<std::string, AGDocumentIndex::Name> AGDocumentManager::_loadLegacyList()
+{
+    std::map<std::string, AGDocumentIndex::Name> names;
+    
+    NSString *libraryPath = [NSString stringWithSTLString:documentLibraryPath()];
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    
+    if(![fileManager fileExistsAtPath:libraryPath])
+        return names;
+    
+    NSError *error = nil;
+    // read data from disk
+    NSData *data = [NSData dataWithContentsOfFile:libraryPath
+                                          options:0 error:&error];
+    if(error != nil)
+    {
+        NSLog(@"error: loading document list: %@", error);
+        return names;
+    }
+    
+    if(data == nil)
+    {
+        NSLog(@"error: loading document list");
+        return names;
+    }
+    
+    NSArray *listObj = [NSJSONSerialization JSONObjectWithData:data
+                                                       options:0
+                                                         error:&error];
+    if(error != nil)
+    {
+        NSLog(@"error: deserializing document list: %@", error);
+        return names;
+    }
+    
+    if(listObj == nil)
+    {
+        NSLog(@"error: deserializing document list");
+        return names;
+    }
+    
+    for(NSDictionary *fileObj in listObj)
+    {
+        if(fileObj[@"filename"] == nil) continue;
+        if(fileObj[@"name"] == nil) continue;
         
-        auto list = new std::vector<DocumentListing>;
-        std::set<std::string> filenameSet;
-        bool didUpdateList = false;
+        std::string filename = [(NSString *) fileObj[@"filename"] stlString];
         
-        for(NSDictionary *fileObj in listObj)
+        bool isValid = true;
+        std::vector<std::vector<GLvertex2f>> name;
+        for(NSArray *figureObj in fileObj[@"name"])
         {
-            if(fileObj[@"filename"] == nil) continue;
-            if(fileObj[@"name"] == nil) continue;
-            
-            std::string filename = [(NSString *) fileObj[@"filename"] stlString];
+            std::vector<GLvertex2f> figure;
             
-            // verify existence on disk
-            std::string filepath = documentDirectory() + "/" + filename;
-            BOOL isDirectory = NO;
-            if(![fileManager fileExistsAtPath:[NSString stringWithSTLString:filepath]
-                                  isDirectory:&isDirectory]
-               || isDirectory)
+            for(NSArray *pointObj in figureObj)
             {
-                // file no longer exists; skip it
-                didUpdateList = true;
-                continue;
-            }
-            
-            bool isValid = true;
-            std::vector<std::vector<GLvertex2f>> name;
-            for(NSArray *figureObj in fileObj[@"name"])
-            {
-                std::vector<GLvertex2f> figure;
-                
-                for(NSArray *pointObj in figureObj)
+                if([pointObj count] != 2)
                 {
-                    if([pointObj count] != 2)
-                    {
-                        isValid = false;
-                        break;
-                    }
-                    
-                    float x = [pointObj[0] floatValue];
-                    float y = [pointObj[1] floatValue];
-                    figure.push_back({ x, y });
+                    isValid = false;
+                    break;
                 }
                 
-                if(!isValid) break;
-                
-                name.push_back(figure);
+                float x = [pointObj[0] floatValue];
+                float y = [pointObj[1] floatValue];
+                figure.push_back({ x, y });
             }
             
-            if(!isValid) continue;
-            
-            filenameSet.insert(filename);
-            list->push_back({ filename, name });
-        }
-        
-        /* scan for new items on the list */
-        NSString *documentDir = [NSString stringWithSTLString:documentDirectory()];
-        NSArray *files = [fileManager contentsOfDirectoryAtPath:documentDir error:&error];
-        for(NSString *file in files)
-        {
-            std::string filename = [file stlString];
-            if(!AGFileManager::instance().fileHasExtension(filename, "json"))
-                continue;
-            if(filename == "nodes.json")
-                continue;
-            
-            if(!filenameSet.count(filename))
-            {
-                didUpdateList = true;
-                // load it
-                AGDocument doc = load(filename);
-                // pull out name
-                auto name = doc.name();
-                // add to list
-                list->push_back({ filename, name });
-            }
-        }
-
-        m_list = list;
-        
-        /* save updated list */
-        if(didUpdateList)
-            _saveList();
-    }
-}
-
-void AGDocumentManager::_saveList()
-{
-    if(m_list != NULL)
-    {
-        NSMutableArray *listObj = [NSMutableArray arrayWithCapacity:m_list->size()];
-        // package into NSArray
-        for(auto file : *m_list)
-        {
-            // array of array of 2d points (array of floats)
-            NSMutableArray *nameObj = [NSMutableArray arrayWithCapacity:file.name.size()];
-            // for each figure (array of points)
-            for(auto figure : file.name)
-            {
-                // array of 2d points (array of floats)
-                NSMutableArray *figureObj = [NSMutableArray arrayWithCapacity:figure.size()];
-                // for each point
-                for(auto point : figure)
-                    [figureObj addObject:@[@(point.x), @(point.y)]];
-                [nameObj addObject:figureObj];
-            }
+            if(!isValid) break;
             
-            [listObj addObject:@{ @"filename": [NSString stringWithSTLString:file.filename],
-                                  @"name": nameObj }];
+            name.push_back(figure);
         }
         
-        NSError *error = nil;
-        NSData *data = [NSJSONSerialization dataWithJSONObject:listObj
-                                                       options:NSJSONWritingPrettyPrinted
-                                                         error:&error];
-        if(error != nil)
-        {
-            NSLog(@"error: serializing document list: %@", error);
-            return;
-        }
+        if(!isValid) continue;
         
-        if(data == nil)
-        {
-            NSLog(@"error: serializing document list");
-            return;
-        }
-        
-        [data writeToFile:[NSString stringWithSTLString:documentLibraryPath()]
-                  options:NSDataWritingAtomic error:&error];
-        
-        if(error != nil)
-        {
-            NSLog(@"error: writing document list: %@", error);
-            return;
-        }
+        names[filename] = name;
     }
+    
+    return names;
 }
 
 
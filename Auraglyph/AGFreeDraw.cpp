@@ -9,6 +9,7 @@
 #include "AGFreeDraw.h"
 
 #include "AGNode.h"
+#include "AGGraphManager.h"
 #include "AGDocument.h"
 #include "AGInteractiveObject.h"
 #include "AGGenericShader.h"
@@ -24,8 +25,8 @@
 #pragma mark - AGFreeDraw
 
 AGFreeDraw::AGFreeDraw(GLvertex3f *points, unsigned long nPoints) :
-m_active(true),
-m_uuid(makeUUID())
+m_uuid(makeUUID()),
+m_active(true)
 {
     m_points = vector<GLvertex3f>(points, points + nPoints);
     
@@ -36,12 +37,14 @@ m_uuid(makeUUID())
     m_alpha.forceTo(1);
     
     m_touchPoint0 = -1;
+    
+    _initBounds();
 }
 
 AGFreeDraw::AGFreeDraw(const AGDocument::Freedraw &docFreedraw) :
-m_active(true),
+m_uuid(docFreedraw.uuid),
+m_active(true)
 //m_alpha(1, 0, 0.5, 2),
-m_uuid(docFreedraw.uuid)
 {
     int nPoints = (int) docFreedraw.points.size()/3;
     
@@ -60,10 +63,28 @@ m_uuid(docFreedraw.uuid)
     m_pos = GLvertex3f(docFreedraw.x, docFreedraw.y, docFreedraw.z);
     
     m_touchPoint0 = -1;
+    
+    _initBounds();
 }
 
 AGFreeDraw::~AGFreeDraw() { }
 
+void AGFreeDraw::_initBounds()
+{
+    if(m_points.size())
+        m_pointBounds = AGBoundingBox(m_points[0].xy(), m_points[0].xy());
+    for(const GLvertex3f &point : m_points)
+        m_pointBounds.unite(point.xy());
+}
+
+void AGFreeDraw::setPosition(const GLvertex3f &pos)
+{
+    AGUIObject::setPosition(pos);
+    markEdited();
+    // move it in the hit-testing index
+    AGGraphManager::instance().freedrawDidMove(this);
+}
+
 void AGFreeDraw::update(float t, float dt)
 {
     AGRenderObject::update(t, dt);
@@ -170,6 +191,33 @@ AGUIObject *AGFreeDraw::hitTest(const GLvertex3f &_t)
 #endif // 0
 }
 
+bool AGFreeDraw::hitsCircle(const GLvertex2f &center, float radius)
+{
+    GLvertex2f pos = m_pos.xy();
+    
+    if(m_points.size() == 1)
+        return pointInCircle(m_points[0].xy() + pos, center, radius);
+    
+    for(int i = 0; i+1 < (int) m_points.size(); i++)
+    {
+        GLvertex2f p0 = m_points[i].xy() + pos;
+        GLvertex2f p1 = m_points[i+1].xy() + pos;
+        
+        if(pointInCircle(p0, center, radius) ||
+           (i+2 == (int) m_points.size() && pointInCircle(p1, center, radius)) ||
+           pointOnLine(center, p0, p1, radius))
+            return true;
+    }
+    
+    return false;
+}
+
+AGBoundingBox AGFreeDraw::hitBounds() const
+{
+    GLvertex2f pos = m_pos.xy();
+    return AGBoundingBox(m_pointBounds.min + pos, m_pointBounds.max + pos);
+}
+
 AGDocument::Freedraw AGFreeDraw::serialize()
 {
     AGDocument::Freedraw fd;
@@ -179,7 +227,7 @@ AGDocument::Freedraw AGFreeDraw::serialize()
     fd.z = position().z;
     
     fd.points.reserve(m_points.size()*3);
-    for(int i = 0; i < m_points.size(); i++)
+    for(int i = 0; i < (int) m_points.size(); i++)
     {
         fd.points.push_back(m_points[i].x);
         fd.points.push_back(m_points[i].y);
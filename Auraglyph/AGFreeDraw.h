@@ -11,6 +11,7 @@
 
 #include "AGDocument.h"
 #include "AGUserInterface.h"
+#include "AGSpatialIndex.h"
 
 //------------------------------------------------------------------------------
 // ### AGFreeDraw ###
@@ -25,6 +26,7 @@ public:
     ~AGFreeDraw();
     
     const string &uuid() { return m_uuid; }
+    void setPosition(const GLvertex3f &pos) override;
     
     virtual void update(float t, float dt);
     virtual void render();
@@ -35,6 +37,10 @@ public:
     
     const vector<GLvertex3f> &points();
     virtual AGUIObject *hitTest(const GLvertex3f &t);
+    /* if any of the stroke is within radius of center */
+    bool hitsCircle(const GLvertex2f &center, float radius);
+    /* the whole stroke, in world coordinates */
+    AGBoundingBox hitBounds() const;
     
     virtual AGDocument::Freedraw serialize();
     
@@ -42,6 +48,10 @@ private:
     const string m_uuid;
     
     vector<GLvertex3f> m_points;
+    // of m_points, relative to m_pos
+    AGBoundingBox m_pointBounds;
+    
+    void _initBounds();
     
     bool m_touchDown;
     GLvertex3f m_touchLast;
@@ -7,7 +7,9 @@
 //
 
 #import "AGGenericShader.h"
+#ifndef AG_HEADLESS
 #import "ShaderHelper.h"
+#endif // AG_HEADLESS
 #import "AGAudioNode.h"
 
 
@@ -22,8 +24,12 @@ AGGenericShader &AGGenericShader::instance()
 
 AGGenericShader::AGGenericShader(const string &name, EnableAttributes attributes)
 {
+#ifndef AG_HEADLESS
     m_program = [ShaderHelper createProgram:[NSString stringWithUTF8String:name.c_str()]
                              withAttributes:attributes];
+#else
+    m_program = 0;
+#endif // AG_HEADLESS
     m_uniformMVPMatrix = glGetUniformLocation(m_program, "modelViewProjectionMatrix");
     m_uniformNormalMatrix = glGetUniformLocation(m_program, "normalMatrix");
     
@@ -33,8 +39,12 @@ AGGenericShader::AGGenericShader(const string &name, EnableAttributes attributes
 
 AGGenericShader::AGGenericShader(const string &name, const map<int, string> &attributeMap)
 {
+#ifndef AG_HEADLESS
     m_program = [ShaderHelper createProgram:[NSString stringWithUTF8String:name.c_str()]
                            withAttributeMap:attributeMap];
+#else
+    m_program = 0;
+#endif // AG_HEADLESS
     m_uniformMVPMatrix = glGetUniformLocation(m_program, "modelViewProjectionMatrix");
     m_uniformNormalMatrix = glGetUniformLocation(m_program, "normalMatrix");
     
@@ -8,7 +8,12 @@
 
 #include "AGGraphManager.h"
 #include "AGNode.h"
+#include "AGFreeDraw.h"
 #include "AGViewController.h"
+#include "AGStyle.h"
+
+// about the width of a node
+static const float s_cellSize = 0.02*AGStyle::oldGlobalScale;
 
 AGGraphManager &AGGraphManager::instance()
 {
@@ -17,7 +22,8 @@ AGGraphManager &AGGraphManager::instance()
 }
 
 AGGraphManager::AGGraphManager()
-: m_viewController(nullptr)
+: m_viewController(nullptr),
+m_nodeIndex(s_cellSize), m_connectionIndex(s_cellSize), m_freedrawIndex(s_cellSize)
 { }
 
 AGGraphManager::~AGGraphManager()
@@ -46,11 +52,14 @@ AGConnection *AGGraphManager::connectionWithUUID(const std::string &uuid)
 void AGGraphManager::addConnection(AGConnection *connection)
 {
     m_connections[connection->uuid()] = connection;
+    if(_isOnCanvas(connection))
+        m_connectionIndex.insert(connection, connection->hitBounds());
 }
 
 void AGGraphManager::removeConnection(AGConnection *connection)
 {
     m_connections.erase(connection->uuid());
+    m_connectionIndex.remove(connection);
 }
 
 void AGGraphManager::setViewController(AGViewController_ *viewController)
@@ -58,3 +67,54 @@ void AGGraphManager::setViewController(AGViewController_ *viewController)
     m_viewController = viewController;
 }
 
+void AGGraphManager::indexNode(AGNode *node)
+{
+    m_nodeIndex.insert(node, node->hitBounds());
+    
+    // connections end at the node's ports, so they move with it
+    for(AGConnection *connection : node->inbound())
+        if(_isOnCanvas(connection))
+            m_connectionIndex.insert(connection, connection->hitBounds());
+    for(AGConnection *connection : node->outbound())
+        if(_isOnCanvas(connection))
+            m_connectionIndex.insert(connection, connection->hitBounds());
+}
+
+void AGGraphManager::unindexNode(AGNode *node)
+{
+    m_nodeIndex.remove(node);
+    
+    // e.g. coalesced into a composite; its connections go with it
+    for(AGConnection *connection : node->inbound())
+        m_connectionIndex.remove(connection);
+    for(AGConnection *connection : node->outbound())
+        m_connectionIndex.remove(connection);
+}
+
+bool AGGraphManager::_isOnCanvas(AGConnection *connection)
+{
+    // not inside a composite, or between a composite's voices
+    return m_nodeIndex.contains(connection->src()) && m_nodeIndex.contains(connection->dst());
+}
+
+void AGGraphManager::nodeDidMove(AGNode *node)
+{
+    if(m_nodeIndex.contains(node))
+        indexNode(node);
+}
+
+void AGGraphManager::indexFreedraw(AGFreeDraw *freedraw)
+{
+    m_freedrawIndex.insert(freedraw, freedraw->hitBounds());
+}
+
+void AGGraphManager::unindexFreedraw(AGFreeDraw *freedraw)
+{
+    m_freedrawIndex.remove(freedraw);
+}
+
+void AGGraphManager::freedrawDidMove(AGFreeDraw *freedraw)
+{
+    if(m_freedrawIndex.contains(freedraw))
+        indexFreedraw(freedraw);
+}
@@ -8,11 +8,14 @@
 
 #pragma once
 
+#include "AGSpatialIndex.h"
+
 #include <string>
 #include <map>
 
 class AGNode;
 class AGConnection;
+class AGFreeDraw;
 class AGViewController_;
 
 class AGGraphManager
@@ -33,8 +36,28 @@ public:
     
     void setViewController(AGViewController_ *viewController);
     
+    /* hit-testing: what's on the canvas, by where it can be hit. Nodes and
+       freedraws are indexed once added to the canvas, and moved with
+       setPosition(); connections whenever both of their nodes are indexed. */
+    void indexNode(AGNode *node);
+    void unindexNode(AGNode *node);
+    void nodeDidMove(AGNode *node);
+    void indexFreedraw(AGFreeDraw *freedraw);
+    void unindexFreedraw(AGFreeDraw *freedraw);
+    void freedrawDidMove(AGFreeDraw *freedraw);
+    
+    const AGSpatialIndex<AGNode> &nodeIndex() const { return m_nodeIndex; }
+    const AGSpatialIndex<AGConnection> &connectionIndex() const { return m_connectionIndex; }
+    const AGSpatialIndex<AGFreeDraw> &freedrawIndex() const { return m_freedrawIndex; }
+    
 private:
     AGViewController_ *m_viewController;
     
     std::map<std::string, AGConnection *> m_connections;
+    
+    AGSpatialIndex<AGNode> m_nodeIndex;
+    AGSpatialIndex<AGConnection> m_connectionIndex;
+    AGSpatialIndex<AGFreeDraw> m_freedrawIndex;
+    
+    bool _isOnCanvas(AGConnection *connection);
 };
@@ -0,0 +1,323 @@
+//
+//  AGHitTestBenchmark.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGHitTestBenchmark.h"
+#include "AGConnection.h"
+#include "AGFreeDraw.h"
+#include "AGGraphManager.h"
+#include "AGNode.h"
+#include "AGStyle.h"
+
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+
+// seconds per call of fn, called repeatedly for at least minTime
+template<class Fn>
+static double _time(double minTime, Fn fn)
+{
+    using namespace std::chrono;
+
+    int num = 0;
+    auto start = steady_clock::now();
+    double elapsed = 0;
+    while(elapsed < minTime)
+    {
+        fn();
+        num++;
+        elapsed = duration<double>(steady_clock::now()-start).count();
+    }
+
+    return elapsed/num;
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGHitTestBenchmark ###
+//------------------------------------------------------------------------------
+#pragma mark - AGHitTestBenchmark
+
+AGHitTestBenchmark::Result AGHitTestBenchmark::run(int numNodes, int numFreedraws, double minTime)
+{
+    Result result;
+    result.numNodes = numNodes;
+    result.numFreedraws = numFreedraws;
+    result.numQueries = 1000;
+    result.same = true;
+
+    AGGraphManager &graph = AGGraphManager::instance();
+    std::mt19937 random(1);
+    auto uniform = [&](float lo, float hi) { return std::uniform_real_distribution<float>(lo, hi)(random); };
+
+    // nodes on a grid, a few node widths apart
+    float spacing = 0.03*AGStyle::oldGlobalScale;
+    int columns = (int) ceilf(sqrtf(numNodes));
+    float width = columns*spacing;
+
+    std::vector<AGNode *> nodes;
+    for(int i = 0; i < numNodes; i++)
+    {
+        GLvertex3f pos((i%columns)*spacing, (i/columns)*spacing, 0);
+        AGNode *node = AGNodeManager::audioNodeManager().createNodeOfType("SineWave", pos);
+        graph.indexNode(node);
+        nodes.push_back(node);
+    }
+
+    // each to the next, and some far across
+    std::vector<AGConnection *> connections;
+    for(int i = 1; i < numNodes; i++)
+    {
+        connections.push_back(AGConnection::connect(nodes[i-1], 0, nodes[i], 0));
+        if(i%10 == 0)
+        {
+            AGNode *dst = nodes[random()%numNodes];
+            connections.push_back(AGConnection::connect(nodes[i], 0, dst, dst->numInputPorts()-1));
+        }
+    }
+    result.numConnections = (int) connections.size();
+    
+    // and some connected over the top of them that aren't on the canvas, as
+    // inside a composite; touches shouldn't find these
+    std::vector<AGNode *> hiddenNodes;
+    std::vector<AGConnection *> hiddenConnections;
+    for(int i = 0; i < numNodes; i += 10)
+    {
+        AGNode *node = AGNodeManager::audioNodeManager().createNodeOfType("SineWave", nodes[i]->position());
+        if(hiddenNodes.size())
+            hiddenConnections.push_back(AGConnection::connect(hiddenNodes.back(), 0, node, 0));
+        hiddenNodes.push_back(node);
+    }
+    
+    // a frame, to bring the connections' terminals to their nodes
+    for(AGConnection *connection : connections)
+        connection->update(0, 1.0/60.0);
+    for(AGConnection *connection : hiddenConnections)
+        connection->update(0, 1.0/60.0);
+
+    // short scribbles, anywhere
+    auto makeFreedraw = [&]() {
+        GLvertex3f points[16];
+        GLvertex3f point;
+        for(int j = 0; j < 16; j++)
+        {
+            points[j] = point;
+            point = point + GLvertex3f(uniform(-8, 8), uniform(-8, 8), 0);
+        }
+        AGFreeDraw *freedraw = new AGFreeDraw(points, 16);
+        freedraw->setPosition(GLvertex3f(uniform(0, width), uniform(0, width), 0));
+        return freedraw;
+    };
+
+    std::vector<AGFreeDraw *> freedraws;
+    for(int i = 0; i < numFreedraws; i++)
+    {
+        freedraws.push_back(makeFreedraw());
+        graph.indexFreedraw(freedraws.back());
+    }
+
+    // touches on nodes, on connections, on freedraws, and anywhere
+    std::vector<GLvertex2f> queries;
+    for(int i = 0; i < result.numQueries; i++)
+    {
+        GLvertex2f point;
+        switch(i%4)
+        {
+            case 0: point = nodes[random()%nodes.size()]->position().xy(); break;
+            case 1: {
+                AGConnection *connection = connections[random()%connections.size()];
+                GLvertex2f p0 = connection->src()->positionForOutboundConnection(connection).xy();
+                GLvertex2f p1 = connection->dst()->positionForInboundConnection(connection).xy();
+                point = p0 + (p1-p0)*uniform(0, 1);
+                break;
+            }
+            case 2: point = freedraws[random()%freedraws.size()]->hitBounds().min; break;
+            default: point = GLvertex2f(uniform(0, width), uniform(0, width)); break;
+        }
+        queries.push_back(point + GLvertex2f(uniform(-20, 20), uniform(-20, 20)));
+    }
+
+    float eraserThresh = 0.005*AGStyle::oldGlobalScale;
+    std::vector<AGNode *> nodeHits;
+    std::vector<AGConnection *> connectionHits;
+    std::vector<AGFreeDraw *> freedrawHits;
+
+    // as hitTest:node:port: does; the first node hit, and how
+    auto nodeLinear = [&](const GLvertex2f &point, int &port) -> std::pair<AGNode *, int> {
+        for(AGNode *node : nodes)
+        {
+            AGNode::HitTestResult hit = node->hit(GLvertex3f(point.x, point.y, 0), &port);
+            if(hit != AGNode::HIT_NONE)
+                return std::make_pair(node, (int) hit);
+        }
+        return std::make_pair((AGNode *) NULL, 0);
+    };
+
+    auto nodeIndexed = [&](const GLvertex2f &point, int &port) -> std::pair<AGNode *, int> {
+        graph.nodeIndex().query(point, 0, nodeHits);
+        for(AGNode *node : nodeHits)
+        {
+            AGNode::HitTestResult hit = node->hit(GLvertex3f(point.x, point.y, 0), &port);
+            if(hit != AGNode::HIT_NONE)
+                return std::make_pair(node, (int) hit);
+        }
+        return std::make_pair((AGNode *) NULL, 0);
+    };
+
+    auto connectionLinear = [&](const GLvertex2f &point) -> AGConnection * {
+        for(AGConnection *connection : connections)
+            if(connection->hitTest(GLvertex3f(point.x, point.y, 0)))
+                return connection;
+        return NULL;
+    };
+
+    auto connectionIndexed = [&](const GLvertex2f &point) -> AGConnection * {
+        graph.connectionIndex().query(point, AGConnection::hitDistance(), connectionHits);
+        for(AGConnection *connection : connectionHits)
+            if(connection->hitTest(GLvertex3f(point.x, point.y, 0)))
+                return connection;
+        return NULL;
+    };
+
+    // as the eraser does; every freedraw it touches
+    auto eraseLinear = [&](const GLvertex2f &point, std::vector<AGFreeDraw *> &hits) {
+        hits.clear();
+        for(AGFreeDraw *freedraw : freedraws)
+            if(freedraw->hitsCircle(point, eraserThresh))
+                hits.push_back(freedraw);
+    };
+
+    auto eraseIndexed = [&](const GLvertex2f &point, std::vector<AGFreeDraw *> &hits) {
+        graph.freedrawIndex().query(point, eraserThresh, freedrawHits);
+        hits.clear();
+        for(AGFreeDraw *freedraw : freedrawHits)
+            if(freedraw->hitsCircle(point, eraserThresh))
+                hits.push_back(freedraw);
+    };
+
+    // freedraws that might be near a drag from one touch to the next
+    auto segmentEnd = [&](int i) { return queries[i] + GLvertex2f(i%7-3, i%5-2)*10; };
+
+    auto segmentLinear = [&](const GLvertex2f &p0, const GLvertex2f &p1, std::vector<AGFreeDraw *> &hits) {
+        hits.clear();
+        for(AGFreeDraw *freedraw : freedraws)
+            if(freedraw->hitBounds().near(p0, p1, eraserThresh))
+                hits.push_back(freedraw);
+    };
+
+    auto segmentIndexed = [&](const GLvertex2f &p0, const GLvertex2f &p1, std::vector<AGFreeDraw *> &hits) {
+        graph.freedrawIndex().query(p0, p1, eraserThresh, hits);
+    };
+
+    // same answers
+    auto checkNodes = [&]() {
+        for(const GLvertex2f &point : queries)
+        {
+            int port0 = -1, port1 = -1;
+            if(nodeLinear(point, port0) != nodeIndexed(point, port1) || port0 != port1)
+                result.same = false;
+        }
+    };
+
+    checkNodes();
+    std::vector<AGFreeDraw *> hits0, hits1;
+    for(int i = 0; i < (int) queries.size(); i++)
+    {
+        const GLvertex2f &point = queries[i];
+        if(connectionLinear(point) != connectionIndexed(point))
+            result.same = false;
+        eraseLinear(point, hits0);
+        eraseIndexed(point, hits1);
+        if(hits0 != hits1)
+            result.same = false;
+        segmentLinear(point, segmentEnd(i), hits0);
+        segmentIndexed(point, segmentEnd(i), hits1);
+        if(hits0 != hits1)
+            result.same = false;
+    }
+
+    // times, per query
+    int port;
+    double n = queries.size();
+    result.nodeLinearUs = _time(minTime, [&]() { for(auto &point : queries) nodeLinear(point, port); })/n*1e6;
+    result.nodeIndexedUs = _time(minTime, [&]() { for(auto &point : queries) nodeIndexed(point, port); })/n*1e6;
+    result.connectionLinearUs = _time(minTime, [&]() { for(auto &point : queries) connectionLinear(point); })/n*1e6;
+    result.connectionIndexedUs = _time(minTime, [&]() { for(auto &point : queries) connectionIndexed(point); })/n*1e6;
+    result.eraseLinearUs = _time(minTime, [&]() { for(auto &point : queries) eraseLinear(point, hits0); })/n*1e6;
+    result.eraseIndexedUs = _time(minTime, [&]() { for(auto &point : queries) eraseIndexed(point, hits0); })/n*1e6;
+    result.segmentLinearUs = _time(minTime, [&]() {
+        for(int i = 0; i < (int) queries.size(); i++) segmentLinear(queries[i], segmentEnd(i), hits0);
+    })/n*1e6;
+    result.segmentIndexedUs = _time(minTime, [&]() {
+        for(int i = 0; i < (int) queries.size(); i++) segmentIndexed(queries[i], segmentEnd(i), hits0);
+    })/n*1e6;
+
+    // dragging nodes around, a little at a time
+    int numMoves = 0;
+    result.moveUs = _time(minTime, [&]() {
+        AGNode *node = nodes[(numMoves*7919)%nodes.size()];
+        float step = (numMoves/nodes.size())%2 ? -5 : 5;
+        node->setPosition(node->position() + GLvertex3f(step, step, 0));
+        numMoves++;
+    })*1e6;
+    // still the same, wherever they ended up
+    checkNodes();
+
+    std::vector<AGFreeDraw *> spares;
+    for(int i = 0; i < 100; i++)
+        spares.push_back(makeFreedraw());
+    int numSpares = 0;
+    result.freedrawUs = _time(minTime, [&]() {
+        AGFreeDraw *freedraw = spares[numSpares++%spares.size()];
+        graph.indexFreedraw(freedraw);
+        graph.unindexFreedraw(freedraw);
+    })*1e6;
+
+    for(AGFreeDraw *freedraw : spares)
+        delete freedraw;
+    for(AGFreeDraw *freedraw : freedraws)
+    {
+        graph.unindexFreedraw(freedraw);
+        delete freedraw;
+    }
+    for(AGConnection *connection : connections)
+    {
+        AGNode::disconnect(connection);
+        delete connection;
+    }
+    for(AGConnection *connection : hiddenConnections)
+    {
+        AGNode::disconnect(connection);
+        delete connection;
+    }
+    for(AGNode *node : nodes)
+    {
+        graph.unindexNode(node);
+        delete node;
+    }
+    for(AGNode *node : hiddenNodes)
+        delete node;
+
+    fprintf(stderr, "%i nodes, %i connections, %i freedraws (us per query)\n",
+            result.numNodes, result.numConnections, result.numFreedraws);
+    fprintf(stderr, "%-28s %10s %10s %8s\n", "", "linear", "indexed", "speedup");
+    auto row = [](const char *name, double linear, double indexed) {
+        fprintf(stderr, "%-28s %10.3f %10.3f %7.1fx\n", name, linear, indexed, linear/indexed);
+    };
+    row("node or port", result.nodeLinearUs, result.nodeIndexedUs);
+    row("connection", result.connectionLinearUs, result.connectionIndexedUs);
+    row("eraser, at a point", result.eraseLinearUs, result.eraseIndexedUs);
+    row("freedraws near a drag", result.segmentLinearUs, result.segmentIndexedUs);
+    fprintf(stderr, "%-28s %10.3f us\n", "moving a node", result.moveUs);
+    fprintf(stderr, "%-28s %10.3f us\n", "adding and erasing a stroke", result.freedrawUs);
+    fprintf(stderr, "indexed hits match: %s\n", result.same ? "yes" : "NO");
+
+    return result;
+}
@@ -0,0 +1,47 @@
+//
+//  AGHitTestBenchmark.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+//------------------------------------------------------------------------------
+// ### AGHitTestBenchmark ###
+// Times hit-testing a large canvas through AGGraphManager's spatial indexes,
+// against walking every node, connection and freedraw as touch handling used
+// to, and checks that both find the same things. Also times keeping the
+// indexes up to date: moving a node (and its connections) and adding and
+// erasing a freedraw.
+//------------------------------------------------------------------------------
+#pragma mark - AGHitTestBenchmark
+
+class AGHitTestBenchmark
+{
+public:
+    struct Result
+    {
+        int numNodes;
+        int numConnections;
+        int numFreedraws;
+        int numQueries;
+        // per query, in microseconds; linear, then indexed
+        double nodeLinearUs, nodeIndexedUs; // tapping a node or port
+        double connectionLinearUs, connectionIndexedUs; // tapping a connection
+        double eraseLinearUs, eraseIndexedUs; // the eraser, at a point
+        double segmentLinearUs, segmentIndexedUs; // freedraws near a drag
+        // per update, in microseconds
+        double moveUs; // moving a node and its connections
+        double freedrawUs; // adding a freedraw and erasing it
+        bool same; // indexed queries found what linear ones did
+    };
+
+    /* build a canvas of numNodes nodes, chained by connections with a tenth
+       of them also connected across the canvas, and numFreedraws freedraws,
+       then run each test for at least minTime seconds; prints a summary to
+       stderr. Connections between nodes off the canvas are laid over it too,
+       which indexed queries must not find. */
+    static Result run(int numNodes, int numFreedraws, double minTime);
+};
@@ -13,6 +13,8 @@
 #include "AGRenderObject.h"
 #include "gfx.h"
 
+#include <atomic>
+
 
 #ifdef __LP64__ // arm64
 typedef uint64_t TouchID;
@@ -101,6 +103,18 @@ public:
     
     static void addTouchOutsideListener(AGInteractiveObject *);
     static void removeTouchOutsideListener(AGInteractiveObject *);
+    
+    /* increases whenever anything a document saves of this object changes,
+       so only edited objects need to be serialized again */
+    unsigned long revision() const { return m_revision.load(std::memory_order_relaxed); }
+    /* the newest revision of any object; unchanged if nothing was edited */
+    static unsigned long lastRevision() { return s_lastRevision.load(std::memory_order_relaxed); }
+    /* call when saved state changes; safe off the main thread */
+    void markEdited();
+    
+private:
+    std::atomic<unsigned long> m_revision;
+    static std::atomic<unsigned long> s_lastRevision;
 };
 
 
@@ -14,10 +14,20 @@
 //------------------------------------------------------------------------------
 #pragma mark - AGInteractiveObject
 
-AGInteractiveObject::AGInteractiveObject() { }
+std::atomic<unsigned long> AGInteractiveObject::s_lastRevision(0);
+
+AGInteractiveObject::AGInteractiveObject()
+{
+    markEdited();
+}
 
 AGInteractiveObject::~AGInteractiveObject() { }
 
+void AGInteractiveObject::markEdited()
+{
+    m_revision.store(s_lastRevision.fetch_add(1, std::memory_order_relaxed)+1, std::memory_order_relaxed);
+}
+
 void AGInteractiveObject::touchDown(const GLvertex3f &t) { }
 void AGInteractiveObject::touchMove(const GLvertex3f &t) { }
 void AGInteractiveObject::touchUp(const GLvertex3f &t) { }
@@ -62,20 +72,27 @@ AGInteractiveObject *AGInteractiveObject::hitTest(const GLvertex3f &t)
     return NULL;
 }
 
+// headless builds have no view controller to manage top-level objects
 void AGInteractiveObject::removeFromTopLevel()
 {
+#ifndef AG_HEADLESS
     [[AGViewController instance] fadeOutAndDelete:this];
+#endif // AG_HEADLESS
 }
 
 void AGInteractiveObject::addTouchOutsideListener(AGInteractiveObject *listener)
 {
+#ifndef AG_HEADLESS
     AGViewController *viewController = [AGViewController instance];
     [viewController addTouchOutsideListener:listener];
+#endif // AG_HEADLESS
 }
 
 void AGInteractiveObject::removeTouchOutsideListener(AGInteractiveObject *listener)
 {
+#ifndef AG_HEADLESS
     [[AGViewController instance] removeTouchOutsideListener:listener];
+#endif // AG_HEADLESS
 }
 
 
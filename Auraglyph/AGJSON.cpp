@@ -0,0 +1,669 @@
+//
+//  AGJSON.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGJSON.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+
+
+//------------------------------------------------------------------------------
+// ### AGJSONReader ###
+//------------------------------------------------------------------------------
+#pragma mark - AGJSONReader
+
+AGJSONReader::AGJSONReader(FILE *file)
+: m_file(file), m_buffer(BUFFER_SIZE), m_data(m_buffer.data()), m_pos(0), m_size(0), m_offset(0),
+m_error(NULL), m_errorOffset(0)
+{ }
+
+AGJSONReader::AGJSONReader(const char *data, size_t size)
+: m_file(NULL), m_data(data), m_pos(0), m_size(size), m_offset(0),
+m_error(NULL), m_errorOffset(0)
+{ }
+
+bool AGJSONReader::_fill()
+{
+    if(m_file == NULL)
+        return false;
+
+    m_offset += m_size;
+    m_size = fread(m_buffer.data(), 1, m_buffer.size(), m_file);
+    m_pos = 0;
+
+    return m_size > 0;
+}
+
+int AGJSONReader::_peekChar()
+{
+    if(m_pos < m_size || _fill())
+        return (unsigned char) m_data[m_pos];
+    return -1;
+}
+
+int AGJSONReader::_skipSpace()
+{
+    while(true)
+    {
+        int c = _peekChar();
+        if(c != ' ' && c != '\t' && c != '\n' && c != '\r')
+            return c;
+        m_pos++;
+    }
+}
+
+bool AGJSONReader::_fail(const char *error)
+{
+    if(m_error == NULL)
+    {
+        m_error = error;
+        m_errorOffset = m_offset + m_pos;
+    }
+    return false;
+}
+
+bool AGJSONReader::_expect(char c)
+{
+    if(m_error)
+        return false;
+    if(_skipSpace() != (unsigned char) c)
+        return _fail(c == '{' ? "expected an object" : c == '[' ? "expected an array" :
+                     c == '"' ? "expected a string" : c == ':' ? "expected ':'" : "unexpected character");
+    m_pos++;
+    return true;
+}
+
+bool AGJSONReader::_readLiteral(const char *literal)
+{
+    _skipSpace();
+    for(const char *l = literal; *l; l++)
+    {
+        if(_getChar() != (unsigned char) *l)
+            return _fail("unexpected character");
+    }
+    return true;
+}
+
+std::string AGJSONReader::error() const
+{
+    if(m_error == NULL)
+        return "";
+    return std::string(m_error) + " at byte " + std::to_string(m_errorOffset);
+}
+
+AGJSONReader::Type AGJSONReader::peek()
+{
+    if(m_error)
+        return NONE;
+
+    switch(_skipSpace())
+    {
+        case '{': return OBJECT;
+        case '[': return ARRAY;
+        case '"': return STRING;
+        case 't': case 'f': return BOOL;
+        case 'n': return NUL;
+        case '-': case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            return NUMBER;
+        default: return NONE;
+    }
+}
+
+bool AGJSONReader::beginObject()
+{
+    if(m_started.size() >= MAX_DEPTH)
+        return _fail("too deeply nested");
+    if(!_expect('{'))
+        return false;
+    m_started.push_back(false);
+    return true;
+}
+
+bool AGJSONReader::nextKey(std::string &key)
+{
+    if(m_error)
+        return false;
+
+    int c = _skipSpace();
+    if(c == '}')
+    {
+        m_pos++;
+        m_started.pop_back();
+        return false;
+    }
+
+    if(m_started.back())
+    {
+        if(c != ',')
+            return _fail("expected ',' or '}'");
+        m_pos++;
+    }
+    else
+        m_started.back() = true;
+
+    return readString(key) && _expect(':');
+}
+
+bool AGJSONReader::beginArray()
+{
+    if(m_started.size() >= MAX_DEPTH)
+        return _fail("too deeply nested");
+    if(!_expect('['))
+        return false;
+    m_started.push_back(false);
+    return true;
+}
+
+bool AGJSONReader::nextElement()
+{
+    if(m_error)
+        return false;
+
+    int c = _skipSpace();
+    if(c == ']')
+    {
+        m_pos++;
+        m_started.pop_back();
+        return false;
+    }
+
+    if(m_started.back())
+    {
+        if(c != ',')
+            return _fail("expected ',' or ']'");
+        m_pos++;
+    }
+    else
+        m_started.back() = true;
+
+    return true;
+}
+
+static int _hexValue(int c)
+{
+    if(c >= '0' && c <= '9') return c-'0';
+    if(c >= 'a' && c <= 'f') return c-'a'+10;
+    if(c >= 'A' && c <= 'F') return c-'A'+10;
+    return -1;
+}
+
+static void _appendUTF8(std::string &str, unsigned cp)
+{
+    if(cp < 0x80) str += (char) cp;
+    else if(cp < 0x800) { str += (char) (0xC0|(cp>>6)); str += (char) (0x80|(cp&0x3F)); }
+    else if(cp < 0x10000) { str += (char) (0xE0|(cp>>12)); str += (char) (0x80|((cp>>6)&0x3F)); str += (char) (0x80|(cp&0x3F)); }
+    else
+    {
+        str += (char) (0xF0|(cp>>18)); str += (char) (0x80|((cp>>12)&0x3F));
+        str += (char) (0x80|((cp>>6)&0x3F)); str += (char) (0x80|(cp&0x3F));
+    }
+}
+
+bool AGJSONReader::readString(std::string &str)
+{
+    if(!_expect('"'))
+        return false;
+
+    str.clear();
+
+    while(true)
+    {
+        // copy runs of plain characters straight out of the buffer
+        size_t start = m_pos;
+        while(m_pos < m_size && m_data[m_pos] != '"' && m_data[m_pos] != '\\' &&
+              (unsigned char) m_data[m_pos] >= 0x20)
+            m_pos++;
+        str.append(m_data+start, m_pos-start);
+
+        int c = _getChar();
+        if(c == '"')
+            return true;
+        else if(c == '\\')
+        {
+            switch(_getChar())
+            {
+                case '"': str += '"'; break;
+                case '\\': str += '\\'; break;
+                case '/': str += '/'; break;
+                case 'b': str += '\b'; break;
+                case 'f': str += '\f'; break;
+                case 'n': str += '\n'; break;
+                case 'r': str += '\r'; break;
+                case 't': str += '\t'; break;
+                case 'u':
+                {
+                    unsigned cp = 0;
+                    for(int i = 0; i < 4; i++)
+                    {
+                        int h = _hexValue(_getChar());
+                        if(h < 0)
+                            return _fail("bad \\u escape");
+                        cp = cp*16 + h;
+                    }
+
+                    // a surrogate pair makes one code point
+                    if(cp >= 0xD800 && cp < 0xDC00 && _peekChar() == '\\')
+                    {
+                        m_pos++;
+                        unsigned low = 0;
+                        if(_getChar() != 'u')
+                            return _fail("bad \\u escape");
+                        for(int i = 0; i < 4; i++)
+                        {
+                            int h = _hexValue(_getChar());
+                            if(h < 0)
+                                return _fail("bad \\u escape");
+                            low = low*16 + h;
+                        }
+                        if(low >= 0xDC00 && low < 0xE000)
+                            cp = 0x10000 + ((cp-0xD800)<<10) + (low-0xDC00);
+                        else
+                        {
+                            _appendUTF8(str, cp);
+                            cp = low;
+                        }
+                    }
+
+                    _appendUTF8(str, cp);
+                    break;
+                }
+                default: return _fail("bad escape");
+            }
+        }
+        else if(c < 0)
+            return _fail("unterminated string");
+        else if(c < 0x20)
+            return _fail("control character in string");
+        // else the buffer ran out mid-run; carry on from the refill
+        else
+            str += (char) c;
+    }
+}
+
+bool AGJSONReader::readNumber(double &number)
+{
+    if(m_error)
+        return false;
+
+    _skipSpace();
+
+    char buf[64];
+    int len = 0;
+    while(len < (int) sizeof(buf)-1)
+    {
+        int c = _peekChar();
+        if(!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E'))
+            break;
+        buf[len++] = (char) c;
+        m_pos++;
+    }
+    buf[len] = '\0';
+
+    char *end = NULL;
+    number = strtod(buf, &end);
+    if(len == 0 || end != buf+len)
+        return _fail("bad number");
+
+    return true;
+}
+
+bool AGJSONReader::readBool(bool &b)
+{
+    if(m_error)
+        return false;
+
+    b = _skipSpace() == 't';
+    return _readLiteral(b ? "true" : "false");
+}
+
+bool AGJSONReader::readNull()
+{
+    if(m_error)
+        return false;
+
+    return _readLiteral("null");
+}
+
+bool AGJSONReader::skip()
+{
+    switch(peek())
+    {
+        case OBJECT:
+            if(beginObject())
+                while(nextKey(m_scratch))
+                    skip();
+            break;
+        case ARRAY:
+            if(beginArray())
+                while(nextElement())
+                    skip();
+            break;
+        case STRING:
+            readString(m_scratch);
+            break;
+        case NUMBER:
+        {
+            double number;
+            readNumber(number);
+            break;
+        }
+        case BOOL:
+        {
+            bool b;
+            readBool(b);
+            break;
+        }
+        case NUL:
+            readNull();
+            break;
+        case NONE:
+            _fail("expected a value");
+            break;
+    }
+
+    return m_error == NULL;
+}
+
+float AGJSONReader::floatValue()
+{
+    switch(peek())
+    {
+        case NUMBER:
+        {
+            double number = 0;
+            readNumber(number);
+            return (float) number;
+        }
+        case BOOL:
+        {
+            bool b = false;
+            readBool(b);
+            return b ? 1 : 0;
+        }
+        case STRING:
+            readString(m_scratch);
+            return (float) atof(m_scratch.c_str());
+        default:
+            skip();
+            return 0;
+    }
+}
+
+int AGJSONReader::intValue()
+{
+    switch(peek())
+    {
+        case NUMBER:
+        {
+            double number = 0;
+            readNumber(number);
+            return (int) number;
+        }
+        case BOOL:
+        {
+            bool b = false;
+            readBool(b);
+            return b ? 1 : 0;
+        }
+        case STRING:
+            readString(m_scratch);
+            return atoi(m_scratch.c_str());
+        default:
+            skip();
+            return 0;
+    }
+}
+
+std::string AGJSONReader::stringValue()
+{
+    std::string str;
+    if(peek() == STRING)
+        readString(str);
+    else
+        skip();
+    return str;
+}
+
+bool AGJSONReader::atEnd()
+{
+    return m_error == NULL && _skipSpace() < 0;
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGJSONWriter ###
+//------------------------------------------------------------------------------
+#pragma mark - AGJSONWriter
+
+AGJSONWriter::AGJSONWriter(FILE *file, bool pretty)
+: m_file(file), m_pretty(pretty), m_buffer(BUFFER_SIZE), m_size(0), m_error(false), m_afterKey(false)
+{ }
+
+AGJSONWriter::~AGJSONWriter()
+{
+    flush();
+}
+
+bool AGJSONWriter::flush()
+{
+    if(m_size > 0)
+    {
+        if(fwrite(m_buffer.data(), 1, m_size, m_file) != m_size)
+            m_error = true;
+        m_size = 0;
+    }
+
+    return !m_error;
+}
+
+void AGJSONWriter::_write(const char *data, size_t size)
+{
+    if(m_size+size > m_buffer.size())
+    {
+        flush();
+        if(size > m_buffer.size())
+        {
+            if(fwrite(data, 1, size, m_file) != size)
+                m_error = true;
+            return;
+        }
+    }
+
+    memcpy(m_buffer.data()+m_size, data, size);
+    m_size += size;
+}
+
+void AGJSONWriter::_newline()
+{
+    if(!m_pretty)
+        return;
+
+    static const char spaces[] = "                                ";
+    _write("\n", 1);
+    for(size_t indent = m_counts.size()*2; indent > 0; )
+    {
+        size_t num = std::min(indent, sizeof(spaces)-1);
+        _write(spaces, num);
+        indent -= num;
+    }
+}
+
+void AGJSONWriter::_beginValue()
+{
+    if(m_afterKey)
+    {
+        m_afterKey = false;
+        return;
+    }
+
+    if(m_counts.size())
+    {
+        if(m_counts.back()++ > 0)
+            _write(",", 1);
+        _newline();
+    }
+}
+
+void AGJSONWriter::beginObject()
+{
+    _beginValue();
+    _write("{", 1);
+    m_counts.push_back(0);
+}
+
+void AGJSONWriter::endObject()
+{
+    int count = m_counts.back();
+    m_counts.pop_back();
+    if(count > 0)
+        _newline();
+    _write("}", 1);
+}
+
+void AGJSONWriter::beginArray()
+{
+    _beginValue();
+    _write("[", 1);
+    m_counts.push_back(0);
+}
+
+void AGJSONWriter::endArray()
+{
+    int count = m_counts.back();
+    m_counts.pop_back();
+    if(count > 0)
+        _newline();
+    _write("]", 1);
+}
+
+void AGJSONWriter::key(const std::string &key)
+{
+    _beginValue();
+    _writeString(key);
+    if(m_pretty)
+        _write(" : ", 3);
+    else
+        _write(":", 1);
+    m_afterKey = true;
+}
+
+void AGJSONWriter::_writeString(const std::string &str)
+{
+    _write("\"", 1);
+
+    const char *s = str.data();
+    size_t start = 0;
+    for(size_t i = 0; i < str.size(); i++)
+    {
+        unsigned char c = s[i];
+        if(c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        _write(s+start, i-start);
+        start = i+1;
+
+        char escape[8];
+        switch(c)
+        {
+            case '"': _write("\\\"", 2); break;
+            case '\\': _write("\\\\", 2); break;
+            case '\n': _write("\\n", 2); break;
+            case '\r': _write("\\r", 2); break;
+            case '\t': _write("\\t", 2); break;
+            default:
+                snprintf(escape, sizeof(escape), "\\u%04x", c);
+                _write(escape, 6);
+                break;
+        }
+    }
+    _write(s+start, str.size()-start);
+
+    _write("\"", 1);
+}
+
+void AGJSONWriter::value(const std::string &str)
+{
+    _beginValue();
+    _writeString(str);
+}
+
+void AGJSONWriter::value(const char *str)
+{
+    _beginValue();
+    _writeString(str);
+}
+
+void AGJSONWriter::value(int i)
+{
+    _beginValue();
+    char buf[16];
+    _write(buf, snprintf(buf, sizeof(buf), "%d", i));
+}
+
+void AGJSONWriter::value(float f)
+{
+    _beginValue();
+
+    // JSON has no inf or nan
+    if(!isfinite(f))
+        f = 0;
+
+    char buf[32];
+    int len = 0;
+    // whole numbers (like many coordinates) print as such
+    if(f == (float) (int) f && fabsf(f) < 1e7f)
+    {
+        len = snprintf(buf, sizeof(buf), "%d", (int) f);
+        _write(buf, len);
+        return;
+    }
+
+    // the shortest that reads back the same
+    for(int precision = 6; precision <= 9; precision++)
+    {
+        len = snprintf(buf, sizeof(buf), "%.*g", precision, f);
+        if(strtof(buf, NULL) == f)
+            break;
+    }
+    _write(buf, len);
+}
+
+void AGJSONWriter::value(double d)
+{
+    _beginValue();
+
+    if(!isfinite(d))
+        d = 0;
+
+    char buf[32];
+    int len = 0;
+    for(int precision = 15; precision <= 17; precision++)
+    {
+        len = snprintf(buf, sizeof(buf), "%.*g", precision, d);
+        if(strtod(buf, NULL) == d)
+            break;
+    }
+    _write(buf, len);
+}
+
+void AGJSONWriter::value(bool b)
+{
+    _beginValue();
+    if(b)
+        _write("true", 4);
+    else
+        _write("false", 5);
+}
+
+void AGJSONWriter::valueNull()
+{
+    _beginValue();
+    _write("null", 4);
+}
@@ -0,0 +1,165 @@
+//
+//  AGJSON.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------
+// ### AGJSONReader ###
+// Streaming JSON reader. Rather than building a tree of the whole document,
+// the caller walks it value by value, reading each straight into wherever it
+// belongs and skipping what it doesn't need:
+//
+//     reader.beginObject();
+//     while(reader.nextKey(key))
+//         if(key == "x") x = reader.floatValue();
+//         else reader.skip();
+//
+// Reads from a file through a fixed-size buffer, or from memory. Any syntax
+// error stops the reader: every later call fails (so loops like the above
+// end), and ok() returns false.
+//------------------------------------------------------------------------------
+#pragma mark - AGJSONReader
+
+class AGJSONReader
+{
+public:
+    enum Type { NONE, NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+    static const int BUFFER_SIZE = 64*1024;
+    // deeper objects and arrays are an error, rather than overflowing skip()'s
+    // stack
+    static const int MAX_DEPTH = 256;
+
+    /* read from an open file, which is left open */
+    AGJSONReader(FILE *file);
+    /* read from memory, which must outlive the reader */
+    AGJSONReader(const char *data, size_t size);
+    AGJSONReader(const AGJSONReader &) = delete;
+
+    /* type of the next value, without reading it; NONE at the end, or after
+       an error */
+    Type peek();
+
+    /* start reading an object; then nextKey() until it returns false */
+    bool beginObject();
+    /* the key of the object's next member, leaving its value to be read;
+       false (having read the closing brace) if there are no more */
+    bool nextKey(std::string &key);
+
+    /* start reading an array; then nextElement() until it returns false */
+    bool beginArray();
+    /* true if the array has another element to be read; false (having read
+       the closing bracket) if not */
+    bool nextElement();
+
+    bool readString(std::string &str);
+    bool readNumber(double &number);
+    bool readBool(bool &b);
+    bool readNull();
+    /* skip the next value, however deeply nested */
+    bool skip();
+
+    /* read the next value as NSNumber/NSString's floatValue, intValue and
+       stringValue would; values of other types are skipped and read as 0 or
+       an empty string */
+    float floatValue();
+    int intValue();
+    std::string stringValue();
+
+    /* true once only whitespace is left */
+    bool atEnd();
+    bool ok() const { return m_error == NULL; }
+    /* what went wrong, and where */
+    std::string error() const;
+
+private:
+    int _peekChar();
+    int _getChar() { int c = _peekChar(); if(c >= 0) m_pos++; return c; }
+    bool _fill();
+    int _skipSpace();
+    bool _expect(char c);
+    bool _fail(const char *error);
+    bool _readLiteral(const char *literal);
+
+    FILE *m_file;
+    std::vector<char> m_buffer;
+    const char *m_data;
+    size_t m_pos;
+    size_t m_size;
+    // bytes of the file before the buffer
+    size_t m_offset;
+
+    // for each open object or array, whether its first member has been read
+    std::vector<bool> m_started;
+    // strings that are skipped
+    std::string m_scratch;
+    const char *m_error;
+    size_t m_errorOffset;
+};
+
+
+//------------------------------------------------------------------------------
+// ### AGJSONWriter ###
+// Streaming JSON writer, to a file through a fixed-size buffer. Values are
+// written in order as the document is walked, with keys before object
+// members; separators and (if pretty) indentation are filled in. Floats are
+// written with as few digits as read back to the same float.
+//------------------------------------------------------------------------------
+#pragma mark - AGJSONWriter
+
+class AGJSONWriter
+{
+public:
+    static const int BUFFER_SIZE = 64*1024;
+
+    /* write to an open file, which is left open */
+    AGJSONWriter(FILE *file, bool pretty = true);
+    ~AGJSONWriter();
+    AGJSONWriter(const AGJSONWriter &) = delete;
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    /* the key of the next member of an object */
+    void key(const std::string &key);
+
+    void value(const std::string &str);
+    void value(const char *str);
+    void value(int i);
+    void value(float f);
+    void value(double d);
+    void value(bool b);
+    void valueNull();
+
+    /* write out what's buffered; false if anything couldn't be written */
+    bool flush();
+
+private:
+    void _beginValue();
+    void _newline();
+    void _write(const char *data, size_t size);
+    void _write(const char *str) { _write(str, strlen(str)); }
+    void _writeString(const std::string &str);
+
+    FILE *m_file;
+    bool m_pretty;
+    std::vector<char> m_buffer;
+    size_t m_size;
+    bool m_error;
+
+    // for each open object or array, the number of members written
+    std::vector<int> m_counts;
+    bool m_afterKey;
+};
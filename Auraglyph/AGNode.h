@@ -15,6 +15,7 @@
 #include "AGDocument.h"
 //#include "AGUserInterface.h"
 #include "AGInteractiveObject.h"
+#include "AGSpatialIndex.h"
 
 #include "Geometry.h"
 #include "Animation.h"
@@ -25,7 +26,9 @@
 #include "gfx.h"
 //#import <Foundation/Foundation.h>
 
+#include <atomic>
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 #include <set>
@@ -40,6 +43,69 @@ class AGUINodeEditor;
 
 typedef AGControl AGParamValue;
 
+
+//------------------------------------------------------------------------------
+// ### AGParamTable ###
+// Values keyed on param id, kept in a flat array indexed by the id itself
+// (param ids are small enums counted up from 0). Nodes size their tables from
+// the manifest when initialized, so lookups are O(1), and setting an id that
+// is already present never reallocates. Each value is an atomic, so the audio
+// thread reads whole values while the UI thread sets them, without locking;
+// only reserve() (done before the node renders) may not race with readers.
+//------------------------------------------------------------------------------
+#pragma mark - AGParamTable
+
+template<typename T>
+class AGParamTable
+{
+public:
+    AGParamTable(const T &absent = T()) : m_absent(absent), m_size(0) { }
+    
+    /* make room for ids below size */
+    void reserve(int size)
+    {
+        if(size > m_size)
+        {
+            std::unique_ptr<std::atomic<T>[]> values(new std::atomic<T>[size]);
+            std::unique_ptr<std::atomic<bool>[]> present(new std::atomic<bool>[size]);
+            for(int id = 0; id < size; id++)
+            {
+                values[id].store(id < m_size ? m_values[id].load(std::memory_order_relaxed) : m_absent, std::memory_order_relaxed);
+                present[id].store(id < m_size && m_present[id].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+            m_values = std::move(values);
+            m_present = std::move(present);
+            m_size = size;
+        }
+    }
+    
+    int count(int id) const { return id >= 0 && id < m_size && m_present[id].load(std::memory_order_acquire); }
+    
+    T at(int id) const
+    {
+        assert(count(id));
+        return m_values[id].load(std::memory_order_relaxed);
+    }
+    
+    /* the value for id, or the absent value if it has none */
+    T operator[](int id) const { return count(id) ? m_values[id].load(std::memory_order_relaxed) : m_absent; }
+    
+    void set(int id, const T &value)
+    {
+        assert(id >= 0);
+        reserve(id+1);
+        m_values[id].store(value, std::memory_order_relaxed);
+        m_present[id].store(true, std::memory_order_release);
+    }
+    
+private:
+    T m_absent;
+    int m_size;
+    std::unique_ptr<std::atomic<T>[]> m_values;
+    std::unique_ptr<std::atomic<bool>[]> m_present;
+};
+
+
 struct AGPortInfo
 {
     int portId;
@@ -146,6 +212,7 @@ public:
     
     virtual const string &type() { return m_manifest->type(); }
     const string &uuid() { return m_uuid; }
+    void setPosition(const GLvertex3f &pos) override;
     void setTitle(const string &title) { m_title = title; }
     const string &title() const { return m_title; }
     
@@ -156,8 +223,17 @@ public:
     // control
     void pushControl(int port, const AGControl &control);
     virtual void receiveControl(int port, const AGControl &control) { }
+    /* last control delivered from port (pushes reach here once the control
+       bus delivers them) */
     AGControl lastControlOutput(int port);
+    /* non-blocking, for the audio thread; returns false if port is out of
+       range (as while its number of outputs changes) */
+    bool tryLastControlOutput(int port, AGControl &control);
     void clearControl(int paramId);
+    /* greater than the rank of any node with a control connection into this
+       one (within AGControlBus::MAX_DEPTH); the control bus delivers lower
+       ranks first */
+    int controlRank() const { return m_controlRank.load(std::memory_order_relaxed); }
 
     enum HitTestResult
     {
@@ -168,6 +244,8 @@ public:
     };
     
     HitTestResult hit(const GLvertex3f &hit, int *port);
+    /* everything hit() can hit, the node and its ports, in world coordinates */
+    AGBoundingBox hitBounds() const;
     void unhit();
     AGInteractiveObject *hitTest(const GLvertex3f &t);
     
@@ -201,15 +279,16 @@ public:
     const std::list<AGConnection *> outbound() const;
     const std::list<AGConnection *> inbound() const;
     
-    void setEditPortValue(int port, AGParamValue value) { m_params[editPortInfo(port).portId] = value; editPortValueChanged(editPortInfo(port).portId); }
+    void setEditPortValue(int port, AGParamValue value) { m_params.set(editPortInfo(port).portId, value); markEdited(); editPortValueChanged(editPortInfo(port).portId); }
     void getEditPortValue(int port, AGParamValue &value) const { value = m_params.at(editPortInfo(port).portId); }
     virtual AGParamValue getDefaultParamValue(int paramId) const { return editPortInfo(m_param2EditPort.at(paramId))._default; }
     AGParamValue param(int paramId) const { return m_params.at(paramId); }
-    void setParam(int paramId, AGParamValue value) { m_params[paramId] = value; editPortValueChanged(paramId); }
+    void setParam(int paramId, AGParamValue value) { m_params.set(paramId, value); markEdited(); editPortValueChanged(paramId); }
     float validateParam(int paramId, AGParamValue value) const { return validateEditPortValue(m_param2EditPort.at(paramId), value); }
     
     // XXX TODO : not sure if we need this (only a handful of callers exist for 'numInputsForPort', namely the extra-tricky
     // add and mul), but for completeness I'm going to add an equivalent output function
+    /* O(1); safe to call from the audio thread */
     int numInputsForPort(int paramId, AGRate rate = RATE_NULL);
     int numOutputsForParam(int paramId);
     int numOutputsForPort(int portId);
@@ -246,12 +325,53 @@ public:
     virtual AGDocument::Node::Class nodeClass() const = 0;
 
 private:
+    friend class AGControlBus;
+    
     static bool s_initNode;
     
     Mutex m_mutex;
+    std::atomic<int> m_controlRank;
+    // whether the bus may hold controls from this node
+    std::atomic<bool> m_pushedControl;
+    
+    // where the control bus delivers each output port's controls. Immutable
+    // once published; rebuilt off the audio thread whenever control
+    // connections from this node or its number of outputs change, with the
+    // old table (and anything it points to) retired through the audio engine
+    struct ControlTarget
+    {
+        AGNode *dst;
+        int dstPort;
+        AGConnection *connection;
+    };
+    
+    struct ControlTable
+    {
+        int numPorts;
+        // port's targets are targets[first[port]] to targets[first[port+1]-1]
+        std::vector<int> first;
+        std::vector<ControlTarget> targets;
+    };
+    
+    // last control delivered from each output port; only reallocated when
+    // the number of outputs changes
+    struct ControlOutputs
+    {
+        ControlOutputs(int _numPorts);
+        
+        int numPorts;
+        std::unique_ptr<std::atomic<AGControl>[]> last;
+    };
+    
+    std::atomic<ControlTable *> m_controlTable;
+    std::atomic<ControlOutputs *> m_controlOutputs;
     
     void _initBase();
     virtual void receiveControl_internal(int port, const AGControl &control);
+    void _raiseControlRank(int rank, int depth);
+    /* off the audio thread, after outbound connections or outputs change */
+    void _updateControlTable();
+    void _updateControlOutputs();
     
 protected:
     static float s_portRadius;
@@ -272,6 +392,10 @@ protected:
     
     virtual void _renderIcon();
     
+    /* nodes whose number of outputs varies call this (off the audio thread)
+       after changing it */
+    void outputPortsChanged();
+    
     const AGNodeManifest *m_manifest;
     string m_title;
     string m_uuid; // TODO: const
@@ -280,7 +404,6 @@ protected:
     std::list<AGConnection *> m_outbound;
     
     vector<AGControl> m_controlPortBuffer;
-    vector<AGControl> m_lastControlOutput;
     
 //    AGPortInfo * m_inputPortInfo;
     
@@ -297,10 +420,21 @@ protected:
     bool m_active;
     powcurvef m_fadeOut;
     
-    map<int, int> m_param2InputPort;
-    map<int, int> m_param2EditPort;
-    map<int, int> m_param2OutputPort;
-    map<int, AGParamValue> m_params;
+    // param id -> port index (-1 if none), and edit param values, resolved
+    // from the manifest in _initBase()
+    AGParamTable<int> m_param2InputPort = AGParamTable<int>(-1);
+    AGParamTable<int> m_param2EditPort = AGParamTable<int>(-1);
+    AGParamTable<int> m_param2OutputPort = AGParamTable<int>(-1);
+    AGParamTable<AGParamValue> m_params;
+    
+    // inbound connections on each input port, kept up to date by
+    // addInbound()/removeInbound()
+    struct InboundCount
+    {
+        int audio;
+        int control;
+    };
+    vector<InboundCount> m_inboundCount;
 };
 
 //------------------------------------------------------------------------------
@@ -8,7 +8,6 @@
 
 #include "AGNode.h"
 
-#import "AGViewController.h"
 #import "AGGenericShader.h"
 #import "AGAudioNode.h"
 #import "AGControlNode.h"
@@ -16,6 +15,8 @@
 #include "AGStyle.h"
 #include "AGControl.h"
 #include "AGGraphManager.h"
+#include "AGAudioManager.h"
+#include "AGControlBus.h"
 
 #import "spstl.h"
 
@@ -35,6 +36,9 @@ GLint AGNode::s_portGeoType = 0;
 
 void AGNode::connect(AGConnection * connection)
 {
+    // published once, with any control table retired along with it
+    AGAudioManager_::instance().beginGraphEdit();
+    
     connection->src()->lock();
     connection->src()->addOutbound(connection);
     connection->src()->unlock();
@@ -43,7 +47,19 @@ void AGNode::connect(AGConnection * connection)
     connection->dst()->addInbound(connection);
     connection->dst()->unlock();
     
-    AGGraphManager::instance().addConnection(connection);
+    if(connection->rate() == RATE_CONTROL)
+    {
+        connection->dst()->_raiseControlRank(connection->src()->controlRank()+1, 0);
+        connection->src()->_updateControlTable();
+    }
+    
+    if(!connection->isPrivate())
+    {
+        AGGraphManager::instance().addConnection(connection);
+        AGAudioManager_::instance().graphDidChange();
+    }
+    
+    AGAudioManager_::instance().endGraphEdit();
 }
 
 void AGNode::disconnect(AGConnection * connection)
@@ -52,6 +68,8 @@ void AGNode::disconnect(AGConnection * connection)
              (unsigned long) connection, (unsigned long) connection->src(), connection->srcPort(),
              (unsigned long) connection->dst(), connection->dstPort());
     
+    AGAudioManager_::instance().beginGraphEdit();
+    
     connection->src()->lock();
     connection->src()->removeOutbound(connection);
     connection->src()->unlock();
@@ -60,7 +78,19 @@ void AGNode::disconnect(AGConnection * connection)
     connection->dst()->removeInbound(connection);
     connection->dst()->unlock();
     
-    AGGraphManager::instance().removeConnection(connection);
+    // the bus may be delivering through the old table; it's kept until the
+    // audio thread has moved on, and the connection and its nodes with it
+    // (see AGViewController's deferred deletes)
+    if(connection->rate() == RATE_CONTROL)
+        connection->src()->_updateControlTable();
+    
+    if(!connection->isPrivate())
+    {
+        AGGraphManager::instance().removeConnection(connection);
+        AGAudioManager_::instance().graphDidChange();
+    }
+    
+    AGAudioManager_::instance().endGraphEdit();
 }
 
 void AGNode::initalizeNode()
@@ -73,7 +103,7 @@ void AGNode::initalizeNode()
         s_portGeoSize = 32;
         s_portGeoType = GL_LINE_LOOP;
         s_portGeo = new GLvertex3f[s_portGeoSize];
-        for(int i = 0; i < s_portGeoSize; i++)
+        for(int i = 0; i < (int) s_portGeoSize; i++)
         {
             float theta = 2*M_PI*((float)i)/((float)(s_portGeoSize));
             s_portGeo[i] = GLvertex3f(s_portRadius*cosf(theta), s_portRadius*sinf(theta), 0);
@@ -83,19 +113,27 @@ void AGNode::initalizeNode()
 
 
 AGNode::AGNode(const AGNodeManifest *mf, const GLvertex3f &pos) :
+m_controlRank(0),
+m_pushedControl(false),
+m_controlTable(NULL),
+m_controlOutputs(NULL),
 m_manifest(mf),
+m_uuid(makeUUID()),
 m_active(true),
-m_fadeOut(1, 0, 0.5, 2),
-m_uuid(makeUUID())
+m_fadeOut(1, 0, 0.5, 2)
 {
     setPosition(pos);
 }
 
 AGNode::AGNode(const AGNodeManifest *mf, const AGDocument::Node &docNode) :
+m_controlRank(0),
+m_pushedControl(false),
+m_controlTable(NULL),
+m_controlOutputs(NULL),
 m_manifest(mf),
+m_uuid(docNode.uuid),
 m_active(true),
-m_fadeOut(1, 0, 0.5, 2),
-m_uuid(docNode.uuid)
+m_fadeOut(1, 0, 0.5, 2)
 {
     setPosition(GLvertex3f(docNode.x, docNode.y, docNode.z));
 }
@@ -112,26 +150,46 @@ void AGNode::_initBase()
     //        m_controlPortBuffer = new AGControl[numInputPorts()];
     
     int numInput = numInputPorts();
+    int numEdit = numEditPorts();
+    int numOutput = numOutputPorts();
+    
+    // size the param tables for the largest id in use, so that later writes
+    // (e.g. setParam() on the UI thread) don't move them under the audio thread
+    int maxId = 0;
+    for(int i = 0; i < numInput; i++)
+        maxId = std::max(maxId, inputPortInfo(i).portId);
+    for(int i = 0; i < numEdit; i++)
+        maxId = std::max(maxId, editPortInfo(i).portId);
+    for(int i = 0; i < numOutput; i++)
+        maxId = std::max(maxId, outputPortInfo(i).portId);
+    m_param2InputPort.reserve(maxId+1);
+    m_param2EditPort.reserve(maxId+1);
+    m_param2OutputPort.reserve(maxId+1);
+    m_params.reserve(maxId+1);
+    
     for(int i = 0; i < numInput; i++)
     {
         const AGPortInfo &info = inputPortInfo(i);
-        m_param2InputPort[info.portId] = i;
+        m_param2InputPort.set(info.portId, i);
     }
     
-    int numEdit = numEditPorts();
     for(int i = 0; i < numEdit; i++)
     {
         const AGPortInfo &info = editPortInfo(i);
-        m_param2EditPort[info.portId] = i;
-        m_params[info.portId] = getDefaultParamValue(info.portId);
+        m_param2EditPort.set(info.portId, i);
+        m_params.set(info.portId, getDefaultParamValue(info.portId));
     }
     
-    int numOutput = numOutputPorts();
     for(int i = 0; i < numOutput; i++)
     {
         const AGPortInfo &info = outputPortInfo(i);
-        m_param2OutputPort[info.portId] = i;
+        m_param2OutputPort.set(info.portId, i);
     }
+    
+    m_inboundCount.resize(numInput, { 0, 0 });
+    
+    _updateControlOutputs();
+    _updateControlTable();
 
 }
 
@@ -173,6 +231,13 @@ void AGNode::loadEditPortValues(const AGDocument::Node &docNode)
 
 AGNode::~AGNode()
 {
+    // (off the delivering thread, the engine's retire() has already waited
+    // out anything this node queued)
+    if(m_pushedControl.load())
+        AGControlBus::instance().removeNode(this);
+    
+    delete m_controlTable.load();
+    delete m_controlOutputs.load();
 }
 
 void AGNode::fadeOutAndRemove()
@@ -181,17 +246,20 @@ void AGNode::fadeOutAndRemove()
     m_fadeOut.reset();
     
     dbgprint("disconnecting inbound nodes (%li)\n", m_inbound.size());
-    itmap_safe(m_inbound, ^(AGConnection *&_connection){
-        AGConnection *connection = _connection;
+    for(auto i = m_inbound.begin(); i != m_inbound.end(); )
+    {
+        // disconnecting removes the connection from the list
+        AGConnection *connection = *i++;
         AGNode::disconnect(connection);
-        [[AGViewController instance] fadeOutAndDelete:connection];
-    });
+        connection->removeFromTopLevel();
+    }
     dbgprint("disconnecting outbound nodes (%li)\n", m_outbound.size());
-    itmap_safe(m_outbound, ^(AGConnection *&_connection){
-        AGConnection *connection = _connection;
+    for(auto i = m_outbound.begin(); i != m_outbound.end(); )
+    {
+        AGConnection *connection = *i++;
         AGNode::disconnect(connection);
-        [[AGViewController instance] fadeOutAndDelete:connection];
-    });
+        connection->removeFromTopLevel();
+    }
 }
 
 void AGNode::renderOut()
@@ -202,11 +270,22 @@ void AGNode::renderOut()
 void AGNode::addInbound(AGConnection *connection)
 {
     m_inbound.push_back(connection);
+    
+    int inputPort = connection->dstPort();
+    if(inputPort >= (int) m_inboundCount.size())
+        m_inboundCount.resize(inputPort+1, { 0, 0 });
+    if(connection->rate() == RATE_AUDIO)
+        m_inboundCount[inputPort].audio++;
+    else
+        m_inboundCount[inputPort].control++;
+    
+    markEdited();
 }
 
 void AGNode::addOutbound(AGConnection *connection)
 {
     m_outbound.push_back(connection);
+    markEdited();
 }
 
 void AGNode::removeInbound(AGConnection *connection)
@@ -215,24 +294,23 @@ void AGNode::removeInbound(AGConnection *connection)
     
     m_inbound.remove(connection);
     
+    InboundCount &count = m_inboundCount[inputPort];
+    if(connection->rate() == RATE_AUDIO)
+        count.audio--;
+    else
+        count.control--;
+    
     // clear m_controlPortBuffer for this connection if no control connections remain
-    bool hasCtlLeft = false;
-    for(auto inboundConn : m_inbound)
-    {
-        if(inboundConn->dstPort() == inputPort && inboundConn->rate() == RATE_CONTROL)
-        {
-            hasCtlLeft = true;
-            break;
-        }
-    }
+    if(count.control == 0)
+        m_controlPortBuffer[inputPort] = AGControl();
     
-    if(!hasCtlLeft)
-        m_controlPortBuffer[connection->dstPort()] = AGControl();
+    markEdited();
 }
 
 void AGNode::removeOutbound(AGConnection *connection)
 {
     m_outbound.remove(connection);
+    markEdited();
 }
 
 void AGNode::trimConnectionsToNodes(const set<AGNode *> &nodes)
@@ -389,6 +467,14 @@ void AGNode::_renderIcon()
     }
 }
 
+void AGNode::setPosition(const GLvertex3f &pos)
+{
+    AGUIObject::setPosition(pos);
+    markEdited();
+    // move it (and its connections) in the hit-testing index
+    AGGraphManager::instance().nodeDidMove(this);
+}
+
 AGNode::HitTestResult AGNode::hit(const GLvertex3f &hit, int *port)
 {
     if(!m_active)
@@ -423,6 +509,22 @@ AGNode::HitTestResult AGNode::hit(const GLvertex3f &hit, int *port)
     return HIT_NONE;
 }
 
+AGBoundingBox AGNode::hitBounds() const
+{
+    // every node's body fits in s_sizeFactor; ports can stick out of it
+    AGBoundingBox bounds(m_pos.xy(), s_sizeFactor);
+    
+    int numIn = numInputPorts();
+    for(int i = 0; i < numIn; i++)
+        bounds.unite(AGBoundingBox((m_pos+relativePositionForInputPort(i)).xy(), s_portRadius));
+    
+    int numOut = numOutputPorts();
+    for(int i = 0; i < numOut; i++)
+        bounds.unite(AGBoundingBox((m_pos+relativePositionForOutputPort(i)).xy(), s_portRadius));
+    
+    return bounds;
+}
+
 void AGNode::unhit()
 {
     
@@ -441,7 +543,7 @@ void AGNode::touchDown(const GLvertex3f &t)
 
 void AGNode::touchMove(const GLvertex3f &t)
 {
-    m_pos = m_pos + (t - m_lastTouch);
+    setPosition(m_pos + (t - m_lastTouch));
     m_lastTouch = t;
     
     AGUITrash &trash = AGUITrash::instance();
@@ -468,45 +570,39 @@ void AGNode::pushControl(int port, const AGControl &control)
 {
     assert(port >= 0 && port < numOutputPorts());
     
-    this->lock();
-    
-    // ensure correct size
-    if(port >= m_lastControlOutput.size())
-        m_lastControlOutput.resize(numOutputPorts());
-    
-    m_lastControlOutput[port] = control;
-    
     float f;
     control.mapTo(f);
     dbgprint_off("pushControl %i:%f from %0lx\n", port, f, (unsigned long)this);
     
-    for(AGConnection *conn : m_outbound)
-    {
-        if(conn->rate() == RATE_CONTROL && conn->srcPort() == port)
-        {
-            conn->dst()->receiveControl_internal(conn->dstPort(), control);
-            conn->controlActivate(control);
-        }
-    };
-    
-    this->unlock();
+    // the bus hands it to connected nodes, and keeps it as port's last
+    if(!m_pushedControl.load(std::memory_order_relaxed))
+        m_pushedControl.store(true);
+    AGControlBus::instance().post(this, port, control);
+}
+
+void AGNode::outputPortsChanged()
+{
+    _updateControlOutputs();
+    _updateControlTable();
 }
 
 AGControl AGNode::lastControlOutput(int port)
+{
+    AGControl control;
+    tryLastControlOutput(port, control);
+    return control;
+}
+
+bool AGNode::tryLastControlOutput(int port, AGControl &control)
 {
     assert(port >= 0 && port < numOutputPorts());
     
-    this->lock();
-    
-    // ensure correct size
-    if(port >= m_lastControlOutput.size())
-        m_lastControlOutput.resize(numOutputPorts());
-    
-    AGControl c = m_lastControlOutput[port];
-    
-    this->unlock();
+    ControlOutputs *outputs = m_controlOutputs.load(std::memory_order_acquire);
+    if(outputs == NULL || port >= outputs->numPorts)
+        return false;
     
-    return c;
+    control = outputs->last[port].load(std::memory_order_relaxed);
+    return true;
 }
 
 void AGNode::clearControl(int paramId)
@@ -520,6 +616,78 @@ void AGNode::receiveControl_internal(int port, const AGControl &control)
     receiveControl(port, control);
 }
 
+void AGNode::_raiseControlRank(int rank, int depth)
+{
+    // feedback loops stop at the depth limit
+    if(rank <= controlRank() || depth >= AGControlBus::MAX_DEPTH)
+        return;
+    
+    m_controlRank.store(rank, std::memory_order_relaxed);
+    
+    // connections only change on this thread, so no need to lock to read them
+    for(AGConnection *conn : m_outbound)
+    {
+        if(conn->rate() == RATE_CONTROL)
+            conn->dst()->_raiseControlRank(rank+1, depth+1);
+    }
+}
+
+AGNode::ControlOutputs::ControlOutputs(int _numPorts) :
+numPorts(_numPorts),
+last(new std::atomic<AGControl>[_numPorts])
+{
+    for(int port = 0; port < numPorts; port++)
+        last[port].store(AGControl(), std::memory_order_relaxed);
+}
+
+void AGNode::_updateControlTable()
+{
+    int numPorts = numOutputPorts();
+    ControlTable *table = new ControlTable;
+    table->numPorts = numPorts;
+    table->first.assign(numPorts+1, 0);
+    
+    // count each port's connections, then lay them out port by port, in the
+    // order they were connected
+    for(AGConnection *conn : m_outbound)
+    {
+        if(conn->rate() == RATE_CONTROL && conn->srcPort() >= 0 && conn->srcPort() < numPorts)
+            table->first[conn->srcPort()+1]++;
+    }
+    for(int port = 0; port < numPorts; port++)
+        table->first[port+1] += table->first[port];
+    
+    table->targets.resize(table->first[numPorts]);
+    std::vector<int> next(table->first.begin(), table->first.end()-1);
+    for(AGConnection *conn : m_outbound)
+    {
+        if(conn->rate() == RATE_CONTROL && conn->srcPort() >= 0 && conn->srcPort() < numPorts)
+            table->targets[next[conn->srcPort()]++] = { conn->dst(), conn->dstPort(), conn };
+    }
+    
+    ControlTable *old = m_controlTable.exchange(table, std::memory_order_acq_rel);
+    if(old != NULL)
+        AGAudioManager_::instance().retire([old]() { delete old; });
+}
+
+void AGNode::_updateControlOutputs()
+{
+    int numPorts = numOutputPorts();
+    ControlOutputs *old = m_controlOutputs.load(std::memory_order_relaxed);
+    if(old != NULL && old->numPorts == numPorts)
+        return;
+    
+    // (a control delivered while this copies is kept by the old ports only;
+    // outputs only change from edits on the UI thread)
+    ControlOutputs *outputs = new ControlOutputs(numPorts);
+    for(int port = 0; old != NULL && port < old->numPorts && port < numPorts; port++)
+        outputs->last[port].store(old->last[port].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    
+    m_controlOutputs.store(outputs, std::memory_order_release);
+    if(old != NULL)
+        AGAudioManager_::instance().retire([old]() { delete old; });
+}
+
 float AGNode::validateEditPortValue(int port, float _new) const
 {
     const AGPortInfo &info = editPortInfo(port);
@@ -547,14 +715,16 @@ void AGNode::finalPortValue(float &value, int portId, int sample) const
 int AGNode::numInputsForPort(int paramId, AGRate rate)
 {
     int portNum = m_param2InputPort[paramId];
-    int numInputs = 0;
-    for(auto conn : m_inbound)
+    if(portNum < 0 || portNum >= (int) m_inboundCount.size())
+        return 0;
+    
+    const InboundCount &count = m_inboundCount[portNum];
+    switch(rate)
     {
-        if(conn->dstPort() == portNum && (rate == AGRate::RATE_NULL || conn->rate() == rate))
-            numInputs++;
+        case RATE_AUDIO: return count.audio;
+        case RATE_CONTROL: return count.control;
+        default: return count.audio+count.control;
     }
-    
-    return numInputs;
 }
 
 int AGNode::numOutputsForParam(int paramId)
@@ -711,6 +881,9 @@ const AGNodeManager &AGNodeManager::nodeManagerForClass(AGDocument::Node::Class
         case AGDocument::Node::OUTPUT:
             return outputNodeManager();
     }
+    
+    // not a class of node we know
+    return audioNodeManager();
 }
 
 AGNode *AGNodeManager::createNode(const AGDocument::Node &docNode)
@@ -729,7 +902,7 @@ const string &AGNodeManager::portNameForPortNumber(AGDocument::Node::Class _clas
     {
         if(mf->type() == nodeType)
         {
-            if(portNumber < mf->inputPortInfo().size() && portNumber >= 0)
+            if(portNumber < (int) mf->inputPortInfo().size() && portNumber >= 0)
                 return mf->inputPortInfo()[portNumber].name;
         }
     }
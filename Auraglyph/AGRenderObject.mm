@@ -206,8 +206,9 @@ void AGRenderObject::update(float t, float dt)
 
 void AGRenderObject::updateChildren(float t, float dt)
 {
-    itmap_safe(m_children, ^(AGRenderObject *&_child){
-        AGRenderObject *child = _child;
+    for(auto i = m_children.begin(); i != m_children.end(); )
+    {
+        AGRenderObject *child = *i++;
         child->update(t, dt);
         
         if(child->finishedRenderingOut())
@@ -216,7 +217,7 @@ void AGRenderObject::updateChildren(float t, float dt)
             child->m_parent = NULL;
             delete child;
         }
-    });
+    }
 }
 
 void AGRenderObject::render()
@@ -0,0 +1,401 @@
+//
+//  AGSoundFile.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGSoundFile.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <unistd.h>
+
+
+//------------------------------------------------------------------------------
+// ### AGSoundFile ###
+//------------------------------------------------------------------------------
+#pragma mark - AGSoundFile
+
+AGSoundFile::AGSoundFile(const std::string &path)
+: m_path(path), m_loaded(false)
+{
+    m_file.open(path);
+
+    m_numFrames = (int) m_file.fileSize();
+    m_numChunks = (m_numFrames+CHUNK_FRAMES-1)/CHUNK_FRAMES;
+    m_resident = m_numFrames <= RESIDENT_FRAMES;
+
+    m_chunks.reset(new Chunk[m_numChunks]);
+    for(int c = 0; c < m_numChunks; c++)
+    {
+        m_chunks[c].pins.store(0, std::memory_order_relaxed);
+        m_chunks[c].data.store(NULL, std::memory_order_relaxed);
+    }
+}
+
+AGSoundFile::~AGSoundFile()
+{
+    int numLoaded = 0;
+    for(int c = 0; c < m_numChunks; c++)
+    {
+        float *data = m_chunks[c].data.load(std::memory_order_relaxed);
+        if(data != NULL)
+        {
+            delete[] data;
+            numLoaded++;
+        }
+    }
+
+    AGSoundFileCache::instance().m_numLoadedChunks.fetch_sub(numLoaded, std::memory_order_relaxed);
+}
+
+bool AGSoundFile::pin(int chunk)
+{
+    std::atomic<int> &pins = m_chunks[chunk].pins;
+    int n = pins.load(std::memory_order_relaxed);
+    while(n >= 0)
+    {
+        if(pins.compare_exchange_weak(n, n+1, std::memory_order_acquire))
+            return true;
+    }
+
+    return false;
+}
+
+void AGSoundFile::unpin(int chunk)
+{
+    m_chunks[chunk].pins.fetch_sub(1, std::memory_order_release);
+}
+
+int AGSoundFile::_service()
+{
+    AGSoundFileCache &cache = AGSoundFileCache::instance();
+
+    if(m_resident)
+    {
+        if(m_loaded)
+            return 0;
+
+        _loadResident();
+        m_loaded = true;
+        return m_numChunks;
+    }
+
+    int numLoaded = 0;
+    for(int c = 0; c < m_numChunks; c++)
+    {
+        Chunk &chunk = m_chunks[c];
+        float *data = chunk.data.load(std::memory_order_relaxed);
+
+        if(chunk.pins.load(std::memory_order_acquire) > 0)
+        {
+            if(data == NULL)
+            {
+                float peak;
+                chunk.data.store(_read(c, peak), std::memory_order_release);
+                cache.m_numLoadedChunks.fetch_add(1, std::memory_order_relaxed);
+                numLoaded++;
+            }
+        }
+        else if(data != NULL)
+        {
+            // lock out pinning while the chunk is freed; fails if a stream
+            // pinned it since we looked
+            int unpinned = 0;
+            if(chunk.pins.compare_exchange_strong(unpinned, -1, std::memory_order_acq_rel))
+            {
+                chunk.data.store(NULL, std::memory_order_relaxed);
+                delete[] data;
+                chunk.pins.store(0, std::memory_order_release);
+                cache.m_numLoadedChunks.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    return numLoaded;
+}
+
+void AGSoundFile::_loadResident()
+{
+    std::vector<float *> chunks(m_numChunks);
+    float peak = 0;
+    for(int c = 0; c < m_numChunks; c++)
+        chunks[c] = _read(c, peak);
+
+    // peak-normalized, as FileWvIn does with whole files
+    if(peak > 0)
+    {
+        for(int c = 0; c < m_numChunks; c++)
+        {
+            for(int i = 0; i < CHUNK_FRAMES+1; i++)
+                chunks[c][i] /= peak;
+        }
+    }
+
+    for(int c = 0; c < m_numChunks; c++)
+        m_chunks[c].data.store(chunks[c], std::memory_order_release);
+
+    AGSoundFileCache::instance().m_numLoadedChunks.fetch_add(m_numChunks, std::memory_order_relaxed);
+}
+
+float *AGSoundFile::_read(int chunk, float &peak)
+{
+    float *data = new float[CHUNK_FRAMES+1];
+    for(int i = 0; i < CHUNK_FRAMES+1; i++)
+        data[i] = 0;
+
+    int start = chunk*CHUNK_FRAMES;
+    int numFrames = std::min(CHUNK_FRAMES+1, m_numFrames-start);
+    int numChannels = m_file.channels();
+
+    try
+    {
+        stk::StkFrames frames(numFrames, numChannels);
+        m_file.read(frames, start, true);
+
+        for(int i = 0; i < numFrames; i++)
+            data[i] = frames(i, 0);
+        // over every channel, as FileWvIn normalizes
+        for(int i = 0; i < numFrames*numChannels; i++)
+            peak = std::max(peak, (float) fabs(frames[i]));
+    }
+    catch(const stk::StkError &error)
+    {
+        // leave it silent, rather than retry forever
+        fprintf(stderr, "AGSoundFile: error reading %s\n", m_path.c_str());
+    }
+
+    return data;
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGSoundFileStream ###
+//------------------------------------------------------------------------------
+#pragma mark - AGSoundFileStream
+
+AGSoundFileStream::AGSoundFileStream(const std::shared_ptr<AGSoundFile> &file)
+: m_file(file), m_numFrames(file ? file->numFrames() : 0),
+m_rate(1), m_interpolate(false), m_finished(true),
+m_windowStart(0), m_windowEnd(0)
+{
+    // as FileWvIn, opened at the end
+    m_time = m_numFrames > 0 ? m_numFrames-1 : 0;
+
+    if(m_file)
+    {
+        m_pinned.resize(m_file->numChunks(), 0);
+        if(m_pinned.size())
+            _pin(0);
+    }
+}
+
+AGSoundFileStream::~AGSoundFileStream()
+{
+    for(int c = 0; c < (int) m_pinned.size(); c++)
+        _unpin(c);
+}
+
+void AGSoundFileStream::prefetch()
+{
+    int numChunks = (int) m_pinned.size();
+    if(numChunks == 0)
+        return;
+
+    // the first chunk stays pinned (if it couldn't be before, try again)
+    _pin(0);
+
+    int start = 0, end = 0;
+    if(!m_finished && m_time >= 0 && m_time <= m_numFrames-1)
+    {
+        int position = (int) m_time;
+        int prefetch = AGSoundFileCache::instance().prefetchFrames();
+        int first = m_rate >= 0 ? position : std::max(position-prefetch, 0);
+        int last = m_rate >= 0 ? std::min(position+prefetch, m_numFrames-1) : position;
+        start = first/AGSoundFile::CHUNK_FRAMES;
+        end = last/AGSoundFile::CHUNK_FRAMES+1;
+    }
+
+    for(int c = m_windowStart; c < m_windowEnd; c++)
+    {
+        if((c < start || c >= end) && c != 0)
+            _unpin(c);
+    }
+    for(int c = start; c < end; c++)
+        _pin(c);
+
+    m_windowStart = start;
+    m_windowEnd = end;
+}
+
+void AGSoundFileStream::reset()
+{
+    m_time = 0;
+    m_finished = false;
+}
+
+void AGSoundFileStream::setRate(double rate)
+{
+    m_rate = rate;
+    // backward from the start means from the end
+    if(m_rate < 0 && m_time == 0)
+        m_time = m_numFrames-1;
+    m_interpolate = fmod(m_rate, 1.0) != 0;
+}
+
+float AGSoundFileStream::tick()
+{
+    if(m_finished)
+        return 0;
+    if(m_time < 0 || m_time > m_numFrames-1)
+    {
+        m_finished = true;
+        return 0;
+    }
+
+    int index = (int) m_time;
+    int chunk = index/AGSoundFile::CHUNK_FRAMES;
+    const float *data = _data(chunk);
+
+    float value = 0;
+    if(data != NULL)
+    {
+        const float *frame = data + (index - chunk*AGSoundFile::CHUNK_FRAMES);
+        value = frame[0];
+        if(m_interpolate)
+            value += (float) (m_time-index)*(frame[1]-frame[0]);
+    }
+
+    m_time += m_rate;
+
+    return value;
+}
+
+const float *AGSoundFileStream::_data(int chunk)
+{
+    AGSoundFileCache &cache = AGSoundFileCache::instance();
+
+    // jumped outside the window since prefetch()
+    _pin(chunk);
+
+    const float *data = m_pinned[chunk] ? m_file->chunkData(chunk) : NULL;
+
+    if(data == NULL && cache.blocking())
+    {
+        while(data == NULL)
+        {
+            usleep(100);
+            _pin(chunk);
+            data = m_pinned[chunk] ? m_file->chunkData(chunk) : NULL;
+        }
+    }
+
+    if(data == NULL)
+        cache.m_numUnderruns.fetch_add(1, std::memory_order_relaxed);
+
+    return data;
+}
+
+void AGSoundFileStream::_pin(int chunk)
+{
+    if(!m_pinned[chunk])
+        m_pinned[chunk] = m_file->pin(chunk);
+}
+
+void AGSoundFileStream::_unpin(int chunk)
+{
+    if(m_pinned[chunk])
+    {
+        m_file->unpin(chunk);
+        m_pinned[chunk] = 0;
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGSoundFileCache ###
+//------------------------------------------------------------------------------
+#pragma mark - AGSoundFileCache
+
+AGSoundFileCache &AGSoundFileCache::instance()
+{
+    static AGSoundFileCache s_instance;
+    return s_instance;
+}
+
+AGSoundFileCache::AGSoundFileCache()
+: m_running(false), m_prefetchFrames(AGSoundFile::CHUNK_FRAMES*2), m_blocking(false),
+m_numLoadedChunks(0), m_numUnderruns(0)
+{ }
+
+std::shared_ptr<AGSoundFile> AGSoundFileCache::open(const std::string &path)
+{
+    std::shared_ptr<AGSoundFile> file;
+
+    m_mutex.lock();
+
+    auto existing = m_files.find(path);
+    if(existing != m_files.end())
+        file = existing->second.lock();
+
+    if(file == NULL)
+    {
+        try
+        {
+            // only reads the header; the I/O thread loads the rest
+            file.reset(new AGSoundFile(path));
+            m_files[path] = file;
+        }
+        catch(const stk::StkError &error)
+        {
+            file.reset();
+        }
+    }
+
+    if(file != NULL && !m_running)
+    {
+        m_running = true;
+        m_thread.start([this] { _run(); });
+    }
+
+    m_mutex.unlock();
+
+    return file;
+}
+
+void AGSoundFileCache::_run()
+{
+    std::vector<std::shared_ptr<AGSoundFile>> files;
+
+    while(true)
+    {
+        m_mutex.lock();
+        for(auto i = m_files.begin(); i != m_files.end(); )
+        {
+            std::shared_ptr<AGSoundFile> file = i->second.lock();
+            if(file != NULL)
+            {
+                files.push_back(file);
+                i++;
+            }
+            else
+            {
+                i = m_files.erase(i);
+            }
+        }
+        m_mutex.unlock();
+
+        int numLoaded = 0;
+        for(auto &file : files)
+            numLoaded += file->_service();
+
+        // files no one else is using are deleted here, off the audio thread
+        files.clear();
+
+        // go again straight away while there is loading to do
+        if(numLoaded == 0)
+            usleep(POLL_MS*1000);
+    }
+}
@@ -0,0 +1,193 @@
+//
+//  AGSoundFile.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include "Mutex.h"
+#include "Thread.h"
+#include "FileRead.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// ### AGSoundFile ###
+// A sound file's samples (its first channel, as stk::FileWvIn plays), decoded
+// in chunks of CHUNK_FRAMES by AGSoundFileCache's I/O thread and shared by
+// every stream playing the file. A chunk is loaded while any stream has it
+// pinned, and freed once none do, so memory follows what is playing rather
+// than the size of the file (re-reading a chunk is cheap, with the OS caching
+// the file). Files of up to
+// RESIDENT_FRAMES are loaded whole and kept, peak-normalized as FileWvIn does
+// for files it doesn't read in chunks.
+//------------------------------------------------------------------------------
+#pragma mark - AGSoundFile
+
+class AGSoundFile
+{
+public:
+    static const int CHUNK_FRAMES = 16384;
+    static const int RESIDENT_FRAMES = 1000000;
+
+    ~AGSoundFile();
+    AGSoundFile(const AGSoundFile &) = delete;
+
+    const std::string &path() const { return m_path; }
+    int numFrames() const { return m_numFrames; }
+    int numChunks() const { return m_numChunks; }
+
+    /* any thread: ask for chunk to be loaded, and kept until unpinned; false
+       if the chunk is being freed at this moment (pin it again later) */
+    bool pin(int chunk);
+    void unpin(int chunk);
+    /* samples of a pinned chunk, CHUNK_FRAMES+1 frames from chunk*CHUNK_FRAMES
+       (the last repeating the next chunk's first, for interpolation; zero past
+       the end of the file), or NULL if not loaded yet */
+    const float *chunkData(int chunk) const { return m_chunks[chunk].data.load(std::memory_order_acquire); }
+
+private:
+    friend class AGSoundFileCache;
+
+    /* throws stk::StkError if path can't be read */
+    AGSoundFile(const std::string &path);
+
+    /* I/O thread: load pinned chunks and free long-unpinned ones; returns
+       the number of chunks loaded */
+    int _service();
+    void _loadResident();
+    float *_read(int chunk, float &peak);
+
+    struct Chunk
+    {
+        // streams holding the chunk, or -1 while it is being freed
+        std::atomic<int> pins;
+        std::atomic<float *> data;
+    };
+
+    std::string m_path;
+    stk::FileRead m_file;
+    int m_numFrames;
+    int m_numChunks;
+    std::unique_ptr<Chunk[]> m_chunks;
+    bool m_resident;
+    bool m_loaded;
+};
+
+
+//------------------------------------------------------------------------------
+// ### AGSoundFileStream ###
+// A playback position in an AGSoundFile, for the audio thread. Plays the file
+// as stk::FileWvIn does (at a variable rate, linearly interpolated, and
+// silent once it runs off either end), keeping the chunks within the prefetch
+// window ahead of the position pinned. The first chunk stays pinned too, so
+// retriggering from the start is always immediate. A chunk that hasn't loaded
+// in time plays as silence and counts an underrun, unless the cache is
+// blocking.
+//------------------------------------------------------------------------------
+#pragma mark - AGSoundFileStream
+
+class AGSoundFileStream
+{
+public:
+    /* off the audio thread; starts at the end of file (i.e. silent). file may
+       be NULL, for a stream of silence */
+    AGSoundFileStream(const std::shared_ptr<AGSoundFile> &file);
+    /* off the audio thread */
+    ~AGSoundFileStream();
+    AGSoundFileStream(const AGSoundFileStream &) = delete;
+
+    /* pin the window from the current position, before each block */
+    void prefetch();
+
+    /* play from the start */
+    void reset();
+    /* frames per sample; negative plays backward (from the end, if at the start) */
+    void setRate(double rate);
+    double rate() const { return m_rate; }
+    /* next sample */
+    float tick();
+    /* true once playback has run off the end (and until reset) */
+    bool finished() const { return m_finished; }
+
+private:
+    const float *_data(int chunk);
+    void _pin(int chunk);
+    void _unpin(int chunk);
+
+    std::shared_ptr<AGSoundFile> m_file;
+    int m_numFrames;
+
+    double m_time;
+    double m_rate;
+    bool m_interpolate;
+    bool m_finished;
+
+    // pinned chunks: the first, and [m_windowStart, m_windowEnd)
+    std::vector<uint8_t> m_pinned;
+    int m_windowStart;
+    int m_windowEnd;
+};
+
+
+//------------------------------------------------------------------------------
+// ### AGSoundFileCache ###
+// Opens sound files, one AGSoundFile per path however many nodes play it, and
+// runs the I/O thread that loads and frees their chunks (polling every
+// POLL_MS, so the audio thread never has to signal it).
+//------------------------------------------------------------------------------
+#pragma mark - AGSoundFileCache
+
+class AGSoundFileCache
+{
+public:
+    static const int POLL_MS = 5;
+
+    static AGSoundFileCache &instance();
+
+    /* off the audio thread: the file at path, or NULL if it can't be read */
+    std::shared_ptr<AGSoundFile> open(const std::string &path);
+
+    /* frames that streams keep loaded ahead of where they are playing */
+    void setPrefetchFrames(int frames) { m_prefetchFrames.store(frames, std::memory_order_relaxed); }
+    int prefetchFrames() const { return m_prefetchFrames.load(std::memory_order_relaxed); }
+
+    /* have streams wait for their chunks instead of playing silence, for
+       offline rendering that can outrun the disk */
+    void setBlocking(bool blocking) { m_blocking.store(blocking, std::memory_order_relaxed); }
+    bool blocking() const { return m_blocking.load(std::memory_order_relaxed); }
+
+    /* chunks loaded, over all files */
+    int numLoadedChunks() const { return m_numLoadedChunks.load(std::memory_order_relaxed); }
+    /* samples streams played as silence for want of a loaded chunk */
+    uint64_t numUnderruns() const { return m_numUnderruns.load(std::memory_order_relaxed); }
+
+private:
+    friend class AGSoundFile;
+    friend class AGSoundFileStream;
+
+    AGSoundFileCache();
+    AGSoundFileCache(const AGSoundFileCache &) = delete;
+
+    void _run();
+
+    Mutex m_mutex;
+    // by path; the streams using a file keep it alive
+    std::map<std::string, std::weak_ptr<AGSoundFile>> m_files;
+    Thread m_thread;
+    bool m_running;
+
+    std::atomic<int> m_prefetchFrames;
+    std::atomic<bool> m_blocking;
+    std::atomic<int> m_numLoadedChunks;
+    std::atomic<uint64_t> m_numUnderruns;
+};
+
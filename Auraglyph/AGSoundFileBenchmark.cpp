@@ -0,0 +1,219 @@
+//
+//  AGSoundFileBenchmark.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGSoundFileBenchmark.h"
+#include "AGSoundFile.h"
+#include "AGAudioNode.h"
+
+#include "FileWrite.h"
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+
+static const double TONE_FREQUENCY = 440;
+static const double TONE_AMPLITUDE = 0.5;
+static const int BLOCK_SIZE = 256;
+
+static double _tone(double frame)
+{
+    return TONE_AMPLITUDE*sin(2*M_PI*TONE_FREQUENCY*frame/AGAudioNode::sampleRate());
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGSoundFileBenchmark ###
+//------------------------------------------------------------------------------
+#pragma mark - AGSoundFileBenchmark
+
+bool AGSoundFileBenchmark::writeTone(const std::string &path, double seconds)
+{
+    stk::FileWrite file;
+    try {
+        file.open(path, 1, stk::FileWrite::FILE_WAV, stk::Stk::STK_SINT16);
+    } catch(const stk::StkError &error) {
+        return false;
+    }
+
+    long numFrames = (long) (seconds*AGAudioNode::sampleRate());
+    stk::StkFrames frames(4096, 1);
+    for(long frame = 0; frame < numFrames; frame += frames.frames())
+    {
+        if(numFrames-frame < frames.frames())
+            frames.resize(numFrames-frame, 1);
+        for(int i = 0; i < (int) frames.frames(); i++)
+            frames[i] = _tone(frame+i);
+        file.write(frames);
+    }
+
+    file.close();
+
+    return true;
+}
+
+AGSoundFileBenchmark::Result AGSoundFileBenchmark::run(const std::string &path, bool blocking, int numStreams, double maxSeconds)
+{
+    using namespace std::chrono;
+
+    AGSoundFileCache &cache = AGSoundFileCache::instance();
+    cache.setBlocking(blocking);
+
+    Result result;
+    result.blocking = blocking;
+    result.numStreams = numStreams;
+    result.rssStart = residentBytes();
+    result.rssMax = result.rssStart;
+    result.maxLoadedChunks = 0;
+    result.maxError = 0;
+
+    std::shared_ptr<AGSoundFile> file = cache.open(path);
+    assert(file != NULL);
+    result.fileBytes = file->numFrames()*sizeof(float);
+    double end = file->numFrames()-1;
+    // whole files are normalized
+    double scale = file->numFrames() <= AGSoundFile::RESIDENT_FRAMES ? 1/TONE_AMPLITUDE : 1;
+
+    // forward, at half speed (interpolating), backward, and at 1.5x
+    const double rates[] = { 1, 0.5, -1, 1.5 };
+    std::vector<std::unique_ptr<AGSoundFileStream>> streams;
+    std::vector<double> positions;
+    for(int s = 0; s < numStreams; s++)
+    {
+        double rate = rates[s%4];
+        streams.emplace_back(new AGSoundFileStream(file));
+        streams[s]->reset();
+        streams[s]->setRate(rate);
+        positions.push_back(rate < 0 ? end : 0);
+    }
+    file.reset();
+
+    // as a node has between opening a file and being triggered, give the I/O
+    // thread a moment to load the start
+    for(auto &stream : streams)
+        stream->prefetch();
+    usleep(100*1000);
+
+    uint64_t underrunsStart = cache.numUnderruns();
+    long maxFrames = maxSeconds > 0 ? (long) (maxSeconds*AGAudioNode::sampleRate()) : -1;
+    long numFrames = 0;
+    long nextSample = 0;
+    float buffer[BLOCK_SIZE];
+
+    auto start = steady_clock::now();
+
+    for(bool playing = true; playing && numFrames != maxFrames; )
+    {
+        playing = false;
+        int blockSize = BLOCK_SIZE;
+        if(maxFrames > 0 && maxFrames-numFrames < blockSize)
+            blockSize = (int) (maxFrames-numFrames);
+
+        for(int s = 0; s < numStreams; s++)
+        {
+            AGSoundFileStream *stream = streams[s].get();
+            stream->prefetch();
+            for(int i = 0; i < blockSize; i++)
+                buffer[i] = stream->tick();
+
+            double rate = stream->rate();
+            double &position = positions[s];
+            for(int i = 0; i < blockSize && position >= 0 && position <= end; i++)
+            {
+                result.maxError = std::max(result.maxError, (float) fabs(buffer[i] - scale*_tone(position)));
+                position += rate;
+            }
+            playing = playing || (position >= 0 && position <= end);
+        }
+
+        numFrames += blockSize;
+
+        if(!blocking)
+        {
+            // keep to real time
+            auto due = start + duration<double>((double) numFrames/AGAudioNode::sampleRate());
+            std::this_thread::sleep_until(due);
+        }
+
+        // about every second
+        if(numFrames >= nextSample)
+        {
+            result.rssMax = std::max(result.rssMax, residentBytes());
+            result.maxLoadedChunks = std::max(result.maxLoadedChunks, cache.numLoadedChunks());
+            nextSample += AGAudioNode::sampleRate();
+        }
+    }
+
+    double elapsed = duration<double>(steady_clock::now()-start).count();
+    result.seconds = (double) numFrames/AGAudioNode::sampleRate();
+    result.realtimeFactor = result.seconds/elapsed;
+    result.numUnderruns = cache.numUnderruns()-underrunsStart;
+
+    streams.clear();
+    result.rssEnd = residentBytes();
+
+    cache.setBlocking(false);
+
+    return result;
+}
+
+void AGSoundFileBenchmark::runAll(const std::string &path, double seconds, double realtimeSeconds)
+{
+    if(!writeTone(path, seconds))
+    {
+        fprintf(stderr, "AGSoundFileBenchmark: unable to write %s\n", path.c_str());
+        return;
+    }
+
+    std::vector<Result> results = {
+        run(path, true),
+        run(path, false, 4, realtimeSeconds),
+    };
+
+    unlink(path.c_str());
+
+    fprintf(stderr, "AGSoundFileBenchmark: %.0f s file (%.1f MB of samples), %i streams\n",
+            seconds, results[0].fileBytes/1.0e6, results[0].numStreams);
+    fprintf(stderr, "%-12s %10s %10s %10s %10s %10s %8s %10s %10s\n", "mode", "seconds", "x realtime",
+            "RSS start", "RSS max", "RSS end", "chunks", "underruns", "max error");
+    for(const Result &result : results)
+    {
+        fprintf(stderr, "%-12s %10.1f %10.1f %9.1fM %9.1fM %9.1fM %8i %10llu %10.6f\n",
+                result.blocking ? "blocking" : "realtime", result.seconds, result.realtimeFactor,
+                result.rssStart/1.0e6, result.rssMax/1.0e6, result.rssEnd/1.0e6,
+                result.maxLoadedChunks, (unsigned long long) result.numUnderruns, result.maxError);
+    }
+}
+
+size_t AGSoundFileBenchmark::residentBytes()
+{
+#if defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if(task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t) &info, &count) != KERN_SUCCESS)
+        return 0;
+    return info.resident_size;
+#else
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if(statm == NULL)
+        return 0;
+    long size = 0, resident = 0;
+    int numRead = fscanf(statm, "%ld %ld", &size, &resident);
+    fclose(statm);
+    return numRead == 2 ? resident*sysconf(_SC_PAGESIZE) : 0;
+#endif
+}
@@ -0,0 +1,56 @@
+//
+//  AGSoundFileBenchmark.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include <string>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// ### AGSoundFileBenchmark ###
+// Plays a long sound file through AGSoundFileStreams, to check that memory
+// stays flat however long the file is. Writes a sine tone of the given length,
+// then plays it end to end through several streams at once (forward, at half
+// speed, and backward), checking every sample against the tone and sampling
+// the process's resident memory as it goes.
+//------------------------------------------------------------------------------
+#pragma mark - AGSoundFileBenchmark
+
+class AGSoundFileBenchmark
+{
+public:
+    struct Result
+    {
+        bool blocking;
+        double seconds; // played, of each stream
+        size_t fileBytes; // of samples, as float
+        int numStreams;
+        double realtimeFactor; // seconds played per second of rendering
+        size_t rssStart; // bytes
+        size_t rssMax;
+        size_t rssEnd;
+        int maxLoadedChunks;
+        uint64_t numUnderruns;
+        float maxError;
+    };
+
+    /* write a mono sine tone of seconds to path; false if it can't be written */
+    static bool writeTone(const std::string &path, double seconds);
+
+    /* play the tone at path (up to maxSeconds of it, if positive) through
+       numStreams streams; blocking, to play as fast as the disk allows, or in
+       real time, counting underruns */
+    static Result run(const std::string &path, bool blocking, int numStreams = 4, double maxSeconds = 0);
+
+    /* write a tone and run both ways, printing a summary to stderr; the
+       real-time run plays the first realtimeSeconds */
+    static void runAll(const std::string &path, double seconds, double realtimeSeconds = 5);
+
+    /* resident memory of this process in bytes, or 0 if unknown */
+    static size_t residentBytes();
+};
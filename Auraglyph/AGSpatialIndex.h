@@ -0,0 +1,306 @@
+//
+//  AGSpatialIndex.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include "Geometry.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// ### AGBoundingBox ###
+// Axis-aligned box, in world coordinates.
+//------------------------------------------------------------------------------
+#pragma mark - AGBoundingBox
+
+struct AGBoundingBox
+{
+    AGBoundingBox() : min(0, 0), max(0, 0) { }
+    AGBoundingBox(const GLvertex2f &_min, const GLvertex2f &_max) : min(_min), max(_max) { }
+    /* the box around a circle */
+    AGBoundingBox(const GLvertex2f &center, float radius) :
+    min(center.x-radius, center.y-radius), max(center.x+radius, center.y+radius) { }
+
+    void unite(const AGBoundingBox &box)
+    {
+        min = GLvertex2f(std::min(min.x, box.min.x), std::min(min.y, box.min.y));
+        max = GLvertex2f(std::max(max.x, box.max.x), std::max(max.y, box.max.y));
+    }
+
+    void unite(const GLvertex2f &point) { unite(AGBoundingBox(point, point)); }
+
+    /* within distance of the box */
+    bool near(const GLvertex2f &point, float distance) const
+    {
+        return point.x >= min.x-distance && point.x <= max.x+distance &&
+               point.y >= min.y-distance && point.y <= max.y+distance;
+    }
+
+    /* any of segment p0-p1 within distance of the box (clipping the segment
+       to the box grown by distance) */
+    bool near(const GLvertex2f &p0, const GLvertex2f &p1, float distance) const
+    {
+        float t0 = 0, t1 = 1;
+        float d[2] = { p1.x-p0.x, p1.y-p0.y };
+        float p[2] = { p0.x, p0.y };
+        float lo[2] = { min.x-distance, min.y-distance };
+        float hi[2] = { max.x+distance, max.y+distance };
+
+        for(int axis = 0; axis < 2; axis++)
+        {
+            if(d[axis] == 0)
+            {
+                if(p[axis] < lo[axis] || p[axis] > hi[axis])
+                    return false;
+                continue;
+            }
+
+            float a = (lo[axis]-p[axis])/d[axis];
+            float b = (hi[axis]-p[axis])/d[axis];
+            if(a > b) std::swap(a, b);
+            t0 = std::max(t0, a);
+            t1 = std::min(t1, b);
+            if(t0 > t1)
+                return false;
+        }
+
+        return true;
+    }
+
+    GLvertex2f min;
+    GLvertex2f max;
+};
+
+
+//------------------------------------------------------------------------------
+// ### AGSpatialIndex ###
+// Finds the objects near a point or a line segment without looking at every
+// object, for hit-testing. Each object is indexed by its bounding box in a
+// grid of square cells, hashed so the canvas needn't be bounded, and listed in
+// every cell its box overlaps. Objects spanning more than MAX_CELLS cells,
+// like a connection across the whole patch, are kept aside and checked by
+// every query.
+//
+// Moving an object only touches the cells it leaves and enters. Queries
+// return candidates whose boxes come within the given distance, for the
+// caller to test exactly, in the order they were first inserted (so that
+// overlapping objects resolve the way a walk of a list in that order would).
+// Not thread-safe; used from the main thread.
+//------------------------------------------------------------------------------
+#pragma mark - AGSpatialIndex
+
+template<class T>
+class AGSpatialIndex
+{
+public:
+    static const int MAX_CELLS = 64;
+
+    /* cellSize should be around the size of a typical object */
+    AGSpatialIndex(float cellSize) : m_cellSize(cellSize) { }
+    AGSpatialIndex(const AGSpatialIndex &) = delete;
+
+    /* index object at box, or move it there if already indexed */
+    void insert(T *object, const AGBoundingBox &box)
+    {
+        int x0, y0, x1, y1;
+        _cellRange(box, x0, y0, x1, y1);
+        bool big = (int64_t) (x1-x0+1)*(y1-y0+1) > MAX_CELLS;
+
+        auto found = m_entries.find(object);
+        if(found == m_entries.end())
+        {
+            Entry &entry = m_entries[object];
+            entry.object = object;
+            entry.order = m_nextOrder++;
+            entry.box = box;
+            _place(entry, x0, y0, x1, y1, big);
+            return;
+        }
+
+        Entry &entry = found->second;
+        entry.box = box;
+        if(big && entry.big)
+            return;
+        if(!big && !entry.big && x0 == entry.x0 && y0 == entry.y0 && x1 == entry.x1 && y1 == entry.y1)
+            return;
+
+        _unplace(entry);
+        _place(entry, x0, y0, x1, y1, big);
+    }
+
+    void remove(T *object)
+    {
+        auto found = m_entries.find(object);
+        if(found == m_entries.end())
+            return;
+
+        _unplace(found->second);
+        m_entries.erase(found);
+    }
+
+    bool contains(T *object) const { return m_entries.count(object) > 0; }
+    size_t size() const { return m_entries.size(); }
+
+    void clear()
+    {
+        m_entries.clear();
+        m_cells.clear();
+        m_big.clear();
+    }
+
+    /* objects whose boxes come within distance of point */
+    void query(const GLvertex2f &point, float distance, std::vector<T *> &results) const
+    {
+        _query(AGBoundingBox(point, distance), results, [&](const Entry &entry) {
+            return entry.box.near(point, distance);
+        });
+    }
+
+    /* objects whose boxes come within distance of segment p0-p1 */
+    void query(const GLvertex2f &p0, const GLvertex2f &p1, float distance, std::vector<T *> &results) const
+    {
+        AGBoundingBox range(p0, distance);
+        range.unite(AGBoundingBox(p1, distance));
+        _query(range, results, [&](const Entry &entry) {
+            return entry.box.near(p0, p1, distance);
+        });
+    }
+
+private:
+    struct Entry
+    {
+        T *object;
+        unsigned long order;
+        AGBoundingBox box;
+        // cells listing this entry, unless it's big
+        int x0, y0, x1, y1;
+        bool big;
+        // last query to see this entry, so it's only returned once
+        mutable unsigned long stamp = 0;
+    };
+
+    static uint64_t _key(int x, int y) { return ((uint64_t) (uint32_t) x << 32) | (uint32_t) y; }
+
+    void _cellRange(const AGBoundingBox &box, int &x0, int &y0, int &x1, int &y1) const
+    {
+        x0 = (int) floorf(box.min.x/m_cellSize);
+        y0 = (int) floorf(box.min.y/m_cellSize);
+        x1 = (int) floorf(box.max.x/m_cellSize);
+        y1 = (int) floorf(box.max.y/m_cellSize);
+    }
+
+    void _place(Entry &entry, int x0, int y0, int x1, int y1, bool big)
+    {
+        entry.x0 = x0; entry.y0 = y0;
+        entry.x1 = x1; entry.y1 = y1;
+        entry.big = big;
+
+        if(big)
+        {
+            m_big.push_back(&entry);
+            return;
+        }
+
+        for(int x = x0; x <= x1; x++)
+            for(int y = y0; y <= y1; y++)
+                m_cells[_key(x, y)].push_back(&entry);
+    }
+
+    void _unplace(Entry &entry)
+    {
+        if(entry.big)
+        {
+            _erase(m_big, &entry);
+            return;
+        }
+
+        for(int x = entry.x0; x <= entry.x1; x++)
+        {
+            for(int y = entry.y0; y <= entry.y1; y++)
+            {
+                auto cell = m_cells.find(_key(x, y));
+                _erase(cell->second, &entry);
+                if(cell->second.empty())
+                    m_cells.erase(cell);
+            }
+        }
+    }
+
+    static void _erase(std::vector<Entry *> &entries, Entry *entry)
+    {
+        auto it = std::find(entries.begin(), entries.end(), entry);
+        *it = entries.back();
+        entries.pop_back();
+    }
+
+    template<class Near>
+    void _query(const AGBoundingBox &range, std::vector<T *> &results, const Near &near) const
+    {
+        unsigned long stamp = ++m_stamp;
+        std::vector<const Entry *> &found = m_found;
+        found.clear();
+
+        auto visit = [&](const Entry *entry) {
+            if(entry->stamp != stamp)
+            {
+                entry->stamp = stamp;
+                if(near(*entry))
+                    found.push_back(entry);
+            }
+        };
+
+        int x0, y0, x1, y1;
+        _cellRange(range, x0, y0, x1, y1);
+        if((int64_t) (x1-x0+1)*(y1-y0+1) <= (int64_t) m_cells.size())
+        {
+            for(int x = x0; x <= x1; x++)
+            {
+                for(int y = y0; y <= y1; y++)
+                {
+                    auto cell = m_cells.find(_key(x, y));
+                    if(cell != m_cells.end())
+                        for(const Entry *entry : cell->second)
+                            visit(entry);
+                }
+            }
+        }
+        else
+        {
+            // a range bigger than what's indexed; visiting every cell is cheaper
+            for(auto &cell : m_cells)
+                for(const Entry *entry : cell.second)
+                    visit(entry);
+        }
+
+        for(const Entry *entry : m_big)
+            visit(entry);
+
+        std::sort(found.begin(), found.end(), [](const Entry *a, const Entry *b) {
+            return a->order < b->order;
+        });
+
+        results.clear();
+        for(const Entry *entry : found)
+            results.push_back(entry->object);
+    }
+
+    float m_cellSize;
+    unsigned long m_nextOrder = 0;
+    // entries don't move once inserted (unordered_map nodes are stable), so
+    // cells can point to them
+    std::unordered_map<T *, Entry> m_entries;
+    std::unordered_map<uint64_t, std::vector<Entry *>> m_cells;
+    std::vector<Entry *> m_big;
+
+    mutable unsigned long m_stamp = 0;
+    mutable std::vector<const Entry *> m_found;
+};
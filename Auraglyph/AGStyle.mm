@@ -22,7 +22,11 @@ const string &AGStyle::standardFontPath()
     static string s_path;
     if(s_path.length() == 0)
     {
+#ifndef AG_HEADLESS
         s_path = string([[[NSBundle mainBundle] pathForResource:@"Orbitron-Medium.ttf" ofType:@""] UTF8String]);
+#else
+        s_path = "Orbitron-Medium.ttf";
+#endif // AG_HEADLESS
 //        s_path = string([[[NSBundle mainBundle] pathForResource:@"bankgthd.ttf" ofType:@""] UTF8String]);
     }
     
@@ -9,24 +9,34 @@
 #ifndef __Auragraph__AGTimer__
 #define __Auragraph__AGTimer__
 
+#include "AGAudioEventScheduler.h"
+
 #include <functional>
 
-class AGTimer
+// fires its action on the audio thread every interval seconds, to the sample
+class AGTimer : public AGAudioEventHandler
 {
 public:
     AGTimer();
-    AGTimer(float interval, void (^action)(AGTimer *timer));
+    AGTimer(float interval, const std::function<void (AGTimer *timer)> &action);
     ~AGTimer();
     
-    void setInterval(float interval) { m_interval = interval; }
-    void setAction(void (^action)(AGTimer *timer)) { m_action = action; }
+    /* takes effect from the next fire (immediately, if that is already due) */
+    void setInterval(float interval);
+    void setAction(const std::function<void (AGTimer *timer)> &action) { m_action = action; }
 
-    void checkTimer(float t, float dt);
+    void scheduleEvents(AGAudioEventScheduler &scheduler, sampletime t) override;
+    void handleEvent(AGAudioEventScheduler &scheduler, sampletime t, int tag) override;
     
 private:
-    float m_lastFire;
-    float m_interval;
-    void (^m_action)(AGTimer *timer);
+    void _post(AGAudioEventScheduler &scheduler, sampletime t);
+    
+    // fire times are kept in fractional samples so that rounding each one to
+    // a whole sample doesn't accumulate; -1 until the timer has started
+    double m_lastFire;
+    double m_nextFire;
+    std::atomic<float> m_interval;
+    std::function<void (AGTimer *timer)> m_action;
 };
 
 
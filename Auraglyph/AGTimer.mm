@@ -8,35 +8,65 @@
 
 #include "AGTimer.h"
 #include "AGAudioManager.h"
+#include "AGAudioNode.h"
+
+#include <float.h>
+#include <math.h>
 
 
 AGTimer::AGTimer() :
-m_lastFire(FLT_MIN), m_interval(FLT_MAX), m_action(NULL)
+m_lastFire(-1), m_nextFire(-1), m_interval(FLT_MAX)
 {
-    [[AGAudioManager instance] addTimer:this];
+    AGAudioManager_::instance().addEventHandler(this);
 }
 
-AGTimer::AGTimer(float interval, void (^action)(AGTimer *timer)) :
-m_lastFire(FLT_MIN), m_interval(interval), m_action(action)
+AGTimer::AGTimer(float interval, const std::function<void (AGTimer *timer)> &action) :
+m_lastFire(-1), m_nextFire(-1), m_interval(interval), m_action(action)
 {
-    [[AGAudioManager instance] addTimer:this];
+    AGAudioManager_::instance().addEventHandler(this);
 }
 
 AGTimer::~AGTimer()
 {
-    [[AGAudioManager instance] removeTimer:this];
-    m_action = NULL;
+    AGAudioManager_::instance().removeEventHandler(this);
+    m_action = nullptr;
+}
+
+void AGTimer::setInterval(float interval)
+{
+    m_interval.store(interval, std::memory_order_relaxed);
+    reschedule();
 }
 
-void AGTimer::checkTimer(float t, float dt)
+void AGTimer::scheduleEvents(AGAudioEventScheduler &scheduler, sampletime t)
 {
     // initial condition
-    if(m_lastFire == FLT_MIN) m_lastFire = t;
+    if(m_lastFire < 0) m_lastFire = t;
+    
+    _post(scheduler, t);
+}
+
+void AGTimer::handleEvent(AGAudioEventScheduler &scheduler, sampletime t, int tag)
+{
+    if(m_action)
+        m_action(this);
+    
+    // count the next interval from when this fire was due, unless it had to
+    // be moved (by a change of interval)
+    m_lastFire = (ceil(m_nextFire) == t ? m_nextFire : t);
+    
+    _post(scheduler, t+1);
+}
+
+void AGTimer::_post(AGAudioEventScheduler &scheduler, sampletime t)
+{
+    // at least a sample apart
+    double interval = std::max(1.0, ((double) m_interval.load(std::memory_order_relaxed))*AGAudioNode::sampleRate());
+    m_nextFire = m_lastFire + interval;
+    
+    // effectively never
+    if(m_nextFire > (double) (1LL << 62))
+        return;
     
-    if(t-m_lastFire >= m_interval)
-    {
-        if(m_action)
-            m_action(this);
-        m_lastFire = t;
-    }
+    scheduler.post(std::max((sampletime) ceil(m_nextFire), t), this);
 }
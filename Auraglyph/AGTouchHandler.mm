@@ -389,97 +389,91 @@
     CGPoint p = [[touches anyObject] locationInView:_viewController.view];
     GLvertex2f erasePos = [_viewController worldCoordinateForScreenCoordinate:p].xy();
     
-    const list<AGFreeDraw*> &freedraws = [_viewController freedraws];
-    
     float eraserThresh = 25;
     
-    for(auto i = freedraws.begin(); i != freedraws.end(); )
+    // just the freedraws that come near the eraser
+    vector<AGFreeDraw *> freedraws;
+    AGGraphManager::instance().freedrawIndex().query(erasePos, eraserThresh, freedraws);
+    
+    for(AGFreeDraw *fd : freedraws)
     {
-        AGFreeDraw *fd = *i++;
         assert(fd);
         
         const vector<GLvertex3f> &oldPoints = fd->points();
         
         // Hit test for whole freedraw
-        for(int i = 0; i < oldPoints.size()-1; i++)
+        if(fd->hitsCircle(erasePos, eraserThresh))
         {
-            GLvertex2f p0 = oldPoints[i].xy();
-            GLvertex2f p1 = oldPoints[i+1].xy();
-            
-            if(pointInCircle(p0, erasePos, eraserThresh) ||
-                (i == oldPoints.size()-2 && pointInCircle(p1, erasePos, eraserThresh)) ||
-                pointOnLine(erasePos, p0, p1, eraserThresh))
+            // points are relative to the freedraw's position
+            GLvertex2f localPos = erasePos - fd->position().xy();
+            vector<vector<GLvertex3f> > newFreedraws;
+            vector<GLvertex3f> newPoints;
+        
+            // Hit test for individual segments within freedraw
+            for(int j = 0; j+1 < oldPoints.size(); j++)
             {
-                vector<vector<GLvertex3f> > newFreedraws;
-                vector<GLvertex3f> newPoints;
+                GLvertex2f p0 = oldPoints[j].xy();
+                GLvertex2f p1 = oldPoints[j+1].xy();
             
-                // Hit test for individual segments within freedraw
-                for(int j = 0; j < oldPoints.size()-1; j++)
+                if(pointInCircle(p0, localPos, eraserThresh))
                 {
-                    GLvertex2f p0 = oldPoints[j].xy();
-                    GLvertex2f p1 = oldPoints[j+1].xy();
-                
-                    if(pointInCircle(p0, erasePos, eraserThresh))
+                    if(newPoints.size()>1)
                     {
-                        if(newPoints.size()>1)
-                        {
-                            newFreedraws.push_back(newPoints);
-                            newPoints.clear();
-                        }
-                        else
-                        {
-                            newPoints.clear();
-                        }
+                        newFreedraws.push_back(newPoints);
+                        newPoints.clear();
                     }
-                    else if((j == oldPoints.size()-2) && pointInCircle(p1, erasePos, eraserThresh))
+                    else
                     {
-                        if(newPoints.size()>0)
-                        {
-                            newPoints.push_back(oldPoints[j]);
-                            newFreedraws.push_back(newPoints);
-                            newPoints.clear();
-                        }
-                        else
-                        {
-                            newPoints.clear();
-                        }
+                        newPoints.clear();
                     }
-                    else if(pointOnLine(erasePos, p0, p1, eraserThresh))
+                }
+                else if((j == oldPoints.size()-2) && pointInCircle(p1, localPos, eraserThresh))
+                {
+                    if(newPoints.size()>0)
                     {
-                        if(newPoints.size()>1)
-                        {
-                            newPoints.push_back(oldPoints[j]);
-                            newFreedraws.push_back(newPoints);
-                            newPoints.clear();
-                        }
-                        else
-                        {
-                            newPoints.clear();
-                        }
-                    }
-                    else {
                         newPoints.push_back(oldPoints[j]);
-                    
-                        if(j == oldPoints.size()-2)
-                        {
-                            newPoints.push_back(oldPoints[j+1]);
-                            newFreedraws.push_back(newPoints);
-                            newPoints.clear();
-                        }
+                        newFreedraws.push_back(newPoints);
+                        newPoints.clear();
+                    }
+                    else
+                    {
+                        newPoints.clear();
                     }
                 }
-            
-                for(auto draw : newFreedraws)
+                else if(pointOnLine(localPos, p0, p1, eraserThresh))
                 {
-                    AGFreeDraw *fd_new = new AGFreeDraw(draw.data(), draw.size());
-                    fd_new->init();
-                    [_viewController addFreeDraw:fd_new];
+                    if(newPoints.size()>1)
+                    {
+                        newPoints.push_back(oldPoints[j]);
+                        newFreedraws.push_back(newPoints);
+                        newPoints.clear();
+                    }
+                    else
+                    {
+                        newPoints.clear();
+                    }
                 }
-            
-                [_viewController resignFreeDraw:fd];
+                else {
+                    newPoints.push_back(oldPoints[j]);
                 
-                break; // Break out of handling this freedraw
+                    if(j == oldPoints.size()-2)
+                    {
+                        newPoints.push_back(oldPoints[j+1]);
+                        newFreedraws.push_back(newPoints);
+                        newPoints.clear();
+                    }
+                }
+            }
+        
+            for(auto draw : newFreedraws)
+            {
+                AGFreeDraw *fd_new = new AGFreeDraw(draw.data(), draw.size());
+                fd_new->setPosition(fd->position());
+                fd_new->init();
+                [_viewController addFreeDraw:fd_new];
             }
+        
+            [_viewController resignFreeDraw:fd];
         }
     }
 }
@@ -396,7 +396,7 @@ m_lastTraceWasRecognized(true)
                 GLvertex2f size = GLvertex2f(m_radius*2*(G_RATIO-1), rowHeight*(G_RATIO-1));
                 AGUIButton *actionButton = new AGUIButton(info.name, GLvertex2f(-size.x/2, y), size);
                 actionButton->init();
-                actionButton->setAction(^{
+                actionButton->setAction([this, port, actionButton](){
                     m_node->setEditPortValue(port, AGControl(actionButton->isPressed()));
                 });
                 actionButton->setRenderFixed(false);
@@ -406,7 +406,7 @@ m_lastTraceWasRecognized(true)
             else
             {
                 AGUIButton *checkButton = AGUIButton::makeCheckButton();
-                checkButton->setAction(^{
+                checkButton->setAction([this, port, checkButton](){
                     m_node->setEditPortValue(port, AGControl(checkButton->isPressed()));
                 });
                 float x = m_radius/2;
@@ -435,7 +435,7 @@ m_lastTraceWasRecognized(true)
     m_pinButton->init();
     m_pinButton->setInteractionType(AGUIButton::INTERACTION_LATCH);
     m_pinButton->setIconMode(AGUIIconButton::ICONMODE_SQUARE);
-    m_pinButton->setAction(^{
+    m_pinButton->setAction([this](){
         pin(m_pinButton->isPressed());
     });
     addChild(m_pinButton);
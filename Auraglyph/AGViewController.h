@@ -68,6 +68,9 @@ enum AGDrawMode
 - (GLvertex3f)fixedCoordinateForScreenCoordinate:(CGPoint)p;
 - (AGNode::HitTestResult)hitTest:(GLvertex3f)pos node:(AGNode **)node port:(int *)port;
 
+/* write edits not yet autosaved, now rather than once they settle */
+- (void)saveChanges;
+
 + (NSString *)styleFontPath;
 
 @end
@@ -15,6 +15,7 @@
 #import "AGNode.h"
 #import "AGFreeDraw.h"
 #import "AGAudioManager.h"
+#import "AGAudioEngine.h"
 #import "AGUserInterface.h"
 #import "TexFont.h"
 #import "AGDef.h"
@@ -24,6 +25,7 @@
 #import "AGAboutBox.h"
 #import "AGDocument.h"
 #import "AGDocumentManager.h"
+#import "AGDocumentAutosave.h"
 #import "GeoGenerator.h"
 #import "spstl.h"
 #import "AGAnalytics.h"
@@ -114,6 +116,16 @@ enum InterfaceMode
     std::string _currentDocumentFilename;
     std::vector<std::vector<GLvertex2f>> _currentDocName;
     
+    // the document as of the last update, kept current one edited object at a
+    // time, and written in the background
+    AGDocument _document;
+    unsigned long _documentRevision;
+    AGDocumentAutosave _autosave;
+    
+    // hit-testing candidates, kept to reuse their storage
+    std::vector<AGNode *> _hitNodes;
+    std::vector<AGConnection *> _hitConnections;
+    
     AGViewController_ *_proxy;
 }
 
@@ -133,6 +145,9 @@ enum InterfaceMode
 - (void)renderUser;
 
 - (void)_save:(BOOL)saveAs;
+- (void)_updateDocument;
+- (void)_startAutosave;
+- (void)_stopAutosave;
 - (void)_openLoad;
 - (void)_clearDocument;
 - (void)_newDocument;
@@ -376,6 +391,8 @@ static AGViewController * g_instance = nil;
     _nodes.push_back(node);
     _objects.push_back(node);
     _uuid2Node[node->uuid()] = node;
+    node->markEdited();
+    AGGraphManager::instance().indexNode(node);
     
     AGInteractiveObject * ui = node->userInterface();
     if(ui)
@@ -407,6 +424,8 @@ static AGViewController * g_instance = nil;
         _nodes.remove(node);
         _objects.remove(node);
         _uuid2Node.erase(node->uuid());
+        _document.removeNode(node->uuid());
+        AGGraphManager::instance().unindexNode(node);
     }
 }
 
@@ -494,12 +513,18 @@ static AGViewController * g_instance = nil;
     {
         _nodes.remove(node);
         _uuid2Node.erase(node->uuid());
+        _document.removeNode(node->uuid());
+        AGGraphManager::instance().unindexNode(node);
     }
     _dashboard.remove(object);
     
     AGFreeDraw *draw = dynamic_cast<AGFreeDraw *>(object);
     if(draw)
+    {
         _freedraws.remove(draw);
+        _document.removeFreedraw(draw->uuid());
+        AGGraphManager::instance().unindexFreedraw(draw);
+    }
 }
 
 - (void)removeFromTouchCapture:(AGInteractiveObject *)object
@@ -523,6 +548,8 @@ static AGViewController * g_instance = nil;
     
     _freedraws.push_back(freedraw);
     _objects.push_back(freedraw);
+    freedraw->markEdited();
+    AGGraphManager::instance().indexFreedraw(freedraw);
 }
 
 //- (void)replaceFreeDraw:(AGFreeDraw *)freedrawOld freedrawNew:(AGFreeDraw *)freedrawNew
@@ -544,6 +571,8 @@ static AGViewController * g_instance = nil;
     
     _freedraws.remove(freedraw);
     _objects.remove(freedraw);
+    _document.removeFreedraw(freedraw->uuid());
+    AGGraphManager::instance().unindexFreedraw(freedraw);
 }
 
 - (void)removeFreeDraw:(AGFreeDraw *)freedraw
@@ -553,6 +582,8 @@ static AGViewController * g_instance = nil;
     
     _freedraws.remove(freedraw);
     _fadingOut.push_back(freedraw);
+    _document.removeFreedraw(freedraw->uuid());
+    AGGraphManager::instance().unindexFreedraw(freedraw);
 }
 
 - (const list<AGFreeDraw *> &)freedraws
@@ -692,12 +723,16 @@ static AGViewController * g_instance = nil;
             assert(obj);
             if(obj->finishedRenderingOut())
             {
-                delete *j;
+                // the audio thread may still be rendering it (if a node) or
+                // delivering control through it (if a connection)
+                AGAudioManager_::instance().retire([obj]() { delete obj; });
                 _fadingOut.erase(j);
             }
         }
     }
     
+    [AGAudioManager instance].engine->reclaim();
+    
     _cameraZ.interp();
     
     [self updateMatrices];
@@ -726,6 +761,8 @@ static AGViewController * g_instance = nil;
     for(auto kv : _touchHandlers)
         [_touchHandlers[kv.first] update:_t dt:dt];
     [_touchHandlerQueue update:_t dt:dt];
+    
+    [self _updateDocument];
 }
 
 - (void)glkView:(GLKView *)view drawInRect:(CGRect)rect
@@ -807,7 +844,11 @@ static AGViewController * g_instance = nil;
 {
     AGNode::HitTestResult hit;
     
-    for(AGNode *node : _nodes)
+    // just the nodes near pos, in the order they were added
+    std::vector<AGNode *> nodes;
+    AGGraphManager::instance().nodeIndex().query(pos.xy(), 0, nodes);
+    
+    for(AGNode *node : nodes)
     {
         hit = node->hit(pos, port);
         if(hit != AGNode::HIT_NONE)
@@ -879,6 +920,9 @@ static AGViewController * g_instance = nil;
         // search the rest of the objects
         if(touchCapture == NULL && handler == nil)
         {
+            // only nodes near the touch can be hit
+            AGGraphManager::instance().nodeIndex().query(pos.xy(), 0, _hitNodes);
+            
             // search in reverse order
             for(auto i = _objects.rbegin(); i != _objects.rend(); i++)
             {
@@ -887,6 +931,8 @@ static AGViewController * g_instance = nil;
                 // check if its a node
                 // todo: check node ports first
                 AGNode *node = dynamic_cast<AGNode *>(object);
+                if(node && std::find(_hitNodes.begin(), _hitNodes.end(), node) == _hitNodes.end())
+                    continue;
                 if(node)
                 {
                     // nodes require special hit testing
@@ -921,15 +967,10 @@ static AGViewController * g_instance = nil;
         // search node connections
         if(touchCapture == NULL && handler == nil)
         {
-            for(AGNode *node : _nodes)
+            AGGraphManager::instance().connectionIndex().query(pos.xy(), AGConnection::hitDistance(), _hitConnections);
+            for(AGConnection *connection : _hitConnections)
             {
-                for(AGConnection *connection : node->outbound())
-                {
-                    touchCapture = connection->hitTest(pos);
-                    if(touchCapture)
-                        break;
-                }
-                
+                touchCapture = connection->hitTest(pos);
                 if(touchCapture)
                     break;
             }
@@ -1168,40 +1209,74 @@ static AGViewController * g_instance = nil;
 
 - (void)_save:(BOOL)saveAs
 {
-    __block AGDocument doc;
-    
-    itmap(_nodes, ^(AGNode *&node) {
-        AGDocument::Node docNode = node->serialize();
-        doc.addNode(docNode);
-    });
-    
-    itmap(_objects, ^(AGInteractiveObject *&obj){
-        AGFreeDraw *freedraw;
-        
-        if((freedraw = dynamic_cast<AGFreeDraw *>(obj)) != NULL)
-        {
-            AGDocument::Freedraw docFreedraw = freedraw->serialize();
-            doc.addFreedraw(docFreedraw);
-        }
-    });
+    [self _updateDocument];
     
     if(_currentDocumentFilename.size() == 0 || saveAs)
     {
-        AGUISaveDialog *saveDialog = AGUISaveDialog::save(doc);
+        AGUISaveDialog *saveDialog = AGUISaveDialog::save(_document);
         
         saveDialog->onSave([self](const std::string &filename, const vector<vector<GLvertex2f>> &name) {
             _currentDocumentFilename = filename;
             _currentDocName = name;
             AGPreferences::instance().setLastOpenedDocument(_currentDocumentFilename);
+            [self _startAutosave];
         });
         
         _dashboard.push_back(saveDialog);
     }
     else
     {
-        doc.setName(_currentDocName);
-        AGDocumentManager::instance().update(_currentDocumentFilename, doc);
+        // already saved as it changes; just don't wait for edits to settle
+        _autosave.saveSoon();
+    }
+}
+
+- (void)saveChanges
+{
+    [self _updateDocument];
+    _autosave.flush();
+}
+
+- (void)_updateDocument
+{
+    // serialize only what was edited since the last update
+    unsigned long revision = AGInteractiveObject::lastRevision();
+    if(revision != _documentRevision)
+    {
+        for(AGNode *node : _nodes)
+        {
+            if(node->revision() > _documentRevision)
+                _document.updateNode(node->uuid(), node->serialize());
+        }
+        
+        for(AGFreeDraw *freedraw : _freedraws)
+        {
+            if(freedraw->revision() > _documentRevision)
+                _document.updateFreedraw(freedraw->uuid(), freedraw->serialize());
+        }
+        
+        _documentRevision = revision;
     }
+    
+    if(_autosave.isRunning() && _document.isDirty())
+        _autosave.submit(_document.takeChanges());
+}
+
+- (void)_startAutosave
+{
+    _document.setName(_currentDocName);
+    
+    // whatever changed since _document was last written is written first thing,
+    // in whichever format the file is already in
+    std::string path = AGDocumentManager::instance().pathForFilename(_currentDocumentFilename);
+    _autosave.start(path, _document, AGDocument::formatForPath(path));
+    _autosave.submit(_document.takeChanges());
+}
+
+- (void)_stopAutosave
+{
+    [self _updateDocument];
+    _autosave.stop();
 }
 
 - (void)_openLoad
@@ -1218,18 +1293,24 @@ static AGViewController * g_instance = nil;
 
 - (void)_clearDocument
 {
+    AGAudioManager_::instance().beginGraphEdit();
+    
     // delete all objects
     itmap_safe(_objects, ^(AGInteractiveObject *&object){
         [self fadeOutAndDelete:object];
     });
+    
+    AGAudioManager_::instance().endGraphEdit();
 }
 
 - (void)_newDocument
 {
+    [self _stopAutosave];
     [self _clearDocument];
     
     _currentDocumentFilename = "";
     _currentDocName = std::vector<std::vector<GLvertex2f>>();
+    _document = AGDocument();
     
     // just create output node by itself
     AGNode *node = AGNodeManager::audioNodeManager().createNodeOfType("Output", GLvertex3f(0, 0, 0));
@@ -1240,6 +1321,7 @@ static AGViewController * g_instance = nil;
 
 - (void)_loadDocument:(AGDocument &)doc
 {
+    [self _stopAutosave];
     [self _clearDocument];
     
     _currentDocName = doc.name();
@@ -1247,6 +1329,9 @@ static AGViewController * g_instance = nil;
     
     __block map<string, AGNode *> uuid2node;
     
+    // compiled and handed to the audio thread once it's all there
+    AGAudioManager_::instance().beginGraphEdit();
+    
     doc.recreate(^(const AGDocument::Node &docNode) {
         AGNode *node = NULL;
         if(docNode._class == AGDocument::Node::AUDIO)
@@ -1284,6 +1369,24 @@ static AGViewController * g_instance = nil;
 //        [self addTopLevelObject:freedraw];
         [self addFreeDraw:freedraw];
     });
+    
+    AGAudioManager_::instance().endGraphEdit();
+    
+    // start over from what was loaded, as it's already on disk
+    _document = AGDocument();
+    for(AGNode *node : _nodes)
+        _document.addNode(node->serialize());
+    for(AGFreeDraw *freedraw : _freedraws)
+        _document.addFreedraw(freedraw->serialize());
+    _document.setName(_currentDocName);
+    _document.takeChanges();
+    _documentRevision = AGInteractiveObject::lastRevision();
+    
+    if(_currentDocumentFilename.size())
+    {
+        std::string path = AGDocumentManager::instance().pathForFilename(_currentDocumentFilename);
+        _autosave.start(path, _document, AGDocument::formatForPath(path));
+    }
 }
 
 
@@ -33,6 +33,7 @@ public:
         PARAM_NOTEOUT_CHANNEL,
         PARAM_NOTEOUT_PITCH,
         PARAM_NOTEOUT_VELOCITY,
+        PARAM_NOTEOUT_POLY,
     };
     
     class Manifest : public AGStandardNodeManifest<AGControlMidiNoteIn>
@@ -50,6 +51,9 @@ public:
                 { PARAM_NOTEOUT_CHANNEL, "Channel", ._default = 0, .min = 0, .max = 16,
                     .type = AGControl::TYPE_INT, .mode = AGPortInfo::LIN,
                     .doc = "Channel." },
+                { PARAM_NOTEOUT_POLY, "Poly", ._default = 0, .min = 0, .max = 1,
+                    .type = AGControl::TYPE_INT, .mode = AGPortInfo::LIN,
+                    .doc = "Send note offs for every held note, not just the last (e.g. for a polyphonic composite)." },
             };
         };
         
@@ -73,6 +73,7 @@ void AGControlMidiNoteIn::messageReceived(double deltatime, vector<unsigned char
     uint8_t chr = message->at(0);
     
     int nodeChan = param(PARAM_NOTEOUT_CHANNEL);
+    bool poly = param(PARAM_NOTEOUT_POLY).getInt();
     
     if(nodeChan == 0)
     {
@@ -95,7 +96,7 @@ void AGControlMidiNoteIn::messageReceived(double deltatime, vector<unsigned char
     
     if(chr == 0x80) // Note off
     {
-        if(message->at(1) == curNote)
+        if(poly || message->at(1) == curNote)
         {
             noteStatus = false;
             
@@ -113,9 +113,8 @@ public:
         pullInputPorts(t, nFrames);
         
         float *triggerv = inputPortVector(PARAM_TRIGGER);
-        float *gainv = inputPortVector(AUDIO_PARAM_GAIN);
         // use constant (1.0) virtual input if no actual inputs are present
-        float virtual_input = numInputsForPort(PARAM_INPUT, AGRate::RATE_AUDIO) == 0 ? 1.0f : 0.0f;
+        float virtual_input = numRenderInputsForPort(PARAM_INPUT, AGRate::RATE_AUDIO) == 0 ? 1.0f : 0.0f;
         float *inputv = inputPortVector(PARAM_INPUT);
         
         for(int i = 0; i < nFrames; i++)
@@ -129,9 +128,30 @@ public:
                         }
             m_prevTrigger = triggerv[i];
             
-            m_outputBuffer[chanNum][i] = m_adsr.tick() * (inputv[i] + virtual_input) * gainv[i];
-            output[i] += m_outputBuffer[chanNum][i];
+            m_outputBuffer[chanNum][i] = m_adsr.tick() * (inputv[i] + virtual_input);
         }
+        
+        scaleByInputPort(AUDIO_PARAM_GAIN, m_outputBuffer[chanNum], nFrames);
+        spv_add(output, m_outputBuffer[chanNum], nFrames);
+    }
+    
+    int tailFrames() const override
+    {
+        // the envelope scales the input, if there is one
+        if(numRenderInputsForPort(PARAM_INPUT, AGRate::RATE_AUDIO) > 0 && nextInputPortValue(PARAM_INPUT) == 0)
+            return 0;
+        return TAIL_INFINITE;
+    }
+    
+    bool outputGated() const override
+    {
+        // at rest, with no trigger on the way
+        if(m_adsr.getState() != stk::ADSR::IDLE)
+            return false;
+        if(numRenderInputsForPort(PARAM_TRIGGER, AGRate::RATE_AUDIO) > 0)
+            return false;
+        float trigger = nextInputPortValue(PARAM_TRIGGER);
+        return !(trigger > 0 && trigger != m_prevTrigger);
     }
     
     virtual void receiveControl(int port, const AGControl &control) override
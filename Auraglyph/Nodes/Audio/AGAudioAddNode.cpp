@@ -75,7 +75,7 @@ public:
     
     void initFinal() override
     {
-        m_inputBuffer.resize(bufferSize());
+        m_inputBuffer.resize(AUDIO_BUFFER_MAX);
     }
     
     virtual void renderAudio(sampletime t, float *input, float *output, int nFrames, int chanNum, int nChans) override
@@ -85,9 +85,7 @@ public:
         
         float gain = param(AUDIO_PARAM_GAIN);
         
-        this->lock();
-        
-        int numInputs = numInputsForPort(PARAM_INPUT);
+        int numInputs = numRenderInputsForPort(PARAM_INPUT);
         // if only one input, process with edit port value
         float base = 0;
         if(numInputs == 1)
@@ -97,25 +95,29 @@ public:
                 }
         
         // set to base value
-        for(int i = 0; i < nFrames; i++)
-            m_outputBuffer[chanNum][i] = base;
+        spv_fill(m_outputBuffer[chanNum], base, nFrames);
         
         for(int j = 0; j < numInputs; j++)
         {
             m_inputBuffer.clear();
             pullPortInput(PARAM_INPUT, j, t, m_inputBuffer, nFrames);
             
-            for(int i = 0; i < nFrames; i++)
-                m_outputBuffer[chanNum][i] += m_inputBuffer[i];
+            spv_add(m_outputBuffer[chanNum], m_inputBuffer, nFrames);
         }
         
-        this->unlock();
-        
-        for(int i = 0; i < nFrames; i++)
-        {
-            m_outputBuffer[chanNum][i] *= gain;
-            output[i] += m_outputBuffer[chanNum][i];
-        }
+        spv_scale(m_outputBuffer[chanNum], gain, nFrames);
+        spv_add(output, m_outputBuffer[chanNum], nFrames);
+    }
+    
+    int tailFrames() const override
+    {
+        // a sum of silent inputs, unless a control input or the add param
+        // (with one input) offsets it
+        if(numRenderInputsForPort(PARAM_INPUT, RATE_CONTROL) > 0)
+            return TAIL_INFINITE;
+        if(numRenderInputsForPort(PARAM_INPUT) == 1 && m_params.count(PARAM_ADD) && (float) m_params.at(PARAM_ADD) != 0)
+            return TAIL_INFINITE;
+        return 0;
     }
     
 private:
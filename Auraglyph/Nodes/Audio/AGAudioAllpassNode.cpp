@@ -7,6 +7,7 @@
 //
 
 #include "AGAudioNode.h"
+#include "RealtimePool.h"
 
 
 //------------------------------------------------------------------------------
@@ -60,13 +61,16 @@ public:
         return m_buffer.size-1;
     }
     
+    // may be called on the audio thread; if no memory is available, the
+    // maximum delay stays as it was
     float maxdelay(float dsamps)
     {
         assert(dsamps >= 0);
         
-        m_buffer.resize((int)floorf(dsamps)+1);
+        if(m_buffer.resize((int)floorf(dsamps)+1))
+            m_index = 0;
         this->clear();
-        return dsamps;
+        return maxdelay();
     }
     
     float last()
@@ -82,7 +86,7 @@ public:
 private:
     int m_delayint;
     
-    Buffer<float> m_buffer;
+    PoolBuffer<float> m_buffer;
     float m_last;
     int m_index;
 };
@@ -128,7 +132,7 @@ public:
     }
     
     float maxdelay() {
-        return m_delay_x.maxdelay();
+        return std::min(m_delay_x.maxdelay(), m_delay_y.maxdelay());
     }
     
     float maxdelay(float dsamps) {
@@ -136,7 +140,7 @@ public:
         
         m_delay_x.maxdelay(dsamps);
         m_delay_y.maxdelay(dsamps);
-        return dsamps;
+        return maxdelay();
     }
     
     void clear()
@@ -181,7 +185,7 @@ public:
             return {
                 { PARAM_INPUT, "input", .doc = "Input signal." },
                 { PARAM_DELAY, "delay", 1, 1, AGInt_Max,
-                    .type = AGControl::TYPE_INT, .mode = AGPortInfo::LIN,
+                    .mode = AGPortInfo::LIN, .type = AGControl::TYPE_INT,
                     .doc = "Delay length (samples)." },
                 { PARAM_COEFF, "coeff", 0.1, 0, 1, .doc = "Allpass coefficient." },
                 { AUDIO_PARAM_GAIN, "gain", 1, .doc = "Output gain." },
@@ -193,7 +197,7 @@ public:
             return {
                 { AUDIO_PARAM_GAIN, "gain", 1, .doc = "Output gain." },
                 { PARAM_DELAY, "delay", 1, 1, AGInt_Max,
-                    .type = AGControl::TYPE_INT, .mode = AGPortInfo::LIN,
+                    .mode = AGPortInfo::LIN, .type = AGControl::TYPE_INT,
                     .doc = "Delay length (samples)." },
                 { PARAM_COEFF, "coeff", 0.1, -AGFloat_Max, AGFloat_Max, .doc = "Allpass coefficient." },
             };
@@ -251,13 +255,6 @@ public:
         m_allpass.clear();
     }
     
-    void editPortValueChanged(int paramId) override
-    {
-        if(paramId == PARAM_DELAY) {
-            _setDelay(param(PARAM_DELAY));
-        }
-    }
-    
     virtual void renderAudio(sampletime t, float *input, float *output, int nFrames, int chanNum, int nChans) override
     {
         if(t <= m_lastTime) { renderLast(output, nFrames, chanNum); return; }
@@ -265,23 +262,43 @@ public:
         pullInputPorts(t, nFrames);
         
         float *inputv = inputPortVector(PARAM_INPUT);
-        float *gainv = inputPortVector(AUDIO_PARAM_GAIN);
-        float *delayLengthv = inputPortVector(PARAM_DELAY);
-        float *coeffv = inputPortVector(PARAM_COEFF);
+        bool constantDelay = inputPortIsConstant(PARAM_DELAY);
+        bool constantCoeff = inputPortIsConstant(PARAM_COEFF);
+        float *delayLengthv = constantDelay ? NULL : inputPortVector(PARAM_DELAY);
+        float *coeffv = constantCoeff ? NULL : inputPortVector(PARAM_COEFF);
+        
+        if(constantDelay)
+            _setDelay(inputPortValue(PARAM_DELAY));
+        if(constantCoeff)
+            m_allpass.g(inputPortValue(PARAM_COEFF));
         
         for(int i = 0; i < nFrames; i++)
         {
-            _setDelay(delayLengthv[i]);
-            m_allpass.g(coeffv[i]);
+            if(!constantDelay)
+                _setDelay(delayLengthv[i]);
+            if(!constantCoeff)
+                m_allpass.g(coeffv[i]);
             
-            float delaySamp = m_allpass.tick(inputv[i]);
-            m_outputBuffer[chanNum][i] = delaySamp * gainv[i];
-            output[i] += m_outputBuffer[chanNum][i];
+            m_outputBuffer[chanNum][i] = m_allpass.tick(inputv[i]);
         }
+        
+        scaleByInputPort(AUDIO_PARAM_GAIN, m_outputBuffer[chanNum], nFrames);
+        spv_add(output, m_outputBuffer[chanNum], nFrames);
+    }
+    
+    int tailFrames() const override
+    {
+        if(nextInputPortValue(PARAM_INPUT) != 0)
+            return TAIL_INFINITE;
+        // echoes recirculate with the coefficient as gain
+        float delaySamps = std::max(m_currentDelayLength, nextInputPortValue(PARAM_DELAY));
+        return echoTailFrames(delaySamps, nextInputPortValue(PARAM_COEFF));
     }
     
 private:
     
+    // render thread only, once the node is live; edits to the delay param
+    // arrive through the port's base value
     void _setDelay(float delaySamps, bool force=false)
     {
         if(force || m_currentDelayLength != delaySamps)
@@ -293,7 +310,8 @@ private:
                 int _max = m_allpass.maxdelay();
                 while(delaySamps > _max)
                     _max *= 2;
-                m_allpass.maxdelay(_max);
+                // clamp to what we have if the pool is out of memory
+                delaySamps = std::min(delaySamps, m_allpass.maxdelay(_max));
                 m_allpass.clear();
             }
             m_allpass.delay(delaySamps);
@@ -14,7 +14,7 @@
 //------------------------------------------------------------------------------
 #pragma mark - AGAudioBiquadNode
 
-class AGAudioBiquadNode : public AGAudioNode
+class AGAudioBiquadNode : public AGAudioNode, public AGAudioFilterBank::Filter
 {
 public:
     
@@ -105,7 +105,7 @@ public:
                 { 0.5, -0.5, 0 }, { 0.3, -0.3, 0 }, { 0.3, -0.5, 0 }, { 0.5, -0.3, 0 },
             };
             
-            for(int i = 0; i < poles.size(); i++)
+            for(int i = 0; i < (int) poles.size(); i++)
             {
                 GLvertex3f vert = poles[i];
                 vert = vert * radius_circ;
@@ -128,42 +128,60 @@ public:
     
     void initFinal() override
     {
-        sn_1 = sn_2 = 0;
+        float coefficients[5];
+        _coefficients(coefficients);
+        resetFilter(coefficients);
     }
     
     virtual void renderAudio(sampletime t, float *input, float *output, int nFrames, int chanNum, int nChans) override
     {
         if(t <= m_lastTime) { renderLast(output, nFrames, chanNum); return; }
+        
+        renderFilter(t, nFrames);
+        spv_add(output, m_outputBuffer[chanNum], nFrames);
+    }
+    
+    AGAudioFilterBank::Kind filterBankKind() const override { return AGAudioFilterBank::BIQUAD; }
+    
+    int tailFrames() const override
+    {
+        // rings out from its current coefficients once the input falls silent
+        return nextInputPortValue(PARAM_INPUT) == 0 ? filterTailFrames(SILENCE) : TAIL_INFINITE;
+    }
+    
+    const float *beginFilter(sampletime t, int nFrames) override
+    {
         m_lastTime = t;
         pullInputPorts(t, nFrames);
         
-        float *inputv = inputPortVector(PARAM_INPUT);
-        float *gainv = inputPortVector(AUDIO_PARAM_GAIN);
-        float a1 = param(PARAM_A1);
-        float a2 = param(PARAM_A2);
-        float b0 = param(PARAM_B0);
-        float b1 = param(PARAM_B1);
-        float b2 = param(PARAM_B2);
-        
-        for(int i = 0; i < nFrames; i++)
+        // Transposed Direct-Form II, run by AGAudioFilterBank
+        float coefficients[5];
+        _coefficients(coefficients);
+        for(int start = 0, interval = 0; start < nFrames; start += SPV_BANK_INTERVAL, interval++)
         {
-            // Transposed Direct-Form II
-            float xn = inputv[i];
-            float yn = b0 * xn + sn_1;
-            sn_2 = -a2 * yn + b2 * xn;
-            sn_1 = -a1 * yn + b1 * xn;
-            
-            if (isbad(yn) || isbad(sn_1) || isbad(sn_2))
-                yn = sn_1 = sn_2 = 0;
-            
-            m_outputBuffer[chanNum][i] = yn * gainv[i];
-            output[i] += m_outputBuffer[chanNum][i];
+            float *targets = filterTargets(interval);
+            for(int k = 0; k < 5; k++)
+                targets[k] = coefficients[k];
         }
+        
+        return inputPortVector(PARAM_INPUT);
+    }
+    
+    float *filterOutput(int o) override { return m_outputBuffer[0]; }
+    
+    void endFilter(int nFrames) override
+    {
+        scaleByInputPort(AUDIO_PARAM_GAIN, m_outputBuffer[0], nFrames);
     }
     
 private:
-    float sn_1, sn_2;
+    // in filter bank order
+    void _coefficients(float *c)
+    {
+        c[0] = param(PARAM_B0);
+        c[1] = param(PARAM_B1);
+        c[2] = param(PARAM_B2);
+        c[3] = param(PARAM_A1);
+        c[4] = param(PARAM_A2);
+    }
 };
-
-
-
@@ -7,6 +7,7 @@
 //
 
 #include "AGAudioNode.h"
+#include "SPCachedCoefficient.h"
 
 
 //------------------------------------------------------------------------------
@@ -134,9 +135,14 @@ public:
         pullInputPorts(t, nFrames);
         
         float *inputv = inputPortVector(PARAM_INPUT);
-        float *gainv = inputPortVector(AUDIO_PARAM_GAIN);
-        float attack_coeff = exp(-1.0f/(sampleRate()*(float)param(PARAM_ATTACK)));
-        float release_coeff = exp(-1.0f/(sampleRate()*(float)param(PARAM_RELEASE)));
+        // exact exp(): these sit close to 1, where approximations show
+        float sr = sampleRate();
+        float attack_coeff = m_attackCoeff.get(param(PARAM_ATTACK), [sr](float attack) {
+            return expf(-1.0f/(sr*attack));
+        });
+        float release_coeff = m_releaseCoeff.get(param(PARAM_RELEASE), [sr](float release) {
+            return expf(-1.0f/(sr*release));
+        });
         
         for(int i = 0; i < nFrames; i++)
         {
@@ -152,13 +158,22 @@ public:
                 m_envelope = release_coeff * m_envelope + (1-release_coeff) * env_input;
             }
             
-            m_outputBuffer[chanNum][i] = m_envelope * gainv[i];
-            
-            output[i] += m_outputBuffer[chanNum][i];
+            m_outputBuffer[chanNum][i] = m_envelope;
         }
+        
+        scaleByInputPort(AUDIO_PARAM_GAIN, m_outputBuffer[chanNum], nFrames);
+        spv_add(output, m_outputBuffer[chanNum], nFrames);
+    }
+    
+    int tailFrames() const override
+    {
+        // the output is the envelope, so it has released once it is silent
+        return nextInputPortValue(PARAM_INPUT) == 0 ? 0 : TAIL_INFINITE;
     }
     
 private:
     float m_envelope;
+    SPCachedCoefficient m_attackCoeff;
+    SPCachedCoefficient m_releaseCoeff;
 };
 
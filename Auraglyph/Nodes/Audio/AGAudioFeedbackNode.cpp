@@ -7,6 +7,7 @@
 //
 
 #include "AGAudioNode.h"
+#include "RealtimePool.h"
 
 
 //------------------------------------------------------------------------------
@@ -107,12 +108,15 @@ public:
         return m_buffer.size-1;
     }
     
+    // may be called on the audio thread; if no memory is available, the
+    // maximum delay stays as it was
     float maxdelay(float dsamps)
     {
         assert(dsamps >= 0);
         
-        m_buffer.resize((int)floorf(dsamps)+1);
-        return dsamps;
+        if(m_buffer.resize((int)floorf(dsamps)+1))
+            m_index = 0;
+        return maxdelay();
     }
     
     void clear()
@@ -130,7 +134,7 @@ private:
     int m_delayint;
     float m_delayfract;
     
-    Buffer<float> m_buffer;
+    PoolBuffer<float> m_buffer;
     int m_index;
     
     AllPass1 m_ap;
@@ -213,12 +217,6 @@ public:
         m_delay.clear();
     }
     
-    void editPortValueChanged(int paramId) override
-    {
-        if(paramId == PARAM_DELAY)
-            _setDelay(param(PARAM_DELAY));
-            }
-    
     virtual void renderAudio(sampletime t, float *input, float *output, int nFrames, int chanNum, int nChans) override
     {
         if(t <= m_lastTime) { renderLast(output, nFrames, chanNum); return; }
@@ -226,24 +224,39 @@ public:
         pullInputPorts(t, nFrames);
         
         float *inputv = inputPortVector(PARAM_INPUT);
-        float *gainv = inputPortVector(AUDIO_PARAM_GAIN);
-        float *delayLengthv = inputPortVector(PARAM_DELAY);
+        bool constantDelay = inputPortIsConstant(PARAM_DELAY);
+        float *delayLengthv = constantDelay ? NULL : inputPortVector(PARAM_DELAY);
         float *feedbackGainv = inputPortVector(PARAM_FEEDBACK);
         float *mixv = inputPortVector(PARAM_MIX);
         
+        if(constantDelay)
+            _setDelay(inputPortValue(PARAM_DELAY));
+        
         for(int i = 0; i < nFrames; i++)
         {
-            _setDelay(delayLengthv[i]);
+            if(!constantDelay)
+                _setDelay(delayLengthv[i]);
             
             float delaySamp = m_delay.tick(inputv[i] + m_delay.last()*feedbackGainv[i]);
-            float outSamp = delaySamp*mixv[i] + inputv[i]*(1-mixv[i]);
-            m_outputBuffer[chanNum][i] = outSamp * gainv[i];
-            output[i] += m_outputBuffer[chanNum][i];
+            m_outputBuffer[chanNum][i] = delaySamp*mixv[i] + inputv[i]*(1-mixv[i]);
         }
+        
+        scaleByInputPort(AUDIO_PARAM_GAIN, m_outputBuffer[chanNum], nFrames);
+        spv_add(output, m_outputBuffer[chanNum], nFrames);
+    }
+    
+    int tailFrames() const override
+    {
+        if(nextInputPortValue(PARAM_INPUT) != 0)
+            return TAIL_INFINITE;
+        float delaySecs = std::max(m_currentDelayLength, nextInputPortValue(PARAM_DELAY));
+        return echoTailFrames(delaySecs*sampleRate(), nextInputPortValue(PARAM_FEEDBACK));
     }
     
 private:
     
+    // render thread only, once the node is live; edits to the delay param
+    // arrive through the port's base value
     void _setDelay(float delaySecs, bool force=false)
     {
         if(force || m_currentDelayLength != delaySecs)
@@ -256,7 +269,8 @@ private:
                 int _max = m_delay.maxdelay();
                 while(delaySamps > _max)
                     _max *= 2;
-                m_delay.maxdelay(_max);
+                // clamp to what we have if the pool is out of memory
+                delaySamps = std::min(delaySamps, m_delay.maxdelay(_max));
                 m_delay.clear();
             }
             m_delay.delay(delaySamps);
@@ -14,8 +14,8 @@
 //------------------------------------------------------------------------------
 #pragma mark - AGAudioFilterNode
 
-template<class Filter>
-class AGAudioFilterFQNode : public AGAudioNode
+template<class Butter>
+class AGAudioFilterFQNode : public AGAudioNode, public AGAudioFilterBank::Filter
 {
 public:
     
@@ -190,19 +190,11 @@ public:
     
     void initFinal() override
     {
-        m_filter = Filter(sampleRate());
-        m_filter.set(param(PARAM_FREQ), param(PARAM_Q));
-    }
-    
-    void editPortValueChanged(int paramId) override
-    {
-        switch(paramId)
-        {
-            case PARAM_FREQ:
-            case PARAM_Q:
-                m_filter.set(param(PARAM_FREQ), param(PARAM_Q));
-                break;
-        }
+        m_filter = Butter(sampleRate());
+        m_freq = param(PARAM_FREQ);
+        m_Q = param(PARAM_Q);
+        _setFilter(m_freq, m_Q);
+        resetFilter(m_coefficients);
     }
     
     float validateEditPortValue(int port, float value) const override
@@ -223,44 +215,78 @@ public:
     virtual void renderAudio(sampletime t, float *input, float *output, int nFrames, int chanNum, int nChans) override
     {
         if(t <= m_lastTime) { renderLast(output, nFrames, chanNum); return; }
+        
+        renderFilter(t, nFrames);
+        spv_add(output, m_outputBuffer[chanNum], nFrames);
+    }
+    
+    AGAudioFilterBank::Kind filterBankKind() const override { return AGAudioFilterBank::BIQUAD; }
+    
+    int tailFrames() const override
+    {
+        // rings out from its current coefficients once the input falls silent
+        return nextInputPortValue(PARAM_INPUT) == 0 ? filterTailFrames(SILENCE) : TAIL_INFINITE;
+    }
+    
+    const float *beginFilter(sampletime t, int nFrames) override
+    {
         m_lastTime = t;
         pullInputPorts(t, nFrames);
         
-        float *inputv = inputPortVector(PARAM_INPUT);
-        float *gainv = inputPortVector(AUDIO_PARAM_GAIN);
-        float *freqv = inputPortVector(PARAM_FREQ);
-        float *qv = inputPortVector(PARAM_Q);
+        // edited values reach us through inputPortValue(), so there's no
+        // need to set the filter from editPortValueChanged (and race render)
+        bool freqConstant = inputPortIsConstant(PARAM_FREQ);
+        bool qConstant = inputPortIsConstant(PARAM_Q);
+        float *freqv = freqConstant ? NULL : inputPortVector(PARAM_FREQ);
+        float *qv = qConstant ? NULL : inputPortVector(PARAM_Q);
+        float constFreq = freqConstant ? inputPortValue(PARAM_FREQ) : 0;
+        float constQ = qConstant ? inputPortValue(PARAM_Q) : 0;
         
-        for(int i = 0; i < nFrames; i++)
+        // recompute coefficients once per interval, at most; the filter
+        // ramps to them across the interval
+        for(int start = 0, interval = 0; start < nFrames; start += SPV_BANK_INTERVAL, interval++)
         {
-            float gain = gainv[i];
-            float freq = freqv[i];
-            float Q = qv[i];
+            int end = std::min(start+SPV_BANK_INTERVAL, nFrames);
+            float freq = freqConstant ? constFreq : freqv[end-1];
+            float Q = qConstant ? constQ : qv[end-1];
             
-            if(freq != param(PARAM_FREQ).getFloat() || Q != param(PARAM_Q).getFloat())
+            if(freq != m_freq || Q != m_Q)
             {
-                if(Q < 0.001) Q = 0.001;
-                if(freq < 0) freq = 0;
-                if(freq > sampleRate()/2) freq = sampleRate()/2;
-                
-                m_filter.set(freq, Q);
+                _setFilter(freq, Q);
+                m_freq = freq;
+                m_Q = Q;
             }
             
-            float samp = gain * m_filter.tick(inputv[i]);
-            if(samp == NAN || samp == INFINITY || samp == -INFINITY)
-            {
-                samp = 0;
-                m_filter.clear();
-            }
-            
-            m_outputBuffer[chanNum][i] = samp;
-            output[i] += m_outputBuffer[chanNum][i];
+            float *targets = filterTargets(interval);
+            for(int k = 0; k < 5; k++)
+                targets[k] = m_coefficients[k];
         }
+        
+        return inputPortVector(PARAM_INPUT);
     }
     
+    float *filterOutput(int o) override { return m_outputBuffer[0]; }
+    
+    void endFilter(int nFrames) override
+    {
+        scaleByInputPort(AUDIO_PARAM_GAIN, m_outputBuffer[0], nFrames);
+    }
     
 private:
-    Filter m_filter;
+    void _setFilter(float freq, float Q)
+    {
+        if(Q < 0.001) Q = 0.001;
+        if(freq < 0) freq = 0;
+        if(freq > sampleRate()/2) freq = sampleRate()/2;
+        
+        m_filter.set(freq, Q);
+        m_filter.biquadCoefficients(m_coefficients);
+    }
+    
+    // computes the coefficients only; filtering is done as a biquad
+    Butter m_filter;
+    // freq/Q the coefficients are for
+    float m_freq;
+    float m_Q;
+    float m_coefficients[5];
 };
-
-
@@ -79,7 +79,7 @@ public:
     
     void initFinal() override
     {
-        srandom((unsigned int) time(NULL));
+        spv_noise_seed(m_noise, arc4random());
     }
     
     virtual void renderAudio(sampletime t, float *input, float *output, int nFrames, int chanNum, int nChans) override
@@ -88,17 +88,16 @@ public:
         m_lastTime = t;
         pullInputPorts(t, nFrames);
         
-        float *gainv = inputPortVector(AUDIO_PARAM_GAIN);
+        float *outputv = m_outputBuffer[chanNum];
         
-        for(int i = 0; i < nFrames; i++)
-        {
-            float randomSample = arc4random()*ONE_OVER_RAND_MAX*2-1;
-            m_outputBuffer[chanNum][i] = randomSample*gainv[i];
-            output[i] += m_outputBuffer[chanNum][i];
-        }
+        spv_noise_render(m_noise, outputv, nFrames);
+        scaleByInputPort(AUDIO_PARAM_GAIN, outputv, nFrames);
+        spv_add(output, outputv, nFrames);
     }
     
 private:
     constexpr static const float ONE_OVER_RAND_MAX = 1.0/4294967295.0;
+    
+    spv_noise m_noise;
 };
 
@@ -15,8 +15,8 @@
 
 void AGAudioOutputNode::initFinal()
 {
-    m_inputBuffer[0].resize(bufferSize());
-    m_inputBuffer[1].resize(bufferSize());
+    m_inputBuffer[0].resize(AUDIO_BUFFER_MAX);
+    m_inputBuffer[1].resize(AUDIO_BUFFER_MAX);
 }
 
 AGAudioOutputNode::~AGAudioOutputNode()
@@ -44,19 +44,20 @@ void AGAudioOutputNode::renderAudio(sampletime t, float *input, float *output, i
     m_inputBuffer[0].clear();
     m_inputBuffer[1].clear();
     
-    this->lock();
-    
-    for(auto conn : m_inbound)
+    // inputs have already been rendered earlier in the plan
+    for(int c = 0; c < m_numRenderInputs; c++)
     {
-        if(conn->rate() == RATE_AUDIO)
+        const AGAudioRenderPlan::Input &in = m_renderInputs[c];
+        
+        if(in.rate == RATE_AUDIO)
         {
-            assert(conn->dstPort() == 0 || conn->dstPort() == 1);
-            ((AGAudioNode *)conn->src())->renderAudio(t, input, m_inputBuffer[conn->dstPort()], nFrames, conn->srcPort(), conn->src()->numOutputPorts());
+            assert(in.dstPort == 0 || in.dstPort == 1);
+            const float *srcBuffer = in.audioSrc()->lastOutputBuffer(in.srcPort);
+            for(int i = 0; i < nFrames; i++)
+                m_inputBuffer[in.dstPort][i] += srcBuffer[i];
         }
     }
     
-    this->unlock();
-    
     float gain = param(AUDIO_PARAM_GAIN);
     
     for(int i = 0; i < nFrames; i++)
@@ -95,7 +95,7 @@ public:
             iconGeo.push_back(GLvertex3f( radius_x * 0.6, radius_y * 1.0, 0));
             
             // Nudge everything downwards a bit
-            for(int i = 0; i < iconGeo.size(); i++)
+            for(int i = 0; i < (int) iconGeo.size(); i++)
             {
                 iconGeo[i].y -= radius_y * 0.6;
             }
@@ -117,20 +117,34 @@ public:
         pullInputPorts(t, nFrames);
         
         float *inputv = inputPortVector(PARAM_INPUT);
-        float *gainv = inputPortVector(AUDIO_PARAM_GAIN);
-        float *panv = inputPortVector(PARAM_PAN);
         
-        for(int i = 0; i < nFrames; i++)
+        // gain_l = sqrt(2)/2*|sin(theta)+cos(theta)|, gain_r = sqrt(2)/2*|sin(theta)-cos(theta)|,
+        // theta = pan*pi/4
+        if(inputPortIsConstant(PARAM_PAN))
         {
-            float theta = panv[i] * M_PI_4;
-            float gain_l = sqrt(2)/2 * abs(sin(theta) + cos(theta));
-            float gain_r = sqrt(2)/2 * abs(sin(theta) - cos(theta));
-            
-            m_outputBuffer[0][i] = inputv[i] * gain_l;
-            m_outputBuffer[1][i] = inputv[i] * gain_r;
-            
-            output[i] += m_outputBuffer[chanNum][i] * gainv[i];
+            float pan = inputPortValue(PARAM_PAN), left, right;
+            spv_panlaw(&left, &right, &pan, 1);
+            spv_fill(m_outputBuffer[0], 0, nFrames);
+            spv_mac(m_outputBuffer[0], inputv, left, nFrames);
+            spv_fill(m_outputBuffer[1], 0, nFrames);
+            spv_mac(m_outputBuffer[1], inputv, right, nFrames);
+        }
+        else
+        {
+            spv_panlaw(m_outputBuffer[0], m_outputBuffer[1], inputPortVector(PARAM_PAN), nFrames);
+            spv_mul(m_outputBuffer[0], inputv, nFrames);
+            spv_mul(m_outputBuffer[1], inputv, nFrames);
         }
+        
+        if(inputPortIsConstant(AUDIO_PARAM_GAIN))
+            spv_mac(output, m_outputBuffer[chanNum], inputPortValue(AUDIO_PARAM_GAIN), nFrames);
+        else
+            spv_muladd(output, m_outputBuffer[chanNum], inputPortVector(AUDIO_PARAM_GAIN), nFrames);
+    }
+    
+    int tailFrames() const override
+    {
+        return nextInputPortValue(PARAM_INPUT) == 0 ? 0 : TAIL_INFINITE;
     }
 };
 
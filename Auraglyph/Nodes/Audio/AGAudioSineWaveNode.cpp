@@ -125,19 +125,13 @@ public:
         m_lastTime = t;
         pullInputPorts(t, nFrames);
         
-        float *gainv = inputPortVector(AUDIO_PARAM_GAIN);
-        float *freqv = inputPortVector(PARAM_FREQ);
-        // if there are audio-rate phase inputs, then ignore m_phase value
-        float phase_ctl = numInputsForPort(PARAM_PHASE, AGRate::RATE_AUDIO) > 0 ? 0.0f : 1.0f;
-        float *phasev = inputPortVector(PARAM_PHASE);
+        float *outputv = m_outputBuffer[chanNum];
         
-        for(int i = 0; i < nFrames; i++)
-        {
-            m_outputBuffer[chanNum][i] = sinf(m_phase*2.0*M_PI) * gainv[i];
-            output[i] += m_outputBuffer[chanNum][i];
-            
-            m_phase = clipunit(m_phase*phase_ctl + freqv[i]/sampleRate() + phasev[i]);
-        }
+        renderPhase(outputv, m_phase, PARAM_FREQ, PARAM_PHASE, nFrames);
+        spv_sin(outputv, outputv, nFrames);
+        
+        scaleByInputPort(AUDIO_PARAM_GAIN, outputv, nFrames);
+        spv_add(output, outputv, nFrames);
     }
     
 private:
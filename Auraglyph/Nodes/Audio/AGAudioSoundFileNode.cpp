@@ -7,7 +7,9 @@
 //
 
 #include "AGAudioNode.h"
-#include "FileWvIn.h"
+#include "AGSoundFile.h"
+#include "AGFileManager.h"
+#include "AtomicSnapshot.h"
 
 
 //------------------------------------------------------------------------------
@@ -89,6 +91,7 @@ public:
     void initFinal() override
     {
         stk::Stk::setSampleRate(sampleRate());
+        m_stream.publish(new AGSoundFileStream(NULL));
     }
     
     int numOutputPorts() const override { return 1; }
@@ -97,18 +100,12 @@ public:
     {
         if(paramId == PARAM_FILE)
         {
-            // todo: abstract filesystem API
-            NSString *documentPath = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) objectAtIndex:0];
-            NSString *subpath = [NSString stringWithUTF8String:param(PARAM_FILE).getString().c_str()];
-            NSString *fullPath = [documentPath stringByAppendingPathComponent:subpath];
-            try {
-                m_file.openFile([fullPath UTF8String]);
-            } catch (const stk::StkError& error) {
+            string fullPath = AGFileManager::instance().soundfileDirectory() + "/" + param(PARAM_FILE).getString();
+            // only opens the file; the cache's I/O thread reads it
+            std::shared_ptr<AGSoundFile> file = AGSoundFileCache::instance().open(fullPath);
+            if(file == NULL)
                 fprintf(stderr, "AGAudioSoundFileNode: unable to open file %s\n", param(PARAM_FILE).getString().c_str());
-            }
-            m_file.setRate(m_rate);
-            // set to end of file
-            m_file.addTime(m_file.getSize());
+            m_stream.publish(new AGSoundFileStream(file));
         }
     }
     
@@ -118,34 +115,53 @@ public:
         m_lastTime = t;
         pullInputPorts(t, nFrames);
         
-        float *gainv = inputPortVector(AUDIO_PARAM_GAIN);
         float *triggerv = inputPortVector(PARAM_TRIGGER);
         float *ratev = inputPortVector(PARAM_RATE);
         
+        AGSoundFileStream *stream = m_stream.acquire();
+        if(stream == NULL)
+        {
+            spv_fill(m_outputBuffer[0], 0, nFrames);
+            return;
+        }
+        
+        stream->prefetch();
+        
         for(int i = 0; i < nFrames; i++)
         {
             // Soundfile is edge-triggered
             if(m_lastTrigger <= 0 && triggerv[i] > 0)
-                m_file.reset();
-                
-                m_lastTrigger = triggerv[i];
+                stream->reset();
+            
+            m_lastTrigger = triggerv[i];
             
-            if(ratev[i] != m_rate)
-            {
-                m_rate = ratev[i];
-                m_file.setRate(m_rate);
-            }
+            if(ratev[i] != stream->rate())
+                stream->setRate(ratev[i]);
             
-            m_outputBuffer[0][i] = m_file.tick() * gainv[i];
-            output[i] += m_outputBuffer[chanNum][i];
+            m_outputBuffer[0][i] = stream->tick();
         }
+        
+        m_finished = stream->finished();
+        
+        scaleByInputPort(AUDIO_PARAM_GAIN, m_outputBuffer[0], nFrames);
+        spv_add(output, m_outputBuffer[chanNum], nFrames);
+    }
+    
+    bool outputGated() const override
+    {
+        // played out (a new file starts out so too), with no trigger on the way
+        if(!m_finished || numRenderInputsForPort(PARAM_TRIGGER, AGRate::RATE_AUDIO) > 0)
+            return false;
+        return !(m_lastTrigger <= 0 && nextInputPortValue(PARAM_TRIGGER) > 0);
     }
     
 private:
     int m_fileNum = -1;
     float m_lastTrigger = 0;
-    float m_rate = 1;
-    stk::FileWvIn m_file;
+    // as of the last block rendered
+    bool m_finished = false;
+    // replaced whole when the file changes
+    AtomicSnapshot<AGSoundFileStream> m_stream;
 };
 
 
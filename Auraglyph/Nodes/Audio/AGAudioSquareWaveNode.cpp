@@ -7,6 +7,7 @@
 //
 
 #include "AGAudioNode.h"
+#include "SPWavetable.h"
 #include "spdsp.h"
 
 //------------------------------------------------------------------------------
@@ -85,6 +86,10 @@ public:
     void initFinal() override
     {
         m_phase = 0;
+        m_level = 0;
+        // build the shared table here rather than on the audio thread
+        m_table = &SPWavetable::sawtooth();
+        m_shiftedBuffer.resize(AUDIO_BUFFER_MAX);
     }
     
     void receiveControl(int port, const AGControl &control) override
@@ -105,23 +110,50 @@ public:
         m_lastTime = t;
         pullInputPorts(t, nFrames);
         
-        float *gainv = inputPortVector(AUDIO_PARAM_GAIN);
-        float *freqv = inputPortVector(PARAM_FREQ);
-        float *width = inputPortVector(PARAM_WIDTH);
-        // if there are audio-rate phase inputs, then ignore m_phase value
-        float phase_ctl = numInputsForPort(PARAM_PHASE, AGRate::RATE_AUDIO) > 0 ? 0.0f : 1.0f;
-        float *phasev = inputPortVector(PARAM_PHASE);
+        float *outputv = m_outputBuffer[chanNum];
+        float *shiftedv = m_shiftedBuffer;
         
-        for(int i = 0; i < nFrames; i++)
+        float frequency = renderPhase(outputv, m_phase, PARAM_FREQ, PARAM_PHASE, nFrames);
+        int level = SPWavetable::level(frequency);
+        // widths past either end hold the output at 1 or -1
+        auto clampWidth = [] (float width) { return width < 0 ? 0.0f : (width > 1 ? 1.0f : width); };
+        
+        // difference of two band-limited saws, the second delayed by width:
+        // saw(phase)-saw(phase-width) is 2-2*width while phase < width and
+        // -2*width after, so offset by 2*width-1 to swing between 1 and -1
+        if(inputPortIsConstant(PARAM_WIDTH))
         {
-            m_outputBuffer[chanNum][i] = (m_phase < width[i] ? 1 : -1) * gainv[i];
-            output[i] += m_outputBuffer[chanNum][i];
-            
-            m_phase = clipunit(m_phase*phase_ctl + freqv[i]/sampleRate() + phasev[i]);
+            float width = clampWidth(inputPortValue(PARAM_WIDTH));
+            for(int i = 0; i < nFrames; i++)
+                shiftedv[i] = outputv[i]-width+1;
+            m_table->render(outputv, outputv, m_level, level, nFrames);
+            m_table->render(shiftedv, shiftedv, m_level, level, nFrames);
+            for(int i = 0; i < nFrames; i++)
+                outputv[i] = outputv[i]-shiftedv[i]+2*width-1;
+        }
+        else
+        {
+            float *widthv = inputPortVector(PARAM_WIDTH);
+            for(int i = 0; i < nFrames; i++)
+                shiftedv[i] = outputv[i]-clampWidth(widthv[i])+1;
+            m_table->render(outputv, outputv, m_level, level, nFrames);
+            m_table->render(shiftedv, shiftedv, m_level, level, nFrames);
+            for(int i = 0; i < nFrames; i++)
+                outputv[i] = outputv[i]-shiftedv[i]+2*clampWidth(widthv[i])-1;
         }
+        
+        m_level = level;
+        
+        scaleByInputPort(AUDIO_PARAM_GAIN, outputv, nFrames);
+        spv_add(output, outputv, nFrames);
     }
     
 private:
     float m_phase;
+    // band-limited level of the last block
+    int m_level;
+    const SPWavetable *m_table;
+    // phase of the second saw
+    Buffer<float> m_shiftedBuffer;
 };
 
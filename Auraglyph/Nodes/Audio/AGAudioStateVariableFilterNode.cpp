@@ -7,6 +7,7 @@
 //
 
 #include "AGAudioNode.h"
+#include "SPCachedCoefficient.h"
 
 
 //------------------------------------------------------------------------------
@@ -14,7 +15,7 @@
 //------------------------------------------------------------------------------
 #pragma mark - AGAudioStateVariableFilterNode
 
-class AGAudioStateVariableFilterNode : public AGAudioNode
+class AGAudioStateVariableFilterNode : public AGAudioNode, public AGAudioFilterBank::Filter
 {
 public:
     
@@ -108,49 +109,65 @@ public:
     
     void initFinal() override
     {
-        d1 = d2 = 0;
+        float coefficients[2] = { _cutoffCoeff(param(PARAM_CUTOFF)), 1.0f/(float) param(PARAM_Q) };
+        resetFilter(coefficients);
     }
     
     virtual void renderAudio(sampletime t, float *input, float *output, int nFrames, int chanNum, int nChans) override
     {
         if(t <= m_lastTime) { renderLast(output, nFrames, chanNum); return; }
+        
+        renderFilter(t, nFrames);
+        spv_add(output, m_outputBuffer[chanNum], nFrames);
+    }
+    
+    AGAudioFilterBank::Kind filterBankKind() const override { return AGAudioFilterBank::SVF; }
+    
+    int tailFrames() const override
+    {
+        // rings out from its current coefficients once the input falls silent
+        return nextInputPortValue(PARAM_INPUT) == 0 ? filterTailFrames(SILENCE) : TAIL_INFINITE;
+    }
+    
+    const float *beginFilter(sampletime t, int nFrames) override
+    {
         m_lastTime = t;
         pullInputPorts(t, nFrames);
         
-        float *inputv = inputPortVector(PARAM_INPUT);
-        float *gainv = inputPortVector(AUDIO_PARAM_GAIN);
-        float *cutoffv = inputPortVector(PARAM_CUTOFF);
-        float *qv = inputPortVector(PARAM_Q);
+        // coefficients only change within the block if cutoff/Q are
+        // audio-rate; then they're taken once per interval, and ramped
+        bool cutoffConstant = inputPortIsConstant(PARAM_CUTOFF);
+        bool qConstant = inputPortIsConstant(PARAM_Q);
+        float *cutoffv = cutoffConstant ? NULL : inputPortVector(PARAM_CUTOFF);
+        float *qv = qConstant ? NULL : inputPortVector(PARAM_Q);
+        float constCutoff = cutoffConstant ? inputPortValue(PARAM_CUTOFF) : 0;
+        float constQ = qConstant ? inputPortValue(PARAM_Q) : 0;
         
-        for(int i = 0; i < nFrames; i++)
+        for(int start = 0, interval = 0; start < nFrames; start += SPV_BANK_INTERVAL, interval++)
         {
-            
-            // TODO: only recompute coeffs if params have changed
-            float cutoff_coeff = 2 * sin(M_PI * cutoffv[i] / sampleRate());
-            float q_coeff = 1.0 / qv[i];
-            
-            float lpf = d2 + cutoff_coeff * d1;
-            float hpf = inputv[i] - lpf - q_coeff * d1;
-            float bpf = cutoff_coeff * hpf + d1;
-            float brf = hpf + lpf;
-            
-            if (isbad(lpf) || isbad(hpf) || isbad(bpf) || isbad(brf))
-                lpf = hpf = bpf = brf = 0;
-            
-            d1 = bpf;
-            d2 = lpf;
-            
-            m_outputBuffer[0][i] = lpf * gainv[i];
-            m_outputBuffer[1][i] = hpf * gainv[i];
-            m_outputBuffer[2][i] = bpf * gainv[i];
-            m_outputBuffer[3][i] = brf * gainv[i];
-            
-            output[i] += m_outputBuffer[chanNum][i];
+            int end = std::min(start+SPV_BANK_INTERVAL, nFrames);
+            float *targets = filterTargets(interval);
+            targets[0] = _cutoffCoeff(cutoffConstant ? constCutoff : cutoffv[end-1]);
+            targets[1] = 1.0f/(qConstant ? constQ : qv[end-1]);
         }
+        
+        return inputPortVector(PARAM_INPUT);
+    }
+    
+    float *filterOutput(int o) override { return m_outputBuffer[o]; }
+    
+    void endFilter(int nFrames) override
+    {
+        for(int j = 0; j < 4; j++)
+            scaleByInputPort(AUDIO_PARAM_GAIN, m_outputBuffer[j], nFrames);
     }
     
 private:
-    float d1;
-    float d2;
+    float _cutoffCoeff(float cutoff)
+    {
+        float sr = sampleRate();
+        return m_cutoffCoeff.get(cutoff, [sr](float cutoff) { return 2 * sin(M_PI * cutoff / sr); });
+    }
+    
+    SPCachedCoefficient m_cutoffCoeff;
 };
-
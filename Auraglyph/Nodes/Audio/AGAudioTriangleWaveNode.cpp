@@ -7,6 +7,7 @@
 //
 
 #include "AGAudioNode.h"
+#include "SPWavetable.h"
 
 //------------------------------------------------------------------------------
 // ### AGAudioTriangleWaveNode ###
@@ -79,6 +80,9 @@ public:
     void initFinal() override
     {
         m_phase = 0;
+        m_level = 0;
+        // build the shared table here rather than on the audio thread
+        m_table = &SPWavetable::triangle();
     }
     
     void receiveControl(int port, const AGControl &control) override
@@ -99,26 +103,22 @@ public:
         m_lastTime = t;
         pullInputPorts(t, nFrames);
         
-        float *gainv = inputPortVector(AUDIO_PARAM_GAIN);
-        float *freqv = inputPortVector(PARAM_FREQ);
-        // if there are audio-rate phase inputs, then ignore m_phase value
-        float phase_ctl = numInputsForPort(PARAM_PHASE, AGRate::RATE_AUDIO) > 0 ? 0.0f : 1.0f;
-        float *phasev = inputPortVector(PARAM_PHASE);
+        float *outputv = m_outputBuffer[chanNum];
         
-        for(int i = 0; i < nFrames; i++)
-        {
-            if(m_phase < 0.5)
-                m_outputBuffer[chanNum][i] = ((1-m_phase*2)*2-1) * gainv[i];
-            else
-                m_outputBuffer[chanNum][i] = ((m_phase-0.5)*4-1) * gainv[i];
-            output[i] += m_outputBuffer[chanNum][i];
-            
-            m_phase = clipunit(m_phase*phase_ctl + freqv[i]/sampleRate() + phasev[i]);
-        }
+        float frequency = renderPhase(outputv, m_phase, PARAM_FREQ, PARAM_PHASE, nFrames);
+        int level = SPWavetable::level(frequency);
+        m_table->render(outputv, outputv, m_level, level, nFrames);
+        m_level = level;
+        
+        scaleByInputPort(AUDIO_PARAM_GAIN, outputv, nFrames);
+        spv_add(output, outputv, nFrames);
     }
     
 private:
     float m_phase;
+    // band-limited level of the last block
+    int m_level;
+    const SPWavetable *m_table;
 };
 
 
@@ -13,13 +13,30 @@
 #include "AGAudioNode.h"
 #include "AGAudioCapturer.h"
 #include "AGAudioOutputDestination.h"
+#include "AGAudioRenderPlan.h"
+#include <atomic>
 #include <list>
+#include <memory>
+#include <vector>
 
 using namespace std;
 
+class AGControlVoiceNode;
+
 
 //------------------------------------------------------------------------------
 // ### AGAudioCompositeNode ###
+// A node containing a subprogram of other nodes, rendered through the Output
+// nodes inside it.
+//
+// With more than one voice, the subprogram is copied once per voice, and notes
+// arriving at the pitch and velocity inputs are handed out to the voices by a
+// voice allocator: a new note takes a voice that isn't sounding, or else steals
+// the oldest or quietest one (released voices first). A Voice node inside the
+// subprogram outputs each voice's note. Each voice renders on its own plan,
+// and only while sounding: once a released voice's output falls silent (e.g.
+// its ADSR has finished), it is skipped until its next note, so CPU follows
+// the number of notes playing rather than the number of voices.
 //------------------------------------------------------------------------------
 #pragma mark - AGAudioCompositeNode
 
@@ -28,10 +45,22 @@ class AGAudioCompositeNode : public AGAudioNode, public AGAudioOutputDestination
 {
 public:
     
+    static const int MAX_VOICES = 16;
+    
     enum Param
     {
         PARAM_INPUT = AUDIO_PARAM_LAST+1,
         PARAM_OUTPUT,
+        PARAM_PITCH,
+        PARAM_VELOCITY,
+        PARAM_VOICES,
+        PARAM_STEAL,
+    };
+    
+    enum Steal
+    {
+        STEAL_OLDEST,
+        STEAL_QUIETEST,
     };
     
     class Manifest : public AGStandardNodeManifest<AGAudioCompositeNode>
@@ -44,14 +73,20 @@ public:
         vector<AGPortInfo> _inputPortInfo() const override
         {
             return {
-                { PARAM_INPUT, "input", .doc = "Input signal." }
+                { PARAM_INPUT, "input", .doc = "Input signal." },
+                { PARAM_PITCH, "pitch", .doc = "Pitch of notes to play (e.g. from MIDI Note In)." },
+                { PARAM_VELOCITY, "velocity", .doc = "Velocity of notes to play; 0 releases the note at the last pitch." },
             };
         };
         
         vector<AGPortInfo> _editPortInfo() const override
         {
             return {
-                { AUDIO_PARAM_GAIN, "gain", 1, .doc = "Output gain." }
+                { AUDIO_PARAM_GAIN, "gain", 1, .doc = "Output gain." },
+                { PARAM_VOICES, "voices", 1, 1, MAX_VOICES, AGPortInfo::LIN, .type = AGControl::TYPE_INT,
+                    .doc = "Number of copies of the subprogram to play notes on." },
+                { PARAM_STEAL, "steal", STEAL_OLDEST, STEAL_OLDEST, STEAL_QUIETEST, AGPortInfo::LIN, .type = AGControl::TYPE_INT,
+                    .doc = "Voice a note takes when all are sounding: oldest (0) or quietest (1)." },
             };
         };
 
@@ -84,10 +119,20 @@ public:
     
     using AGAudioNode::AGAudioNode;
     
+    ~AGAudioCompositeNode();
+    
+    void initFinal() override;
+    
     virtual int numOutputPorts() const override;
+    
+    void editPortValueChanged(int paramId) override;
+    void receiveControl(int port, const AGControl &control) override;
         
     virtual void renderAudio(sampletime t, float *input, float *output, int nFrames, int chanNum, int nChans) override;
     
+    /* audio thread: voices rendered in the last block */
+    int numActiveVoices();
+    
 //    void addOutputNode(AGAudioNode *outputNode);
 //    void addInputNode(AGAudioCapturer *inputNode);
     
@@ -96,15 +141,77 @@ public:
     
     void addOutput(AGAudioRenderer *renderer) override;
     void removeOutput(AGAudioRenderer *renderer) override;
+    
+    void subgraphOutputs(vector<AGAudioRenderer *> &outputs) override;
 
 private:
     
+    // one copy of the subprogram
+    struct Voice
+    {
+        // copies of the subprogram's nodes and connections, owned by the
+        // voice (empty for the first voice, which plays the originals); not
+        // on the canvas, so privately connected
+        vector<AGNode *> nodes;
+        vector<AGConnection *> connections;
+        AGControlVoiceNode *voiceNode;
+        // renders the voice, when polyphonic
+        unique_ptr<AGAudioRenderPlan> plan;
+    };
+    
+    // built on the UI thread whenever the subprogram or voice count changes;
+    // a replaced pool is retired through the audio engine, and deleted (with
+    // its copies) once the audio thread has moved on
+    struct VoicePool
+    {
+        ~VoicePool();
+        
+        vector<Voice> voices;
+        // voices render on their own plans, rather than the graph's
+        bool polyphonic;
+        // distinguishes the pool from the one before, which the voice
+        // allocator may still be describing
+        uint64_t generation;
+    };
+    
+    /* UI thread: rebuild the voice pool */
+    void _updateVoices();
+    
+    /* audio thread: the current pool, with the voice allocator caught up to it */
+    VoicePool *_acquireVoicePool();
+    void _noteOn(VoicePool *pool, float pitch, float velocity);
+    void _noteOff(VoicePool *pool, float pitch);
+    int _stealVoice(int numVoices);
+    
+    /* render and fold to mono; returns the peak level */
+    float _renderVoice(sampletime t, const Voice &voice, int nFrames, float *output);
+    float _renderSubgraph(sampletime t, float *input, int nFrames, float *output);
+    
     Mutex m_outputsMutex;
     list<AGAudioRenderer *> m_outputs;
     Mutex m_inputsMutex;
     list<AGAudioCapturer *> m_inputNodes;
     
     list<AGNode *> m_subnodes;
+    
+    std::atomic<VoicePool *> m_voicePool{NULL};
+    // UI thread: whether the subprogram is left out of the graph's render plan
+    bool m_polyphonic;
+    uint64_t m_poolGeneration;
+    
+    // voice allocator (audio thread), indexed by voice of the pool whose
+    // generation is m_allocatorGeneration
+    uint64_t m_allocatorGeneration;
+    float m_voicePitch[MAX_VOICES];
+    bool m_voiceHeld[MAX_VOICES];
+    bool m_voiceSounding[MAX_VOICES];
+    uint64_t m_voiceStarted[MAX_VOICES];
+    float m_voiceLevel[MAX_VOICES];
+    uint64_t m_numNotes;
+    float m_pitch;
+    
+    // stereo, interleaved, from Output nodes
+    Buffer<float> m_subgraphBuffer;
 };
 
 
@@ -7,27 +7,355 @@
 //
 
 #include "AGCompositeNode.h"
+#include "AGAudioManager.h"
+#include "AGControlVoiceNode.h"
+#include "spvdsp.h"
+#include "sputil.h"
+
+#include <algorithm>
+#include <map>
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioCompositeNode::VoicePool ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioCompositeNode::VoicePool
+
+AGAudioCompositeNode::VoicePool::~VoicePool()
+{
+    // nothing renders the voices any more, but controls already on their way
+    // through the bus may still reach the copies, so they go a tick later
+    AGAudioManager_::instance().beginGraphEdit();
+    
+    for(Voice &voice : voices)
+    {
+        voice.plan.reset();
+        for(AGConnection *connection : voice.connections)
+        {
+            AGNode::disconnect(connection);
+            AGAudioManager_::instance().retire([connection]() { delete connection; });
+        }
+        for(AGNode *node : voice.nodes)
+            AGAudioManager_::instance().retire([node]() { delete node; });
+    }
+    
+    AGAudioManager_::instance().endGraphEdit();
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioCompositeNode ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioCompositeNode
+
+AGAudioCompositeNode::~AGAudioCompositeNode()
+{
+    delete m_voicePool.load();
+}
+
+void AGAudioCompositeNode::initFinal()
+{
+    m_polyphonic = false;
+    m_poolGeneration = 0;
+    m_allocatorGeneration = 0;
+    
+    for(int v = 0; v < MAX_VOICES; v++)
+    {
+        m_voicePitch[v] = 0;
+        m_voiceHeld[v] = false;
+        m_voiceSounding[v] = false;
+        m_voiceStarted[v] = 0;
+        m_voiceLevel[v] = 0;
+    }
+    m_numNotes = 0;
+    m_pitch = 0;
+    
+    m_subgraphBuffer.resize(AUDIO_BUFFER_MAX*2);
+    
+    _updateVoices();
+}
 
 void AGAudioCompositeNode::addOutput(AGAudioRenderer *output)
 {
-    auto scope = m_outputsMutex.inScope();
+    AGAudioManager_::instance().beginGraphEdit();
+    
+    m_outputsMutex.lock();
     m_outputs.push_back(output);
+    m_outputsMutex.unlock();
+    
+    // port buffers were allocated before there were any outputs (and so output
+    // ports); nothing renders the composite until now
+    if(m_outputBuffer.size() == 0)
+    {
+        m_outputBuffer.resize(1);
+        m_outputBuffer[0].resize(AUDIO_BUFFER_MAX);
+        m_outputBuffer[0].clear();
+    }
+    
+    _updateVoices();
+    AGAudioManager_::instance().graphDidChange();
+    AGAudioManager_::instance().endGraphEdit();
 }
 
 void AGAudioCompositeNode::removeOutput(AGAudioRenderer *output)
 {
-    auto scope = m_outputsMutex.inScope();
-    m_outputs.push_back(output);
+    AGAudioManager_::instance().beginGraphEdit();
+    
+    m_outputsMutex.lock();
+    m_outputs.remove(output);
+    m_outputsMutex.unlock();
+    
+    _updateVoices();
+    AGAudioManager_::instance().graphDidChange();
+    AGAudioManager_::instance().endGraphEdit();
+}
+
+void AGAudioCompositeNode::subgraphOutputs(vector<AGAudioRenderer *> &outputs)
+{
+    // voices render the subprogram themselves
+    if(m_polyphonic)
+        return;
+    
+    m_outputsMutex.lock();
+    outputs.insert(outputs.end(), m_outputs.begin(), m_outputs.end());
+    m_outputsMutex.unlock();
 }
 
 void AGAudioCompositeNode::addSubnode(AGNode *subnode)
 {
     m_subnodes.push_back(subnode);
+    _updateVoices();
 }
 
 void AGAudioCompositeNode::removeSubnode(AGNode *subnode)
 {
     m_subnodes.remove(subnode);
+    _updateVoices();
+}
+
+void AGAudioCompositeNode::editPortValueChanged(int paramId)
+{
+    if(paramId == PARAM_VOICES)
+        _updateVoices();
+}
+
+void AGAudioCompositeNode::_updateVoices()
+{
+    m_outputsMutex.lock();
+    list<AGAudioRenderer *> outputs = m_outputs;
+    m_outputsMutex.unlock();
+    
+    // the subprogram: subnodes, and outputs added without being subnodes
+    vector<AGNode *> subprogram(m_subnodes.begin(), m_subnodes.end());
+    for(AGAudioRenderer *output : outputs)
+    {
+        AGNode *outputNode = dynamic_cast<AGNode *>(output);
+        if(outputNode && std::find(subprogram.begin(), subprogram.end(), outputNode) == subprogram.end())
+            subprogram.push_back(outputNode);
+    }
+    
+    int numVoices = param(PARAM_VOICES).getInt();
+    if(numVoices > MAX_VOICES)
+        numVoices = MAX_VOICES;
+    if(numVoices < 1 || subprogram.size() == 0)
+        numVoices = 1;
+    
+    // the copies' wiring, the old pool and any change to the graph go out to
+    // the audio thread in one publish
+    AGAudioManager_::instance().beginGraphEdit();
+    
+    VoicePool *pool = new VoicePool;
+    pool->polyphonic = numVoices > 1;
+    pool->generation = ++m_poolGeneration;
+    pool->voices.resize(numVoices);
+    
+    for(int v = 0; v < numVoices; v++)
+    {
+        Voice &voice = pool->voices[v];
+        voice.voiceNode = NULL;
+        
+        // the first voice plays the subprogram itself
+        std::map<AGNode *, AGNode *> copies;
+        for(AGNode *node : subprogram)
+        {
+            if(v == 0)
+            {
+                copies[node] = node;
+            }
+            else
+            {
+                AGDocument::Node docNode = node->serialize();
+                docNode.uuid = makeUUID();
+                AGNode *copy = AGNodeManager::createNode(docNode);
+                voice.nodes.push_back(copy);
+                copies[node] = copy;
+            }
+        }
+        
+        if(v > 0)
+        {
+            for(AGNode *node : subprogram)
+            {
+                for(AGConnection *connection : node->outbound())
+                {
+                    auto dst = copies.find(connection->dst());
+                    if(dst != copies.end())
+                        voice.connections.push_back(AGConnection::connectPrivate(copies[node], connection->srcPort(),
+                                                                                 dst->second, connection->dstPort()));
+                }
+            }
+        }
+        
+        std::list<AGAudioRenderer *> voiceOutputs;
+        for(AGNode *node : subprogram)
+        {
+            if(voice.voiceNode == NULL)
+                voice.voiceNode = dynamic_cast<AGControlVoiceNode *>(copies[node]);
+            if(std::find(outputs.begin(), outputs.end(), dynamic_cast<AGAudioRenderer *>(node)) != outputs.end())
+                voiceOutputs.push_back(dynamic_cast<AGAudioRenderer *>(copies[node]));
+        }
+        
+        if(pool->polyphonic)
+            voice.plan.reset(AGAudioRenderPlan::compile(voiceOutputs));
+    }
+    
+    VoicePool *old = m_voicePool.exchange(pool, std::memory_order_acq_rel);
+    if(old != NULL)
+        AGAudioManager_::instance().retire([old]() { delete old; });
+    
+    if(pool->polyphonic != m_polyphonic)
+    {
+        m_polyphonic = pool->polyphonic;
+        AGAudioManager_::instance().graphDidChange();
+    }
+    
+    AGAudioManager_::instance().endGraphEdit();
+}
+
+void AGAudioCompositeNode::receiveControl(int port, const AGControl &control)
+{
+    int paramId = inputPortInfo(port).portId;
+    if(paramId == PARAM_PITCH)
+    {
+        m_pitch = control.getFloat();
+    }
+    else if(paramId == PARAM_VELOCITY)
+    {
+        VoicePool *pool = _acquireVoicePool();
+        if(pool == NULL)
+            return;
+        
+        float velocity = control.getFloat();
+        if(velocity > 0)
+            _noteOn(pool, m_pitch, velocity);
+        else
+            _noteOff(pool, m_pitch);
+    }
+}
+
+AGAudioCompositeNode::VoicePool *AGAudioCompositeNode::_acquireVoicePool()
+{
+    VoicePool *pool = m_voicePool.load(std::memory_order_acquire);
+    
+    if(pool != NULL && pool->generation != m_allocatorGeneration)
+    {
+        // voice 0 plays the original subprogram in every pool, so its note
+        // carries over; the other voices are fresh copies that have never
+        // had a note, whatever the old pool's copies were playing
+        for(int v = 1; v < MAX_VOICES; v++)
+        {
+            m_voicePitch[v] = 0;
+            m_voiceHeld[v] = false;
+            m_voiceSounding[v] = false;
+            m_voiceStarted[v] = 0;
+            m_voiceLevel[v] = 0;
+        }
+        m_allocatorGeneration = pool->generation;
+    }
+    
+    return pool;
+}
+
+void AGAudioCompositeNode::_noteOn(VoicePool *pool, float pitch, float velocity)
+{
+    int numVoices = (int) pool->voices.size();
+    int voice = -1;
+    
+    // a note played again restarts its voice
+    for(int v = 0; v < numVoices && voice < 0; v++)
+    {
+        if(m_voiceHeld[v] && m_voicePitch[v] == pitch)
+            voice = v;
+    }
+    for(int v = 0; v < numVoices && voice < 0; v++)
+    {
+        if(!m_voiceSounding[v])
+            voice = v;
+    }
+    if(voice < 0)
+        voice = _stealVoice(numVoices);
+    
+    m_voicePitch[voice] = pitch;
+    m_voiceHeld[voice] = true;
+    m_voiceSounding[voice] = true;
+    m_voiceStarted[voice] = m_numNotes++;
+    
+    if(pool->voices[voice].voiceNode)
+        pool->voices[voice].voiceNode->noteOn(pitch, velocity);
+}
+
+void AGAudioCompositeNode::_noteOff(VoicePool *pool, float pitch)
+{
+    int numVoices = (int) pool->voices.size();
+    for(int v = 0; v < numVoices; v++)
+    {
+        if(m_voiceHeld[v] && m_voicePitch[v] == pitch)
+        {
+            m_voiceHeld[v] = false;
+            if(pool->voices[v].voiceNode)
+                pool->voices[v].voiceNode->noteOff();
+        }
+    }
+}
+
+int AGAudioCompositeNode::_stealVoice(int numVoices)
+{
+    bool quietest = param(PARAM_STEAL).getInt() == STEAL_QUIETEST;
+    
+    // released voices first, then any
+    int voice = -1;
+    for(int pass = 0; pass < 2 && voice < 0; pass++)
+    {
+        for(int v = 0; v < numVoices; v++)
+        {
+            if(pass == 0 && m_voiceHeld[v])
+                continue;
+            if(voice < 0 ||
+               (quietest && m_voiceLevel[v] < m_voiceLevel[voice]) ||
+               (!quietest && m_voiceStarted[v] < m_voiceStarted[voice]))
+                voice = v;
+        }
+    }
+    
+    return voice;
+}
+
+int AGAudioCompositeNode::numActiveVoices()
+{
+    VoicePool *pool = m_voicePool.load(std::memory_order_acquire);
+    if(pool == NULL)
+        return 0;
+    if(!pool->polyphonic)
+        return (int) pool->voices.size();
+    
+    int numActive = 0;
+    for(int v = 0; v < (int) pool->voices.size(); v++)
+    {
+        if(m_voiceSounding[v] || pool->voices[v].voiceNode == NULL)
+            numActive++;
+    }
+    
+    return numActive;
 }
 
 int AGAudioCompositeNode::numOutputPorts() const
@@ -45,13 +373,28 @@ void AGAudioCompositeNode::renderAudio(sampletime t, float *input, float *output
     
     // feed input audio to input port(s)
     for(AGAudioCapturer *capturer : m_inputNodes)
-        capturer->captureAudio(m_inputPortBuffer[0], nFrames);
+        capturer->captureAudio(_inputPortVector(0), nFrames);
     
-    // render internal audio
+    VoicePool *pool = _acquireVoicePool();
+    if(pool != NULL && pool->polyphonic)
+    {
+        for(int v = 0; v < (int) pool->voices.size(); v++)
+        {
+            const Voice &voice = pool->voices[v];
+            // without a Voice node, notes can't reach the voice, so it always plays
+            if(voice.voiceNode != NULL && !m_voiceSounding[v])
+                continue;
+            
+            m_voiceLevel[v] = _renderVoice(t, voice, nFrames, m_outputBuffer[chanNum]);
+            // released and fallen silent, the voice has finished sounding
+            if(!m_voiceHeld[v] && m_voiceLevel[v] < SILENCE)
+                m_voiceSounding[v] = false;
+        }
+    }
+    else
     {
-        Mutex::Scope scope = m_outputsMutex.inScope();
-        for(AGAudioRenderer *outputNode : m_outputs)
-            outputNode->renderAudio(t, input, m_outputBuffer[chanNum], nFrames, 0, 1);
+        // render internal audio, as of the current render plan
+        _renderSubgraph(t, input, nFrames, m_outputBuffer[chanNum]);
     }
     
     float gain = param(AUDIO_PARAM_GAIN);
@@ -59,3 +402,29 @@ void AGAudioCompositeNode::renderAudio(sampletime t, float *input, float *output
     for(int i = 0; i < nFrames; i++)
         output[i] += m_outputBuffer[chanNum][i]*gain;
 }
+
+float AGAudioCompositeNode::_renderVoice(sampletime t, const Voice &voice, int nFrames, float *output)
+{
+    spv_fill(m_subgraphBuffer, 0, nFrames*2);
+    voice.plan->render(t, m_subgraphBuffer, nFrames, 2);
+    
+    for(int i = 0; i < nFrames; i++)
+        output[i] += m_subgraphBuffer[i*2] + m_subgraphBuffer[i*2+1];
+    
+    return spv_maxabs(m_subgraphBuffer, nFrames*2);
+}
+
+float AGAudioCompositeNode::_renderSubgraph(sampletime t, float *input, int nFrames, float *output)
+{
+    if(m_renderStep == NULL)
+        return 0;
+    
+    spv_fill(m_subgraphBuffer, 0, nFrames*2);
+    for(int i = 0; i < m_renderStep->numSubgraphOutputs; i++)
+        m_renderStep->subgraphOutputs[i]->renderAudio(t, input, m_subgraphBuffer, nFrames, 0, 2);
+    
+    for(int i = 0; i < nFrames; i++)
+        output[i] += m_subgraphBuffer[i*2] + m_subgraphBuffer[i*2+1];
+    
+    return spv_maxabs(m_subgraphBuffer, nFrames*2);
+}
@@ -29,8 +29,10 @@ void AGAudioCompressorNode::renderAudio(sampletime t, float *input, float *outpu
     float release = param(PARAM_RELEASE);
     float *inputv = inputPortVector(PARAM_INPUT);
     
+    // only recomputed when attack/release change
     m_detector.setTauAttack(attack, sampleRate());
     m_detector.setTauRelease(release, sampleRate());
+    float slope = 1.0f/ratio-1.0f;
     
     // if(m_controlPortBuffer[1]) gain += m_controlPortBuffer[1].getFloat();
 
@@ -38,22 +40,28 @@ void AGAudioCompressorNode::renderAudio(sampletime t, float *input, float *outpu
     {
         ///////////  PEAK DETECTOR  //////////////////////////
         float level_estimate;
-        m_detector.process(m_inputPortBuffer[0][i], level_estimate);
+        m_detector.process(inputv[i], level_estimate);
         
-        float log_level = lin2dB(level_estimate);
-        
-        // limiter setup
-        float dbgainval = std::min(0.0, lin2dB(linThreshold/level_estimate));
-        
-        if(log_level > dbThreshold)
-            dbgainval = (log_level-dbThreshold)*(1.0f/ratio-1.0f);
-        else
-            dbgainval = 0;
-        
-        // Compute linear gain for compressor
-        float gainval = dB2lin(dbgainval);
+        // level/gain conversions per sample, so approximate
+        // (same -100dB floor as lin2dB)
+        float gainval = 1;
+        if(level_estimate > linThreshold)
+        {
+            float log_level = fastlin2dB(level_estimate);
+            if(log_level > dbThreshold)
+                gainval = fastdB2lin((log_level-dbThreshold)*slope);
+        }
         m_outputBuffer[chanNum][i] = inputv[i]*gainval*gain;
         output[i] += m_outputBuffer[chanNum][i];
     }
 }
 
+int AGAudioCompressorNode::tailFrames() const
+{
+    if(nextInputPortValue(PARAM_INPUT) != 0)
+        return TAIL_INFINITE;
+    // silent in is silent out, but let the detector release fully, so the
+    // next note isn't compressed by the last
+    float release = std::max((float) param(PARAM_RELEASE), 0.0f);
+    return (int) ceilf(release*sampleRate()*logf(1/SILENCE));
+}
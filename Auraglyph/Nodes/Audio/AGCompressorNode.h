@@ -14,6 +14,7 @@
 #include "AGAudioNode.h"
 #include "AGAudioCapturer.h"
 #include "AGAudioOutputDestination.h"
+#include "SPCachedCoefficient.h"
 #include <list>
 
 using namespace std;
@@ -24,6 +25,8 @@ class PeakDetector {
 protected:
     float b0_r, a1_r, b0_a, a1_a, levelEstimate;
     float p, _1_p;
+    // keyed on tau*fs
+    SPCachedCoefficient a1_r_cache, a1_a_cache;
 
 public:
     PeakDetector() {
@@ -38,12 +41,12 @@ public:
     }
     
     void setTauRelease(float tauRelease, float fs) {
-        a1_r = exp( -1.0 / ( tauRelease * fs ) );
+        a1_r = a1_r_cache.get( tauRelease * fs, [](float tauFs) { return expf( -1.0f / tauFs ); } );
         b0_r = 1 - a1_r;
     }
     
     void setTauAttack(float tauAttack, float fs) {
-        a1_a = exp( -1.0 / ( tauAttack * fs ) );
+        a1_a = a1_a_cache.get( tauAttack * fs, [](float tauFs) { return expf( -1.0f / tauFs ); } );
         b0_a = 1 - a1_a;
     }
     
@@ -59,10 +62,12 @@ public:
     }
     
     void process (float input, float& output) {
+        // p is 2 unless set otherwise; skip pow() for it
+        float power = p == 2 ? input*input : pow(input, p);
         if ( fabs( input ) > levelEstimate )
-            levelEstimate += b0_a * ( pow(input, p) - levelEstimate );
+            levelEstimate += b0_a * ( power - levelEstimate );
         else
-            levelEstimate += b0_r * ( pow(input, p) - levelEstimate );
+            levelEstimate += b0_r * ( power - levelEstimate );
         output = levelEstimate;
     }
 };
@@ -142,6 +147,7 @@ public:
     void initFinal() override;
     
     virtual void renderAudio(sampletime t, float *input, float *output, int nFrames, int chanNum, int nChans) override;
+    int tailFrames() const override;
     
 private:
     PeakDetector m_detector;
@@ -7,10 +7,16 @@
 //
 
 #include "AGMatrixMixerNode.h"
+#ifndef AG_HEADLESS
 #include "AGUINodeEditor.h"
+#endif // AG_HEADLESS
 #include "AGSlider.h"
 
 #include "GeoGenerator.h"
+#include "spvdsp.h"
+
+// editors are touch UI, which headless builds leave out
+#ifndef AG_HEADLESS
 
 class AGMatrixMixerEditor : public AGUINodeEditor
 {
@@ -92,7 +98,7 @@ public:
         m_pinButton->init();
         m_pinButton->setInteractionType(AGUIButton::INTERACTION_LATCH);
         m_pinButton->setIconMode(AGUIIconButton::ICONMODE_SQUARE);
-        m_pinButton->setAction(^{
+        m_pinButton->setAction([this](){
             pin(m_pinButton->isPressed());
         });
         addChild(m_pinButton);
@@ -147,6 +153,8 @@ public:
     virtual GLvertex2f size() override { return GLvertex2f(m_width, m_height); }
 };
 
+#endif // AG_HEADLESS
+
 void AGAudioMatrixMixerNode::renderAudio(sampletime t, float *input, float *output, int nFrames, int chanNum, int nChans)
 {
     if(t <= m_lastTime) { renderLast(output, nFrames, chanNum); return; }
@@ -165,29 +173,45 @@ void AGAudioMatrixMixerNode::renderAudio(sampletime t, float *input, float *outp
     
     for(int i = 0; i < 4; i++) // For every output channel
     {
-        for(int k = 0; k < nFrames; k++) // Zero out buffer
+        // unconnected inputs only contribute a constant
+        float offset = 0;
+        for(int j = 0; j < 4; j++)
         {
-            m_outputBuffer[i][k] = 0;
+            if(m_inputPortState[j].constant)
+                offset += m_inputPortBase[j]*gains[i][j];
         }
         
+        spv_fill(m_outputBuffer[i], offset, nFrames);
+        
         for(int j = 0; j < 4; j++) // For every input
         {
-            for(int k = 0; k < nFrames; k++) // For every frame
-            {
-                m_outputBuffer[i][k] += m_inputPortBuffer[j][k] * gains[i][j];
-            }
+            if(!m_inputPortState[j].constant)
+                spv_mac(m_outputBuffer[i], m_inputPortBuffer[j], gains[i][j], nFrames);
         }
     }
-        
-    for(int i = 0; i < nFrames; i++) // Accumulate to our output buffer
+    
+    spv_add(output, m_outputBuffer[chanNum], nFrames); // Accumulate to our output buffer
+}
+
+int AGAudioMatrixMixerNode::tailFrames() const
+{
+    // no state; silent in, silent out, unless an input is offset
+    for(int j = 0; j < 4; j++)
     {
-        output[i] += m_outputBuffer[chanNum][i];
+        if(nextInputPortValue(PARAM_IN_1+j) != 0)
+            return TAIL_INFINITE;
     }
+    
+    return 0;
 }
 
 AGUINodeEditor *AGAudioMatrixMixerNode::createCustomEditor()
 {
+#ifndef AG_HEADLESS
     AGUINodeEditor *editor = new AGMatrixMixerEditor(this);
     editor->init();
     return editor;
+#else
+    return NULL;
+#endif // AG_HEADLESS
 }
@@ -149,6 +149,7 @@ public:
     using AGAudioNode::AGAudioNode;
     
     void renderAudio(sampletime t, float *input, float *output, int nFrames, int chanNum, int nChans) override;
+    int tailFrames() const override;
     
     AGUINodeEditor *createCustomEditor() override;
     
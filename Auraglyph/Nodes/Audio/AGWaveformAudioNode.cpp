@@ -7,12 +7,18 @@
 //
 
 #include "AGWaveformAudioNode.h"
+#ifndef AG_HEADLESS
 #include "AGUINodeEditor.h"
+#endif // AG_HEADLESS
 #include "AGGenericShader.h"
 #include "AGSlider.h"
 
 #include "GeoGenerator.h"
 #include "spdsp.h"
+#include "spvdsp.h"
+
+// editors are touch UI, which headless builds leave out
+#ifndef AG_HEADLESS
 
 class AGWaveformEditor : public AGUINodeEditor
 {
@@ -27,12 +33,14 @@ private:
     GLvertex2f m_waveformSize;
     
     unsigned long m_lastModifiedPos;
+    // waveform edited since the wavetable was last rebuilt
+    bool m_waveformChanged;
     
     AGUIButton *m_pinButton;
     
 public:
     AGWaveformEditor(AGAudioWaveformNode *node) :
-    m_node(node), m_doneEditing(false)
+    m_node(node), m_doneEditing(false), m_waveformChanged(false)
     {
         m_squeeze.open();
         m_width = 425;
@@ -156,6 +164,13 @@ public:
         m_squeeze.update(t, dt);
         m_renderState.modelview = m_squeeze.apply(m_renderState.modelview);
         
+        // rebuild at most once a frame, however many touches came in
+        if(m_waveformChanged)
+        {
+            m_node->_updateWavetable();
+            m_waveformChanged = false;
+        }
+        
         updateChildren(t, dt);
     }
     
@@ -227,6 +242,8 @@ public:
             
             int pos = (int) roundf(normX*(m_node->m_waveform.size()-1));
             m_node->m_waveform[pos] = normY;
+            m_node->markEdited();
+            m_waveformChanged = true;
             
             m_lastModifiedPos = pos;
         }
@@ -255,6 +272,8 @@ public:
 
             int pos = (int) roundf(normX*(m_node->m_waveform.size()-1));
             m_node->m_waveform[pos] = normY;
+            m_node->markEdited();
+            m_waveformChanged = true;
             
             // interpolate from last point
             if(pos != m_lastModifiedPos)
@@ -310,28 +329,30 @@ public:
     virtual GLvertex2f size() override { return GLvertex2f(m_width, m_height); }
 };
 
+#endif // AG_HEADLESS
+
 void AGAudioWaveformNode::initFinal()
 {
     m_phase = 0;
+    m_level = 0;
     
     m_waveform.resize(1024, 0);
-    for(int i = 0; i < m_waveform.size(); i++)
+    for(int i = 0; i < (int) m_waveform.size(); i++)
         m_waveform[i] = sinf(2*M_PI*((float)i)/m_waveform.size());
+    
+    _updateWavetable();
 }
 
 void AGAudioWaveformNode::deserializeFinal(const AGDocument::Node &docNode)
 {
     docNode.loadParam("waveform", m_waveform);
+    
+    _updateWavetable();
 }
 
-float AGAudioWaveformNode::get(float phase)
+void AGAudioWaveformNode::_updateWavetable()
 {
-    double pos = ((double)phase)*m_waveform.size();
-    int whole = (int)floor(pos);
-    double fract = fmod(pos, 1.0f);
-    
-    // linear interpolation
-    return m_waveform[whole]*(1-fract) + m_waveform[(whole+1)%m_waveform.size()]*(fract);
+    m_wavetable.publish(new SPWavetable(m_waveform.data(), (int) m_waveform.size()));
 }
 
 void AGAudioWaveformNode::receiveControl(int port, const AGControl &control)
@@ -339,7 +360,7 @@ void AGAudioWaveformNode::receiveControl(int port, const AGControl &control)
     if(port == m_param2InputPort[PARAM_PHASE])
     {
         // hard-sync phase to control input
-        m_phase = control.getFloat();
+        m_phase = clipunit(control.getFloat());
         // clear control
         // prevents upsampling to renderAudio phase vector
         clearControl(PARAM_PHASE);
@@ -352,19 +373,16 @@ void AGAudioWaveformNode::renderAudio(sampletime t, float *input, float *output,
     m_lastTime = t;
     pullInputPorts(t, nFrames);
     
-    float *gainv = inputPortVector(AUDIO_PARAM_GAIN);
-    float *freqv = inputPortVector(PARAM_FREQ);
-    // if there are audio-rate phase inputs, then ignore m_phase value
-    float phase_ctl = numInputsForPort(PARAM_PHASE, AGRate::RATE_AUDIO) > 0 ? 0.0f : 1.0f;
-    float *phasev = inputPortVector(PARAM_PHASE);
+    float *outputv = m_outputBuffer[chanNum];
+    SPWavetable *wavetable = m_wavetable.acquire();
     
-    for(int i = 0; i < nFrames; i++)
-    {
-        m_outputBuffer[chanNum][i] = get(m_phase) * gainv[i];
-        output[i] += m_outputBuffer[chanNum][i];
-        
-        m_phase = clipunit(m_phase*phase_ctl + freqv[i]/sampleRate() + phasev[i]);
-    }
+    float frequency = renderPhase(outputv, m_phase, PARAM_FREQ, PARAM_PHASE, nFrames);
+    int level = SPWavetable::level(frequency);
+    wavetable->render(outputv, outputv, m_level, level, nFrames);
+    m_level = level;
+    
+    scaleByInputPort(AUDIO_PARAM_GAIN, outputv, nFrames);
+    spv_add(output, outputv, nFrames);
 }
 
 void AGAudioWaveformNode::_renderIcon()
@@ -378,21 +396,26 @@ void AGAudioWaveformNode::_renderIcon()
     float w = radius*1.3, h = w*0.3, t = h*0.75, rot = -M_PI*0.8f;
     GLvertex2f offset(-w/2,0);
     
-    drawLineStrip((GLvertex2f[]) {
+    GLvertex2f outline[] = {
         rotateZ(offset+GLvertex2f( w/2,      0), rot),
         rotateZ(offset+GLvertex2f( w/2-t,  h/2), rot),
         rotateZ(offset+GLvertex2f(-w/2,    h/2), rot),
         rotateZ(offset+GLvertex2f(-w/2,   -h/2), rot),
         rotateZ(offset+GLvertex2f( w/2-t, -h/2), rot),
         rotateZ(offset+GLvertex2f( w/2,      0), rot),
-    }, 6);
+    };
+    drawLineStrip(outline, 6);
 }
 
 AGUINodeEditor *AGAudioWaveformNode::createCustomEditor()
 {
+#ifndef AG_HEADLESS
     AGUINodeEditor *editor = new AGWaveformEditor(this);
     editor->init();
     return editor;
+#else
+    return NULL;
+#endif // AG_HEADLESS
 }
 
 AGDocument::Node AGAudioWaveformNode::serialize()
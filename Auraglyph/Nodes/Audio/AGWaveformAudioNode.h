@@ -10,6 +10,8 @@
 #define AGWaveformAudioNode_h
 
 #include "AGAudioNode.h"
+#include "SPWavetable.h"
+#include "AtomicSnapshot.h"
 
 class AGWaveformEditor;
 
@@ -102,7 +104,13 @@ private:
     vector<float> m_waveform;
     float m_phase;
     
-    float get(float phase);
+    // m_waveform, band-limited; rebuilt whenever it is edited
+    AtomicSnapshot<SPWavetable> m_wavetable;
+    // band-limited level of the last block
+    int m_level;
+    
+    /* publish a new wavetable from m_waveform (off the audio thread) */
+    void _updateWavetable();
 };
 
 
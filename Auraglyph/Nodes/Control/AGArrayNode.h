@@ -11,7 +11,9 @@
 
 #include "AGControlNode.h"
 #include "AGControl.h"
+#include "AtomicSnapshot.h"
 #include <list>
+#include <vector>
 
 class AGUIArrayEditor;
 
@@ -56,8 +58,15 @@ private:
     
     sampletime m_lastTime;
     
+    // edited on the UI thread only
     list<float> m_items;
-    list<float>::iterator m_position;
+    
+    // what the audio thread iterates, republished after each edit
+    AtomicSnapshot<std::vector<float>> m_itemsSnapshot;
+    // audio thread only
+    int m_position;
+    
+    void _publishItems();
 };
 
 
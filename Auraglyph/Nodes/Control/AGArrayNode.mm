@@ -9,9 +9,11 @@
 #include "AGArrayNode.h"
 #include "AGUserInterface.h"
 #include "AGStyle.h"
-#include "AGHandwritingRecognizer.h"
 #include "AGGenericShader.h"
+#ifndef AG_HEADLESS
+#include "AGHandwritingRecognizer.h"
 #include "AGUINodeEditor.h"
+#endif // AG_HEADLESS
 #include "AGInteractiveObject.h"
 
 #include "GeoGenerator.h"
@@ -19,6 +21,9 @@
 #include <sstream>
 
 
+// editors are touch UI, which headless builds leave out
+#ifndef AG_HEADLESS
+
 //------------------------------------------------------------------------------
 // ### AGUINumberInput ###
 //------------------------------------------------------------------------------
@@ -474,6 +479,8 @@ public:
                 m_ghostElement->setEditAction(m_editAction);
                 addChild(m_ghostElement);
             }
+            
+            m_node->_publishItems();
         };
         
         int j = 0;
@@ -590,6 +597,8 @@ private:
 //    int hitTest(const GLvertex3f &t, bool *inBbox);
 };
 
+#endif // AG_HEADLESS
+
 
 //------------------------------------------------------------------------------
 // ### AGControlArrayNode ###
@@ -645,14 +654,24 @@ GLuint AGControlArrayNode::Manifest::_iconGeoType() const { return GL_LINES; };
 void AGControlArrayNode::initFinal()
 {
     m_lastTime = 0;
-    m_position = m_items.begin();
+    m_position = 0;
+    _publishItems();
+}
+
+void AGControlArrayNode::_publishItems()
+{
+    m_itemsSnapshot.publish(new std::vector<float>(m_items.begin(), m_items.end()));
 }
 
 AGUINodeEditor *AGControlArrayNode::createCustomEditor()
 {
+#ifndef AG_HEADLESS
     AGUIArrayEditor *editor = new AGUIArrayEditor(this);
     editor->init();
     return editor;
+#else
+    return NULL;
+#endif // AG_HEADLESS
 }
 
 void AGControlArrayNode::receiveControl(int port, const AGControl &control)
@@ -660,15 +679,19 @@ void AGControlArrayNode::receiveControl(int port, const AGControl &control)
     switch(port)
     {
         case 0: // iterate
-            if(m_items.size())
+        {
+            const std::vector<float> &items = *m_itemsSnapshot.acquire();
+            if(items.size())
             {
-                pushControl(0, AGControl(*m_position));
+                // (the array may have shrunk since the last item)
+                if(m_position >= (int) items.size()) m_position = 0;
+                pushControl(0, AGControl(items[m_position]));
                 
                 m_position++;
-                if(m_position == m_items.end()) m_position = m_items.begin();
-                
+                if(m_position == (int) items.size()) m_position = 0;
             }
             break;
+        }
     }
 }
 
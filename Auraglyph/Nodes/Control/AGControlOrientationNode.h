@@ -83,6 +83,10 @@ public:
 private:
     CMMotionManager *m_manager;
     AGTimer m_timer;
+    // attitude as of the last timer tick
+    std::atomic<float> m_roll{0};
+    std::atomic<float> m_pitch{0};
+    std::atomic<float> m_yaw{0};
     
     void _pushData();
 };
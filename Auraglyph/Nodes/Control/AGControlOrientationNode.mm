@@ -63,6 +63,12 @@ void AGControlOrientationNode::initFinal()
     
     m_timer.setInterval(1.0f/param(PARAM_RATE).getFloat());
     m_timer.setAction([this](AGTimer *timer){
+        // CoreMotion is read here, on the UI thread; a read control (which
+        // arrives on the audio thread) gets the latest of these
+        m_roll.store((float) m_manager.deviceMotion.attitude.roll, std::memory_order_relaxed);
+        m_pitch.store((float) m_manager.deviceMotion.attitude.pitch, std::memory_order_relaxed);
+        m_yaw.store((float) m_manager.deviceMotion.attitude.yaw, std::memory_order_relaxed);
+        
         if(inbound().size() == 0)
             _pushData();
     });
@@ -91,9 +97,9 @@ void AGControlOrientationNode::receiveControl(int port, const AGControl &control
 
 void AGControlOrientationNode::_pushData()
 {
-    AGControl roll = AGControl((float) m_manager.deviceMotion.attitude.roll);
-    AGControl pitch = AGControl((float) m_manager.deviceMotion.attitude.pitch);
-    AGControl yaw = AGControl((float) m_manager.deviceMotion.attitude.yaw);
+    AGControl roll = AGControl(m_roll.load(std::memory_order_relaxed));
+    AGControl pitch = AGControl(m_pitch.load(std::memory_order_relaxed));
+    AGControl yaw = AGControl(m_yaw.load(std::memory_order_relaxed));
     
     pushControl(0, roll);
     pushControl(1, pitch);
@@ -7,10 +7,11 @@
 //
 
 #include "AGControlSequencerNode.h"
+#ifndef AG_HEADLESS
 #include "AGUINodeEditor.h"
+#endif // AG_HEADLESS
 #include "AGStyle.h"
 #include "GeoGenerator.h"
-#include "AGTimer.h"
 #include "AGGenericShader.h"
 #include "AGStyle.h"
 #include "AGSlider.h"
@@ -19,6 +20,9 @@
 
 #include <string>
 
+// editors are touch UI, which headless builds leave out
+#ifndef AG_HEADLESS
+
 //------------------------------------------------------------------------------
 // ### AGUISequencerEditor ###
 //------------------------------------------------------------------------------
@@ -509,6 +513,8 @@ private:
     AGUIButton *m_pinButton;
 };
 
+#endif // AG_HEADLESS
+
 
 //------------------------------------------------------------------------------
 // ### AGControlSequencerNode ###
@@ -575,13 +581,11 @@ void AGControlSequencerNode::initFinal()
     for(auto i = m_sequence.begin(); i != m_sequence.end(); i++)
         for(auto j = i->begin(); j != i->end(); j++)
             *j = Step(Random::unit(), 0.5);
+    _publishPattern();
+    outputPortsChanged();
     
-    // apparently Block_copy is necessary since ARC doesn't work in C++(?)
-//    m_timer = AGTimer(60.0f/param(PARAM_BPM).getFloat(), Block_copy(^(AGTimer *) {
-//        if(numInputsForPort(PARAM_ADVANCE) == 0)
-//            updateStep();
-//    }));
-    AGAudioManager_::instance().addAudioRateProcessor(this);
+    // steps are timed by the audio engine's scheduler
+    AGAudioManager_::instance().addEventHandler(this);
 }
 
 void AGControlSequencerNode::deserializeFinal(const AGDocument::Node &docNode)
@@ -621,63 +625,98 @@ void AGControlSequencerNode::deserializeFinal(const AGDocument::Node &docNode)
     {
         m_sequence.push_back(std::vector<Step>(m_numSteps));
     }
+    
+    _publishPattern();
+    outputPortsChanged();
 }
 
 AGControlSequencerNode::~AGControlSequencerNode()
 {
-    AGAudioManager_::instance().removeAudioRateProcessor(this);
+    AGAudioManager_::instance().removeEventHandler(this);
 }
 
 AGUINodeEditor *AGControlSequencerNode::createCustomEditor()
 {
+#ifndef AG_HEADLESS
     return new AGUISequencerEditor(this);
+#else
+    return NULL;
+#endif // AG_HEADLESS
 }
 
 int AGControlSequencerNode::numOutputPorts() const
 {
-    return (int) m_sequence.size();
+    // asked from the audio thread too
+    return m_numSequences.load(std::memory_order_acquire);
+}
+
+void AGControlSequencerNode::_publishPattern()
+{
+    Pattern *pattern = new Pattern;
+    pattern->numSequences = (int) m_sequence.size();
+    pattern->numSteps = m_numSteps;
+    pattern->steps.reserve(pattern->numSequences*pattern->numSteps);
+    for(auto &sequence : m_sequence)
+        pattern->steps.insert(pattern->steps.end(), sequence.begin(), sequence.end());
+    
+    m_pattern.publish(pattern);
+    m_numSequences.store(pattern->numSequences, std::memory_order_release);
 }
 
-void AGControlSequencerNode::process(sampletime _t)
+void AGControlSequencerNode::scheduleEvents(AGAudioEventScheduler &scheduler, sampletime t)
 {
-    float t = ((float)_t)/AGAudioNode::sampleRate();
+    // initial condition
+    if(m_stepStart < 0)
+        m_stepStart = t;
     
-    if(m_t == -1)
+    _postStep(scheduler, t);
+}
+
+void AGControlSequencerNode::handleEvent(AGAudioEventScheduler &scheduler, sampletime t, int tag)
+{
+    if(tag == EVENT_STEP)
     {
-        m_t = t;
-        m_lastStep = t;
+        // keep to the beat unless the step had to be moved (by a change of bpm)
+        m_stepStart = (ceil(m_nextStep) == t ? m_nextStep : t);
         
-        return;
+        // don't automatically advance if there is an advance input
+        if(numInputsForPort(PARAM_ADVANCE) == 0)
+            updateStep();
+        
+        _postStep(scheduler, t+1);
+    }
+    else
+    {
+        Pattern *pattern = m_pattern.acquire();
+        if(tag < pattern->numSequences)
+            pushControl(tag, 0);
     }
+}
+
+void AGControlSequencerNode::_postStep(AGAudioEventScheduler &scheduler, sampletime t)
+{
+    float bpm = param(PARAM_BPM);
+    if(bpm <= 0)
+        return;
+    
+    // at least a sample long
+    double stepLength = std::max(1.0, 60.0/bpm*AGAudioNode::sampleRate());
+    m_nextStep = m_stepStart + stepLength;
+    scheduler.post(std::max((sampletime) ceil(m_nextStep), t), this, EVENT_STEP);
     
-    // don't automatically advance if there is an advance input
     if(numInputsForPort(PARAM_ADVANCE))
         return;
     
-    float bpm = param(PARAM_BPM);
-    float stepLength = 60.0/bpm;
-    float stepTime = t-m_lastStep;
-    if(stepTime >= stepLength)
-    {
-        updateStep();
-        m_lastStep = t;
-    }
-    else
+    Pattern *pattern = m_pattern.acquire();
+    int pos = m_pos;
+    
+    // each sequence's value drops to 0 once its step length is up
+    for(int seq = 0; seq < pattern->numSequences && pos < pattern->numSteps; seq++)
     {
-        m_seqLock.lock();
-        
-        for(int seq = 0; seq < m_sequence.size(); seq++)
-        {
-            if(stepTime > m_sequence[seq][m_pos].length*stepLength)
-            {
-                pushControl(seq, 0);
-            }
-        }
-        
-        m_seqLock.unlock();
+        double end = m_stepStart + pattern->step(seq, pos).length*stepLength;
+        if(end < m_nextStep && ceil(end) >= t)
+            scheduler.post((sampletime) ceil(end), this, seq);
     }
-    
-    m_t = t;
 }
 
 void AGControlSequencerNode::receiveControl(int port, const AGControl &control)
@@ -700,17 +739,19 @@ int AGControlSequencerNode::numSequences()
 
 void AGControlSequencerNode::setNumSequences(int num)
 {
-    m_seqLock.lock();
-    
     if(num < 1)
         num = 1;
     
-    if(num < m_sequence.size())
+    if(num < (int) m_sequence.size())
         m_sequence.resize(num);
-    else if(num > m_sequence.size())
+    else if(num > (int) m_sequence.size())
         m_sequence.resize(num, std::vector<Step>(m_numSteps));
     
-    m_seqLock.unlock();
+    _publishPattern();
+    
+    markEdited();
+    outputPortsChanged();
+    reschedule();
 }
 
 int AGControlSequencerNode::numSteps()
@@ -720,19 +761,18 @@ int AGControlSequencerNode::numSteps()
 
 void AGControlSequencerNode::setNumSteps(int num)
 {
-    m_seqLock.lock();
-    
     if(num < 4)
         num = 4;
     
     if(m_numSteps != num)
     {
-        for(int i = 0; i < m_sequence.size(); i++)
+        for(int i = 0; i < (int) m_sequence.size(); i++)
             m_sequence[i].resize(num);
         m_numSteps = num;
+        _publishPattern();
     }
     
-    m_seqLock.unlock();
+    markEdited();
 }
 
 
@@ -744,37 +784,35 @@ float AGControlSequencerNode::bpm()
 void AGControlSequencerNode::setBpm(float bpm)
 {
     setParam(PARAM_BPM, validateParam(PARAM_BPM, bpm));
-    m_timer.setInterval(60.0/param(PARAM_BPM).getFloat());
 }
 
 void AGControlSequencerNode::updateStep()
 {
-    m_seqLock.lock();
-    
-    m_pos = (m_pos + 1) % m_numSteps;
+    Pattern *pattern = m_pattern.acquire();
     
-    for(int seq = 0; seq < m_sequence.size(); seq++)
-        pushControl(seq, AGControl(m_sequence[seq][m_pos].value));
+    // (the pattern may have shrunk since the last step)
+    int pos = (m_pos + 1) % pattern->numSteps;
+    m_pos = pos;
     
-    m_seqLock.unlock();
+    for(int seq = 0; seq < pattern->numSequences; seq++)
+        pushControl(seq, AGControl(pattern->step(seq, pos).value));
 }
 
 void AGControlSequencerNode::setStepValue(int seq, int step, float value)
 {
-    m_seqLock.lock();
-    
     m_sequence[seq][step].value = value;
+    _publishPattern();
     
-    m_seqLock.unlock();
+    markEdited();
 }
 
 void AGControlSequencerNode::setStepLength(int seq, int step, float length)
 {
-    m_seqLock.lock();
-    
     m_sequence[seq][step].length = length;
+    _publishPattern();
     
-    m_seqLock.unlock();
+    markEdited();
+    reschedule();
 }
 
 float AGControlSequencerNode::getStepValue(int seq, int step)
@@ -790,7 +828,7 @@ float AGControlSequencerNode::getStepLength(int seq, int step)
 void AGControlSequencerNode::editPortValueChanged(int paramId)
 {
     if(paramId == PARAM_BPM)
-        m_timer.setInterval(60.0/param(PARAM_BPM).getFloat());
+        reschedule();
 }
 
 AGDocument::Node AGControlSequencerNode::serialize()
@@ -9,13 +9,15 @@
 #pragma once
 
 #include "AGControlNode.h"
-#include "AGTimer.h"
+#include "AGAudioEventScheduler.h"
 #include "AGAudioManager.h"
+#include "AtomicSnapshot.h"
 
+#include <atomic>
 #include <list>
 #include <vector>
 
-class AGControlSequencerNode : public AGControlNode, public AGAudioRateProcessor
+class AGControlSequencerNode : public AGControlNode, public AGAudioEventHandler
 {
 public:
     
@@ -63,7 +65,9 @@ public:
     float getStepLength(int seq, int step);
     
     void receiveControl(int port, const AGControl &control) override;
-    void process(sampletime t) override;
+    
+    void scheduleEvents(AGAudioEventScheduler &scheduler, sampletime t) override;
+    void handleEvent(AGAudioEventScheduler &scheduler, sampletime t, int tag) override;
     
     float bpm();
     void setBpm(float bpm);
@@ -73,13 +77,17 @@ public:
 private:
     static AGNodeInfo *s_nodeInfo;
     
-    AGTimer m_timer;
+    // event tags other than this are the sequence whose step ends
+    enum { EVENT_STEP = -1 };
     
-    int m_pos;
+    std::atomic<int> m_pos{0};
     int m_numSteps;
     
-    float m_t = -1;
-    float m_lastStep = -1;
+    // start of the current step and of the next, in fractional samples so
+    // that rounding each step to a whole sample doesn't accumulate; -1 until
+    // the sequencer has started
+    double m_stepStart = -1;
+    double m_nextStep = -1;
     
     struct Step
     {
@@ -89,9 +97,26 @@ private:
         float length = 0.5; // [0,1]
     };
     
-    Mutex m_seqLock;
+    // edited on the UI thread only
     std::vector<std::vector<Step>> m_sequence;
+    std::atomic<int> m_numSequences{0};
+    
+    // what the audio thread steps through, republished after each edit
+    struct Pattern
+    {
+        int numSequences;
+        int numSteps;
+        std::vector<Step> steps; // by sequence, then step
+        
+        const Step &step(int seq, int pos) const { return steps[seq*numSteps+pos]; }
+    };
+    
+    AtomicSnapshot<Pattern> m_pattern;
+    
+    void _publishPattern();
     
     void updateStep();
+    /* post the next step, and the ends of the current one not before t */
+    void _postStep(AGAudioEventScheduler &scheduler, sampletime t);
 };
 
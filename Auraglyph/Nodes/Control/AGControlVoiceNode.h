@@ -0,0 +1,92 @@
+//
+//  AGControlVoiceNode.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include "AGControlNode.h"
+#include "AGStyle.h"
+
+//------------------------------------------------------------------------------
+// ### AGControlVoiceNode ###
+// The note played by one voice of a polyphonic composite. Placed inside a
+// composite's subprogram, each voice's copy of it outputs the pitch and
+// velocity of the notes the composite's voice allocator hands that voice (and
+// velocity 0 when the note is released), as MIDI Note In does for the notes
+// it receives. Outside of a composite it outputs nothing.
+//------------------------------------------------------------------------------
+#pragma mark - AGControlVoiceNode
+
+class AGControlVoiceNode : public AGControlNode
+{
+public:
+
+    enum Param
+    {
+        PARAM_PITCH,
+        PARAM_VELOCITY,
+    };
+
+    class Manifest : public AGStandardNodeManifest<AGControlVoiceNode>
+    {
+    public:
+        string _type() const override { return "Voice"; };
+        string _name() const override { return "Voice"; };
+        string _description() const override { return "Note of one voice of a polyphonic composite."; };
+
+        vector<AGPortInfo> _inputPortInfo() const override { return { }; };
+
+        vector<AGPortInfo> _editPortInfo() const override { return { }; };
+
+        vector<AGPortInfo> _outputPortInfo() const override
+        {
+            return {
+                { PARAM_PITCH, "pitch", .doc = "Pitch of the voice's note." },
+                { PARAM_VELOCITY, "velocity", .doc = "Velocity of the voice's note (0 when released)." },
+            };
+        };
+
+        vector<GLvertex3f> _iconGeo() const override
+        {
+            float radius = 0.005*AGStyle::oldGlobalScale;
+            float head = radius*0.4f;
+            int NUM_PTS = 16;
+
+            // note head and stem
+            vector<GLvertex3f> iconGeo;
+            GLvertex3f center(-radius*0.3f, -radius*0.6f, 0);
+            for(int i = 0; i < NUM_PTS; i++)
+            {
+                float theta0 = 2*M_PI*i/NUM_PTS, theta1 = 2*M_PI*(i+1)/NUM_PTS;
+                iconGeo.push_back(center + GLvertex3f(head*cosf(theta0), head*sinf(theta0), 0));
+                iconGeo.push_back(center + GLvertex3f(head*cosf(theta1), head*sinf(theta1), 0));
+            }
+            iconGeo.push_back(center + GLvertex3f(head, 0, 0));
+            iconGeo.push_back(center + GLvertex3f(head, radius*1.6f, 0));
+
+            return iconGeo;
+        };
+
+        GLuint _iconGeoType() const override { return GL_LINES; };
+    };
+
+    using AGControlNode::AGControlNode;
+
+    virtual int numOutputPorts() const override { return 2; }
+
+    /* from the composite, when receiving control */
+    void noteOn(float pitch, float velocity)
+    {
+        pushControl(0, AGControl(pitch));
+        pushControl(1, AGControl(velocity));
+    }
+
+    void noteOff()
+    {
+        pushControl(1, AGControl(0.0f));
+    }
+};
@@ -147,7 +147,7 @@ AGDashboard::AGDashboard(AGViewController_ *viewController)
                                     GLvertex2f(recordButtonWidth, recordButtonHeight));
     m_recordButton->init();
     m_recordButton->setRenderFixed(true);
-    m_recordButton->setAction(^{
+    m_recordButton->setAction([this](){
         // AGAnalytics::instance().eventTrainer();
         // TODO: analytics
         // flip toggle
@@ -188,7 +188,7 @@ AGDashboard::AGDashboard(AGViewController_ *viewController)
     m_freedrawButton->init();
     m_freedrawButton->setInteractionType(AGUIButton::INTERACTION_LATCH);
     m_freedrawButton->setIconMode(AGUIIconButton::ICONMODE_CIRCLE);
-    modeButtonGroup->addButton(m_freedrawButton, ^{
+    modeButtonGroup->addButton(m_freedrawButton, [this](){
         //NSLog(@"freedraw");
         AGAnalytics::instance().eventFreedrawMode();
         m_viewController->setDrawMode(DRAWMODE_FREEDRAW);
@@ -222,7 +222,7 @@ AGDashboard::AGDashboard(AGViewController_ *viewController)
     m_freedrawEraseButton->init();
     m_freedrawEraseButton->setInteractionType(AGUIButton::INTERACTION_LATCH);
     m_freedrawEraseButton->setIconMode(AGUIIconButton::ICONMODE_CIRCLE);
-    modeButtonGroup->addButton(m_freedrawEraseButton, ^{
+    modeButtonGroup->addButton(m_freedrawEraseButton, [this](){
         //NSLog(@"freedraw_erase");
         //AGAnalytics::instance().eventFreedrawMode(); // XXX needed?
         m_viewController->setDrawMode(DRAWMODE_FREEDRAW_ERASE);
@@ -242,7 +242,7 @@ AGDashboard::AGDashboard(AGViewController_ *viewController)
     m_nodeButton->init();
     m_nodeButton->setInteractionType(AGUIButton::INTERACTION_LATCH);
     m_nodeButton->setIconMode(AGUIIconButton::ICONMODE_CIRCLE);
-    modeButtonGroup->addButton(m_nodeButton, ^{
+    modeButtonGroup->addButton(m_nodeButton, [this](){
         //NSLog(@"node");
         AGAnalytics::instance().eventNodeMode();
         m_viewController->setDrawMode(DRAWMODE_NODE);
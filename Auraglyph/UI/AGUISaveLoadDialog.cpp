@@ -52,7 +52,7 @@ public:
         m_saveButton->init();
         m_saveButton->setRenderFixed(false);
         
-        m_saveButton->setAction(^{
+        m_saveButton->setAction([this](){
             AGDocumentManager &manager = AGDocumentManager::instance();
             
             m_doc.setName(m_name);
@@ -73,7 +73,7 @@ public:
         m_cancelButton->init();
         m_cancelButton->setRenderFixed(false);
 
-        m_cancelButton->setAction(^{
+        m_cancelButton->setAction([this](){
             removeFromTopLevel();
         });
         addChild(m_cancelButton);
@@ -198,13 +198,13 @@ private:
     GLvertex3f m_lastTouch;
     int m_selection;
     
-    const std::vector<AGDocumentManager::DocumentListing> &m_documentList;
+    AGDocumentIndex &m_library;
     
     std::function<void (const std::string &file, AGDocument &doc)> m_onLoad;
     
 public:
     AGUIConcreteLoadDialog(const GLvertex3f &pos) :
-    m_documentList(AGDocumentManager::instance().list())
+    m_library(AGDocumentManager::instance().library())
     {
         setPosition(pos);
         
@@ -215,7 +215,7 @@ public:
         m_itemStart = m_size.y/3.0f;
         m_itemHeight = m_size.y/3.0f;
         
-        m_verticalScrollPos.raw().clampTo(0, max(0.0f, (m_documentList.size()-3.0f)*m_itemHeight));
+        m_verticalScrollPos.raw().clampTo(0, max(0.0f, (m_library.count()-3.0f)*m_itemHeight));
         
         float buttonWidth = 100;
         float buttonHeight = 25;
@@ -227,7 +227,7 @@ public:
                                         GLvertex2f(buttonWidth, buttonHeight));
         m_cancelButton->init();
         m_cancelButton->setRenderFixed(false);
-        m_cancelButton->setAction(^{
+        m_cancelButton->setAction([this](){
             removeFromTopLevel();
         });
         addChild(m_cancelButton);
@@ -274,9 +274,12 @@ public:
         }, 4);
         
         GLcolor4f whiteA = AGStyle::foregroundColor().withAlpha(0.75);
-        float yPos = m_itemStart + m_verticalScrollPos;
-        int i = 0;
-        int len = (int) m_documentList.size();
+        int len = m_library.count();
+        // only the rows that show, so that names are decoded as they come
+        // into view
+        float scroll = m_verticalScrollPos;
+        int first = max(0, (int) floorf((m_itemStart + scroll - m_size.y/2)/m_itemHeight - 0.5f));
+        int last = min(len-1, (int) ceilf((m_itemStart + scroll + m_size.y/2)/m_itemHeight + 0.5f));
         
         glLineWidth(4.0f);
         
@@ -284,8 +287,9 @@ public:
         shader.useProgram();
         shader.setClip(m_pos.xy()-m_size/2, m_size);
         
-        for(auto document : m_documentList)
+        for(int i = first; i <= last; i++)
         {
+            float yPos = m_itemStart + scroll - i*m_itemHeight;
             GLKMatrix4 xform = GLKMatrix4MakeTranslation(0, yPos, 0);
             shader.setLocalMatrix(xform);
             
@@ -311,7 +315,7 @@ public:
             }
             
             // draw each "figure" in the "name"
-            for(auto figure : document.name)
+            for(auto &figure : m_library.name(i))
                 drawLineStrip(shader, figure.data(), figure.size(), xform);
             
             // draw separating line between rows
@@ -322,13 +326,10 @@ public:
                     { -m_size.x/2*margin, -m_itemHeight/2 }, { m_size.x/2*margin, -m_itemHeight/2 },
                 }, 2, xform);
             }
-            
-            yPos -= m_itemHeight;
-            i++;
         }
         
         /* draw scroll bar */
-        int nRows = (int) m_documentList.size();
+        int nRows = len;
         if(nRows > 3)
         {
             float scroll_bar_margin = 0.95;
@@ -366,19 +367,11 @@ public:
     virtual void touchDown(const AGTouchInfo &t) override
     {
         GLvertex3f relPos = t.position-m_pos;
-        float yPos = m_itemStart+m_verticalScrollPos;
-        
-        for(int i = 0; i < m_documentList.size(); i++)
-        {
-            if(relPos.y < yPos+m_itemHeight/2.0f && relPos.y > yPos-m_itemHeight/2.0f &&
-               relPos.x > -m_size.x/2 && relPos.x < m_size.x/2)
-            {
-                m_selection = i;
-                break;
-            }
-            
-            yPos -= m_itemStart;
-        }
+        // row i is centered at m_itemStart+scroll-i*m_itemHeight
+        int i = (int) roundf((m_itemStart+m_verticalScrollPos-relPos.y)/m_itemHeight);
+        if(i >= 0 && i < m_library.count() &&
+           relPos.x > -m_size.x/2 && relPos.x < m_size.x/2)
+            m_selection = i;
         
         m_touchStart = t.position;
         m_lastTouch = t.position;
@@ -407,8 +400,8 @@ public:
         
         if(m_selection >= 0)
         {
-            const string &filename = m_documentList[m_selection].filename;
-            AGDocument doc = AGDocumentManager::instance().load(m_documentList[m_selection].filename);
+            string filename = m_library.filename(m_selection);
+            AGDocument doc = AGDocumentManager::instance().load(filename);
             m_onLoad(filename, doc);
             removeFromTopLevel();
         }
@@ -26,8 +26,7 @@
 //------------------------------------------------------------------------------
 #pragma mark - AGUIButton
 
-AGUIButton::AGUIButton(const std::string &title, const GLvertex3f &pos, const GLvertex3f &size) :
-m_action(nil)
+AGUIButton::AGUIButton(const std::string &title, const GLvertex3f &pos, const GLvertex3f &size)
 {
     m_hit = m_hitOnTouchDown = m_latch = false;
     m_interactionType = INTERACTION_UPDOWN;
@@ -51,8 +50,7 @@ m_action(nil)
 
 AGUIButton::~AGUIButton()
 {
-    if(m_action != nil) Block_release(m_action);
-    m_action = nil;
+    m_action = nullptr;
 }
 
 void AGUIButton::update(float t, float dt)
@@ -161,9 +159,9 @@ GLvrectf AGUIButton::effectiveBounds()
     return GLvrectf(m_pos, m_pos+m_size);
 }
 
-void AGUIButton::setAction(void (^action)())
+void AGUIButton::setAction(const std::function<void ()> &action)
 {
-    m_action = Block_copy(action);
+    m_action = action;
 }
 
 bool AGUIButton::isPressed()
@@ -207,7 +205,7 @@ AGUIButton *AGUIButton::makePinButton(AGUINodeEditor *nodeEditor)
     
     if(nodeEditor != nullptr)
     {
-        pinButton->setAction(^{
+        pinButton->setAction([nodeEditor, pinButton](){
             nodeEditor->pin(pinButton->isPressed());
         });
     }
@@ -400,27 +398,24 @@ AGUIButtonGroup::AGUIButtonGroup()
 
 AGUIButtonGroup::~AGUIButtonGroup()
 {
-    for(auto action : m_actions)
-        Block_release(action);
-    m_actions.clear();
 }
 
-void AGUIButtonGroup::addButton(AGUIButton *button, void (^action)(), bool isDefault)
+void AGUIButtonGroup::addButton(AGUIButton *button, const std::function<void ()> &action, bool isDefault)
 {
     button->setLatched(isDefault);
     m_buttons.push_back(button);
-    m_actions.push_back(Block_copy(action));
     addChild(button);
     
-    button->setAction(^{
-        itmap(m_buttons, ^(AGUIButton *&_b) {
-            if(_b == button)
-                _b->setLatched(true);
+    button->setAction([this, button, action](){
+        for(AGUIButton *b : m_buttons)
+        {
+            if(b == button)
+                b->setLatched(true);
             else
-                _b->setLatched(false);
-        });
+                b->setLatched(false);
+        }
         
-        if(action != NULL)
+        if(action)
             action();
     });
 }
@@ -16,6 +16,7 @@
 
 #include <string>
 #include <vector>
+#include <functional>
 
 // forward declaration
 class AGUINodeEditor;
@@ -98,7 +99,7 @@ public:
     
     virtual GLvertex2f size() { return m_size.xy(); }
     
-    void setAction(void (^action)());
+    void setAction(const std::function<void ()> &action);
     bool isPressed();
     void setLatched(bool latched);
     
@@ -152,7 +153,7 @@ protected:
 //    ActionType m_actionType;
     InteractionType m_interactionType;
     
-    void (^m_action)();
+    std::function<void ()> m_action;
 };
 
 
@@ -219,13 +220,12 @@ public:
     AGUIButtonGroup();
     ~AGUIButtonGroup();
     
-    void addButton(AGUIButton *button, void (^action)(), bool isDefault);
+    void addButton(AGUIButton *button, const std::function<void ()> &action, bool isDefault);
     
     virtual bool renderFixed() { return true; }
     
 private:
     std::list<AGUIButton *> m_buttons;
-    std::list<void (^)()> m_actions;
 };
 
 
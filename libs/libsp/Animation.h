@@ -179,7 +179,7 @@ class curvef
 {
 public:
     curvef(float _start = 0, float _end = 1, float _rate = 1) :
-    start(_start), end(_end), rate(_rate), t(0)
+    t(0), start(_start), end(_end), rate(_rate)
     { }
     
     virtual float evaluate(float t) const = 0;
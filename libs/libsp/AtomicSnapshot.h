@@ -0,0 +1,179 @@
+//
+//  AtomicSnapshot.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <utility>
+#include <stdint.h>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+// ### AtomicSnapshot ###
+// Publishes immutable snapshots from a single writer thread to a single
+// real-time reader thread via an atomic pointer swap. Replaced snapshots are
+// retired and deleted on the writer thread once the reader has moved on to a
+// newer snapshot (epoch-based reclamation). The reader never blocks or frees.
+// Other things the reader may still be using, like objects just removed from
+// a snapshot, can be retired the same way. Several writer threads have to
+// serialize themselves, freeing outside their lock what publish() and
+// reclaim() hand back, since freeing can publish again.
+//------------------------------------------------------------------------------
+#pragma mark - AtomicSnapshot
+
+template<typename T>
+class AtomicSnapshot
+{
+public:
+    AtomicSnapshot() : m_current(NULL), m_readerEpoch(0), m_publishedEpoch(0), m_heldEpoch(0), m_version(0) { }
+
+    ~AtomicSnapshot()
+    {
+        // no reader left to wait for
+        while(m_retired.size())
+        {
+            std::function<void ()> free = std::move(m_retired.front().second);
+            m_retired.pop_front();
+            free();
+        }
+        delete m_current.load();
+    }
+
+    AtomicSnapshot(const AtomicSnapshot &) = delete;
+
+    /* reader: get the current snapshot, valid until the next call to acquire() */
+    T *acquire()
+    {
+        // read the epoch before the pointer; the writer swaps the pointer before
+        // advancing the epoch, so the snapshot we load is at least this new
+        uint64_t epoch = m_publishedEpoch.load(std::memory_order_acquire);
+        T *snapshot = m_current.load(std::memory_order_acquire);
+        m_readerEpoch.store(epoch, std::memory_order_release);
+        return snapshot;
+    }
+
+    /* reader: as acquire(), but the snapshot, and whatever was retired before
+       it was published, stay valid until release() rather than the next
+       acquire; for a reader that passes through work queued before then */
+    T *acquireUntilRelease()
+    {
+        m_heldEpoch = m_publishedEpoch.load(std::memory_order_acquire);
+        return m_current.load(std::memory_order_acquire);
+    }
+
+    /* reader: done with the snapshot from acquireUntilRelease() */
+    void release()
+    {
+        m_readerEpoch.store(m_heldEpoch, std::memory_order_release);
+    }
+
+    // things retired and ready to be freed
+    typedef std::list<std::function<void ()>> FreeList;
+
+    /* writer: make a new snapshot current, retiring the previous one */
+    void publish(T *snapshot)
+    {
+        FreeList ready;
+        publish(snapshot, ready);
+        _free(ready);
+    }
+
+    /* writer: as publish(), but leave what is ready to be freed in ready for
+       the caller to free, e.g. after unlocking whatever serializes writers */
+    void publish(T *snapshot, FreeList &ready)
+    {
+        uint64_t version = ++m_version;
+        T *old = m_current.exchange(snapshot, std::memory_order_acq_rel);
+        m_publishedEpoch.store(version, std::memory_order_release);
+        if(old != NULL)
+            m_retired.push_back(std::make_pair(version, [old]() { delete old; }));
+
+        reclaim(ready);
+    }
+
+    /* writer: call free once the reader has picked up the next snapshot
+       published, and so can't be using anything removed before now */
+    void retire(const std::function<void ()> &free)
+    {
+        m_retired.push_back(std::make_pair(m_version+1, free));
+    }
+
+    /* writer: current snapshot (the writer is the only thread that replaces it) */
+    T *current() const { return m_current.load(std::memory_order_acquire); }
+
+    /* writer: version of the latest snapshot published, for waitFor() */
+    uint64_t version() const { return m_version; }
+
+    /* writer: delete retired snapshots (and free what else was retired) that
+       the reader can no longer see */
+    void reclaim()
+    {
+        FreeList ready;
+        reclaim(ready);
+        _free(ready);
+    }
+
+    /* writer: as reclaim(), but leave what is ready to be freed in ready */
+    void reclaim(FreeList &ready)
+    {
+        uint64_t epoch = m_readerEpoch.load(std::memory_order_acquire);
+        while(m_retired.size() && m_retired.front().first <= epoch)
+        {
+            ready.push_back(std::move(m_retired.front().second));
+            m_retired.pop_front();
+        }
+    }
+
+    /* writer: wait until the reader has seen the latest snapshot, or timeout
+       (e.g. if the reader thread is not running); returns true if synchronized */
+    bool synchronize(int timeoutMs = 250)
+    {
+        if(!waitFor(m_version, timeoutMs))
+            return false;
+
+        reclaim();
+        return true;
+    }
+
+    /* any thread: wait until the reader has seen snapshot version, or
+       timeout; unlike synchronize(), reads no writer state, so it needs no
+       lock held by writers that serialize themselves */
+    bool waitFor(uint64_t version, int timeoutMs = 250)
+    {
+        for(int ms = 0; ms < timeoutMs; ms++)
+        {
+            if(m_readerEpoch.load(std::memory_order_acquire) >= version)
+                return true;
+            usleep(1000);
+        }
+
+        return false;
+    }
+
+private:
+    static void _free(FreeList &ready)
+    {
+        // taken off the retired list before being called, since freeing
+        // something may publish or retire more
+        for(std::function<void ()> &free : ready)
+            free();
+    }
+
+    std::atomic<T *> m_current;
+    std::atomic<uint64_t> m_readerEpoch;
+    std::atomic<uint64_t> m_publishedEpoch;
+    // reader only; the epoch of the snapshot held until release()
+    uint64_t m_heldEpoch;
+    uint64_t m_version;
+
+    // (epoch the reader has to reach, what to free then), in epoch order
+    std::list<std::pair<uint64_t, std::function<void ()>>> m_retired;
+};
+
@@ -0,0 +1,82 @@
+//
+//  CycleCounter.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+//------------------------------------------------------------------------------
+// ### CycleCounter ###
+// Cheapest monotonic tick counter on the host, for timing short stretches of
+// code on the audio thread: the timestamp counter on x86, the generic timer on
+// ARM64 (what mach_absolute_time reads; it ticks slower than the core clock),
+// and steady_clock nanoseconds elsewhere.
+//------------------------------------------------------------------------------
+#pragma mark - CycleCounter
+
+class CycleCounter
+{
+public:
+    static inline uint64_t now()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t count;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(count));
+        return count;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    static const char *name()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return "rdtsc";
+#elif defined(__aarch64__)
+        return "cntvct_el0";
+#else
+        return "steady_clock";
+#endif
+    }
+
+    /* tick rate; measured against steady_clock on first use where the
+       hardware doesn't report it, so don't call from the audio thread */
+    static double ticksPerSecond()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        static double s_ticksPerSecond = _measureTicksPerSecond();
+        return s_ticksPerSecond;
+#elif defined(__aarch64__)
+        uint64_t frequency;
+        asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+        return (double) frequency;
+#else
+        return 1e9;
+#endif
+    }
+
+private:
+    static double _measureTicksPerSecond()
+    {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t startTicks = now();
+        while(std::chrono::steady_clock::now()-start < std::chrono::milliseconds(20))
+            ;
+        uint64_t ticks = now()-startTicks;
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+        return ticks/elapsed;
+    }
+};
+
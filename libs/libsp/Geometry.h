@@ -15,7 +15,7 @@
 #include <CoreGraphics/CoreGraphics.h>
 #include "gfx.h"
 
-#if defined(__APPLE__)
+#if defined(__APPLE__) || defined(AG_HEADLESS)
 #define ENABLE_GLKIT (1)
 #else
 #error only works on apple 
@@ -214,14 +214,14 @@ struct GLgeoprimf
     GLvertex3f normal;
     GLvertex2f texcoord;
     GLcolor4f color;
-} __attribute__((packed));
+} __attribute__((aligned(4),packed));
 
 // vertex + color primitve, i.e. vertex/color
 struct GLvcprimf
 {
     GLvertex3f vertex;
     GLcolor4f color;
-} __attribute__((packed));
+} __attribute__((aligned(4),packed));
 
 
 // vertex + normal + color primitve, i.e. vertex/normal/color
@@ -234,7 +234,7 @@ struct GLvncprimf
     GLvertex3f vertex;
     GLvertex3f normal;
     GLcolor4f color;
-} __attribute__((packed));
+} __attribute__((aligned(4),packed));
 
 // triangle primitive -- 3 vertex primitives
 struct GLtrif
@@ -242,18 +242,18 @@ struct GLtrif
     GLgeoprimf a;
     GLgeoprimf b;
     GLgeoprimf c;
-} __attribute__((packed));
+} __attribute__((aligned(4),packed));
 
 // rect primitive -- 4 vertex primitives
 // fill directly as GL_TRIANGLE_FAN or stroke as GL_LINE_LOOP
 struct GLvrectf
 {
     GLvrectf() :
-    bl(GLvertex3f(0, 0, 0)), br(GLvertex3f(0, 0, 0)), ul(GLvertex3f(0, 0, 0)), ur(GLvertex3f(0, 0, 0))
+    bl(GLvertex3f(0, 0, 0)), br(GLvertex3f(0, 0, 0)), ur(GLvertex3f(0, 0, 0)), ul(GLvertex3f(0, 0, 0))
     { }
     
     GLvrectf(const GLvertex3f &_bl, const GLvertex3f &_ur) :
-    bl(_bl), ur(_ur), br(GLvertex3f(_ur.x, _bl.y, 0.5*(_ur.z+_bl.z))), ul(GLvertex3f(_bl.x, _ur.y, 0.5*(_ur.z+_bl.z)))
+    bl(_bl), br(GLvertex3f(_ur.x, _bl.y, 0.5*(_ur.z+_bl.z))), ur(_ur), ul(GLvertex3f(_bl.x, _ur.y, 0.5*(_ur.z+_bl.z)))
     { }
     
     bool contains(const GLvertex3f &p);
@@ -262,7 +262,7 @@ struct GLvrectf
     GLvertex3f br; // bottom right
     GLvertex3f ur; // upper right
     GLvertex3f ul; // upper left
-} __attribute__((packed));
+} __attribute__((aligned(4),packed));
 
 
 static inline bool pointOnLine(const GLvertex2f &point, const GLvertex2f &line0, const GLvertex2f &line1, float thres)
@@ -316,7 +316,7 @@ static inline float area(const GLvertex3f *points, int N)
     // via http://stackoverflow.com/questions/451426/how-do-i-calculate-the-area-of-a-2d-polygon
     
     float area = 0;
-    for(size_t i = 1; i <= N; ++i)
+    for(int i = 1; i <= N; ++i)
         area += points[i%N].x*(points[(i+1)%N].y - points[(i-1)%N].y);
     area /= 2;
     
@@ -0,0 +1,156 @@
+//
+//  LockFreeQueue.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// ### SPSCQueue ###
+// Fixed-capacity lock-free ring buffer for one producer thread and one
+// consumer thread. Capacity must be a power of two and is never grown, so no
+// operation allocates. Items are copied in and out, so keep them plain data.
+//------------------------------------------------------------------------------
+#pragma mark - SPSCQueue
+
+template<typename T, int Capacity = 1024>
+class SPSCQueue
+{
+    static_assert((Capacity & (Capacity-1)) == 0, "capacity must be a power of two");
+
+public:
+    SPSCQueue() : m_head(0), m_tail(0) { }
+    SPSCQueue(const SPSCQueue &) = delete;
+
+    /* producer: returns false if full */
+    bool push(const T &item)
+    {
+        uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if(tail - m_head.load(std::memory_order_acquire) >= Capacity)
+            return false;
+
+        m_items[tail & (Capacity-1)] = item;
+        m_tail.store(tail+1, std::memory_order_release);
+        return true;
+    }
+
+    /* consumer: returns false if empty */
+    bool pop(T &item)
+    {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        if(head == m_tail.load(std::memory_order_acquire))
+            return false;
+
+        item = m_items[head & (Capacity-1)];
+        m_head.store(head+1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_relaxed);
+    }
+
+private:
+    // consumer and producer positions on separate cache lines
+    alignas(64) std::atomic<uint64_t> m_head;
+    alignas(64) std::atomic<uint64_t> m_tail;
+    T m_items[Capacity];
+};
+
+
+//------------------------------------------------------------------------------
+// ### MPSCQueue ###
+// Fixed-capacity lock-free queue for any number of producer threads and one
+// consumer thread (Vyukov's bounded queue: each slot carries a sequence
+// number saying whose turn it is). Producers only contend on claiming a slot;
+// a producer that is preempted between claiming and filling its slot holds up
+// the consumer at that slot until it resumes, but never blocks other
+// producers. Capacity must be a power of two; items should be plain data.
+//------------------------------------------------------------------------------
+#pragma mark - MPSCQueue
+
+template<typename T, int Capacity = 1024>
+class MPSCQueue
+{
+    static_assert((Capacity & (Capacity-1)) == 0, "capacity must be a power of two");
+
+public:
+    MPSCQueue() : m_head(0), m_tail(0)
+    {
+        for(int i = 0; i < Capacity; i++)
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MPSCQueue(const MPSCQueue &) = delete;
+
+    /* any thread: returns false if full */
+    bool push(const T &item)
+    {
+        uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        Slot *slot;
+
+        while(true)
+        {
+            slot = &m_slots[tail & (Capacity-1)];
+            uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            int64_t diff = (int64_t) sequence - (int64_t) tail;
+
+            if(diff == 0)
+            {
+                // slot is free for this position; claim it
+                if(m_tail.compare_exchange_weak(tail, tail+1, std::memory_order_relaxed))
+                    break;
+            }
+            else if(diff < 0)
+            {
+                // consumer hasn't freed this slot from the previous lap
+                return false;
+            }
+            else
+            {
+                // another producer claimed it first
+                tail = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->item = item;
+        slot->sequence.store(tail+1, std::memory_order_release);
+        return true;
+    }
+
+    /* consumer: returns false if empty (or the next item is still being
+       written) */
+    bool pop(T &item)
+    {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        Slot &slot = m_slots[head & (Capacity-1)];
+        if(slot.sequence.load(std::memory_order_acquire) != head+1)
+            return false;
+
+        item = slot.item;
+        // free for the producer one lap on
+        slot.sequence.store(head+Capacity, std::memory_order_release);
+        m_head.store(head+1, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence;
+        T item;
+    };
+
+    alignas(64) std::atomic<uint64_t> m_head;
+    alignas(64) std::atomic<uint64_t> m_tail;
+    Slot m_slots[Capacity];
+};
+
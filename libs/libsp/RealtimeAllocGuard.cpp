@@ -0,0 +1,212 @@
+//
+//  RealtimeAllocGuard.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "RealtimeAllocGuard.h"
+
+#include <atomic>
+#include <new>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#if RT_ALLOC_GUARD
+#include <execinfo.h>
+#endif
+
+thread_local int RealtimeAllocGuard::s_depth = 0;
+thread_local int RealtimeAllocGuard::s_allow = 0;
+
+static std::atomic<int> s_action(RealtimeAllocGuard::ACTION_LOG);
+static std::atomic<uint64_t> s_violations(0);
+
+// violations past this many are counted but not printed
+static const uint64_t MAX_REPORTS = 32;
+
+
+//------------------------------------------------------------------------------
+// ### RealtimeAllocGuard ###
+//------------------------------------------------------------------------------
+#pragma mark - RealtimeAllocGuard
+
+bool RealtimeAllocGuard::enabled()
+{
+#if RT_ALLOC_GUARD
+    return true;
+#else
+    return false;
+#endif
+}
+
+void RealtimeAllocGuard::setAction(Action action)
+{
+    s_action.store(action, std::memory_order_relaxed);
+}
+
+uint64_t RealtimeAllocGuard::violations()
+{
+    return s_violations.load(std::memory_order_relaxed);
+}
+
+void RealtimeAllocGuard::_violation(const char *function)
+{
+#if RT_ALLOC_GUARD
+    // reporting may itself allocate
+    Allow allow;
+
+    uint64_t count = s_violations.fetch_add(1, std::memory_order_relaxed);
+    bool abort = s_action.load(std::memory_order_relaxed) == ACTION_ABORT;
+
+    if(count < MAX_REPORTS || abort)
+    {
+        char message[128];
+        int length = snprintf(message, sizeof(message), "RealtimeAllocGuard: %s on real-time thread\n", function);
+        write(STDERR_FILENO, message, length);
+
+        void *frames[32];
+        int numFrames = backtrace(frames, 32);
+        // skip this function and check()
+        if(numFrames > 2)
+            backtrace_symbols_fd(frames+2, numFrames-2, STDERR_FILENO);
+    }
+
+    if(abort)
+        ::abort();
+#endif
+}
+
+
+#if RT_ALLOC_GUARD
+
+//------------------------------------------------------------------------------
+// ### allocator replacements ###
+// On glibc, malloc itself is interposed, which covers operator new as well as
+// C and library code. Elsewhere (Darwin), only operator new/delete can be
+// replaced portably.
+//------------------------------------------------------------------------------
+#pragma mark - allocator replacements
+
+#if defined(__GLIBC__)
+
+extern "C"
+{
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size)
+{
+    RealtimeAllocGuard::check("malloc");
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    RealtimeAllocGuard::check("calloc");
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    RealtimeAllocGuard::check("realloc");
+    return __libc_realloc(ptr, size);
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    RealtimeAllocGuard::check("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    RealtimeAllocGuard::check("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+    RealtimeAllocGuard::check("posix_memalign");
+    void *p = __libc_memalign(alignment, size);
+    if(p == NULL)
+        return ENOMEM;
+    *ptr = p;
+    return 0;
+}
+
+void free(void *ptr)
+{
+    if(ptr != NULL)
+        RealtimeAllocGuard::check("free");
+    __libc_free(ptr);
+}
+
+} // extern "C"
+
+#else // !__GLIBC__
+
+void *operator new(size_t size)
+{
+    RealtimeAllocGuard::check("operator new");
+    void *ptr = malloc(size ? size : 1);
+    if(ptr == NULL)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    RealtimeAllocGuard::check("operator new[]");
+    void *ptr = malloc(size ? size : 1);
+    if(ptr == NULL)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    RealtimeAllocGuard::check("operator new");
+    return malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    RealtimeAllocGuard::check("operator new[]");
+    return malloc(size ? size : 1);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    if(ptr != NULL)
+        RealtimeAllocGuard::check("operator delete");
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    if(ptr != NULL)
+        RealtimeAllocGuard::check("operator delete[]");
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    operator delete[](ptr);
+}
+
+#endif // __GLIBC__
+
+#endif // RT_ALLOC_GUARD
+
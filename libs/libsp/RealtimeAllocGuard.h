@@ -0,0 +1,82 @@
+//
+//  RealtimeAllocGuard.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+// checking is on by default in debug builds
+#if !defined(RT_ALLOC_GUARD) && defined(DEBUG)
+#define RT_ALLOC_GUARD 1
+#endif
+
+//------------------------------------------------------------------------------
+// ### RealtimeAllocGuard ###
+// Tracks which threads are real-time (the audio callback, render workers) and,
+// in RT_ALLOC_GUARD builds, reports any heap allocation or free made on them.
+// Threads mark themselves real-time for the extent of a Scope. Checking
+// replaces the global operator new/delete, and on glibc malloc and friends
+// too, so allocations made by libraries are caught there as well.
+//------------------------------------------------------------------------------
+#pragma mark - RealtimeAllocGuard
+
+class RealtimeAllocGuard
+{
+public:
+    enum Action
+    {
+        // print the offending call stack and carry on
+        ACTION_LOG,
+        ACTION_ABORT,
+    };
+
+    /* marks the calling thread real-time until destroyed; may nest */
+    class Scope
+    {
+    public:
+        Scope() { s_depth++; }
+        ~Scope() { s_depth--; }
+
+        Scope(const Scope &) = delete;
+    };
+
+    /* suspends checking on this thread until destroyed, for allocations that
+       are known and accepted (e.g. one-time setup) */
+    class Allow
+    {
+    public:
+        Allow() { s_allow++; }
+        ~Allow() { s_allow--; }
+
+        Allow(const Allow &) = delete;
+    };
+
+    /* true if the calling thread is inside a Scope */
+    static bool isRealtime() { return s_depth > 0; }
+
+    /* true if allocations are being checked (RT_ALLOC_GUARD builds) */
+    static bool enabled();
+
+    static void setAction(Action action);
+    /* number of allocations/frees on real-time threads so far */
+    static uint64_t violations();
+
+    /* called by the replaced allocators */
+    static inline void check(const char *function)
+    {
+        if(s_depth > 0 && s_allow == 0)
+            _violation(function);
+    }
+
+private:
+    static void _violation(const char *function);
+
+    static thread_local int s_depth;
+    static thread_local int s_allow;
+};
+
@@ -0,0 +1,116 @@
+//
+//  RealtimePool.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "RealtimePool.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+//------------------------------------------------------------------------------
+// ### RealtimePool ###
+//------------------------------------------------------------------------------
+#pragma mark - RealtimePool
+
+RealtimePool &RealtimePool::instance()
+{
+    static RealtimePool s_pool(DEFAULT_CAPACITY);
+    return s_pool;
+}
+
+RealtimePool::RealtimePool(size_t capacity) :
+m_capacity(capacity), m_top(0), m_used(0)
+{
+    // granule indices are 32-bit
+    assert(capacity/GRANULE < UINT32_MAX);
+
+    // pages are left untouched (uncommitted) until blocks are carved from
+    // them; malloc alignment keeps blocks 16-byte aligned
+    m_arena = (char *) malloc(m_capacity);
+    if(m_arena == NULL)
+        m_capacity = 0;
+    assert(((uintptr_t) m_arena) % GRANULE == 0);
+
+    for(int i = 0; i < NUM_CLASSES; i++)
+        m_free[i].store(0, std::memory_order_relaxed);
+}
+
+RealtimePool::~RealtimePool()
+{
+    free(m_arena);
+}
+
+void *RealtimePool::allocate(size_t size)
+{
+    int sizeClass = MIN_CLASS;
+    while(sizeClass < MIN_CLASS+NUM_CLASSES && (((size_t) 1) << sizeClass) < size+sizeof(Header))
+        sizeClass++;
+    if(sizeClass == MIN_CLASS+NUM_CLASSES)
+        return NULL;
+    size_t blockSize = ((size_t) 1) << sizeClass;
+
+    Header *header = NULL;
+
+    // reuse a free block of this class
+    std::atomic<uint64_t> &freeList = m_free[sizeClass-MIN_CLASS];
+    uint64_t head = freeList.load(std::memory_order_acquire);
+    while((uint32_t) head != 0)
+    {
+        Header *first = _header((uint32_t) head - 1);
+        // may read a stale link if the block was popped in the meantime, but
+        // then the version has moved on and the exchange fails
+        uint64_t next = first->next.load(std::memory_order_relaxed);
+        uint64_t newHead = (((head >> 32)+1) << 32) | next;
+        if(freeList.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire))
+        {
+            header = first;
+            break;
+        }
+    }
+
+    // or carve a new one from the arena
+    if(header == NULL)
+    {
+        size_t top = m_top.load(std::memory_order_relaxed);
+        do
+        {
+            if(top+blockSize > m_capacity)
+                return NULL;
+        } while(!m_top.compare_exchange_weak(top, top+blockSize, std::memory_order_relaxed));
+
+        header = (Header *) (m_arena+top);
+        header->sizeClass = sizeClass;
+    }
+
+    m_used.fetch_add(blockSize, std::memory_order_relaxed);
+
+    return header+1;
+}
+
+void RealtimePool::release(void *ptr)
+{
+    if(ptr == NULL)
+        return;
+
+    assert(owns(ptr));
+
+    Header *header = ((Header *) ptr)-1;
+    uint32_t index = (uint32_t) (((char *) header - m_arena)/GRANULE);
+    std::atomic<uint64_t> &freeList = m_free[header->sizeClass-MIN_CLASS];
+
+    m_used.fetch_sub(((size_t) 1) << header->sizeClass, std::memory_order_relaxed);
+
+    uint64_t head = freeList.load(std::memory_order_relaxed);
+    uint64_t newHead;
+    do
+    {
+        header->next.store((uint32_t) head, std::memory_order_relaxed);
+        newHead = (((head >> 32)+1) << 32) | (index+1);
+    } while(!freeList.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+}
+
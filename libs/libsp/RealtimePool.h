@@ -0,0 +1,162 @@
+//
+//  RealtimePool.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include "RealtimeAllocGuard.h"
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------
+// ### RealtimePool ###
+// Lock-free memory pool that real-time threads can allocate from and free to.
+// Blocks come in power-of-two size classes and are carved on demand from one
+// arena reserved up front (pages are only committed by the OS as blocks are
+// first used); freed blocks go on a per-class free list and are reused for
+// that class only. Nothing is returned to the system until the pool is
+// destroyed.
+//------------------------------------------------------------------------------
+#pragma mark - RealtimePool
+
+class RealtimePool
+{
+public:
+    // arena size of the shared pool
+    static const size_t DEFAULT_CAPACITY = 128*1024*1024;
+
+    /* pool shared by audio nodes; create it before the audio thread starts */
+    static RealtimePool &instance();
+
+    RealtimePool(size_t capacity);
+    ~RealtimePool();
+
+    RealtimePool(const RealtimePool &) = delete;
+
+    /* 16-byte aligned block of at least size bytes, or NULL if the arena is
+       used up; any thread */
+    void *allocate(size_t size);
+    /* return a block from allocate(); any thread */
+    void release(void *ptr);
+
+    /* true if ptr is a block from this pool */
+    bool owns(const void *ptr) const { return ptr >= m_arena && ptr < m_arena+m_capacity; }
+
+    size_t capacity() const { return m_capacity; }
+    /* bytes in blocks currently allocated, including headers */
+    size_t used() const { return m_used.load(std::memory_order_relaxed); }
+
+private:
+    // 64-byte blocks and up
+    static const int MIN_CLASS = 6;
+    static const int NUM_CLASSES = 40;
+    // offsets within the arena are kept in these units
+    static const size_t GRANULE = 16;
+
+    struct Header
+    {
+        uint32_t sizeClass;
+        // next free block, as granule index + 1 (0 = none)
+        std::atomic<uint32_t> next;
+        uint64_t _pad;
+    };
+
+    Header *_header(uint32_t index) { return (Header *) (m_arena + index*GRANULE); }
+
+    char *m_arena;
+    size_t m_capacity;
+    std::atomic<size_t> m_top;
+    std::atomic<size_t> m_used;
+    // heads of the free lists: version counter in the top 32 bits (against
+    // ABA), granule index + 1 in the bottom
+    std::atomic<uint64_t> m_free[NUM_CLASSES];
+};
+
+
+//------------------------------------------------------------------------------
+// ### PoolBuffer ###
+// Buffer whose storage comes from the shared RealtimePool, so it can be
+// resized on the audio thread. Off real-time threads, falls back to the heap
+// if the pool is exhausted; on them, resize() fails instead and the buffer is
+// left as it was. For plain data only; elements are not constructed.
+//------------------------------------------------------------------------------
+#pragma mark - PoolBuffer
+
+template<typename T>
+struct PoolBuffer
+{
+public:
+    PoolBuffer() : size(0), buffer(NULL) { }
+
+    PoolBuffer(size_t _size) : size(0), buffer(NULL) { resize(_size); }
+
+    ~PoolBuffer() { _release(buffer); }
+
+    PoolBuffer(const PoolBuffer &) = delete;
+
+    /* contents are not preserved; returns false if no memory was available */
+    bool resize(size_t _size);
+
+    void clear() { if(buffer) memset(buffer, 0, sizeof(T)*size); }
+
+    operator T*() { return buffer; }
+    operator const T*() const { return buffer; }
+
+    const T operator[](int i) const { return buffer[i]; }
+    T &operator[](int i) { return buffer[i]; }
+
+    size_t size;
+    T *buffer;
+
+private:
+    static void _release(T *ptr);
+};
+
+template<typename T>
+bool PoolBuffer<T>::resize(size_t _size)
+{
+    if(_size == size)
+        return true;
+
+    RealtimePool &pool = RealtimePool::instance();
+    bool realtime = RealtimeAllocGuard::isRealtime();
+
+    // a heap-backed buffer (from while the pool was exhausted) can't be freed
+    // on a real-time thread either
+    if(realtime && buffer != NULL && !pool.owns(buffer))
+        return false;
+
+    T *newBuffer = (T *) pool.allocate(sizeof(T)*_size);
+    if(newBuffer == NULL)
+    {
+        if(realtime)
+            return false;
+        newBuffer = new T[_size];
+    }
+
+    _release(buffer);
+    buffer = newBuffer;
+    size = _size;
+    return true;
+}
+
+template<typename T>
+void PoolBuffer<T>::_release(T *ptr)
+{
+    if(ptr == NULL)
+        return;
+
+    RealtimePool &pool = RealtimePool::instance();
+    if(pool.owns(ptr))
+        pool.release(ptr);
+    else
+        delete[] ptr;
+}
+
@@ -0,0 +1,47 @@
+//
+//  SPCachedCoefficient.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include <math.h>
+
+//------------------------------------------------------------------------------
+// ### SPCachedCoefficient ###
+// A value derived from a parameter (e.g. a one-pole coefficient from a time
+// constant), recomputed only when the parameter changes.
+//------------------------------------------------------------------------------
+#pragma mark - SPCachedCoefficient
+
+class SPCachedCoefficient
+{
+public:
+    SPCachedCoefficient() : m_param(NAN), m_value(0) { }
+
+    /* compute(param), or the last result if param hasn't changed */
+    template<typename Function>
+    float get(float param, Function compute)
+    {
+        // NAN never compares equal, so the first call always computes
+        if(param != m_param)
+        {
+            m_param = param;
+            m_value = compute(param);
+        }
+
+        return m_value;
+    }
+
+    /* force the next get() to recompute */
+    void invalidate() { m_param = NAN; }
+
+private:
+    float m_param;
+    float m_value;
+};
+
+
@@ -9,6 +9,7 @@
 
 
 #include <math.h>
+#include "spdsp.h"
 
 #if !defined(MIN)
 #define MIN(A,B)	({ __typeof__(A) __a = (A); __typeof__(B) __b = (B); __a < __b ? __a : __b; })
@@ -24,6 +25,12 @@
 
 typedef float SAMPLE;
 
+// fasttan() where it applies (everywhere but extreme Q settings)
+inline float sp_filter_tan(float x)
+{
+    return (x >= 0 && x < 1.57079632f) ? fasttan(x) : ::tan(x);
+}
+
 struct Butterworth2Filter
 {
     // much of this implementation is adapted or copied outright from SC3
@@ -54,7 +61,7 @@ struct Butterworth2Filter
     {
         float pfreq = freq * m_radians_per_sample * 0.5;
         
-        float C = 1.0 / ::tan(pfreq);
+        float C = 1.0 / sp_filter_tan(pfreq);
         float C2 = C * C;
         float sqrt2C = C * SQRT2;
         float next_a0 = 1.0 / (1.0 + sqrt2C + C2);
@@ -91,7 +98,7 @@ struct Butterworth2Filter
     {
         float pfreq = freq * m_radians_per_sample * 0.5;
         
-        float C = ::tan(pfreq);
+        float C = sp_filter_tan(pfreq);
         float C2 = C * C;
         float sqrt2C = C * SQRT2;
         float next_a0 = 1.0 / (1.0 + sqrt2C + C2);
@@ -129,7 +136,7 @@ struct Butterworth2Filter
         float pfreq = freq * m_radians_per_sample;
         float pbw = 1.0 / Q * pfreq * .5;
         
-        float C = 1.0 / ::tan(pbw);
+        float C = 1.0 / sp_filter_tan(pbw);
         float D = 2.0 * ::cos(pfreq);
         float next_a0 = 1.0 / (1.0 + C);
         float next_b1 = C * D * next_a0 ;
@@ -166,7 +173,7 @@ struct Butterworth2Filter
         float pfreq = freq * m_radians_per_sample;
         float pbw = 1.0 / Q * pfreq * .5;
         
-        float C = ::tan(pbw);
+        float C = sp_filter_tan(pbw);
         float D = 2.0 * ::cos(pfreq);
         float next_a0 = 1.0 / (1.0 + C);
         float next_b1 = -D * next_a0 ;
@@ -204,7 +211,7 @@ struct Butterworth2Filter
         float qres = MAX( .001, 1.0/Q );
         float pfreq = freq * m_radians_per_sample;
         
-        float D = ::tan(pfreq * qres * 0.5);
+        float D = sp_filter_tan(pfreq * qres * 0.5);
         float C = (1.0 - D) / (1.0 + D);
         float cosf = ::cos(pfreq);
         float next_b1 = (1.0 + C) * cosf;
@@ -242,7 +249,7 @@ struct Butterworth2Filter
         float qres = MAX( .001, 1.0/Q );
         float pfreq = freq * m_radians_per_sample;
         
-        float D = ::tan(pfreq * qres * 0.5);
+        float D = sp_filter_tan(pfreq * qres * 0.5);
         float C = (1.0 - D) / (1.0 + D);
         float cosf = ::cos(pfreq);
         float next_b1 = (1.0 + C) * cosf;
@@ -325,6 +332,10 @@ public:
     
     void clear() { m_filter.m_y1 = 0; m_filter.m_y2 = 0; set(m_filter.m_freq, m_filter.m_Q); }
     
+    // the current setting as transposed direct form II biquad coefficients
+    // (b0, b1, b2, a1, a2), for running outside of tick()
+    virtual void biquadCoefficients(float *c) const = 0;
+    
 protected:
     Butterworth2Filter m_filter;
 };
@@ -335,6 +346,12 @@ public:
     Butter2RLPF(float srate = 44100) : Butter2Filter(srate) { }
     virtual void set(float freq, float Q) { m_filter.set_rlpf(freq, Q); }
     virtual float tick(float input) { return m_filter.tick_rlpf(input); }
+    virtual void biquadCoefficients(float *c) const
+    {
+        // a0*(1 + 2z^-1 + z^-2)/(1 - b1*z^-1 - b2*z^-2)
+        c[0] = m_filter.m_a0; c[1] = 2*m_filter.m_a0; c[2] = m_filter.m_a0;
+        c[3] = -m_filter.m_b1; c[4] = -m_filter.m_b2;
+    }
 };
 
 class Butter2RHPF : public Butter2Filter
@@ -343,6 +360,12 @@ public:
     Butter2RHPF(float srate = 44100) : Butter2Filter(srate) { }
     virtual void set(float freq, float Q) { m_filter.set_rhpf(freq, Q); }
     virtual float tick(float input) { return m_filter.tick_rhpf(input); }
+    virtual void biquadCoefficients(float *c) const
+    {
+        // a0*(1 - 2z^-1 + z^-2)/(1 - b1*z^-1 - b2*z^-2)
+        c[0] = m_filter.m_a0; c[1] = -2*m_filter.m_a0; c[2] = m_filter.m_a0;
+        c[3] = -m_filter.m_b1; c[4] = -m_filter.m_b2;
+    }
 };
 
 class Butter2BPF : public Butter2Filter
@@ -351,5 +374,11 @@ public:
     Butter2BPF(float srate = 44100) : Butter2Filter(srate) { }
     virtual void set(float freq, float Q) { m_filter.set_bpf(freq, Q); }
     virtual float tick(float input) { return m_filter.tick_bpf(input); }
+    virtual void biquadCoefficients(float *c) const
+    {
+        // a0*(1 - z^-2)/(1 - b1*z^-1 - b2*z^-2)
+        c[0] = m_filter.m_a0; c[1] = 0; c[2] = -m_filter.m_a0;
+        c[3] = -m_filter.m_b1; c[4] = -m_filter.m_b2;
+    }
 };
 
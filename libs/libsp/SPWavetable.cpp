@@ -0,0 +1,189 @@
+//
+//  SPWavetable.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "SPWavetable.h"
+#include "spvdsp.h"
+
+#include <complex>
+#include <math.h>
+
+typedef std::complex<double> complexd;
+
+/* in-place radix-2 FFT of n (a power of two) points; inverse is unscaled */
+static void _fft(complexd *x, int n, bool inverse)
+{
+    // bit-reversed order
+    for(int i = 1, j = 0; i < n; i++)
+    {
+        int bit = n >> 1;
+        for(; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if(i < j)
+            std::swap(x[i], x[j]);
+    }
+
+    for(int len = 2; len <= n; len <<= 1)
+    {
+        double angle = 2*M_PI/len * (inverse ? 1 : -1);
+        complexd w(cos(angle), sin(angle));
+        for(int i = 0; i < n; i += len)
+        {
+            complexd wk(1, 0);
+            for(int k = 0; k < len/2; k++)
+            {
+                complexd a = x[i+k];
+                complexd b = x[i+k+len/2]*wk;
+                x[i+k] = a+b;
+                x[i+k+len/2] = a-b;
+                wk *= w;
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// ### SPWavetable ###
+//------------------------------------------------------------------------------
+#pragma mark - SPWavetable
+
+SPWavetable::SPWavetable(const float *waveform, int length)
+{
+    std::vector<complexd> x(SIZE);
+    for(int i = 0; length > 0 && i < SIZE; i++)
+    {
+        double pos = ((double) i)*length/SIZE;
+        int whole = (int) pos;
+        double fract = pos-whole;
+        x[i] = waveform[whole]*(1-fract) + waveform[(whole+1)%length]*fract;
+    }
+
+    _fft(x.data(), SIZE, false);
+
+    std::vector<float> re(SIZE/2+1), im(SIZE/2+1);
+    for(int h = 0; h <= SIZE/2; h++)
+    {
+        re[h] = x[h].real();
+        im[h] = x[h].imag();
+    }
+
+    _build(re, im);
+}
+
+SPWavetable::SPWavetable(const float *sine, const float *cosine, int numHarmonics)
+{
+    // DFT bins of a SIZE-point cycle with these components
+    std::vector<float> re(SIZE/2+1), im(SIZE/2+1);
+    for(int h = 0; h < numHarmonics && h <= MAX_HARMONICS; h++)
+    {
+        float scale = h == 0 ? SIZE : SIZE/2;
+        re[h] = cosine[h]*scale;
+        im[h] = h == 0 ? 0 : -sine[h]*scale;
+    }
+
+    _build(re, im);
+}
+
+void SPWavetable::_build(const std::vector<float> &re, const std::vector<float> &im)
+{
+    m_tables.resize(NUM_LEVELS*(SIZE+1));
+
+    std::vector<complexd> x(SIZE);
+    for(int level = 0; level < NUM_LEVELS; level++)
+    {
+        int numHarmonics = MAX_HARMONICS >> level;
+
+        // keep the harmonics (and their mirror images) this level can hold
+        std::fill(x.begin(), x.end(), complexd(0, 0));
+        x[0] = complexd(re[0], 0);
+        for(int h = 1; h <= numHarmonics; h++)
+        {
+            x[h] = complexd(re[h], im[h]);
+            x[SIZE-h] = std::conj(x[h]);
+        }
+
+        _fft(x.data(), SIZE, true);
+
+        float *table = m_tables.data() + level*(SIZE+1);
+        for(int i = 0; i < SIZE; i++)
+            table[i] = x[i].real()/SIZE;
+        table[SIZE] = table[0];
+    }
+}
+
+const SPWavetable &SPWavetable::sawtooth()
+{
+    static const SPWavetable s_sawtooth = [] {
+        // 1-2*phase = 2/pi * sum(sin(2*pi*h*phase)/h)
+        std::vector<float> sine(MAX_HARMONICS+1), cosine(MAX_HARMONICS+1);
+        for(int h = 1; h <= MAX_HARMONICS; h++)
+            sine[h] = 2/(M_PI*h);
+        return SPWavetable(sine.data(), cosine.data(), MAX_HARMONICS+1);
+    }();
+
+    return s_sawtooth;
+}
+
+const SPWavetable &SPWavetable::triangle()
+{
+    static const SPWavetable s_triangle = [] {
+        // 8/pi^2 * sum(cos(2*pi*h*phase)/h^2), odd h
+        std::vector<float> sine(MAX_HARMONICS+1), cosine(MAX_HARMONICS+1);
+        for(int h = 1; h <= MAX_HARMONICS; h += 2)
+            cosine[h] = 8/(M_PI*M_PI*h*h);
+        return SPWavetable(sine.data(), cosine.data(), MAX_HARMONICS+1);
+    }();
+
+    return s_triangle;
+}
+
+int SPWavetable::level(float frequency)
+{
+    // lowest level with (MAX_HARMONICS >> level)*frequency <= 1/2,
+    // i.e. ceil(log2(2*MAX_HARMONICS*frequency))
+    float x = 2*MAX_HARMONICS*fabsf(frequency);
+    if(!(x > 1))
+        return 0;
+    if(x >= (1 << (NUM_LEVELS-1)))
+        return NUM_LEVELS-1;
+
+    int exponent;
+    float mantissa = frexpf(x, &exponent);
+    return mantissa == 0.5f ? exponent-1 : exponent;
+}
+
+void SPWavetable::render(float *dst, const float *phase, int level, int n) const
+{
+    spv_wavetable(dst, table(level), SIZE, phase, n);
+}
+
+void SPWavetable::render(float *dst, const float *phase, int from, int to, int n) const
+{
+    if(from == to)
+    {
+        render(dst, phase, to, n);
+        return;
+    }
+
+    // phase may alias dst, so each chunk reads it before writing
+    const int CHUNK = 64;
+    float a[CHUNK], b[CHUNK];
+    for(int i = 0; i < n; i += CHUNK)
+    {
+        int count = n-i < CHUNK ? n-i : CHUNK;
+        render(a, phase+i, from, count);
+        render(b, phase+i, to, count);
+
+        for(int k = 0; k < count; k++)
+        {
+            float mix = (float) (i+k+1)/n;
+            dst[i+k] = a[k] + (b[k]-a[k])*mix;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+//
+//  SPWavetable.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include <vector>
+
+//------------------------------------------------------------------------------
+// ### SPWavetable ###
+// One cycle of a waveform, band-limited into a mip-map of octave-spaced
+// tables: level 0 keeps MAX_HARMONICS harmonics, and each level after it half
+// as many as the one before. An oscillator reads the level with no harmonics
+// past Nyquist at its frequency (see level()), so it stays free of aliasing
+// at any pitch without oversampling. Tables are 4x oversampled relative to
+// their highest harmonic, which keeps linear interpolation clean.
+//
+// Building one takes a few FFTs and allocates, so do it off the audio thread;
+// once built, a wavetable is read-only.
+//------------------------------------------------------------------------------
+#pragma mark - SPWavetable
+
+class SPWavetable
+{
+public:
+    // samples per cycle, at every level
+    static const int SIZE = 4096;
+    static const int MAX_HARMONICS = SIZE/4;
+    // down to the fundamental alone
+    static const int NUM_LEVELS = 11;
+
+    /* from one cycle of a waveform, as linearly interpolated between its
+       points (e.g. drawn by hand); any length */
+    SPWavetable(const float *waveform, int length);
+    /* from the amplitudes of each harmonic's sine and cosine components, for
+       harmonics 0 (DC; cosine only) through numHarmonics-1 */
+    SPWavetable(const float *sine, const float *cosine, int numHarmonics);
+
+    /* shared, band-limited versions of the naive shapes of AGAudioSawtoothWaveNode
+       (1-2*phase) and AGAudioTriangleWaveNode (1 at phase 0, -1 at phase 1/2).
+       Built on first use, so call once off the audio thread first */
+    static const SPWavetable &sawtooth();
+    static const SPWavetable &triangle();
+
+    /* the lowest (brightest) level with no harmonics past Nyquist for
+       frequency in cycles per sample */
+    static int level(float frequency);
+
+    /* level's table: SIZE samples followed by a guard sample (see spv_wavetable) */
+    const float *table(int level) const { return m_tables.data() + level*(SIZE+1); }
+
+    /* dst[i] = waveform at phase[i] (cycles), from level */
+    void render(float *dst, const float *phase, int level, int n) const;
+    /* the same, crossfading from level from to level to over the block, so
+       that a pitch crossing an octave doesn't step in brightness */
+    void render(float *dst, const float *phase, int from, int to, int n) const;
+
+private:
+    void _build(const std::vector<float> &re, const std::vector<float> &im);
+
+    std::vector<float> m_tables;
+};
+
@@ -9,9 +9,13 @@
 #include "SampleCircularBuffer.h"
 
 #include <algorithm> // min
+#include <thread>
 #include <assert.h>
+#include <string.h>
 
-SampleCircularBuffer::SampleCircularBuffer() { }
+SampleCircularBuffer::SampleCircularBuffer()
+: m_read(0), m_write(0)
+{ }
 
 SampleCircularBuffer::~SampleCircularBuffer()
 {
@@ -21,95 +25,86 @@ SampleCircularBuffer::~SampleCircularBuffer()
 void SampleCircularBuffer::initialize(int size)
 {
     SAFE_DELETE_ARRAY(m_data);
-    m_size = size;
-    m_data = new float[size];
+
+    m_size = 1;
+    while(m_size < size)
+        m_size *= 2;
+    m_data = new float[m_size];
+    memset(m_data, 0, sizeof(float)*m_size);
+
+    clear();
 }
 
 void SampleCircularBuffer::cleanup()
 {
     SAFE_DELETE_ARRAY(m_data);
     m_size = 0;
+    clear();
 }
 
 int SampleCircularBuffer::get(float *data, int max)
 {
-    int elems_before_end;
-    int elems_after_end;
-    
-    if(m_write < m_read)
-    {
-        elems_before_end = m_size - m_read;
-        elems_after_end = m_write;
-    }
-    else
-    {
-        elems_before_end = m_write - m_read;
-        elems_after_end = 0;
-    }
-    
-    if(elems_before_end > max)
-    {
-        elems_before_end = max;
-        elems_after_end = 0;
-    }
-    else if(elems_before_end + elems_after_end > max)
-    {
-        elems_after_end = max - elems_before_end;
-    }
-    
+    uint64_t read = m_read.load(std::memory_order_relaxed);
+    // acquire: the samples before the producer's position are written
+    uint64_t write = m_write.load(std::memory_order_acquire);
+
+    int num = (int) std::min<uint64_t>(write - read, max);
+    int start = (int) (read & (m_size-1));
+    int elems_before_end = std::min(num, m_size - start);
+    int elems_after_end = num - elems_before_end;
+
     if(elems_before_end)
-        memcpy(data, m_data + m_read, elems_before_end*sizeof(float));
-    
+        memcpy(data, m_data + start, elems_before_end*sizeof(float));
     if(elems_after_end)
         memcpy(data + elems_before_end, m_data, elems_after_end*sizeof(float));
-    
-    if(elems_after_end)
-        m_read = elems_after_end;
-    else
-        m_read += elems_before_end;
-    
-    return elems_before_end + elems_after_end;
+
+    // release: done with the samples, which the producer may now overwrite
+    m_read.store(read + num, std::memory_order_release);
+
+    return num;
 }
 
-int SampleCircularBuffer::put(float *data, int num)
+int SampleCircularBuffer::put(const float *data, int num)
 {
-    if(m_write+num >= m_read && m_write+num < m_write)
+    uint64_t write = m_write.load(std::memory_order_relaxed);
+    // acquire: the consumer is done with the samples before its position
+    uint64_t read = m_read.load(std::memory_order_acquire);
+
+    if(num > m_size - (int) (write - read))
     {
         // overflow
         return 0;
     }
-    
-    int elems_before_end = std::min(num, m_size - m_write);
+
+    int start = (int) (write & (m_size-1));
+    int elems_before_end = std::min(num, m_size - start);
     int elems_after_end = num - elems_before_end;
-    
+
     if(elems_before_end)
-        memcpy(m_data + m_write, data, elems_before_end*sizeof(float));
-    
-    if(elems_after_end)
-        memcpy(m_data, data+elems_before_end, elems_after_end*sizeof(float));
-    
+        memcpy(m_data + start, data, elems_before_end*sizeof(float));
     if(elems_after_end)
-        m_write = elems_after_end;
-    else
-        m_write += elems_before_end;
-    
-    return elems_before_end + elems_after_end;
+        memcpy(m_data, data + elems_before_end, elems_after_end*sizeof(float));
+
+    // release: publish the samples along with the position
+    m_write.store(write + num, std::memory_order_release);
+
+    return num;
 }
 
 void SampleCircularBuffer::test()
 {
     SampleCircularBuffer buffer;
     buffer.initialize(1024);
-    
-    int testSize = 1000;
+
+    const int testSize = 1000;
     int numTests = 100;
-    
+
     float input[testSize];
     float output[testSize];
-    
+
     for(int i = 0; i < testSize; i++)
         input[i] = i;
-    
+
     for(int n = 0; n < numTests; n++)
     {
         buffer.put(input, testSize);
@@ -117,18 +112,47 @@ void SampleCircularBuffer::test()
         for(int i = 0; i < testSize; i++)
             assert(input[i] == output[i]);
     }
-    
+
     for(int n = 0; n < numTests; n++)
     {
-        buffer.put(input, testSize);
-        buffer.put(input, testSize);
-        
-        buffer.get(output, testSize);
-        for(int i = 0; i < testSize; i++)
-            assert(input[i] == output[i]);
-        
-        buffer.get(output, testSize);
+        // only one fits; the second is refused whole
+        assert(buffer.put(input, testSize) == testSize);
+        assert(buffer.put(input, testSize) == 0);
+
+        assert(buffer.get(output, testSize) == testSize);
         for(int i = 0; i < testSize; i++)
             assert(input[i] == output[i]);
+
+        assert(buffer.get(output, testSize) == 0);
     }
+
+    // a producer and consumer on their own threads, with block sizes that
+    // don't divide the capacity, so every wrap position comes up
+    const int numSamples = 1 << 24;
+    std::thread producer([&buffer, numSamples]() {
+        float block[testSize];
+        for(int next = 0; next < numSamples; )
+        {
+            int num = std::min(1 + next % 257, numSamples - next);
+            for(int i = 0; i < num; i++)
+                block[i] = (float) ((next + i) & 0xffff);
+            if(buffer.put(block, num) == num)
+                next += num;
+            else
+                std::this_thread::yield();
+        }
+    });
+
+    for(int next = 0; next < numSamples; )
+    {
+        int num = buffer.get(output, 1 + next % 509);
+        for(int i = 0; i < num; i++)
+            assert(output[i] == (float) ((next + i) & 0xffff));
+        next += num;
+        if(num == 0)
+            std::this_thread::yield();
+    }
+
+    producer.join();
+    assert(!buffer.hasMore());
 }
@@ -8,9 +8,17 @@
 
 #pragma once
 
+#include <atomic>
+#include <stdint.h>
+
 //------------------------------------------------------------------------------
 // ### SampleCircularBuffer ###
-// Circular buffer for float samples
+// Circular buffer for float samples, lock-free for one producer thread and
+// one consumer thread. The write and read positions only ever grow (wrapping
+// into the buffer by mask), and each side publishes its position with release
+// and reads the other's with acquire, so the samples a put() copies in are
+// visible to the get() that sees them. Neither side ever blocks or allocates.
+// The capacity is rounded up to a power of two.
 //------------------------------------------------------------------------------
 #pragma mark - SampleCircularBuffer
 
@@ -19,20 +27,36 @@ class SampleCircularBuffer
 public:
     SampleCircularBuffer();
     ~SampleCircularBuffer();
-    
+    SampleCircularBuffer(const SampleCircularBuffer &) = delete;
+
+    /* off the producer and consumer threads; the memory is touched here, so
+       the first puts don't fault it in */
     void initialize(int num_elem);
     void cleanup();
-    
+
+    /* consumer: copy out up to max samples; returns the number copied */
     int get( float *data, int max );
-    int put( float *data, int num );
-    inline bool hasMore() { return (m_read != m_write); }
-    inline void clear() { m_read = m_write = 0; }
-    
+    /* producer: copy in all num samples, or none if there isn't room (so a
+       block is never split); returns the number copied */
+    int put( const float *data, int num );
+
+    /* consumer: samples waiting to be got */
+    int numAvailable() const { return (int) (m_write.load(std::memory_order_acquire) - m_read.load(std::memory_order_relaxed)); }
+    /* producer: room for samples to be put */
+    int numFree() const { return m_size - (int) (m_write.load(std::memory_order_relaxed) - m_read.load(std::memory_order_acquire)); }
+    int capacity() const { return m_size; }
+
+    inline bool hasMore() const { return numAvailable() > 0; }
+    /* only while neither side is using the buffer */
+    inline void clear() { m_read.store(0); m_write.store(0); }
+
     static void test();
-    
+
 protected:
     float *m_data = NULL;
-    int m_read = 0;
-    int m_write = 0;
     int m_size = 0;
+    // positions, in samples since the buffer was cleared; the consumer's and
+    // producer's on separate cache lines
+    alignas(64) std::atomic<uint64_t> m_read;
+    alignas(64) std::atomic<uint64_t> m_write;
 };
@@ -0,0 +1,56 @@
+//
+//  Semaphore.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __APPLE__
+#include <dispatch/dispatch.h>
+#else
+#include <errno.h>
+#include <semaphore.h>
+#endif
+
+//------------------------------------------------------------------------------
+// ### Semaphore ###
+// Counting semaphore for parking a thread until another posts to it. post()
+// doesn't lock or allocate, so real-time threads may wake others with it.
+//------------------------------------------------------------------------------
+#pragma mark - Semaphore
+
+class Semaphore
+{
+public:
+#ifdef __APPLE__
+    Semaphore(int count = 0) : m_sem(dispatch_semaphore_create(count)) { }
+    ~Semaphore()
+    {
+        // ARC releases it when included from Objective-C++
+#if !__has_feature(objc_arc)
+        dispatch_release(m_sem);
+#endif
+    }
+
+    void post() { dispatch_semaphore_signal(m_sem); }
+    void wait() { dispatch_semaphore_wait(m_sem, DISPATCH_TIME_FOREVER); }
+#else
+    Semaphore(int count = 0) { sem_init(&m_sem, 0, count); }
+    ~Semaphore() { sem_destroy(&m_sem); }
+
+    void post() { sem_post(&m_sem); }
+    void wait() { while(sem_wait(&m_sem) != 0 && errno == EINTR) { } }
+#endif
+
+    Semaphore(const Semaphore &) = delete;
+
+private:
+#ifdef __APPLE__
+    dispatch_semaphore_t m_sem;
+#else
+    sem_t m_sem;
+#endif
+};
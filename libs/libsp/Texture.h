@@ -10,8 +10,8 @@
 #ifndef __TEXTURE_H__
 #define __TEXTURE_H__
 
-#import <OpenGLES/ES1/gl.h>
-#import <OpenGLES/ES1/glext.h>
+#include <OpenGLES/ES1/gl.h>
+#include <OpenGLES/ES1/glext.h>
 
 #if __OBJC__
 
@@ -15,7 +15,7 @@ Thread::~Thread()
     if(m_thread)
     {
         pthread_detach(m_thread);
-        m_thread = NULL;
+        m_thread = pthread_t();
     }
 }
 
@@ -28,7 +28,10 @@ void Thread::start(const std::function<void ()> &go)
 void Thread::wait()
 {
     if(m_thread)
+    {
         pthread_join(m_thread, NULL);
+        m_thread = pthread_t();
+    }
 }
 
 void *Thread::_threadFunc(void *_this)
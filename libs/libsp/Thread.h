@@ -23,7 +23,7 @@ public:
 private:
     static void *_threadFunc(void *_this);
     
-    pthread_t m_thread = NULL;
+    pthread_t m_thread = pthread_t();
     std::function<void ()> m_go = [](){};
 };
 
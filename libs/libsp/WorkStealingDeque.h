@@ -0,0 +1,99 @@
+//
+//  WorkStealingDeque.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// ### WorkStealingDeque ###
+// Fixed-capacity lock-free Chase-Lev deque. The owning thread pushes and pops
+// at the bottom; any other thread may steal from the top. Capacity must be a
+// power of two and is never grown, so no operation allocates.
+//------------------------------------------------------------------------------
+#pragma mark - WorkStealingDeque
+
+template<typename T, int Capacity = 256>
+class WorkStealingDeque
+{
+    static_assert((Capacity & (Capacity-1)) == 0, "capacity must be a power of two");
+
+public:
+    WorkStealingDeque() : m_top(0), m_bottom(0) { }
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+
+    /* owner: returns false if full */
+    bool push(const T &item)
+    {
+        int64_t b = m_bottom.load(std::memory_order_relaxed);
+        int64_t t = m_top.load(std::memory_order_acquire);
+        if(b - t >= Capacity)
+            return false;
+
+        m_items[b & (Capacity-1)].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(b+1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /* owner: returns false if empty */
+    bool pop(T &item)
+    {
+        int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = m_top.load(std::memory_order_relaxed);
+
+        if(t > b)
+        {
+            // empty
+            m_bottom.store(b+1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = m_items[b & (Capacity-1)].load(std::memory_order_relaxed);
+        if(t == b)
+        {
+            // last item; race any thieves for it
+            bool won = m_top.compare_exchange_strong(t, t+1, std::memory_order_seq_cst,
+                                                     std::memory_order_relaxed);
+            m_bottom.store(b+1, std::memory_order_relaxed);
+            return won;
+        }
+
+        return true;
+    }
+
+    /* any thread: returns false if empty or if another thread won the race */
+    bool steal(T &item)
+    {
+        int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = m_bottom.load(std::memory_order_acquire);
+
+        if(t >= b)
+            return false;
+
+        item = m_items[t & (Capacity-1)].load(std::memory_order_relaxed);
+        return m_top.compare_exchange_strong(t, t+1, std::memory_order_seq_cst,
+                                             std::memory_order_relaxed);
+    }
+
+    bool empty() const
+    {
+        return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+    }
+
+private:
+    // top and bottom on separate cache lines; thieves hammer the former
+    alignas(64) std::atomic<int64_t> m_top;
+    alignas(64) std::atomic<int64_t> m_bottom;
+    std::atomic<T> m_items[Capacity];
+};
+
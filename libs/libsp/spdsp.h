@@ -21,9 +21,20 @@
 #endif
 
 #include <cmath>
+#include <stdint.h>
 
+// wrap to [0, 1); truncating to int is much cheaper than floor() where the
+// latter isn't inlined, so that is only used outside of int range
 template<typename T>
-inline T clipunit(T x) { return x-std::floor(x); }
+inline T clipunit(T x)
+{
+    if(x > -2147483648.0 && x < 2147483648.0)
+    {
+        T f = x-(T)(int)x;
+        return f < 0 ? f+1 : f;
+    }
+    return x-std::floor(x);
+}
 
 template<typename T>
 inline bool isbad(T x) { return isnan(x) || isinf(x); }
@@ -31,4 +42,82 @@ inline bool isbad(T x) { return isnan(x) || isinf(x); }
 template<typename T>
 inline bool isgood(T x) { return !(isnan(x) || isinf(x)); }
 
+
+//------------------------------------------------------------------------------
+// fast approximations, for coefficients and gain computers that run per
+// sample or per few samples; accurate to well under what a float coefficient
+// can resolve in the ranges noted
+//------------------------------------------------------------------------------
+
+// 2^x; relative error < 3e-7 for x in [-126, 127]
+inline float fastexp2(float x)
+{
+    if(x < -126) return 0;
+    if(x > 127) x = 127;
+    
+    float fi = std::floor(x);
+    // 2^f for f in [0, 1), as sqrt(2)*2^g with g in [-1/2, 1/2), by its series
+    float g = x-fi-0.5f;
+    float p = 1.41421356f*(1.0f+g*(0.69314718f+g*(0.24022651f+g*(0.05550411f+g*(0.00961813f+g*(0.00133336f+g*0.00015404f))))));
+    
+    union { float f; int32_t i; } u = { p };
+    u.i += ((int32_t) fi) << 23;
+    return u.f;
+}
+
+// e^x
+inline float fastexp(float x)
+{
+    return fastexp2(x*1.44269504f);
+}
+
+// log2(x) for x > 0; absolute error < 1e-5
+inline float fastlog2(float x)
+{
+    union { float f; int32_t i; } u = { x };
+    float e = (float) (((u.i >> 23) & 0xff) - 127);
+    // mantissa in [1, 2), recentred on [sqrt(1/2), sqrt(2)) for accuracy
+    u.i = (u.i & 0x007fffff) | 0x3f800000;
+    float m = u.f;
+    if(m > 1.41421356f) { m *= 0.5f; e += 1; }
+    
+    // log2(m) = 2/ln(2) * atanh((m-1)/(m+1)), as an odd series in z
+    float z = (m-1)/(m+1);
+    float z2 = z*z;
+    return e + z*(2.88539008f+z2*(0.96179669f+z2*(0.57707801f+z2*0.41219858f)));
+}
+
+// tan(x) for x in [0, pi/2); relative error < 1e-6
+inline float fasttan(float x)
+{
+    // tan(x) = 1/tan(pi/2-x) folds x into [0, pi/4], and the half angle into
+    // [0, pi/8], where a truncated Lambert continued fraction is exact to
+    // float precision
+    bool invert = x > 0.78539816f;
+    // (in double, since pi/2 isn't representable in float and near it the
+    // difference is all that's left)
+    if(invert) x = (float) (1.5707963267948966-x);
+    
+    float h = x*0.5f;
+    float h2 = h*h;
+    float t = h*(135135.0f+h2*(-17325.0f+h2*(378.0f-h2)))/(135135.0f+h2*(-62370.0f+h2*(3150.0f-28.0f*h2)));
+    // double angle
+    t = 2*t/(1-t*t);
+    
+    return invert ? 1.0f/t : t;
+}
+
+// as dB2lin/lin2dB (including the -100dB floor)
+inline float fastdB2lin(float db)
+{
+    // 10^(db/20) = 2^(db*log2(10)/20)
+    return fastexp2(db*0.16609640f);
+}
+
+inline float fastlin2dB(float lin)
+{
+    // 20*log10(x) = 20*log10(2)*log2(x)
+    return 6.02059991f*fastlog2(lin > 0.00001f ? lin : 0.00001f);
+}
+
 #endif /* spdsp_hpp */
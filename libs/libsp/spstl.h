@@ -10,6 +10,9 @@
 #define Auragraph_spstl_h
 
 
+// block-based helpers are only available where the compiler supports blocks
+#ifdef __BLOCKS__
+
 /*------------------------------------------------------------------------------
   itmap()
   Map a block to every item in a C++/STL iterable container
@@ -97,6 +100,8 @@ void itfilter(T &container, bool (^func)(typename T::reference v))
     }
 }
 
+#endif // __BLOCKS__
+
 /*------------------------------------------------------------------------------
  removevalues()
  Remove all keys from a map with the specified value
@@ -7,6 +7,9 @@
 //
 
 #include "sputil.h"
+
+#ifdef __APPLE__
+
 #include <CoreFoundation/CoreFoundation.h>
 
 string makeUUID()
@@ -20,3 +23,35 @@ string makeUUID()
     
     return str;
 }
+
+#else // !__APPLE__
+
+#include <random>
+#include <stdio.h>
+
+// random (version 4) UUID, formatted like CFUUIDCreateString
+string makeUUID()
+{
+    static std::random_device s_device;
+    static std::mt19937_64 s_rng(s_device());
+    
+    unsigned char bytes[16];
+    for(int i = 0; i < 16; i += 8)
+    {
+        uint64_t r = s_rng();
+        for(int j = 0; j < 8; j++)
+            bytes[i+j] = (r >> (j*8)) & 0xff;
+    }
+    bytes[6] = (bytes[6] & 0x0f) | 0x40;
+    bytes[8] = (bytes[8] & 0x3f) | 0x80;
+    
+    char str[37];
+    snprintf(str, sizeof(str),
+             "%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X",
+             bytes[0], bytes[1], bytes[2], bytes[3], bytes[4], bytes[5], bytes[6], bytes[7],
+             bytes[8], bytes[9], bytes[10], bytes[11], bytes[12], bytes[13], bytes[14], bytes[15]);
+    
+    return str;
+}
+
+#endif // __APPLE__
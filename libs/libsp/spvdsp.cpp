@@ -0,0 +1,716 @@
+//
+//  spvdsp.cpp
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "spvdsp.h"
+#include "spdsp.h"
+
+#include <math.h>
+#include <string.h>
+
+// SPV_SCALAR builds the plain loops regardless, for checking the others
+// against (see tools/agrender/agdspcheck.cpp)
+#if defined(SPV_SCALAR)
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define SPV_NEON 1
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define SPV_AVX 1
+#elif defined(__SSE2__) || defined(__x86_64__)
+#include <emmintrin.h>
+#define SPV_SSE2 1
+#endif
+
+#define SPV_VECTOR (SPV_NEON || SPV_AVX || SPV_SSE2)
+
+
+//------------------------------------------------------------------------------
+// ### Vector primitives ###
+// One float vector type per instruction set, with just the operations the
+// kernels below need. The scalar fallback is a vector of width 1.
+//------------------------------------------------------------------------------
+#pragma mark - Vector primitives
+
+#if SPV_NEON
+
+typedef float32x4_t vfloat;
+static const int VWIDTH = 4;
+
+static inline vfloat vload(const float *p) { return vld1q_f32(p); }
+static inline void vstore(float *p, vfloat v) { vst1q_f32(p, v); }
+static inline vfloat vset(float f) { return vdupq_n_f32(f); }
+static inline vfloat vadd(vfloat a, vfloat b) { return vaddq_f32(a, b); }
+static inline vfloat vsub(vfloat a, vfloat b) { return vsubq_f32(a, b); }
+static inline vfloat vmul(vfloat a, vfloat b) { return vmulq_f32(a, b); }
+static inline vfloat vmin(vfloat a, vfloat b) { return vminq_f32(a, b); }
+static inline vfloat vmax(vfloat a, vfloat b) { return vmaxq_f32(a, b); }
+static inline vfloat vabs(vfloat a) { return vabsq_f32(a); }
+// a + b*c
+static inline vfloat vmadd(vfloat a, vfloat b, vfloat c) { return vfmaq_f32(a, b, c); }
+static inline vfloat vround(vfloat a) { return vrndnq_f32(a); }
+// magnitude of a with the sign of s
+static inline vfloat vcopysign(vfloat a, vfloat s) { return vbslq_f32(vdupq_n_u32(0x80000000), s, a); }
+// every lane of a equal to b's
+static inline bool vsame(vfloat a, vfloat b) { return vminvq_u32(vceqq_f32(a, b)) != 0; }
+// floor(a), also stored to index as integers
+static inline vfloat vfloori(vfloat a, int32_t *index)
+{
+    int32x4_t i = vcvtmq_s32_f32(a);
+    vst1q_s32(index, i);
+    return vcvtq_f32_s32(i);
+}
+
+#elif SPV_AVX
+
+typedef __m256 vfloat;
+static const int VWIDTH = 8;
+
+static inline vfloat vload(const float *p) { return _mm256_loadu_ps(p); }
+static inline void vstore(float *p, vfloat v) { _mm256_storeu_ps(p, v); }
+static inline vfloat vset(float f) { return _mm256_set1_ps(f); }
+static inline vfloat vadd(vfloat a, vfloat b) { return _mm256_add_ps(a, b); }
+static inline vfloat vsub(vfloat a, vfloat b) { return _mm256_sub_ps(a, b); }
+static inline vfloat vmul(vfloat a, vfloat b) { return _mm256_mul_ps(a, b); }
+static inline vfloat vmin(vfloat a, vfloat b) { return _mm256_min_ps(a, b); }
+static inline vfloat vmax(vfloat a, vfloat b) { return _mm256_max_ps(a, b); }
+static inline vfloat vabs(vfloat a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+#if defined(__FMA__)
+static inline vfloat vmadd(vfloat a, vfloat b, vfloat c) { return _mm256_fmadd_ps(b, c, a); }
+#else
+static inline vfloat vmadd(vfloat a, vfloat b, vfloat c) { return _mm256_add_ps(a, _mm256_mul_ps(b, c)); }
+#endif
+static inline vfloat vround(vfloat a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT|_MM_FROUND_NO_EXC); }
+static inline vfloat vcopysign(vfloat a, vfloat s)
+{
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    return _mm256_or_ps(_mm256_andnot_ps(sign, a), _mm256_and_ps(sign, s));
+}
+static inline bool vsame(vfloat a, vfloat b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_NEQ_UQ)) == 0; }
+static inline vfloat vfloori(vfloat a, int32_t *index)
+{
+    __m256 f = _mm256_floor_ps(a);
+    _mm256_storeu_si256((__m256i *) index, _mm256_cvttps_epi32(f));
+    return f;
+}
+
+#elif SPV_SSE2
+
+typedef __m128 vfloat;
+static const int VWIDTH = 4;
+
+static inline vfloat vload(const float *p) { return _mm_loadu_ps(p); }
+static inline void vstore(float *p, vfloat v) { _mm_storeu_ps(p, v); }
+static inline vfloat vset(float f) { return _mm_set1_ps(f); }
+static inline vfloat vadd(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+static inline vfloat vsub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+static inline vfloat vmul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+static inline vfloat vmin(vfloat a, vfloat b) { return _mm_min_ps(a, b); }
+static inline vfloat vmax(vfloat a, vfloat b) { return _mm_max_ps(a, b); }
+static inline vfloat vabs(vfloat a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline vfloat vmadd(vfloat a, vfloat b, vfloat c) { return _mm_add_ps(a, _mm_mul_ps(b, c)); }
+// round to nearest (even) via the default MXCSR rounding mode
+static inline vfloat vround(vfloat a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+static inline vfloat vcopysign(vfloat a, vfloat s)
+{
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    return _mm_or_ps(_mm_andnot_ps(sign, a), _mm_and_ps(sign, s));
+}
+static inline bool vsame(vfloat a, vfloat b) { return _mm_movemask_ps(_mm_cmpneq_ps(a, b)) == 0; }
+static inline vfloat vfloori(vfloat a, int32_t *index)
+{
+    // truncate, then step down where that rounded up (negative a)
+    __m128i i = _mm_cvttps_epi32(a);
+    __m128 t = _mm_cvtepi32_ps(i);
+    __m128i up = _mm_castps_si128(_mm_cmpgt_ps(t, a));
+    i = _mm_add_epi32(i, up);
+    _mm_storeu_si128((__m128i *) index, i);
+    return _mm_cvtepi32_ps(i);
+}
+
+#else
+
+typedef float vfloat;
+static const int VWIDTH = 1;
+
+static inline vfloat vload(const float *p) { return *p; }
+static inline void vstore(float *p, vfloat v) { *p = v; }
+static inline vfloat vset(float f) { return f; }
+static inline vfloat vadd(vfloat a, vfloat b) { return a+b; }
+static inline vfloat vsub(vfloat a, vfloat b) { return a-b; }
+static inline vfloat vmul(vfloat a, vfloat b) { return a*b; }
+static inline vfloat vmin(vfloat a, vfloat b) { return a < b ? a : b; }
+static inline vfloat vmax(vfloat a, vfloat b) { return a > b ? a : b; }
+static inline vfloat vabs(vfloat a) { return fabsf(a); }
+static inline vfloat vmadd(vfloat a, vfloat b, vfloat c) { return a+b*c; }
+static inline vfloat vround(vfloat a) { return rintf(a); }
+static inline vfloat vcopysign(vfloat a, vfloat s) { return copysignf(a, s); }
+static inline bool vsame(vfloat a, vfloat b) { return a == b; }
+static inline vfloat vfloori(vfloat a, int32_t *index)
+{
+    vfloat f = floorf(a);
+    *index = (int32_t) f;
+    return f;
+}
+
+#endif
+
+#if SPV_VECTOR
+// scalar overloads of the above, for kernels that finish off leftover lanes
+// one at a time (see the filter banks)
+static inline float vadd(float a, float b) { return a+b; }
+static inline float vsub(float a, float b) { return a-b; }
+static inline float vmul(float a, float b) { return a*b; }
+static inline float vmadd(float a, float b, float c) { return a+b*c; }
+static inline void vstore(float *p, float v) { *p = v; }
+static inline bool vsame(float a, float b) { return a == b; }
+#endif
+
+// load/broadcast as either vfloat or float
+template<typename V> static inline V vload_as(const float *p);
+template<typename V> static inline V vset_as(float f);
+template<> inline vfloat vload_as<vfloat>(const float *p) { return vload(p); }
+template<> inline vfloat vset_as<vfloat>(float f) { return vset(f); }
+#if SPV_VECTOR
+template<> inline float vload_as<float>(const float *p) { return *p; }
+template<> inline float vset_as<float>(float f) { return f; }
+#endif
+
+const char *spv_isa()
+{
+#if SPV_NEON
+    return "neon";
+#elif SPV_AVX
+    return "avx";
+#elif SPV_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+
+//------------------------------------------------------------------------------
+// ### Arithmetic ###
+//------------------------------------------------------------------------------
+#pragma mark - Arithmetic
+
+void spv_fill(float *dst, float value, int n)
+{
+    vfloat v = vset(value);
+    int i = 0;
+    for(; i+VWIDTH <= n; i += VWIDTH)
+        vstore(dst+i, v);
+    for(; i < n; i++)
+        dst[i] = value;
+}
+
+void spv_add(float *dst, const float *src, int n)
+{
+    int i = 0;
+    for(; i+VWIDTH <= n; i += VWIDTH)
+        vstore(dst+i, vadd(vload(dst+i), vload(src+i)));
+    for(; i < n; i++)
+        dst[i] += src[i];
+}
+
+void spv_mul(float *dst, const float *src, int n)
+{
+    int i = 0;
+    for(; i+VWIDTH <= n; i += VWIDTH)
+        vstore(dst+i, vmul(vload(dst+i), vload(src+i)));
+    for(; i < n; i++)
+        dst[i] *= src[i];
+}
+
+void spv_scale(float *dst, float gain, int n)
+{
+    vfloat g = vset(gain);
+    int i = 0;
+    for(; i+VWIDTH <= n; i += VWIDTH)
+        vstore(dst+i, vmul(vload(dst+i), g));
+    for(; i < n; i++)
+        dst[i] *= gain;
+}
+
+void spv_mac(float *dst, const float *src, float gain, int n)
+{
+    vfloat g = vset(gain);
+    int i = 0;
+    for(; i+VWIDTH <= n; i += VWIDTH)
+        vstore(dst+i, vmadd(vload(dst+i), vload(src+i), g));
+    for(; i < n; i++)
+        dst[i] += src[i]*gain;
+}
+
+void spv_muladd(float *dst, const float *a, const float *b, int n)
+{
+    int i = 0;
+    for(; i+VWIDTH <= n; i += VWIDTH)
+        vstore(dst+i, vmadd(vload(dst+i), vload(a+i), vload(b+i)));
+    for(; i < n; i++)
+        dst[i] += a[i]*b[i];
+}
+
+float spv_maxabs(const float *src, int n)
+{
+    vfloat m = vset(0);
+    int i = 0;
+    for(; i+VWIDTH <= n; i += VWIDTH)
+        m = vmax(m, vabs(vload(src+i)));
+
+    float lanes[VWIDTH];
+    vstore(lanes, m);
+    float max = 0;
+    for(int k = 0; k < VWIDTH; k++)
+        max = fmaxf(max, lanes[k]);
+    for(; i < n; i++)
+        max = fmaxf(max, fabsf(src[i]));
+
+    return max;
+}
+
+
+//------------------------------------------------------------------------------
+// ### Sine ###
+//------------------------------------------------------------------------------
+#pragma mark - Sine
+
+// Taylor coefficients of sin(2*pi*x); truncation error at x = 1/4 is ~6e-8
+static const float SIN_C1 = 6.28318530718f;
+static const float SIN_C3 = -41.3417022404f;
+static const float SIN_C5 = 81.6052492761f;
+static const float SIN_C7 = -76.7058597531f;
+static const float SIN_C9 = 42.0586939449f;
+static const float SIN_C11 = -15.0946425768f;
+
+template<typename V>
+static inline V _sin(V phase)
+{
+    // wrap to [-1/2, 1/2] cycle, then fold onto [0, 1/4] by symmetry
+    V r = vsub(phase, vround(phase));
+    V a = vabs(r);
+    a = vmin(a, vsub(vset(0.5f), a));
+    V a2 = vmul(a, a);
+
+    V p = vset(SIN_C11);
+    p = vmadd(vset(SIN_C9), p, a2);
+    p = vmadd(vset(SIN_C7), p, a2);
+    p = vmadd(vset(SIN_C5), p, a2);
+    p = vmadd(vset(SIN_C3), p, a2);
+    p = vmadd(vset(SIN_C1), p, a2);
+
+    return vcopysign(vmul(p, a), r);
+}
+
+float spv_sinf(float phase)
+{
+    float r = phase-rintf(phase);
+    float a = fabsf(r);
+    a = fminf(a, 0.5f-a);
+    float a2 = a*a;
+
+    float p = SIN_C11;
+    p = SIN_C9 + p*a2;
+    p = SIN_C7 + p*a2;
+    p = SIN_C5 + p*a2;
+    p = SIN_C3 + p*a2;
+    p = SIN_C1 + p*a2;
+
+    return copysignf(p*a, r);
+}
+
+void spv_sin(float *dst, const float *phase, int n)
+{
+    int i = 0;
+    for(; i+VWIDTH <= n; i += VWIDTH)
+        vstore(dst+i, _sin(vload(phase+i)));
+    for(; i < n; i++)
+        dst[i] = spv_sinf(phase[i]);
+}
+
+float spv_sinosc(float *dst, const float *increment, float phase, int n)
+{
+    phase = spv_phasor(dst, increment, phase, n);
+    spv_sin(dst, dst, n);
+    
+    return phase;
+}
+
+void spv_panlaw(float *left, float *right, const float *pan, int n)
+{
+    // pi/4*(pan-1) radians, in cycles
+    int i = 0;
+    for(; i+VWIDTH <= n; i += VWIDTH)
+    {
+        vfloat phase = vmul(vsub(vload(pan+i), vset(1)), vset(0.125f));
+        vstore(right+i, vabs(_sin(phase)));
+        vstore(left+i, vabs(_sin(vadd(phase, vset(0.25f)))));
+    }
+    for(; i < n; i++)
+    {
+        float phase = (pan[i]-1)*0.125f;
+        right[i] = fabsf(spv_sinf(phase));
+        left[i] = fabsf(spv_sinf(phase+0.25f));
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// ### spv_noise ###
+//------------------------------------------------------------------------------
+#pragma mark - spv_noise
+
+void spv_noise_seed(spv_noise &noise, uint32_t seed)
+{
+    // decorrelate the lanes (splitmix32-style hash of seed+lane)
+    for(int lane = 0; lane < 8; lane++)
+    {
+        uint32_t x = seed + 0x9E3779B9u*(lane+1);
+        x = (x ^ (x >> 16))*0x85EBCA6Bu;
+        x = (x ^ (x >> 13))*0xC2B2AE35u;
+        x ^= x >> 16;
+        noise.state[lane] = x ? x : 0x6D2B79F5u;
+    }
+}
+
+// one step of all eight generators, as floats in [-1, 1): the top 23 bits
+// become the mantissa of a float in [2, 4)
+static inline void _noise8(uint32_t *state, float *dst)
+{
+#if SPV_NEON
+    for(int half = 0; half < 8; half += 4)
+    {
+        uint32x4_t x = vld1q_u32(state+half);
+        x = veorq_u32(x, vshlq_n_u32(x, 13));
+        x = veorq_u32(x, vshrq_n_u32(x, 17));
+        x = veorq_u32(x, vshlq_n_u32(x, 5));
+        vst1q_u32(state+half, x);
+        uint32x4_t bits = vorrq_u32(vshrq_n_u32(x, 9), vdupq_n_u32(0x40000000));
+        vst1q_f32(dst+half, vsubq_f32(vreinterpretq_f32_u32(bits), vdupq_n_f32(3)));
+    }
+#elif SPV_AVX || SPV_SSE2
+    for(int half = 0; half < 8; half += 4)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *) (state+half));
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+        _mm_storeu_si128((__m128i *) (state+half), x);
+        __m128i bits = _mm_or_si128(_mm_srli_epi32(x, 9), _mm_set1_epi32(0x40000000));
+        _mm_storeu_ps(dst+half, _mm_sub_ps(_mm_castsi128_ps(bits), _mm_set1_ps(3)));
+    }
+#else
+    for(int lane = 0; lane < 8; lane++)
+    {
+        uint32_t x = state[lane];
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        state[lane] = x;
+        uint32_t bits = (x >> 9) | 0x40000000;
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        dst[lane] = f-3;
+    }
+#endif
+}
+
+void spv_noise_render(spv_noise &noise, float *dst, int n)
+{
+    int i = 0;
+    for(; i+8 <= n; i += 8)
+        _noise8(noise.state, dst+i);
+
+    if(i < n)
+    {
+        float tail[8];
+        _noise8(noise.state, tail);
+        memcpy(dst+i, tail, sizeof(float)*(n-i));
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// ### Wavetables ###
+//------------------------------------------------------------------------------
+#pragma mark - Wavetables
+
+float spv_phasor(float *dst, const float *increment, float phase, int n)
+{
+    // increment may alias dst, so read it before overwriting
+    int i = 0;
+    while(i < n)
+    {
+        int end = i+8 < n ? i+8 : n;
+        for(; i < end; i++)
+        {
+            float inc = increment[i];
+            dst[i] = phase;
+            phase += inc;
+        }
+        phase = clipunit(phase);
+    }
+    
+    return phase;
+}
+
+void spv_wavetable(float *dst, const float *table, int size, const float *phase, int n)
+{
+    // masking the index wraps phase outside [0, 1) (and keeps garbage phase
+    // inside the table); the guard sample saves wrapping index+1
+    const int32_t mask = size-1;
+    vfloat vsize = vset((float) size);
+    int i = 0;
+    for(; i+VWIDTH <= n; i += VWIDTH)
+    {
+        int32_t index[VWIDTH];
+        vfloat pos = vmul(vload(phase+i), vsize);
+        vfloat fract = vsub(pos, vfloori(pos, index));
+        
+        float a[VWIDTH], b[VWIDTH];
+        for(int k = 0; k < VWIDTH; k++)
+        {
+            const float *p = table + (index[k] & mask);
+            a[k] = p[0];
+            b[k] = p[1];
+        }
+        
+        vfloat va = vload(a);
+        vstore(dst+i, vmadd(va, vsub(vload(b), va), fract));
+    }
+    for(; i < n; i++)
+    {
+        float pos = phase[i]*size;
+        float whole = floorf(pos);
+        const float *p = table + ((int32_t) whole & mask);
+        dst[i] = p[0] + (p[1]-p[0])*(pos-whole);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// ### Interleaving ###
+//------------------------------------------------------------------------------
+#pragma mark - Interleaving
+
+#if SPV_NEON
+
+typedef float32x4_t vfloat4;
+static inline vfloat4 vload4(const float *p) { return vld1q_f32(p); }
+static inline void vstore4(float *p, vfloat4 v) { vst1q_f32(p, v); }
+static inline void vtranspose4(vfloat4 &a0, vfloat4 &a1, vfloat4 &a2, vfloat4 &a3)
+{
+    float32x4x2_t t01 = vtrnq_f32(a0, a1);
+    float32x4x2_t t23 = vtrnq_f32(a2, a3);
+    a0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    a1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    a2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    a3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+#elif SPV_AVX || SPV_SSE2
+
+typedef __m128 vfloat4;
+static inline vfloat4 vload4(const float *p) { return _mm_loadu_ps(p); }
+static inline void vstore4(float *p, vfloat4 v) { _mm_storeu_ps(p, v); }
+static inline void vtranspose4(vfloat4 &a0, vfloat4 &a1, vfloat4 &a2, vfloat4 &a3)
+{
+    _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+}
+
+#endif
+
+void spv_interleave(float *dst, int stride, const float *const *src, int numChannels, int n)
+{
+    int c = 0;
+#if SPV_VECTOR
+    // 4x4 tiles: four frames of four channels at a time
+    for(; c+4 <= numChannels; c += 4)
+    {
+        int i = 0;
+        for(; i+4 <= n; i += 4)
+        {
+            vfloat4 a0 = vload4(src[c]+i), a1 = vload4(src[c+1]+i);
+            vfloat4 a2 = vload4(src[c+2]+i), a3 = vload4(src[c+3]+i);
+            vtranspose4(a0, a1, a2, a3);
+            vstore4(dst+i*stride+c, a0);
+            vstore4(dst+(i+1)*stride+c, a1);
+            vstore4(dst+(i+2)*stride+c, a2);
+            vstore4(dst+(i+3)*stride+c, a3);
+        }
+        for(; i < n; i++)
+        {
+            for(int k = 0; k < 4; k++)
+                dst[i*stride+c+k] = src[c+k][i];
+        }
+    }
+#endif
+    for(; c < numChannels; c++)
+    {
+        for(int i = 0; i < n; i++)
+            dst[i*stride+c] = src[c][i];
+    }
+}
+
+void spv_deinterleave(float *const *dst, const float *src, int stride, int numChannels, int n)
+{
+    int c = 0;
+#if SPV_VECTOR
+    for(; c+4 <= numChannels; c += 4)
+    {
+        int i = 0;
+        for(; i+4 <= n; i += 4)
+        {
+            vfloat4 a0 = vload4(src+i*stride+c), a1 = vload4(src+(i+1)*stride+c);
+            vfloat4 a2 = vload4(src+(i+2)*stride+c), a3 = vload4(src+(i+3)*stride+c);
+            vtranspose4(a0, a1, a2, a3);
+            vstore4(dst[c]+i, a0);
+            vstore4(dst[c+1]+i, a1);
+            vstore4(dst[c+2]+i, a2);
+            vstore4(dst[c+3]+i, a3);
+        }
+        for(; i < n; i++)
+        {
+            for(int k = 0; k < 4; k++)
+                dst[c+k][i] = src[i*stride+c+k];
+        }
+    }
+#endif
+    for(; c < numChannels; c++)
+    {
+        for(int i = 0; i < n; i++)
+            dst[c][i] = src[i*stride+c];
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// ### Filter banks ###
+//------------------------------------------------------------------------------
+#pragma mark - Filter banks
+
+// Transposed direct form II; coefficients b0, b1, b2, a1, a2
+struct _Biquad
+{
+    enum { NUM_COEFFICIENTS = 5, NUM_STATES = 2, NUM_OUTPUTS = 1 };
+    
+    template<typename V>
+    static inline void tick(const V *c, V *s, V x, V *y)
+    {
+        V yn = vmadd(s[0], c[0], x);
+        s[0] = vmadd(vsub(s[1], vmul(c[3], yn)), c[1], x);
+        s[1] = vsub(vmul(c[2], x), vmul(c[4], yn));
+        y[0] = yn;
+    }
+};
+
+// Chamberlin state variable filter; coefficients f, q
+struct _SVF
+{
+    enum { NUM_COEFFICIENTS = 2, NUM_STATES = 2, NUM_OUTPUTS = 4 };
+    
+    template<typename V>
+    static inline void tick(const V *c, V *s, V x, V *y)
+    {
+        V lpf = vmadd(s[1], c[0], s[0]);
+        V hpf = vsub(vsub(x, lpf), vmul(c[1], s[0]));
+        V bpf = vmadd(s[0], c[0], hpf);
+        y[0] = lpf;
+        y[1] = hpf;
+        y[2] = bpf;
+        y[3] = vadd(hpf, lpf);
+        s[0] = bpf;
+        s[1] = lpf;
+    }
+};
+
+// the lanes of one vector (or one lane, for V = float) starting at lane
+template<class Filter, typename V>
+static void _filterbank(float *coeff, float *state, const float *target, const float *in,
+                        float *const *out, int stride, int lane, int n)
+{
+    const int NC = Filter::NUM_COEFFICIENTS;
+    const int NS = Filter::NUM_STATES;
+    const int NO = Filter::NUM_OUTPUTS;
+    
+    V c[NC], d[NC], t[NC], s[NS], y[NO];
+    for(int k = 0; k < NC; k++)
+        c[k] = vload_as<V>(coeff+k*stride+lane);
+    for(int k = 0; k < NS; k++)
+        s[k] = vload_as<V>(state+k*stride+lane);
+    
+    for(int start = 0, seg = 0; start < n; start += SPV_BANK_INTERVAL, seg++)
+    {
+        int end = start+SPV_BANK_INTERVAL < n ? start+SPV_BANK_INTERVAL : n;
+        
+        int i = start;
+        bool ramp = false;
+        for(int k = 0; k < NC; k++)
+        {
+            t[k] = vload_as<V>(target+(seg*NC+k)*stride+lane);
+            ramp = ramp || !vsame(t[k], c[k]);
+        }
+        
+        if(ramp)
+        {
+            // step towards the targets each frame, landing on them exactly
+            // at the last
+            V scale = vset_as<V>(1.0f/(end-start));
+            for(int k = 0; k < NC; k++)
+                d[k] = vmul(vsub(t[k], c[k]), scale);
+            
+            for(; i < end-1; i++)
+            {
+                for(int k = 0; k < NC; k++)
+                    c[k] = vadd(c[k], d[k]);
+                
+                Filter::tick(c, s, vload_as<V>(in+i*stride+lane), y);
+                for(int o = 0; o < NO; o++)
+                    vstore(out[o]+i*stride+lane, y[o]);
+            }
+            
+            for(int k = 0; k < NC; k++)
+                c[k] = t[k];
+        }
+        
+        for(; i < end; i++)
+        {
+            Filter::tick(c, s, vload_as<V>(in+i*stride+lane), y);
+            for(int o = 0; o < NO; o++)
+                vstore(out[o]+i*stride+lane, y[o]);
+        }
+    }
+    
+    for(int k = 0; k < NC; k++)
+        vstore(coeff+k*stride+lane, c[k]);
+    for(int k = 0; k < NS; k++)
+        vstore(state+k*stride+lane, s[k]);
+}
+
+template<class Filter>
+static void _filterbank(float *coeff, float *state, const float *target, const float *in,
+                        float *const *out, int stride, int n)
+{
+    int lane = 0;
+    for(; lane+VWIDTH <= stride; lane += VWIDTH)
+        _filterbank<Filter, vfloat>(coeff, state, target, in, out, stride, lane, n);
+#if SPV_VECTOR
+    for(; lane < stride; lane++)
+        _filterbank<Filter, float>(coeff, state, target, in, out, stride, lane, n);
+#endif
+}
+
+void spv_biquad_bank(float *coeff, float *state, const float *target, const float *in, float *out, int stride, int n)
+{
+    _filterbank<_Biquad>(coeff, state, target, in, &out, stride, n);
+}
+
+void spv_svf_bank(float *coeff, float *state, const float *target, const float *in, float *const out[4], int stride, int n)
+{
+    _filterbank<_SVF>(coeff, state, target, in, out, stride, n);
+}
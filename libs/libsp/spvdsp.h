@@ -0,0 +1,113 @@
+//
+//  spvdsp.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+//  Block DSP kernels, vectorized with NEON (arm64), SSE2 or AVX where
+//  available and plain loops elsewhere. All take a frame count n and work for
+//  any n; in-place operation (dst == src) is fine. Pointers need no particular
+//  alignment. tools/agrender's agdspcheck (make check) tests each instruction
+//  set against scalar and libm references, within the tolerances below.
+//
+
+#ifndef spvdsp_h
+#define spvdsp_h
+
+#include <stdint.h>
+
+/* instruction set the kernels were compiled for ("neon", "avx", "sse2", "scalar") */
+const char *spv_isa();
+
+/* dst[i] = value */
+void spv_fill(float *dst, float value, int n);
+/* dst[i] += src[i] */
+void spv_add(float *dst, const float *src, int n);
+/* dst[i] *= src[i] */
+void spv_mul(float *dst, const float *src, int n);
+/* dst[i] *= gain */
+void spv_scale(float *dst, float gain, int n);
+/* dst[i] += src[i]*gain */
+void spv_mac(float *dst, const float *src, float gain, int n);
+/* dst[i] += a[i]*b[i] */
+void spv_muladd(float *dst, const float *a, const float *b, int n);
+/* largest |src[i]|, or 0 if n is 0 */
+float spv_maxabs(const float *src, int n);
+
+/* dst[i] = sin(2*pi*phase[i]), for phase in cycles (any range within +/-2^23).
+   Degree-11 odd polynomial after folding to a quarter cycle; absolute error
+   is within 3e-7 of sinf() */
+void spv_sin(float *dst, const float *phase, int n);
+/* scalar version of the same approximation, for single values */
+float spv_sinf(float phase);
+/* sine oscillator: dst[i] = sin(2*pi*phase), advancing phase by increment[i]
+   (cycles) after each sample, as spv_phasor; returns the phase following the
+   block, in [0, 1) */
+float spv_sinosc(float *dst, const float *increment, float phase, int n);
+
+/* phase accumulator: dst[i] = phase, advancing phase by increment[i] (cycles)
+   after each sample; returns the phase following the block, in [0, 1). Phase
+   is only wrapped every few samples, keeping the per-sample dependency to a
+   single add, so dst may stray a little outside [0, 1) */
+float spv_phasor(float *dst, const float *increment, float phase, int n);
+/* dst[i] = table at phase[i] cycles, linearly interpolated. table holds one
+   cycle of size samples (a power of two), followed by a copy of table[0];
+   phase wraps, so any range works */
+void spv_wavetable(float *dst, const float *table, int size, const float *phase, int n);
+
+/* equal-power pan law of AGAudioPannerNode, for pan in [-1, 1]:
+   left[i] = |cos(pi/4*(pan[i]-1))|, right[i] = |sin(pi/4*(pan[i]-1))| */
+void spv_panlaw(float *left, float *right, const float *pan, int n);
+
+//------------------------------------------------------------------------------
+// ### spv_noise ###
+// White noise in [-1, 1) from eight interleaved xorshift32 generators, so that
+// four or eight lanes can advance at once. Output is identical whichever
+// kernel is compiled in; blocks are generated in multiples of eight samples,
+// with any extra discarded.
+//------------------------------------------------------------------------------
+#pragma mark - spv_noise
+
+struct spv_noise
+{
+    uint32_t state[8];
+};
+
+/* seed must be nonzero */
+void spv_noise_seed(spv_noise &noise, uint32_t seed);
+/* dst[i] = uniform random value in [-1, 1) */
+void spv_noise_render(spv_noise &noise, float *dst, int n);
+
+//------------------------------------------------------------------------------
+// ### Filter banks ###
+// Many independent recursive filters run side by side, one per vector lane.
+// Everything is structure-of-arrays with stride floats between consecutive
+// values of the same lane (stride is at least the number of filters; lane l's
+// values are at offset l):
+//   coeff[k*stride]                   current coefficient k, updated on return
+//   state[k*stride]                   filter state k, updated on return
+//   target[(seg*NC+k)*stride]         coefficient k to reach by the end of
+//                                     frames [seg*SPV_BANK_INTERVAL,
+//                                     (seg+1)*SPV_BANK_INTERVAL), ramping
+//                                     linearly from the previous value
+//   in[i*stride], out[i*stride]       frame i, i.e. channel-interleaved
+// With stride 1, this is a single filter over plain buffers.
+//------------------------------------------------------------------------------
+#pragma mark - Filter banks
+
+#define SPV_BANK_INTERVAL (16)
+
+/* dst[i*stride+c] = src[c][i], for each of numChannels channels */
+void spv_interleave(float *dst, int stride, const float *const *src, int numChannels, int n);
+/* dst[c][i] = src[i*stride+c], for each of numChannels channels */
+void spv_deinterleave(float *const *dst, const float *src, int stride, int numChannels, int n);
+
+/* transposed direct form II biquads; NC = 5 coefficients (b0, b1, b2, a1, a2),
+   2 states */
+void spv_biquad_bank(float *coeff, float *state, const float *target, const float *in, float *out, int stride, int n);
+/* Chamberlin state variable filters; NC = 2 coefficients (f = 2*sin(pi*fc/sr),
+   q = 1/Q), 2 states; out holds the low-, high-, band-pass and notch outputs */
+void spv_svf_bank(float *coeff, float *state, const float *target, const float *in, float *const out[4], int stride, int n);
+
+#endif /* spvdsp_h */
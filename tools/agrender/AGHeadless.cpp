@@ -0,0 +1,246 @@
+//
+//  AGHeadless.cpp
+//  agrender
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#include "AGHeadless.h"
+#include "AGAudioEngine.h"
+#include "AGAudioWorkerPool.h"
+#include "AGAudioManager.h"
+#include "AGFileManager.h"
+#include "AGViewController.h"
+#include "AGUINodeEditor.h"
+#include "TexFont.h"
+#include "Texture.h"
+#include "ES2Render.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+
+//------------------------------------------------------------------------------
+// ### AGHeadless ###
+//------------------------------------------------------------------------------
+#pragma mark - AGHeadless
+
+static std::string g_documentDirectory = ".";
+
+AGAudioEngine &AGHeadless::engine()
+{
+    // nodes are rendered on the thread that builds the graph, so there is no
+    // audio thread to hand snapshots off to
+    static AGAudioEngine *s_engine = new AGAudioEngine(AGAudioWorkerPool::defaultNumWorkers(), false);
+    return *s_engine;
+}
+
+void AGHeadless::setDocumentDirectory(const std::string &directory)
+{
+    g_documentDirectory = directory;
+}
+
+const std::string &AGHeadless::documentDirectory()
+{
+    return g_documentDirectory;
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGAudioManager_ ###
+//------------------------------------------------------------------------------
+#pragma mark - AGAudioManager_
+
+AGAudioManager_ &AGAudioManager_::instance()
+{
+    static AGAudioManager_ *s_instance = nullptr;
+    if(s_instance == nullptr)
+        s_instance = new AGAudioManager_(NULL);
+
+    return *s_instance;
+}
+
+AGAudioManager_::AGAudioManager_(AGAudioManager *audioManager)
+{
+    m_audioManager = audioManager;
+}
+
+// offline renders capture their output directly
+void AGAudioManager_::startSessionRecording() { }
+void AGAudioManager_::stopSessionRecording() { }
+
+void AGAudioManager_::addAudioRateProcessor(AGAudioRateProcessor *processor)
+{
+    AGHeadless::engine().addAudioRateProcessor(processor);
+}
+
+void AGAudioManager_::removeAudioRateProcessor(AGAudioRateProcessor *processor)
+{
+    AGHeadless::engine().removeAudioRateProcessor(processor);
+}
+
+void AGAudioManager_::addCapturer(AGAudioCapturer *capturer)
+{
+    AGHeadless::engine().addCapturer(capturer);
+}
+
+void AGAudioManager_::removeCapturer(AGAudioCapturer *capturer)
+{
+    AGHeadless::engine().removeCapturer(capturer);
+}
+
+void AGAudioManager_::addEventHandler(AGAudioEventHandler *handler)
+{
+    AGHeadless::engine().addEventHandler(handler);
+}
+
+void AGAudioManager_::removeEventHandler(AGAudioEventHandler *handler)
+{
+    AGHeadless::engine().removeEventHandler(handler);
+}
+
+void AGAudioManager_::graphDidChange()
+{
+    AGHeadless::engine().graphDidChange();
+}
+
+void AGAudioManager_::beginGraphEdit()
+{
+    AGHeadless::engine().beginGraphEdit();
+}
+
+void AGAudioManager_::endGraphEdit()
+{
+    AGHeadless::engine().endGraphEdit();
+}
+
+void AGAudioManager_::retire(const std::function<void ()> &free)
+{
+    AGHeadless::engine().retire(free);
+}
+
+AGAudioOutputDestination *AGAudioManager_::masterOut()
+{
+    return AGHeadless::engine().masterOut();
+}
+
+
+//------------------------------------------------------------------------------
+// ### AGFileManager ###
+//------------------------------------------------------------------------------
+#pragma mark - AGFileManager
+
+AGFileManager &AGFileManager::instance()
+{
+    static AGFileManager s_manager;
+    return s_manager;
+}
+
+AGFileManager::AGFileManager()
+{
+    m_soundfileDirectory = AGHeadless::documentDirectory();
+    m_userDataDirectory = AGHeadless::documentDirectory();
+    m_documentDirectory = AGHeadless::documentDirectory();
+}
+
+AGFileManager::~AGFileManager()
+{ }
+
+const string &AGFileManager::soundfileDirectory()
+{
+    return m_soundfileDirectory;
+}
+
+const string &AGFileManager::userDataDirectory()
+{
+    return m_userDataDirectory;
+}
+
+const string &AGFileManager::documentDirectory()
+{
+    return m_documentDirectory;
+}
+
+bool AGFileManager::fileHasExtension(const string &filepathOrName, const string &extension)
+{
+    if(filepathOrName.length() == 0 || extension.length() == 0)
+        return false;
+    const auto pos = filepathOrName.rfind(extension);
+    bool hasExtensionAtEnd = (pos == filepathOrName.length()-extension.length());
+    bool hasDotBeforeExtension = (pos > 0 && filepathOrName[pos-1] == '.');
+    return hasExtensionAtEnd && hasDotBeforeExtension;
+}
+
+bool AGFileManager::filenameExists(const string &filename)
+{
+    std::string filepath = documentDirectory() + "/" + filename;
+    struct stat st;
+    return stat(filepath.c_str(), &st) == 0;
+}
+
+vector<string> AGFileManager::listDirectory(const string &directory)
+{
+    vector<string> pathList;
+    DIR *dir = opendir(directory.c_str());
+    if(dir == NULL)
+        return pathList;
+
+    while(struct dirent *entry = readdir(dir))
+    {
+        string name = entry->d_name;
+        if(name != "." && name != "..")
+            pathList.push_back(name);
+    }
+    closedir(dir);
+
+    return pathList;
+}
+
+
+//------------------------------------------------------------------------------
+// ### Touch UI and graphics ###
+// Never reached without a view; these only satisfy the linker.
+//------------------------------------------------------------------------------
+#pragma mark - Touch UI and graphics
+
+void AGViewController_::addNodeToTopLevel(AGNode *node) { }
+AGNode *AGViewController_::nodeWithUUID(const std::string &uuid) { return NULL; }
+
+void AGUINodeEditor::pin(bool _pin) { }
+
+TexFont::TexFont(const std::string &filepath, int size) : m_tex(0) { }
+void TexFont::render(const std::string &text, const GLcolor4f &color,
+                     const GLKMatrix4 &modelView, const GLKMatrix4 &proj) { }
+void TexFont::renderTexmap(const GLcolor4f &color, const GLKMatrix4 &modelView, const GLKMatrix4 &proj) { }
+float TexFont::width() { return 0; }
+float TexFont::width(const std::string &text) { return 0; }
+float TexFont::height() { return 0; }
+float TexFont::ascender() { return 0; }
+float TexFont::descender() { return 0; }
+
+GLuint loadTexture(const char *name) { return 0; }
+GLuint loadOrRetrieveTexture(const char *name) { return 0; }
+
+void genVertexArrayAndBuffer(const GLuint size, GLvertex3f * const geo,
+                             GLuint &vertexArray, GLuint &vertexBuffer,
+                             const GLcolor4f &color, const GLvertex3f &normal)
+{
+    vertexArray = 0;
+    vertexBuffer = 0;
+}
+
+void genVertexArrayAndBuffer(const GLuint size, GLvncprimf * const geo,
+                             GLuint &vertexArray, GLuint &vertexBuffer)
+{
+    vertexArray = 0;
+    vertexBuffer = 0;
+}
+
+void genVertexArrayAndBuffer(const GLuint size, GLgeoprimf * const geo,
+                             GLuint &vertexArray, GLuint &vertexBuffer)
+{
+    vertexArray = 0;
+    vertexBuffer = 0;
+}
+
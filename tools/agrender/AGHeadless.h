@@ -0,0 +1,35 @@
+//
+//  AGHeadless.h
+//  agrender
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+
+#pragma once
+
+#include <string>
+
+class AGAudioEngine;
+
+//------------------------------------------------------------------------------
+// ### AGHeadless ###
+// Platform layer for running Auragraph's node graph without the app: an
+// offline audio engine in place of AGAudioManager, a plain directory in place
+// of the app's Documents folder, and no-op stand-ins for the touch UI.
+//------------------------------------------------------------------------------
+#pragma mark - AGHeadless
+
+class AGHeadless
+{
+public:
+    /* offline engine that AGAudioManager_ forwards to; nothing renders unless
+       the caller calls render() on it */
+    static AGAudioEngine &engine();
+
+    /* directory standing in for the app's Documents folder (sound files,
+       saved documents); call before anything touches AGFileManager */
+    static void setDocumentDirectory(const std::string &directory);
+    static const std::string &documentDirectory();
+};
+
@@ -0,0 +1,51 @@
+//
+//  AGHeadlessDocument.cpp
+//  agrender
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+//  Where AGDocument keeps documents in headless builds, which can't ask
+//  Foundation; reading and writing them is AGDocument.mm's.
+//
+
+#include "AGDocument.h"
+#include "AGHeadless.h"
+
+#include <sys/stat.h>
+
+
+//------------------------------------------------------------------------------
+// ### AGDocument ###
+//------------------------------------------------------------------------------
+#pragma mark - AGDocument
+
+static string filenameForTitle(const string &title)
+{
+    return AGHeadless::documentDirectory() + "/" + title + ".json";
+}
+
+void AGDocument::load(const string &title)
+{
+    m_title = title;
+
+    loadFromPath(filenameForTitle(m_title));
+}
+
+void AGDocument::save() const
+{
+    saveToPath(filenameForTitle(m_title));
+}
+
+void AGDocument::saveTo(const string &title)
+{
+    m_title = title;
+    save();
+}
+
+bool AGDocument::existsForTitle(const string &title)
+{
+    struct stat st;
+    return stat(filenameForTitle(title).c_str(), &st) == 0;
+}
+
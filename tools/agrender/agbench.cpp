@@ -0,0 +1,265 @@
+//
+//  agbench.cpp
+//  agrender
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+//  Runs AGAudioNodeBenchmark over the audio node types, reporting the DSP cost
+//  of each per sample at several block sizes, with audio- and control-rate
+//  inputs.
+//
+//    agbench [filter] [-t seconds] [-b blocksize]...
+//    agbench -f [filter] [-t seconds] [-b blocksize]...
+//    agbench -c [-t seconds]
+//    agbench -s seconds
+//    agbench -v [-t seconds] [-b blocksize]...
+//    agbench -q [-t seconds] [-b blocksize]...
+//    agbench -r seconds [-x speed]
+//    agbench -p [-t seconds] [patch.json]...
+//    agbench -a
+//    agbench -l [documents]
+//    agbench -g [-t seconds]
+//
+//  Only node types whose name contains filter are run. -t sets the minimum
+//  time spent on each benchmark; -b (repeatable) replaces the default block
+//  sizes of 64, 256 and 1024. Built with RT_ALLOC_GUARD, also reports any
+//  allocations the nodes make while rendering. -f times filter node types in
+//  filter banks, against the same filters rendered separately. -c runs
+//  AGControlBusBenchmark instead, reporting control messages delivered per
+//  second. -s runs AGSoundFileBenchmark, streaming a sound file of the given
+//  length and reporting the memory it takes. -v times a polyphonic composite
+//  with different numbers of notes held. -q times a patch of many voices, few
+//  of them sounding, with dormant nodes skipped and without. -r runs
+//  AGAudioRecorderBenchmark, recording a session of the given length under
+//  load (fed at -x times real time) and checking that nothing was dropped.
+//  -p runs AGDocumentBenchmark, timing loading and saving the given patches
+//  (by default, those in ../../patches) and a large generated one. -a edits a
+//  500-node document for a few seconds of 60 fps frames with AGDocumentAutosave
+//  saving it, reporting the main thread's time per frame against saving the
+//  whole document there. -l lists a library of generated documents (1000 by
+//  default) with AGDocumentIndex, against loading each of them. -g runs
+//  AGHitTestBenchmark, hit-testing a canvas of 1000 nodes and 10000 freedraws
+//  through AGGraphManager's spatial indexes, against walking all of them.
+//
+
+#include "AGAudioNodeBenchmark.h"
+#include "AGAudioRecorderBenchmark.h"
+#include "AGControlBusBenchmark.h"
+#include "AGDocumentBenchmark.h"
+#include "AGHitTestBenchmark.h"
+#include "AGSoundFileBenchmark.h"
+#include "AGAudioNode.h"
+#include "AGDef.h"
+#include "RealtimeAllocGuard.h"
+
+#include "Stk.h"
+
+#include <glob.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+
+static void usage()
+{
+    fprintf(stderr, "usage: agbench [filter] [-t seconds] [-b blocksize]...\n");
+    fprintf(stderr, "       agbench -f [filter] [-t seconds] [-b blocksize]...\n");
+    fprintf(stderr, "       agbench -c [-t seconds]\n");
+    fprintf(stderr, "       agbench -s seconds\n");
+    fprintf(stderr, "       agbench -v [-t seconds] [-b blocksize]...\n");
+    fprintf(stderr, "       agbench -q [-t seconds] [-b blocksize]...\n");
+    fprintf(stderr, "       agbench -r seconds [-x speed]\n");
+    fprintf(stderr, "       agbench -p [-t seconds] [patch.json]...\n");
+    fprintf(stderr, "       agbench -a\n");
+    fprintf(stderr, "       agbench -l [documents]\n");
+    fprintf(stderr, "       agbench -g [-t seconds]\n");
+}
+
+int main(int argc, const char **argv)
+{
+    string filter;
+    vector<string> patches;
+    bool documents = false;
+    bool autosave = false;
+    int libraryDocuments = 0;
+    bool hitTest = false;
+    double minTime = 0.25;
+    vector<int> blockSizes;
+    bool controlBus = false;
+    bool filterBanks = false;
+    bool voices = false;
+    bool silence = false;
+    double soundFileSeconds = 0;
+    double recordSeconds = 0;
+    double recordSpeed = 1;
+
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if(arg == "-t" && i+1 < argc)
+            minTime = atof(argv[++i]);
+        else if(arg == "-c")
+            controlBus = true;
+        else if(arg == "-f")
+            filterBanks = true;
+        else if(arg == "-v")
+            voices = true;
+        else if(arg == "-q")
+            silence = true;
+        else if(arg == "-p")
+            documents = true;
+        else if(arg == "-a")
+            autosave = true;
+        else if(arg == "-l")
+            libraryDocuments = (i+1 < argc && argv[i+1][0] != '-') ? atoi(argv[++i]) : 1000;
+        else if(arg == "-g")
+            hitTest = true;
+        else if(arg == "-s" && i+1 < argc)
+            soundFileSeconds = atof(argv[++i]);
+        else if(arg == "-r" && i+1 < argc)
+            recordSeconds = atof(argv[++i]);
+        else if(arg == "-x" && i+1 < argc)
+            recordSpeed = atof(argv[++i]);
+        else if(arg == "-b" && i+1 < argc)
+            blockSizes.push_back(atoi(argv[++i]));
+        else if(arg.length() && arg[0] != '-' && documents)
+            patches.push_back(arg);
+        else if(arg.length() && arg[0] != '-' && filter.length() == 0)
+            filter = arg;
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if(blockSizes.size() == 0)
+        blockSizes = AGAudioNodeBenchmark::defaultBlockSizes();
+
+    for(int blockSize : blockSizes)
+    {
+        if(blockSize <= 0 || blockSize > AUDIO_BUFFER_MAX)
+        {
+            fprintf(stderr, "agbench: error: block size must be between 1 and %i\n", AUDIO_BUFFER_MAX);
+            return 1;
+        }
+    }
+
+    if(minTime <= 0 || recordSpeed <= 0)
+    {
+        usage();
+        return 1;
+    }
+
+    stk::Stk::setSampleRate(AGAudioNode::sampleRate());
+
+    if(controlBus)
+    {
+        AGControlBusBenchmark::runAll(minTime);
+        return 0;
+    }
+
+    if(soundFileSeconds > 0)
+    {
+        const char *tmpdir = getenv("TMPDIR");
+        string path = string(tmpdir ? tmpdir : "/tmp") + "/agbench-" + std::to_string(getpid()) + ".wav";
+        AGSoundFileBenchmark::runAll(path, soundFileSeconds);
+        return 0;
+    }
+
+    if(documents)
+    {
+        if(patches.size() == 0)
+        {
+            glob_t g;
+            if(glob("../../patches/*.json", 0, NULL, &g) == 0)
+                patches.assign(g.gl_pathv, g.gl_pathv+g.gl_pathc);
+            globfree(&g);
+        }
+        
+        const char *tmpdir = getenv("TMPDIR");
+        AGDocumentBenchmark::runAll(patches, tmpdir ? tmpdir : "/tmp", minTime);
+        return 0;
+    }
+
+    if(autosave)
+    {
+        const char *tmpdir = getenv("TMPDIR");
+        string path = string(tmpdir ? tmpdir : "/tmp") + "/agbench-" + std::to_string(getpid()) + "-autosave.json";
+        AGDocumentBenchmark::AutosaveResult result = AGDocumentBenchmark::runAutosave(path, 500);
+        return result.same ? 0 : 1;
+    }
+
+    if(libraryDocuments > 0)
+    {
+        const char *tmpdir = getenv("TMPDIR");
+        string dir = string(tmpdir ? tmpdir : "/tmp") + "/agbench-" + std::to_string(getpid()) + "-library";
+        AGDocumentBenchmark::LibraryResult result = AGDocumentBenchmark::runLibrary(dir, libraryDocuments);
+        return result.same ? 0 : 1;
+    }
+
+    if(hitTest)
+    {
+        AGHitTestBenchmark::Result result = AGHitTestBenchmark::run(1000, 10000, minTime);
+        return result.same ? 0 : 1;
+    }
+
+    if(recordSeconds > 0)
+    {
+        const char *tmpdir = getenv("TMPDIR");
+        string path = string(tmpdir ? tmpdir : "/tmp") + "/agbench-" + std::to_string(getpid()) + ".wav";
+        AGAudioRecorderBenchmark::runAll(path, recordSeconds, recordSpeed);
+        return 0;
+    }
+
+    if(voices)
+    {
+        AGAudioNodeBenchmark::runAllVoices(blockSizes, minTime);
+        
+        if(RealtimeAllocGuard::enabled())
+            fprintf(stderr, "agbench: %llu allocations while rendering\n",
+                    (unsigned long long) RealtimeAllocGuard::violations());
+        
+        return 0;
+    }
+
+    if(silence)
+    {
+        AGAudioNodeBenchmark::runAllSilence(blockSizes, minTime);
+        
+        if(RealtimeAllocGuard::enabled())
+            fprintf(stderr, "agbench: %llu allocations while rendering\n",
+                    (unsigned long long) RealtimeAllocGuard::violations());
+        
+        return 0;
+    }
+
+    if(filterBanks)
+    {
+        vector<AGAudioNodeBenchmark::BankResult> results = AGAudioNodeBenchmark::runAllBanks(filter, blockSizes, minTime);
+        if(results.size() == 0)
+        {
+            fprintf(stderr, "agbench: error: no filter types match '%s'\n", filter.c_str());
+            return 1;
+        }
+        
+        if(RealtimeAllocGuard::enabled())
+            fprintf(stderr, "agbench: %llu allocations while rendering\n",
+                    (unsigned long long) RealtimeAllocGuard::violations());
+        
+        return 0;
+    }
+
+    vector<AGAudioNodeBenchmark::Result> results = AGAudioNodeBenchmark::runAll(filter, blockSizes, minTime);
+    if(results.size() == 0)
+    {
+        fprintf(stderr, "agbench: error: no node types match '%s'\n", filter.c_str());
+        return 1;
+    }
+    
+    if(RealtimeAllocGuard::enabled())
+        fprintf(stderr, "agbench: %llu allocations while rendering\n",
+                (unsigned long long) RealtimeAllocGuard::violations());
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+//
+//  agconvert.cpp
+//  agrender
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+//  Converts an Auragraph patch between JSON and the binary format
+//  (AGDocumentBinary), in either direction.
+//
+//    agconvert in.json out.agpatch
+//    agconvert in.agpatch out.json
+//
+//  The input's format is detected from its contents and the output's chosen
+//  by its extension. The output is loaded back and compared against the
+//  input, failing if anything was lost.
+//
+
+#include "AGHeadless.h"
+#include "AGDocument.h"
+#include "AGDocumentBenchmark.h"
+
+
+static void usage()
+{
+    fprintf(stderr, "usage: agconvert in.json|in.agpatch out.json|out.agpatch\n");
+}
+
+int main(int argc, const char *argv[])
+{
+    if(argc != 3)
+    {
+        usage();
+        return 1;
+    }
+
+    string inPath = argv[1];
+    string outPath = argv[2];
+    AGDocument::Format format = AGDocument::formatForPath(outPath);
+
+    AGDocument doc;
+    doc.loadFromPath(inPath);
+    string original = AGDocumentBenchmark::describe(doc);
+    if(original.empty())
+    {
+        fprintf(stderr, "agconvert: error: nothing loaded from '%s'\n", inPath.c_str());
+        return 1;
+    }
+
+    doc.saveToPath(outPath, format);
+
+    AGDocument converted;
+    converted.loadFromPath(outPath);
+    if(AGDocumentBenchmark::describe(converted) != original)
+    {
+        fprintf(stderr, "agconvert: error: '%s' doesn't load back the same as '%s'\n",
+                outPath.c_str(), inPath.c_str());
+        return 1;
+    }
+
+    fprintf(stderr, "agconvert: wrote %s as %s\n", outPath.c_str(),
+            format == AGDocument::FORMAT_BINARY ? "binary" : "JSON");
+
+    return 0;
+}
@@ -0,0 +1,766 @@
+//
+//  agdspcheck.cpp
+//  agrender
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+//  Checks spvdsp's kernels, as compiled for this build's instruction set,
+//  against plain scalar loops and libm (in double precision), printing the
+//  worst error of each against its tolerance. Exits nonzero if any kernel is
+//  out of tolerance.
+//
+//    agdspcheck [-v]
+//
+//  The tolerances are those spvdsp.h states where it states one: spv_sin is
+//  within 3e-7 of the true sine. Elementwise arithmetic must match the scalar
+//  loops exactly, but for one rounding of slack where a fused multiply-add
+//  may be used; noise must match bit for bit. Each kernel runs at odd lengths
+//  and from unaligned pointers, so both the vector body and the leftover
+//  samples get checked. -v prints every check, not just failures and totals.
+//
+//  The Makefile also builds this against the scalar fallback
+//  (agdspcheck-scalar) and, on x86, against AVX (agdspcheck-avx); make check
+//  runs all of them.
+//
+
+#include "spvdsp.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+
+// frame counts around every vector width and a filter bank interval
+static const int LENGTHS[] = { 0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 63, 100, 257, 1031 };
+static const int NUM_LENGTHS = sizeof(LENGTHS)/sizeof(LENGTHS[0]);
+// start offsets, to misalign the buffers
+static const int MAX_OFFSET = 3;
+
+static bool g_verbose = false;
+static int g_failures = 0;
+static uint32_t g_random = 1;
+
+static float frand(float lo, float hi)
+{
+    g_random = g_random*1664525u + 1013904223u;
+    return lo + (hi-lo)*((g_random >> 8)/16777216.0f);
+}
+
+static void randomize(float *buf, int n, float lo, float hi)
+{
+    for(int i = 0; i < n; i++)
+        buf[i] = frand(lo, hi);
+}
+
+// circular distance between phases, in cycles
+static double phasediff(double a, double b)
+{
+    double d = a-b;
+    return fabs(d-floor(d+0.5));
+}
+
+
+//------------------------------------------------------------------------------
+// ### Reporting ###
+//------------------------------------------------------------------------------
+#pragma mark - Reporting
+
+// the worst error seen by one check, and where
+struct Check
+{
+    Check(const char *name, double tolerance) : name(name), tolerance(tolerance) { }
+
+    void sample(double error, int n, int i, double at)
+    {
+        if(!(error <= worst))
+        {
+            worst = error;
+            worstN = n;
+            worstIndex = i;
+            worstAt = at;
+        }
+    }
+
+    void fail(const char *what)
+    {
+        if(failure == NULL)
+            failure = what;
+    }
+
+    void report()
+    {
+        bool ok = failure == NULL && worst <= tolerance;
+        if(!ok)
+            g_failures++;
+        if(!ok || g_verbose)
+        {
+            printf("%-22s max error %-10.3g tolerance %-10.3g %s", name, worst, tolerance, ok ? "ok" : "FAIL");
+            if(failure != NULL)
+                printf(" (%s)", failure);
+            else if(!ok)
+                printf(" (n = %d, i = %d, at %.9g)", worstN, worstIndex, worstAt);
+            printf("\n");
+        }
+    }
+
+    const char *name;
+    double tolerance;
+    double worst = 0;
+    int worstN = 0, worstIndex = 0;
+    double worstAt = 0;
+    const char *failure = NULL;
+};
+
+
+//------------------------------------------------------------------------------
+// ### Arithmetic ###
+//------------------------------------------------------------------------------
+#pragma mark - Arithmetic
+
+// one float rounding of the exact a + b*c, i.e. the slack between fused and
+// separate multiply-add
+static double maddslack(float a, float b, float c)
+{
+    return (fabs(a) + fabs((double) b*c))*ldexp(1.0, -23);
+}
+
+static void checkArithmetic()
+{
+    Check fill("spv_fill", 0), add("spv_add", 0), mul("spv_mul", 0), scale("spv_scale", 0);
+    Check mac("spv_mac", 1), muladd("spv_muladd", 1), maxabs("spv_maxabs", 0);
+
+    const int MAX = 1031+MAX_OFFSET;
+    std::vector<float> a(MAX), b(MAX), c(MAX), dst(MAX), ref(MAX);
+
+    for(int l = 0; l < NUM_LENGTHS; l++)
+    {
+        int n = LENGTHS[l];
+        for(int off = 0; off <= MAX_OFFSET; off++)
+        {
+            randomize(a.data(), MAX, -4, 4);
+            randomize(b.data(), MAX, -4, 4);
+            randomize(c.data(), MAX, -4, 4);
+            float *pa = a.data()+off, *pb = b.data()+off, *pc = c.data()+off;
+            float *pd = dst.data()+off;
+            float gain = frand(-2, 2);
+
+            // also checks nothing is written past n
+            spv_fill(dst.data(), 7, MAX);
+            spv_fill(pd, gain, n);
+            for(int i = 0; i < MAX; i++)
+                fill.sample(dst[i] == (i >= off && i < off+n ? gain : 7) ? 0 : INFINITY, n, i, gain);
+
+            memcpy(pd, pa, sizeof(float)*n);
+            spv_add(pd, pb, n);
+            for(int i = 0; i < n; i++)
+                add.sample(fabs(pd[i]-(pa[i]+pb[i])), n, i, pa[i]);
+
+            memcpy(pd, pa, sizeof(float)*n);
+            spv_mul(pd, pb, n);
+            for(int i = 0; i < n; i++)
+                mul.sample(fabs(pd[i]-pa[i]*pb[i]), n, i, pa[i]);
+
+            memcpy(pd, pa, sizeof(float)*n);
+            spv_scale(pd, gain, n);
+            for(int i = 0; i < n; i++)
+                scale.sample(fabs(pd[i]-pa[i]*gain), n, i, pa[i]);
+
+            // measured in units of the fused/separate slack
+            memcpy(pd, pa, sizeof(float)*n);
+            spv_mac(pd, pb, gain, n);
+            for(int i = 0; i < n; i++)
+            {
+                double exact = pa[i] + (double) pb[i]*gain;
+                mac.sample(fabs(pd[i]-exact)/maddslack(pa[i], pb[i], gain), n, i, pa[i]);
+            }
+
+            memcpy(pd, pa, sizeof(float)*n);
+            spv_muladd(pd, pb, pc, n);
+            for(int i = 0; i < n; i++)
+            {
+                double exact = pa[i] + (double) pb[i]*pc[i];
+                muladd.sample(fabs(pd[i]-exact)/maddslack(pa[i], pb[i], pc[i]), n, i, pa[i]);
+            }
+
+            float max = 0;
+            for(int i = 0; i < n; i++)
+                max = fmaxf(max, fabsf(pa[i]));
+            maxabs.sample(fabs(spv_maxabs(pa, n)-max), n, 0, max);
+        }
+    }
+
+    // in place
+    for(int i = 0; i < 64; i++)
+        dst[i] = a[i];
+    spv_mul(dst.data(), dst.data(), 64);
+    for(int i = 0; i < 64; i++)
+        mul.sample(fabs(dst[i]-a[i]*a[i]), 64, i, a[i]);
+
+    fill.report();
+    add.report();
+    mul.report();
+    scale.report();
+    mac.report();
+    muladd.report();
+    maxabs.report();
+}
+
+
+//------------------------------------------------------------------------------
+// ### Sine and pan law ###
+//------------------------------------------------------------------------------
+#pragma mark - Sine and pan law
+
+static const double SIN_TOLERANCE = 3e-7;
+
+static void checkSin()
+{
+    Check vsin("spv_sin", SIN_TOLERANCE), ssin("spv_sinf", SIN_TOLERANCE);
+
+    const int N = 4096;
+    std::vector<float> phase(N+MAX_OFFSET), dst(N+MAX_OFFSET);
+
+    // finely over a few cycles, then coarsely out to the stated range
+    const float ranges[] = { 2, 64, 65536, 8388608 };
+    for(float range : ranges)
+    {
+        for(int off = 0; off <= MAX_OFFSET; off++)
+        {
+            float *p = phase.data()+off, *d = dst.data()+off;
+            if(range == 2)
+            {
+                for(int i = 0; i < N; i++)
+                    p[i] = -range + 2*range*i/(N-1);
+            }
+            else
+                randomize(p, N, -range, range);
+
+            for(int l = 0; l < NUM_LENGTHS; l++)
+            {
+                int n = LENGTHS[l] < N ? LENGTHS[l] : N;
+                spv_sin(d, p, n);
+                for(int i = 0; i < n; i++)
+                {
+                    // phase-round(phase) is exact, so reduce it first
+                    double r = p[i]-rint(p[i]);
+                    double exact = sin(2*M_PI*r);
+                    vsin.sample(fabs(d[i]-exact), n, i, p[i]);
+                    ssin.sample(fabs(spv_sinf(p[i])-exact), n, i, p[i]);
+                }
+            }
+
+            spv_sin(d, p, N);
+            for(int i = 0; i < N; i++)
+                vsin.sample(fabs(d[i]-sin(2*M_PI*(p[i]-rint(p[i])))), N, i, p[i]);
+        }
+    }
+
+    // in place, at the quadrant boundaries
+    float at[] = { 0, 0.25f, 0.5f, 0.75f, 1, -0.25f, -0.5f, -0.75f, -1 };
+    const int NUM_AT = sizeof(at)/sizeof(at[0]);
+    float in[NUM_AT];
+    memcpy(in, at, sizeof(at));
+    spv_sin(at, at, NUM_AT);
+    for(int i = 0; i < NUM_AT; i++)
+        vsin.sample(fabs(at[i]-sin(2*M_PI*in[i])), NUM_AT, i, in[i]);
+
+    vsin.report();
+    ssin.report();
+}
+
+static void checkPanlaw()
+{
+    Check left("spv_panlaw left", SIN_TOLERANCE), right("spv_panlaw right", SIN_TOLERANCE);
+
+    const int N = 1031;
+    std::vector<float> pan(N+MAX_OFFSET), l(N+MAX_OFFSET), r(N+MAX_OFFSET);
+
+    for(int off = 0; off <= MAX_OFFSET; off++)
+    {
+        float *p = pan.data()+off;
+        if(off == 0)
+        {
+            for(int i = 0; i < N; i++)
+                p[i] = -1 + 2.0f*i/(N-1);
+        }
+        else
+            randomize(p, N, -1, 1);
+
+        for(int k = 0; k < NUM_LENGTHS; k++)
+        {
+            int n = LENGTHS[k];
+            spv_panlaw(l.data()+off, r.data()+off, p, n);
+            for(int i = 0; i < n; i++)
+            {
+                double angle = M_PI/4*(p[i]-1.0);
+                left.sample(fabs(l[off+i]-fabs(cos(angle))), n, i, p[i]);
+                right.sample(fabs(r[off+i]-fabs(sin(angle))), n, i, p[i]);
+            }
+        }
+    }
+
+    left.report();
+    right.report();
+}
+
+
+//------------------------------------------------------------------------------
+// ### Oscillators ###
+//------------------------------------------------------------------------------
+#pragma mark - Oscillators
+
+static void checkPhasor()
+{
+    // each step is one float add, at phases below 1+8*0.5 = 5, so rounds by
+    // at most half an ulp of 4
+    Check step("spv_phasor step", ldexp(1.0, -22));
+    Check range("spv_phasor range", 0);
+    Check end("spv_phasor return", 0);
+    Check osc("spv_sinosc", SIN_TOLERANCE);
+
+    const int N = 1031;
+    std::vector<float> inc(N+MAX_OFFSET), dst(N+MAX_OFFSET), sine(N+MAX_OFFSET);
+
+    // audio-rate frequencies, then anything up to Nyquist either way
+    const float maxIncrements[] = { 0.01f, 0.5f };
+    for(float maxInc : maxIncrements)
+    {
+        for(int off = 0; off <= MAX_OFFSET; off++)
+        {
+            float *pi = inc.data()+off, *pd = dst.data()+off, *ps = sine.data()+off;
+            if(off == 0)
+                spv_fill(pi, maxInc, N);
+            else
+                randomize(pi, N, -maxInc, maxInc);
+
+            for(int k = 0; k < NUM_LENGTHS; k++)
+            {
+                int n = LENGTHS[k];
+                float start = frand(0, 1);
+                float next = spv_phasor(pd, pi, start, n);
+
+                double expected = start;
+                for(int i = 0; i < n; i++)
+                {
+                    step.sample(phasediff(pd[i], expected), n, i, pd[i]);
+                    // strays by less than the samples between wraps
+                    double stray = fmax(-pd[i], pd[i]-1);
+                    range.sample(stray < 8*maxInc ? 0 : stray, n, i, pd[i]);
+                    expected = (double) pd[i] + pi[i];
+                }
+                step.sample(phasediff(next, expected), n, n, next);
+                end.sample(next >= 0 && next < 1 ? 0 : fabs(next), n, n, next);
+
+                float oscNext = spv_sinosc(ps, pi, start, n);
+                if(oscNext != next)
+                    osc.fail("returns a different phase than spv_phasor");
+                for(int i = 0; i < n; i++)
+                    osc.sample(fabs(ps[i]-sin(2*M_PI*(pd[i]-rint(pd[i])))), n, i, pd[i]);
+            }
+
+            // in place (increment aliasing dst)
+            memcpy(pd, pi, sizeof(float)*N);
+            float start = frand(0, 1);
+            spv_phasor(ps, pi, start, N);
+            spv_phasor(pd, pd, start, N);
+            if(memcmp(pd, ps, sizeof(float)*N) != 0)
+                step.fail("differs in place");
+        }
+    }
+
+    step.report();
+    range.report();
+    end.report();
+    osc.report();
+}
+
+static void checkWavetable()
+{
+    // a + (b-a)*fract, rounded at each of three steps, for |table| <= 1
+    Check wave("spv_wavetable", 3*ldexp(1.0, -24)*2);
+
+    const int SIZE = 256;
+    const int N = 1031;
+    std::vector<float> table(SIZE+1), phase(N+MAX_OFFSET), dst(N+MAX_OFFSET);
+    randomize(table.data(), SIZE, -1, 1);
+    table[SIZE] = table[0];
+
+    for(int off = 0; off <= MAX_OFFSET; off++)
+    {
+        float *p = phase.data()+off, *d = dst.data()+off;
+        // including every table point exactly, and phases outside [0, 1)
+        if(off == 0)
+        {
+            for(int i = 0; i < N; i++)
+                p[i] = (i-N/2)/(float) SIZE;
+        }
+        else
+            randomize(p, N, -2, 2);
+
+        for(int k = 0; k < NUM_LENGTHS; k++)
+        {
+            int n = LENGTHS[k];
+            spv_wavetable(d, table.data(), SIZE, p, n);
+            for(int i = 0; i < n; i++)
+            {
+                double pos = (double) p[i]*SIZE;
+                double whole = floor(pos);
+                int index = ((int) whole) & (SIZE-1);
+                double exact = table[index] + ((double) table[index+1]-table[index])*(pos-whole);
+                wave.sample(fabs(d[i]-exact), n, i, p[i]);
+            }
+        }
+    }
+
+    wave.report();
+}
+
+
+//------------------------------------------------------------------------------
+// ### Noise ###
+//------------------------------------------------------------------------------
+#pragma mark - Noise
+
+static void checkNoise()
+{
+    Check match("spv_noise", 0), range("spv_noise range", 0);
+
+    const int N = 1031;
+    std::vector<float> dst(N+MAX_OFFSET);
+    const uint32_t seeds[] = { 1, 2, 12345, 0xFFFFFFFFu };
+
+    for(uint32_t seed : seeds)
+    {
+        spv_noise noise;
+        spv_noise_seed(noise, seed);
+        for(int lane = 0; lane < 8; lane++)
+        {
+            if(noise.state[lane] == 0)
+                match.fail("seeds a lane with zero state");
+        }
+
+        // the eight xorshift32 generators, stepped one sample at a time
+        uint32_t state[8];
+        memcpy(state, noise.state, sizeof(state));
+
+        for(int k = 0; k < NUM_LENGTHS; k++)
+        {
+            int n = LENGTHS[k];
+            int off = k%(MAX_OFFSET+1);
+            float *d = dst.data()+off;
+            spv_noise_render(noise, d, n);
+
+            for(int i = 0; i < (n+7)/8*8; i++)
+            {
+                uint32_t &x = state[i%8];
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                if(i >= n)
+                    continue;
+
+                // top 23 bits over [-1, 1)
+                double exact = -1 + (x >> 9)/4194304.0;
+                match.sample(d[i] == exact ? 0 : fabs(d[i]-exact), n, i, seed);
+                range.sample(d[i] >= -1 && d[i] < 1 ? 0 : fabs(d[i]), n, i, seed);
+            }
+
+            if(memcmp(state, noise.state, sizeof(state)) != 0)
+                match.fail("generator state diverges");
+        }
+    }
+
+    match.report();
+    range.report();
+}
+
+
+//------------------------------------------------------------------------------
+// ### Interleaving ###
+//------------------------------------------------------------------------------
+#pragma mark - Interleaving
+
+static void checkInterleave()
+{
+    Check inter("spv_interleave", 0), deinter("spv_deinterleave", 0);
+
+    const int N = 257;
+    const int MAX_CHANNELS = 9;
+
+    for(int numChannels = 1; numChannels <= MAX_CHANNELS; numChannels++)
+    {
+        // stride wider than the channels, to check the gaps are left alone
+        int stride = numChannels + (numChannels%2);
+        std::vector<float> channels(numChannels*(N+1)), frames(stride*N+1), out(numChannels*(N+1));
+        randomize(channels.data(), (int) channels.size(), -1, 1);
+        std::vector<const float *> src(numChannels);
+        std::vector<float *> dst(numChannels);
+        for(int c = 0; c < numChannels; c++)
+        {
+            src[c] = channels.data()+c*(N+1)+1;
+            dst[c] = out.data()+c*(N+1)+1;
+        }
+
+        for(int k = 0; k < NUM_LENGTHS; k++)
+        {
+            int n = LENGTHS[k] < N ? LENGTHS[k] : N;
+            spv_fill(frames.data(), 7, (int) frames.size());
+            spv_interleave(frames.data()+1, stride, src.data(), numChannels, n);
+            for(int i = 0; i < n; i++)
+            {
+                for(int c = 0; c < stride; c++)
+                {
+                    float expected = c < numChannels ? src[c][i] : 7;
+                    inter.sample(frames[1+i*stride+c] == expected ? 0 : INFINITY, n, i, c);
+                }
+            }
+
+            spv_fill(out.data(), 7, (int) out.size());
+            spv_deinterleave(dst.data(), frames.data()+1, stride, numChannels, n);
+            for(int c = 0; c < numChannels; c++)
+            {
+                for(int i = 0; i < n; i++)
+                    deinter.sample(dst[c][i] == src[c][i] ? 0 : INFINITY, n, i, c);
+                if(n < N && dst[c][n] != 7)
+                    deinter.fail("writes past n");
+            }
+        }
+    }
+
+    inter.report();
+    deinter.report();
+}
+
+
+//------------------------------------------------------------------------------
+// ### Filter banks ###
+//------------------------------------------------------------------------------
+#pragma mark - Filter banks
+
+// the banks' ramping, one lane at a time, in double
+template<int NC, class Tick>
+static void filterReference(double *c, double *s, const float *target, const float *in,
+                            double *const *out, int stride, int lane, int n, Tick tick)
+{
+    for(int start = 0, seg = 0; start < n; start += SPV_BANK_INTERVAL, seg++)
+    {
+        int end = start+SPV_BANK_INTERVAL < n ? start+SPV_BANK_INTERVAL : n;
+        double t[NC], d[NC];
+        for(int k = 0; k < NC; k++)
+        {
+            t[k] = target[(seg*NC+k)*stride+lane];
+            d[k] = (t[k]-c[k])/(end-start);
+        }
+
+        for(int i = start; i < end; i++)
+        {
+            for(int k = 0; k < NC; k++)
+                c[k] = i == end-1 ? t[k] : c[k]+d[k];
+            tick(c, s, in[i*stride+lane], out, i);
+        }
+    }
+}
+
+// lowpass biquad coefficients (b0, b1, b2, a1, a2) for a cutoff in cycles
+static void lowpass(float *c, double fc, double Q)
+{
+    double w = 2*M_PI*fc, alpha = sin(w)/(2*Q), a0 = 1+alpha;
+    c[0] = (1-cos(w))/2/a0;
+    c[1] = (1-cos(w))/a0;
+    c[2] = c[0];
+    c[3] = -2*cos(w)/a0;
+    c[4] = (1-alpha)/a0;
+}
+
+static void checkBanks()
+{
+    // float against double over a few hundred frames of stable, well-damped
+    // filters (Q <= 2) with unit input; relative to each output's peak
+    Check biquad("spv_biquad_bank", 1e-4), svf("spv_svf_bank", 1e-4);
+
+    // wider than every vector, with lanes left over; and one plain filter
+    const int strides[] = { 1, 11 };
+    const int N = 257;
+    const int SEGS = (N+SPV_BANK_INTERVAL-1)/SPV_BANK_INTERVAL;
+
+    for(int stride : strides)
+    {
+        std::vector<float> in(N*stride), out(N*stride);
+        randomize(in.data(), N*stride, -1, 1);
+
+        // biquads: targets hold still for some segments, so that both the
+        // ramping and the steady paths run
+        {
+            const int NC = 5;
+            std::vector<float> coeff(NC*stride), state(2*stride, 0.0f), target(SEGS*NC*stride);
+            for(int lane = 0; lane < stride; lane++)
+            {
+                float c[NC];
+                lowpass(c, frand(0.01f, 0.2f), frand(0.5f, 2));
+                for(int k = 0; k < NC; k++)
+                    coeff[k*stride+lane] = c[k];
+                for(int seg = 0; seg < SEGS; seg++)
+                {
+                    if(seg%3 != 2)
+                        lowpass(c, frand(0.01f, 0.2f), frand(0.5f, 2));
+                    for(int k = 0; k < NC; k++)
+                        target[(seg*NC+k)*stride+lane] = c[k];
+                }
+            }
+
+            std::vector<double> rc(NC*stride), rs(2*stride, 0.0), rout(N*stride);
+            for(int i = 0; i < NC*stride; i++)
+                rc[i] = coeff[i];
+
+            spv_biquad_bank(coeff.data(), state.data(), target.data(), in.data(), out.data(), stride, N);
+
+            for(int lane = 0; lane < stride; lane++)
+            {
+                double c[NC], s[2] = { 0, 0 };
+                for(int k = 0; k < NC; k++)
+                    c[k] = rc[k*stride+lane];
+                double *o = rout.data()+lane;
+                filterReference<NC>(c, s, target.data(), in.data(), &o, stride, lane, N,
+                                    [stride](const double *c, double *s, double x, double *const *out, int i) {
+                    double y = s[0] + c[0]*x;
+                    s[0] = s[1] - c[3]*y + c[1]*x;
+                    s[1] = c[2]*x - c[4]*y;
+                    out[0][i*stride] = y;
+                });
+
+                double peak = 1;
+                for(int i = 0; i < N; i++)
+                    peak = fmax(peak, fabs(rout[i*stride+lane]));
+                for(int i = 0; i < N; i++)
+                    biquad.sample(fabs(out[i*stride+lane]-rout[i*stride+lane])/peak, N, i, lane);
+                for(int k = 0; k < NC; k++)
+                {
+                    if(coeff[k*stride+lane] != target[((SEGS-1)*NC+k)*stride+lane])
+                        biquad.fail("coefficients miss their final targets");
+                }
+            }
+        }
+
+        // state variable filters, all four outputs
+        {
+            const int NC = 2;
+            std::vector<float> coeff(NC*stride), state(2*stride, 0.0f), target(SEGS*NC*stride);
+            std::vector<float> outs(4*N*stride);
+            float *out4[4] = { outs.data(), outs.data()+N*stride, outs.data()+2*N*stride, outs.data()+3*N*stride };
+            for(int lane = 0; lane < stride; lane++)
+            {
+                coeff[lane] = 2*sin(M_PI*frand(0.01f, 0.15f));
+                coeff[stride+lane] = 1/frand(0.5f, 2);
+                for(int seg = 0; seg < SEGS; seg++)
+                {
+                    bool hold = seg%3 == 2 && seg > 0;
+                    for(int k = 0; k < NC; k++)
+                    {
+                        float &t = target[(seg*NC+k)*stride+lane];
+                        if(hold)
+                            t = target[((seg-1)*NC+k)*stride+lane];
+                        else
+                            t = k == 0 ? 2*sin(M_PI*frand(0.01f, 0.15f)) : 1/frand(0.5f, 2);
+                    }
+                }
+            }
+
+            std::vector<double> rc(NC*stride), routs(4*N*stride);
+            for(int i = 0; i < NC*stride; i++)
+                rc[i] = coeff[i];
+
+            spv_svf_bank(coeff.data(), state.data(), target.data(), in.data(), out4, stride, N);
+
+            for(int lane = 0; lane < stride; lane++)
+            {
+                double c[NC] = { rc[lane], rc[stride+lane] }, s[2] = { 0, 0 };
+                double *o[4];
+                for(int k = 0; k < 4; k++)
+                    o[k] = routs.data()+k*N*stride+lane;
+                filterReference<NC>(c, s, target.data(), in.data(), o, stride, lane, N,
+                                    [stride](const double *c, double *s, double x, double *const *out, int i) {
+                    double lpf = s[1] + c[0]*s[0];
+                    double hpf = x - lpf - c[1]*s[0];
+                    double bpf = s[0] + c[0]*hpf;
+                    out[0][i*stride] = lpf;
+                    out[1][i*stride] = hpf;
+                    out[2][i*stride] = bpf;
+                    out[3][i*stride] = hpf+lpf;
+                    s[0] = bpf;
+                    s[1] = lpf;
+                });
+
+                for(int k = 0; k < 4; k++)
+                {
+                    double peak = 1;
+                    for(int i = 0; i < N; i++)
+                        peak = fmax(peak, fabs(o[k][i*stride]));
+                    for(int i = 0; i < N; i++)
+                        svf.sample(fabs(out4[k][i*stride+lane]-o[k][i*stride])/peak, N, i, lane);
+                }
+            }
+        }
+    }
+
+    biquad.report();
+    svf.report();
+}
+
+
+//------------------------------------------------------------------------------
+// ### main ###
+//------------------------------------------------------------------------------
+#pragma mark - main
+
+int main(int argc, const char **argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-v") == 0)
+            g_verbose = true;
+        else
+        {
+            fprintf(stderr, "usage: agdspcheck [-v]\n");
+            return 1;
+        }
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    // agdspcheck-avx builds on any x86, but only runs where AVX and FMA do
+    if(strcmp(spv_isa(), "avx") == 0)
+    {
+        unsigned int a, b, c, d;
+        bool avx = __get_cpuid(1, &a, &b, &c, &d) && (c & bit_AVX) && (c & bit_FMA);
+        if(!avx)
+        {
+            printf("agdspcheck: avx: not supported by this CPU, skipped\n");
+            return 0;
+        }
+    }
+#endif
+
+    checkArithmetic();
+    checkSin();
+    checkPanlaw();
+    checkPhasor();
+    checkWavetable();
+    checkNoise();
+    checkInterleave();
+    checkBanks();
+
+    if(g_failures)
+    {
+        printf("agdspcheck: %s: %d check%s FAILED\n", spv_isa(), g_failures, g_failures == 1 ? "" : "s");
+        return 1;
+    }
+
+    printf("agdspcheck: %s: all checks passed\n", spv_isa());
+    return 0;
+}
@@ -0,0 +1,271 @@
+//
+//  agjitter.cpp
+//  agrender
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+//  Measures how far control events land from their ideal times once they
+//  reach the audio graph. Each event source (Timer, Sequencer, slew) drives a
+//  probe node that outputs its control input as a constant signal; every
+//  change in the rendered output is compared against the source's period.
+//
+//    agjitter [-d seconds] [-b blocksize]...
+//
+//  -d sets the length rendered per source and block size; -b (repeatable)
+//  replaces the default block sizes of 64, 256, 512 and 1024. Exits with
+//  status 1 if any event lands a sample or more from where it should.
+//
+
+#include "AGHeadless.h"
+#include "AGAudioEngine.h"
+#include "AGAudioManager.h"
+#include "AGAudioNode.h"
+#include "AGControlNode.h"
+#include "AGControlSequencerNode.h"
+#include "AGConnection.h"
+#include "Buffers.h"
+#include "spvdsp.h"
+
+#include "Stk.h"
+
+#include <functional>
+#include <math.h>
+
+
+//------------------------------------------------------------------------------
+// ### AGJitterProbeNode ###
+// Passes its control input through as a constant signal, so the sample at
+// which each value took effect can be read off the output.
+//------------------------------------------------------------------------------
+#pragma mark - AGJitterProbeNode
+
+class AGJitterProbeNode : public AGAudioNode
+{
+public:
+
+    enum Param
+    {
+        PARAM_INPUT = AUDIO_PARAM_LAST+1,
+        PARAM_OUTPUT,
+    };
+
+    class Manifest : public AGStandardNodeManifest<AGJitterProbeNode>
+    {
+    public:
+        string _type() const override { return "JitterProbe"; };
+        string _name() const override { return "JitterProbe"; };
+        string _description() const override { return "Outputs its control input as a constant signal."; };
+
+        vector<AGPortInfo> _inputPortInfo() const override
+        {
+            return {
+                { PARAM_INPUT, "input", .doc = "Control input." },
+            };
+        };
+
+        vector<AGPortInfo> _editPortInfo() const override { return { }; };
+
+        vector<AGPortInfo> _outputPortInfo() const override
+        {
+            return {
+                { PARAM_OUTPUT, "output", .doc = "Output." },
+            };
+        };
+
+        vector<GLvertex3f> _iconGeo() const override { return { }; };
+        GLuint _iconGeoType() const override { return GL_LINES; };
+    };
+
+    using AGAudioNode::AGAudioNode;
+
+    void renderAudio(sampletime t, float *input, float *output, int nFrames, int chanNum, int nChans) override
+    {
+        if(t <= m_lastTime) { renderLast(output, nFrames, chanNum); return; }
+        m_lastTime = t;
+        pullInputPorts(t, nFrames);
+
+        spv_fill(m_outputBuffer[chanNum], inputPortValue(PARAM_INPUT), nFrames);
+        spv_add(output, m_outputBuffer[chanNum], nFrames);
+    }
+};
+
+
+//------------------------------------------------------------------------------
+// ### measurement ###
+//------------------------------------------------------------------------------
+#pragma mark - measurement
+
+struct Source
+{
+    const char *name;
+    // seconds between changes in the source's output
+    double period;
+    std::function<AGNode *()> create;
+};
+
+struct Jitter
+{
+    int numEvents = 0;
+    // in samples
+    double maxError = 0;
+    double meanError = 0;
+};
+
+static void setEditPort(AGNode *node, const string &name, float value)
+{
+    for(int port = 0; port < node->numEditPorts(); port++)
+    {
+        if(node->editPortInfo(port).name == name)
+            node->setEditPortValue(port, value);
+    }
+}
+
+static Jitter measure(const Source &source, int blockSize, double duration)
+{
+    static AGJitterProbeNode::Manifest s_probeManifest;
+
+    AGAudioEngine &engine = AGHeadless::engine();
+
+    AGNode *node = source.create();
+    AGNode *probe = AGNodeManager::audioNodeManager().createNodeType(&s_probeManifest, GLvertex3f());
+    AGAudioOutputNode *outputNode = dynamic_cast<AGAudioOutputNode *>(AGNodeManager::audioNodeManager().createNodeOfType("Output", GLvertex3f()));
+
+    AGConnection *control = AGConnection::connect(node, 0, probe, 0);
+    AGConnection *audio = AGConnection::connect(probe, 0, outputNode, 0);
+    outputNode->setOutputDestination(AGAudioManager_::instance().masterOut());
+
+    // event sources count from the first block they are rendered in, which
+    // is where t starts
+    double period = source.period*AGAudioNode::sampleRate();
+    sampletime numFrames = (sampletime) (duration*AGAudioNode::sampleRate());
+
+    Buffer<float> output(AUDIO_BUFFER_MAX*AGAudioEngine::NUM_OUTPUT_CHANNELS);
+    float last = 0;
+    Jitter jitter;
+
+    for(sampletime t = 0; t < numFrames; t += blockSize)
+    {
+        engine.render(NULL, output, blockSize);
+
+        for(int i = 0; i < blockSize; i++)
+        {
+            float value = output[i*AGAudioEngine::NUM_OUTPUT_CHANNELS];
+            if(value == last)
+                continue;
+            last = value;
+
+            // distance to the nearest multiple of the period
+            double time = (double) (t+i);
+            double error = fabs(time - round(time/period)*period);
+            jitter.numEvents++;
+            jitter.maxError = std::max(jitter.maxError, error);
+            jitter.meanError += error;
+        }
+    }
+
+    if(jitter.numEvents)
+        jitter.meanError /= jitter.numEvents;
+
+    AGNode::disconnect(control);
+    delete control;
+    AGNode::disconnect(audio);
+    delete audio;
+    delete outputNode;
+    delete probe;
+    delete node;
+
+    return jitter;
+}
+
+
+static void usage()
+{
+    fprintf(stderr, "usage: agjitter [-d seconds] [-b blocksize]...\n");
+}
+
+int main(int argc, const char **argv)
+{
+    double duration = 10;
+    vector<int> blockSizes;
+
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if(arg == "-d" && i+1 < argc)
+            duration = atof(argv[++i]);
+        else if(arg == "-b" && i+1 < argc)
+            blockSizes.push_back(atoi(argv[++i]));
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if(blockSizes.size() == 0)
+        blockSizes = { 64, 256, 512, 1024 };
+
+    for(int blockSize : blockSizes)
+    {
+        if(blockSize <= 0 || blockSize > AUDIO_BUFFER_MAX)
+        {
+            fprintf(stderr, "agjitter: error: block size must be between 1 and %i\n", AUDIO_BUFFER_MAX);
+            return 1;
+        }
+    }
+
+    if(duration <= 0)
+    {
+        usage();
+        return 1;
+    }
+
+    stk::Stk::setSampleRate(AGAudioNode::sampleRate());
+
+    // periods deliberately not a whole number of blocks (or samples)
+    const float BPM = 137;
+    vector<Source> sources = {
+        { "Timer", 0.0137f, [] {
+            AGNode *timer = AGNodeManager::controlNodeManager().createNodeOfType("Timer", GLvertex3f());
+            setEditPort(timer, "interval", 0.0137);
+            return timer;
+        } },
+        // values change at each step, and drop to 0 half way through it
+        { "Sequencer", 30.0/BPM, [BPM] {
+            AGControlSequencerNode *sequencer = dynamic_cast<AGControlSequencerNode *>(AGNodeManager::controlNodeManager().createNodeOfType("Sequencer", GLvertex3f()));
+            sequencer->setBpm(BPM);
+            for(int step = 0; step < sequencer->numSteps(); step++)
+            {
+                sequencer->setStepValue(0, step, 1+step);
+                sequencer->setStepLength(0, step, 0.5);
+            }
+            return sequencer;
+        } },
+        { "slew", 0.01, [] {
+            AGNode *slew = AGNodeManager::controlNodeManager().createNodeOfType("slew", GLvertex3f());
+            setEditPort(slew, "rate", 0.25);
+            slew->receiveControl(0, AGControl(1.0f));
+            return slew;
+        } },
+    };
+
+    bool ok = true;
+
+    fprintf(stderr, "%-24s %8s %16s %16s\n", "source", "events", "mean (samples)", "max (samples)");
+    for(const Source &source : sources)
+    {
+        for(int blockSize : blockSizes)
+        {
+            Jitter jitter = measure(source, blockSize, duration);
+            bool sourceOk = jitter.numEvents > 0 && jitter.maxError < 1;
+            ok = ok && sourceOk;
+
+            string name = string(source.name) + "/" + std::to_string(blockSize);
+            fprintf(stderr, "%-24s %8i %16.3f %16.3f%s\n", name.c_str(), jitter.numEvents,
+                    jitter.meanError, jitter.maxError, sourceOk ? "" : "  FAIL");
+        }
+    }
+
+    return ok ? 0 : 1;
+}
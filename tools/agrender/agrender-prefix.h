@@ -0,0 +1,33 @@
+//
+//  agrender-prefix.h
+//  agrender
+//
+//  Prefix header for the headless build; stands in for Auragraph-Prefix.pch,
+//  including the C library headers that the iOS SDK pulls in implicitly.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <limits.h>
+#include <assert.h>
+
+#ifdef __cplusplus
+#include <cmath>
+#include <string>
+#endif
+
+// STK byte-swaps file I/O unless told the host is little endian; clang
+// predefines this on Apple platforms
+#if !defined(__LITTLE_ENDIAN__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define __LITTLE_ENDIAN__ 1
+#endif
+
+// normally provided by the Objective-C runtime headers
+#ifndef nil
+#define nil NULL
+#endif
+
+#include "AGDef.h"
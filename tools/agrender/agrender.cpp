@@ -0,0 +1,209 @@
+//
+//  agrender.cpp
+//  agrender
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+//  Renders an Auragraph patch offline to a WAV file, as fast as possible, and
+//  reports throughput as a multiple of real time.
+//
+//    agrender patch.json [-o out.wav] [-d seconds] [-p trace.json]
+//
+//  Sound files referenced by the patch are looked up next to it. -p profiles
+//  each node, printing its load and writing the last few seconds of the render
+//  as a Chrome trace. Built with RT_ALLOC_GUARD, reports any allocations made
+//  while rendering.
+//
+
+#include "AGHeadless.h"
+#include "AGAudioEngine.h"
+#include "AGAudioManager.h"
+#include "AGAudioNode.h"
+#include "AGAudioProfiler.h"
+#include "AGDocument.h"
+#include "AGConnection.h"
+#include "AGSoundFile.h"
+#include "Buffers.h"
+#include "RealtimeAllocGuard.h"
+
+#include "FileWrite.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+
+
+static void usage()
+{
+    fprintf(stderr, "usage: agrender patch.json [-o out.wav] [-d seconds] [-p trace.json]\n");
+}
+
+static int loadPatch(const string &path, vector<AGAudioNode *> &audioNodes)
+{
+    AGDocument doc;
+    doc.loadFromPath(path);
+
+    std::map<string, AGNode *> uuid2node;
+
+    // compiled once it's all there
+    AGAudioManager_::instance().beginGraphEdit();
+
+    doc.recreate([&](const AGDocument::Node &docNode) {
+        AGNode *node = AGNodeManager::createNode(docNode);
+        if(node == NULL)
+        {
+            fprintf(stderr, "agrender: warning: skipping unsupported node '%s'\n", docNode.type.c_str());
+            return;
+        }
+
+        uuid2node[node->uuid()] = node;
+        
+        AGAudioNode *audioNode = dynamic_cast<AGAudioNode *>(node);
+        if(audioNode)
+            audioNodes.push_back(audioNode);
+
+        if(node->type() == "Output")
+        {
+            AGAudioOutputNode *outputNode = dynamic_cast<AGAudioOutputNode *>(node);
+            if(outputNode)
+                outputNode->setOutputDestination(AGAudioManager_::instance().masterOut());
+        }
+    }, [&](const AGDocument::Connection &docConnection) {
+        if(uuid2node.count(docConnection.srcUuid) && uuid2node.count(docConnection.dstUuid))
+        {
+            AGNode *srcNode = uuid2node[docConnection.srcUuid];
+            AGNode *dstNode = uuid2node[docConnection.dstUuid];
+            if(docConnection.dstPort >= 0 && docConnection.dstPort < dstNode->numInputPorts() &&
+               docConnection.srcPort >= 0 && docConnection.srcPort < srcNode->numOutputPorts())
+                AGConnection::connect(srcNode, docConnection.srcPort, dstNode, docConnection.dstPort);
+        }
+    }, [](const AGDocument::Freedraw &docFreedraw) { });
+
+    AGAudioManager_::instance().endGraphEdit();
+
+    return (int) uuid2node.size();
+}
+
+int main(int argc, const char **argv)
+{
+    string patchPath;
+    string outputPath = "out.wav";
+    string tracePath;
+    float duration = 10;
+
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if(arg == "-o" && i+1 < argc)
+            outputPath = argv[++i];
+        else if(arg == "-d" && i+1 < argc)
+            duration = atof(argv[++i]);
+        else if(arg == "-p" && i+1 < argc)
+            tracePath = argv[++i];
+        else if(arg.length() && arg[0] != '-' && patchPath.length() == 0)
+            patchPath = arg;
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if(patchPath.length() == 0 || duration <= 0)
+    {
+        usage();
+        return 1;
+    }
+
+    size_t slash = patchPath.rfind('/');
+    AGHeadless::setDocumentDirectory(slash == string::npos ? "." : patchPath.substr(0, slash));
+
+    stk::Stk::setSampleRate(AGAudioNode::sampleRate());
+    // faster than real time, so wait on the disk rather than drop out
+    AGSoundFileCache::instance().setBlocking(true);
+
+    vector<AGAudioNode *> audioNodes;
+    int numNodes = loadPatch(patchPath, audioNodes);
+    if(numNodes == 0)
+    {
+        fprintf(stderr, "agrender: error: no nodes loaded from '%s'\n", patchPath.c_str());
+        return 1;
+    }
+
+    stk::FileWrite file;
+    try {
+        file.open(outputPath, AGAudioEngine::NUM_OUTPUT_CHANNELS, stk::FileWrite::FILE_WAV, stk::Stk::STK_FLOAT32);
+    } catch(const stk::StkError &error) {
+        fprintf(stderr, "agrender: error: unable to open '%s' for writing\n", outputPath.c_str());
+        return 1;
+    }
+
+    AGAudioProfiler::instance().setEnabled(tracePath.length() > 0);
+
+    AGAudioEngine &engine = AGHeadless::engine();
+    int bufferSize = AGAudioNode::bufferSize();
+    sampletime numFrames = (sampletime) (duration*AGAudioNode::sampleRate());
+
+    Buffer<float> output(bufferSize*AGAudioEngine::NUM_OUTPUT_CHANNELS);
+    stk::StkFrames frames(bufferSize, AGAudioEngine::NUM_OUTPUT_CHANNELS);
+    double renderTime = 0;
+
+    for(sampletime t = 0; t < numFrames; t += bufferSize)
+    {
+        int blockSize = (int) std::min<sampletime>(bufferSize, numFrames-t);
+
+        auto start = std::chrono::steady_clock::now();
+        engine.render(NULL, output, blockSize);
+        renderTime += std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+        if((int) frames.frames() != blockSize)
+            frames.resize(blockSize, AGAudioEngine::NUM_OUTPUT_CHANNELS);
+        for(int i = 0; i < blockSize*AGAudioEngine::NUM_OUTPUT_CHANNELS; i++)
+            frames[i] = output[i];
+        file.write(frames);
+    }
+
+    file.close();
+
+    double audioTime = ((double) numFrames)/AGAudioNode::sampleRate();
+    fprintf(stderr, "agrender: %s: %d nodes, rendered %.2f s in %.3f s (%.1fx real time) to %s\n",
+            patchPath.c_str(), numNodes, audioTime, renderTime,
+            renderTime > 0 ? audioTime/renderTime : 0, outputPath.c_str());
+    
+    if(RealtimeAllocGuard::enabled())
+        fprintf(stderr, "agrender: %llu allocations on the audio thread\n",
+                (unsigned long long) RealtimeAllocGuard::violations());
+
+    if(tracePath.length())
+    {
+        AGAudioProfiler &profiler = AGAudioProfiler::instance();
+
+        // most expensive first
+        vector<pair<AGAudioNode *, AGAudioProfiler::Stats>> stats;
+        for(AGAudioNode *node : audioNodes)
+            stats.push_back(make_pair(node, profiler.nodeStats(node)));
+        std::sort(stats.begin(), stats.end(), [](const pair<AGAudioNode *, AGAudioProfiler::Stats> &a,
+                                                 const pair<AGAudioNode *, AGAudioProfiler::Stats> &b) {
+            return a.second.avgTime > b.second.avgTime;
+        });
+
+        auto printStats = [](const string &name, const AGAudioProfiler::Stats &s) {
+            fprintf(stderr, "%-48s %10.2f %10.2f %10.2f %7.2f%%\n", name.c_str(), s.avgTime, s.p99Time, s.maxTime, s.load*100);
+        };
+
+        fprintf(stderr, "%-48s %10s %10s %10s %8s\n", "node (us/block)", "avg", "p99", "max", "load");
+        printStats("(all)", profiler.blockStats());
+        for(auto &nodeStats : stats)
+            printStats(nodeStats.first->type() + " " + nodeStats.first->uuid(), nodeStats.second);
+
+        if(!profiler.writeTrace(tracePath, audioNodes))
+        {
+            fprintf(stderr, "agrender: error: unable to write trace to '%s'\n", tracePath.c_str());
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
@@ -0,0 +1,200 @@
+//
+//  AGHeadlessGL.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+//  Stand-in for OpenGL ES in headless builds. Types and constants match the
+//  real headers closely enough for the app's rendering code to compile; every
+//  call is a no-op, and objects are handed out as plain incrementing names.
+//
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int GLenum;
+typedef unsigned char GLboolean;
+typedef unsigned int GLbitfield;
+typedef signed char GLbyte;
+typedef short GLshort;
+typedef int GLint;
+typedef int GLsizei;
+typedef unsigned char GLubyte;
+typedef unsigned short GLushort;
+typedef unsigned int GLuint;
+typedef float GLfloat;
+typedef float GLclampf;
+typedef void GLvoid;
+typedef char GLchar;
+typedef intptr_t GLintptr;
+typedef intptr_t GLsizeiptr;
+
+#define GL_FALSE 0
+#define GL_TRUE 1
+
+#define GL_POINTS 0x0000
+#define GL_LINES 0x0001
+#define GL_LINE_LOOP 0x0002
+#define GL_LINE_STRIP 0x0003
+#define GL_TRIANGLES 0x0004
+#define GL_TRIANGLE_STRIP 0x0005
+#define GL_TRIANGLE_FAN 0x0006
+
+#define GL_ZERO 0
+#define GL_ONE 1
+#define GL_SRC_ALPHA 0x0302
+#define GL_ONE_MINUS_SRC_ALPHA 0x0303
+
+#define GL_BYTE 0x1400
+#define GL_UNSIGNED_BYTE 0x1401
+#define GL_SHORT 0x1402
+#define GL_UNSIGNED_SHORT 0x1403
+#define GL_INT 0x1404
+#define GL_UNSIGNED_INT 0x1405
+#define GL_FLOAT 0x1406
+
+#define GL_DEPTH_BUFFER_BIT 0x00000100
+#define GL_STENCIL_BUFFER_BIT 0x00000400
+#define GL_COLOR_BUFFER_BIT 0x00004000
+
+#define GL_BLEND 0x0BE2
+#define GL_DEPTH_TEST 0x0B71
+#define GL_STENCIL_TEST 0x0B90
+#define GL_SCISSOR_TEST 0x0C11
+#define GL_CULL_FACE 0x0B44
+#define GL_LINE_WIDTH 0x0B21
+#define GL_VIEWPORT 0x0BA2
+
+#define GL_NEVER 0x0200
+#define GL_LESS 0x0201
+#define GL_EQUAL 0x0202
+#define GL_LEQUAL 0x0203
+#define GL_GREATER 0x0204
+#define GL_NOTEQUAL 0x0205
+#define GL_GEQUAL 0x0206
+#define GL_ALWAYS 0x0207
+#define GL_KEEP 0x1E00
+#define GL_REPLACE 0x1E01
+#define GL_INCR 0x1E02
+#define GL_DECR 0x1E03
+
+#define GL_TEXTURE_2D 0x0DE1
+#define GL_TEXTURE0 0x84C0
+#define GL_TEXTURE_MAG_FILTER 0x2800
+#define GL_TEXTURE_MIN_FILTER 0x2801
+#define GL_TEXTURE_WRAP_S 0x2802
+#define GL_TEXTURE_WRAP_T 0x2803
+#define GL_NEAREST 0x2600
+#define GL_LINEAR 0x2601
+#define GL_CLAMP_TO_EDGE 0x812F
+#define GL_RGB 0x1907
+#define GL_RGBA 0x1908
+#define GL_ALPHA 0x1906
+#define GL_LUMINANCE 0x1909
+
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_STATIC_DRAW 0x88E4
+#define GL_DYNAMIC_DRAW 0x88E8
+#define GL_STREAM_DRAW 0x88E0
+
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_RENDERBUFFER 0x8D41
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_DEPTH_ATTACHMENT 0x8D00
+#define GL_STENCIL_ATTACHMENT 0x8D20
+#define GL_DEPTH_COMPONENT16 0x81A5
+#define GL_STENCIL_INDEX8 0x8D48
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#define GL_FRAMEBUFFER_BINDING 0x8CA6
+
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_VERTEX_SHADER 0x8B31
+#define GL_COMPILE_STATUS 0x8B81
+#define GL_LINK_STATUS 0x8B82
+#define GL_VALIDATE_STATUS 0x8B83
+#define GL_INFO_LOG_LENGTH 0x8B84
+
+namespace AGHeadlessGL
+{
+    inline GLuint nextName() { static GLuint s_name = 0; return ++s_name; }
+    inline void genNames(GLsizei n, GLuint *names) { for(GLsizei i = 0; i < n; i++) names[i] = nextName(); }
+}
+
+inline void glActiveTexture(GLenum) { }
+inline void glAttachShader(GLuint, GLuint) { }
+inline void glBindAttribLocation(GLuint, GLuint, const GLchar *) { }
+inline void glBindBuffer(GLenum, GLuint) { }
+inline void glBindFramebuffer(GLenum, GLuint) { }
+inline void glBindRenderbuffer(GLenum, GLuint) { }
+inline void glBindTexture(GLenum, GLuint) { }
+inline void glBindVertexArrayOES(GLuint) { }
+inline void glBlendFunc(GLenum, GLenum) { }
+inline void glBufferData(GLenum, GLsizeiptr, const GLvoid *, GLenum) { }
+inline void glBufferSubData(GLenum, GLintptr, GLsizeiptr, const GLvoid *) { }
+inline GLenum glCheckFramebufferStatus(GLenum) { return GL_FRAMEBUFFER_COMPLETE; }
+inline void glClear(GLbitfield) { }
+inline void glClearColor(GLclampf, GLclampf, GLclampf, GLclampf) { }
+inline void glClearStencil(GLint) { }
+inline void glColorMask(GLboolean, GLboolean, GLboolean, GLboolean) { }
+inline void glCompileShader(GLuint) { }
+inline GLuint glCreateProgram() { return AGHeadlessGL::nextName(); }
+inline GLuint glCreateShader(GLenum) { return AGHeadlessGL::nextName(); }
+inline void glDeleteBuffers(GLsizei, const GLuint *) { }
+inline void glDeleteFramebuffers(GLsizei, const GLuint *) { }
+inline void glDeleteProgram(GLuint) { }
+inline void glDeleteRenderbuffers(GLsizei, const GLuint *) { }
+inline void glDeleteShader(GLuint) { }
+inline void glDeleteTextures(GLsizei, const GLuint *) { }
+inline void glDeleteVertexArraysOES(GLsizei, const GLuint *) { }
+inline void glDepthMask(GLboolean) { }
+inline void glDisable(GLenum) { }
+inline void glDisableVertexAttribArray(GLuint) { }
+inline void glDrawArrays(GLenum, GLint, GLsizei) { }
+inline void glDrawElements(GLenum, GLsizei, GLenum, const GLvoid *) { }
+inline void glEnable(GLenum) { }
+inline void glEnableVertexAttribArray(GLuint) { }
+inline void glFramebufferRenderbuffer(GLenum, GLenum, GLenum, GLuint) { }
+inline void glFramebufferTexture2D(GLenum, GLenum, GLenum, GLuint, GLint) { }
+inline void glGenBuffers(GLsizei n, GLuint *names) { AGHeadlessGL::genNames(n, names); }
+inline void glGenFramebuffers(GLsizei n, GLuint *names) { AGHeadlessGL::genNames(n, names); }
+inline void glGenRenderbuffers(GLsizei n, GLuint *names) { AGHeadlessGL::genNames(n, names); }
+inline void glGenTextures(GLsizei n, GLuint *names) { AGHeadlessGL::genNames(n, names); }
+inline void glGenVertexArraysOES(GLsizei n, GLuint *names) { AGHeadlessGL::genNames(n, names); }
+inline void glGetFloatv(GLenum, GLfloat *params) { if(params) *params = 0; }
+inline void glGetIntegerv(GLenum, GLint *params) { if(params) *params = 0; }
+inline void glGetProgramiv(GLuint, GLenum, GLint *params) { if(params) *params = GL_TRUE; }
+inline void glGetShaderiv(GLuint, GLenum, GLint *params) { if(params) *params = GL_TRUE; }
+inline GLint glGetAttribLocation(GLuint, const GLchar *) { return 0; }
+inline GLint glGetUniformLocation(GLuint, const GLchar *) { return 0; }
+inline void glLineWidth(GLfloat) { }
+inline void glLinkProgram(GLuint) { }
+inline void glPixelStorei(GLenum, GLint) { }
+inline void glPointSize(GLfloat) { }
+inline void glReadPixels(GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, GLvoid *) { }
+inline void glRenderbufferStorage(GLenum, GLenum, GLsizei, GLsizei) { }
+inline void glScissor(GLint, GLint, GLsizei, GLsizei) { }
+inline void glShaderSource(GLuint, GLsizei, const GLchar * const *, const GLint *) { }
+inline void glStencilFunc(GLenum, GLint, GLuint) { }
+inline void glStencilMask(GLuint) { }
+inline void glStencilOp(GLenum, GLenum, GLenum) { }
+inline void glTexImage2D(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid *) { }
+inline void glTexParameteri(GLenum, GLenum, GLint) { }
+inline void glUniform1f(GLint, GLfloat) { }
+inline void glUniform1i(GLint, GLint) { }
+inline void glUniform2f(GLint, GLfloat, GLfloat) { }
+inline void glUniform3f(GLint, GLfloat, GLfloat, GLfloat) { }
+inline void glUniform4f(GLint, GLfloat, GLfloat, GLfloat, GLfloat) { }
+inline void glUniform4fv(GLint, GLsizei, const GLfloat *) { }
+inline void glUniformMatrix3fv(GLint, GLsizei, GLboolean, const GLfloat *) { }
+inline void glUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat *) { }
+inline void glUseProgram(GLuint) { }
+inline void glValidateProgram(GLuint) { }
+inline void glVertexAttrib3f(GLuint, GLfloat, GLfloat, GLfloat) { }
+inline void glVertexAttrib4f(GLuint, GLfloat, GLfloat, GLfloat, GLfloat) { }
+inline void glVertexAttrib4fv(GLuint, const GLfloat *) { }
+inline void glVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const GLvoid *) { }
+inline void glViewport(GLint, GLint, GLsizei, GLsizei) { }
@@ -0,0 +1,18 @@
+// headless stand-in for the few CoreGraphics types used by libsp
+#pragma once
+
+typedef double CGFloat;
+
+struct CGPoint { CGFloat x; CGFloat y; };
+typedef struct CGPoint CGPoint;
+
+struct CGSize { CGFloat width; CGFloat height; };
+typedef struct CGSize CGSize;
+
+struct CGRect { CGPoint origin; CGSize size; };
+typedef struct CGRect CGRect;
+
+inline CGPoint CGPointMake(CGFloat x, CGFloat y) { CGPoint p; p.x = x; p.y = y; return p; }
+inline CGSize CGSizeMake(CGFloat width, CGFloat height) { CGSize s; s.width = width; s.height = height; return s; }
+inline CGRect CGRectMake(CGFloat x, CGFloat y, CGFloat width, CGFloat height)
+{ CGRect r; r.origin = CGPointMake(x, y); r.size = CGSizeMake(width, height); return r; }
@@ -0,0 +1,237 @@
+//
+//  GLKMath.h
+//  Auragraph
+//
+//  Created by Spencer Salazar on 10/17/26.
+//  Copyright © 2026 Spencer Salazar. All rights reserved.
+//
+//  Headless stand-in for the parts of GLKit's math library used by the app.
+//  Matrices are column-major, as in GLKit.
+//
+
+#pragma once
+
+#include <math.h>
+#include <stdbool.h>
+
+union GLKVector3
+{
+    struct { float x, y, z; };
+    float v[3];
+};
+typedef union GLKVector3 GLKVector3;
+
+union GLKVector4
+{
+    struct { float x, y, z, w; };
+    float v[4];
+};
+typedef union GLKVector4 GLKVector4;
+
+union GLKMatrix3
+{
+    struct
+    {
+        float m00, m01, m02;
+        float m10, m11, m12;
+        float m20, m21, m22;
+    };
+    float m[9];
+};
+typedef union GLKMatrix3 GLKMatrix3;
+
+union GLKMatrix4
+{
+    struct
+    {
+        float m00, m01, m02, m03;
+        float m10, m11, m12, m13;
+        float m20, m21, m22, m23;
+        float m30, m31, m32, m33;
+    };
+    float m[16];
+};
+typedef union GLKMatrix4 GLKMatrix4;
+
+static const GLKMatrix4 GLKMatrix4Identity = {{ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 }};
+static const GLKMatrix3 GLKMatrix3Identity = {{ 1, 0, 0, 0, 1, 0, 0, 0, 1 }};
+
+inline GLKVector3 GLKVector3Make(float x, float y, float z)
+{
+    GLKVector3 v; v.x = x; v.y = y; v.z = z; return v;
+}
+
+inline GLKVector4 GLKVector4Make(float x, float y, float z, float w)
+{
+    GLKVector4 v; v.x = x; v.y = y; v.z = z; v.w = w; return v;
+}
+
+inline GLKMatrix4 GLKMatrix4Make(float m00, float m01, float m02, float m03,
+                                 float m10, float m11, float m12, float m13,
+                                 float m20, float m21, float m22, float m23,
+                                 float m30, float m31, float m32, float m33)
+{
+    GLKMatrix4 m = {{ m00, m01, m02, m03, m10, m11, m12, m13,
+                      m20, m21, m22, m23, m30, m31, m32, m33 }};
+    return m;
+}
+
+inline GLKMatrix4 GLKMatrix4Multiply(GLKMatrix4 left, GLKMatrix4 right)
+{
+    GLKMatrix4 m;
+    for(int c = 0; c < 4; c++)
+        for(int r = 0; r < 4; r++)
+            m.m[c*4+r] = left.m[0*4+r]*right.m[c*4+0] + left.m[1*4+r]*right.m[c*4+1] +
+                         left.m[2*4+r]*right.m[c*4+2] + left.m[3*4+r]*right.m[c*4+3];
+    return m;
+}
+
+inline GLKMatrix4 GLKMatrix4MakeTranslation(float tx, float ty, float tz)
+{
+    GLKMatrix4 m = GLKMatrix4Identity;
+    m.m[12] = tx; m.m[13] = ty; m.m[14] = tz;
+    return m;
+}
+
+inline GLKMatrix4 GLKMatrix4MakeScale(float sx, float sy, float sz)
+{
+    GLKMatrix4 m = GLKMatrix4Identity;
+    m.m[0] = sx; m.m[5] = sy; m.m[10] = sz;
+    return m;
+}
+
+inline GLKMatrix4 GLKMatrix4MakeRotation(float radians, float x, float y, float z)
+{
+    float len = sqrtf(x*x + y*y + z*z);
+    if(len > 0) { x /= len; y /= len; z /= len; }
+    float c = cosf(radians), s = sinf(radians), p = 1-c;
+    return GLKMatrix4Make(c + p*x*x, p*x*y + z*s, p*x*z - y*s, 0,
+                          p*x*y - z*s, c + p*y*y, p*y*z + x*s, 0,
+                          p*x*z + y*s, p*y*z - x*s, c + p*z*z, 0,
+                          0, 0, 0, 1);
+}
+
+inline GLKMatrix4 GLKMatrix4MakeOrtho(float left, float right, float bottom, float top, float nearZ, float farZ)
+{
+    return GLKMatrix4Make(2/(right-left), 0, 0, 0,
+                          0, 2/(top-bottom), 0, 0,
+                          0, 0, -2/(farZ-nearZ), 0,
+                          -(right+left)/(right-left), -(top+bottom)/(top-bottom), -(farZ+nearZ)/(farZ-nearZ), 1);
+}
+
+inline GLKMatrix4 GLKMatrix4MakePerspective(float fovyRadians, float aspect, float nearZ, float farZ)
+{
+    float cotan = 1.0f/tanf(fovyRadians/2.0f);
+    return GLKMatrix4Make(cotan/aspect, 0, 0, 0,
+                          0, cotan, 0, 0,
+                          0, 0, (farZ+nearZ)/(nearZ-farZ), -1,
+                          0, 0, (2*farZ*nearZ)/(nearZ-farZ), 0);
+}
+
+inline GLKMatrix4 GLKMatrix4Translate(GLKMatrix4 m, float tx, float ty, float tz)
+{
+    return GLKMatrix4Multiply(m, GLKMatrix4MakeTranslation(tx, ty, tz));
+}
+
+inline GLKMatrix4 GLKMatrix4Scale(GLKMatrix4 m, float sx, float sy, float sz)
+{
+    return GLKMatrix4Multiply(m, GLKMatrix4MakeScale(sx, sy, sz));
+}
+
+inline GLKMatrix4 GLKMatrix4Rotate(GLKMatrix4 m, float radians, float x, float y, float z)
+{
+    return GLKMatrix4Multiply(m, GLKMatrix4MakeRotation(radians, x, y, z));
+}
+
+inline GLKVector4 GLKMatrix4MultiplyVector4(GLKMatrix4 m, GLKVector4 v)
+{
+    return GLKVector4Make(m.m[0]*v.x + m.m[4]*v.y + m.m[8]*v.z + m.m[12]*v.w,
+                          m.m[1]*v.x + m.m[5]*v.y + m.m[9]*v.z + m.m[13]*v.w,
+                          m.m[2]*v.x + m.m[6]*v.y + m.m[10]*v.z + m.m[14]*v.w,
+                          m.m[3]*v.x + m.m[7]*v.y + m.m[11]*v.z + m.m[15]*v.w);
+}
+
+inline GLKVector3 GLKMatrix4MultiplyVector3(GLKMatrix4 m, GLKVector3 v)
+{
+    return GLKVector3Make(m.m[0]*v.x + m.m[4]*v.y + m.m[8]*v.z,
+                          m.m[1]*v.x + m.m[5]*v.y + m.m[9]*v.z,
+                          m.m[2]*v.x + m.m[6]*v.y + m.m[10]*v.z);
+}
+
+inline GLKVector3 GLKMatrix4MultiplyVector3WithTranslation(GLKMatrix4 m, GLKVector3 v)
+{
+    GLKVector4 v4 = GLKMatrix4MultiplyVector4(m, GLKVector4Make(v.x, v.y, v.z, 1));
+    return GLKVector3Make(v4.x, v4.y, v4.z);
+}
+
+inline GLKMatrix3 GLKMatrix4GetMatrix3(GLKMatrix4 m)
+{
+    GLKMatrix3 m3 = {{ m.m[0], m.m[1], m.m[2], m.m[4], m.m[5], m.m[6], m.m[8], m.m[9], m.m[10] }};
+    return m3;
+}
+
+inline GLKMatrix3 GLKMatrix3Transpose(GLKMatrix3 m)
+{
+    GLKMatrix3 t = {{ m.m[0], m.m[3], m.m[6], m.m[1], m.m[4], m.m[7], m.m[2], m.m[5], m.m[8] }};
+    return t;
+}
+
+inline GLKMatrix3 GLKMatrix3Invert(GLKMatrix3 m, bool *isInvertible)
+{
+    float det = m.m[0]*(m.m[4]*m.m[8] - m.m[7]*m.m[5])
+              - m.m[3]*(m.m[1]*m.m[8] - m.m[7]*m.m[2])
+              + m.m[6]*(m.m[1]*m.m[5] - m.m[4]*m.m[2]);
+    if(isInvertible) *isInvertible = (det != 0);
+    if(det == 0) return GLKMatrix3Identity;
+    float invdet = 1.0f/det;
+    GLKMatrix3 inv = {{
+        (m.m[4]*m.m[8] - m.m[5]*m.m[7])*invdet,
+        (m.m[2]*m.m[7] - m.m[1]*m.m[8])*invdet,
+        (m.m[1]*m.m[5] - m.m[2]*m.m[4])*invdet,
+        (m.m[5]*m.m[6] - m.m[3]*m.m[8])*invdet,
+        (m.m[0]*m.m[8] - m.m[2]*m.m[6])*invdet,
+        (m.m[2]*m.m[3] - m.m[0]*m.m[5])*invdet,
+        (m.m[3]*m.m[7] - m.m[4]*m.m[6])*invdet,
+        (m.m[1]*m.m[6] - m.m[0]*m.m[7])*invdet,
+        (m.m[0]*m.m[4] - m.m[1]*m.m[3])*invdet,
+    }};
+    return inv;
+}
+
+inline GLKMatrix3 GLKMatrix3InvertAndTranspose(GLKMatrix3 m, bool *isInvertible)
+{
+    return GLKMatrix3Transpose(GLKMatrix3Invert(m, isInvertible));
+}
+
+inline GLKMatrix4 GLKMatrix4Invert(GLKMatrix4 m, bool *isInvertible)
+{
+    const float *a = m.m;
+    GLKMatrix4 inv;
+    float *o = inv.m;
+    
+    o[0] = a[5]*a[10]*a[15] - a[5]*a[11]*a[14] - a[9]*a[6]*a[15] + a[9]*a[7]*a[14] + a[13]*a[6]*a[11] - a[13]*a[7]*a[10];
+    o[4] = -a[4]*a[10]*a[15] + a[4]*a[11]*a[14] + a[8]*a[6]*a[15] - a[8]*a[7]*a[14] - a[12]*a[6]*a[11] + a[12]*a[7]*a[10];
+    o[8] = a[4]*a[9]*a[15] - a[4]*a[11]*a[13] - a[8]*a[5]*a[15] + a[8]*a[7]*a[13] + a[12]*a[5]*a[11] - a[12]*a[7]*a[9];
+    o[12] = -a[4]*a[9]*a[14] + a[4]*a[10]*a[13] + a[8]*a[5]*a[14] - a[8]*a[6]*a[13] - a[12]*a[5]*a[10] + a[12]*a[6]*a[9];
+    o[1] = -a[1]*a[10]*a[15] + a[1]*a[11]*a[14] + a[9]*a[2]*a[15] - a[9]*a[3]*a[14] - a[13]*a[2]*a[11] + a[13]*a[3]*a[10];
+    o[5] = a[0]*a[10]*a[15] - a[0]*a[11]*a[14] - a[8]*a[2]*a[15] + a[8]*a[3]*a[14] + a[12]*a[2]*a[11] - a[12]*a[3]*a[10];
+    o[9] = -a[0]*a[9]*a[15] + a[0]*a[11]*a[13] + a[8]*a[1]*a[15] - a[8]*a[3]*a[13] - a[12]*a[1]*a[11] + a[12]*a[3]*a[9];
+    o[13] = a[0]*a[9]*a[14] - a[0]*a[10]*a[13] - a[8]*a[1]*a[14] + a[8]*a[2]*a[13] + a[12]*a[1]*a[10] - a[12]*a[2]*a[9];
+    o[2] = a[1]*a[6]*a[15] - a[1]*a[7]*a[14] - a[5]*a[2]*a[15] + a[5]*a[3]*a[14] + a[13]*a[2]*a[7] - a[13]*a[3]*a[6];
+    o[6] = -a[0]*a[6]*a[15] + a[0]*a[7]*a[14] + a[4]*a[2]*a[15] - a[4]*a[3]*a[14] - a[12]*a[2]*a[7] + a[12]*a[3]*a[6];
+    o[10] = a[0]*a[5]*a[15] - a[0]*a[7]*a[13] - a[4]*a[1]*a[15] + a[4]*a[3]*a[13] + a[12]*a[1]*a[7] - a[12]*a[3]*a[5];
+    o[14] = -a[0]*a[5]*a[14] + a[0]*a[6]*a[13] + a[4]*a[1]*a[14] - a[4]*a[2]*a[13] - a[12]*a[1]*a[6] + a[12]*a[2]*a[5];
+    o[3] = -a[1]*a[6]*a[11] + a[1]*a[7]*a[10] + a[5]*a[2]*a[11] - a[5]*a[3]*a[10] - a[9]*a[2]*a[7] + a[9]*a[3]*a[6];
+    o[7] = a[0]*a[6]*a[11] - a[0]*a[7]*a[10] - a[4]*a[2]*a[11] + a[4]*a[3]*a[10] + a[8]*a[2]*a[7] - a[8]*a[3]*a[6];
+    o[11] = -a[0]*a[5]*a[11] + a[0]*a[7]*a[9] + a[4]*a[1]*a[11] - a[4]*a[3]*a[9] - a[8]*a[1]*a[7] + a[8]*a[3]*a[5];
+    o[15] = a[0]*a[5]*a[10] - a[0]*a[6]*a[9] - a[4]*a[1]*a[10] + a[4]*a[2]*a[9] + a[8]*a[1]*a[6] - a[8]*a[2]*a[5];
+    
+    float det = a[0]*o[0] + a[1]*o[4] + a[2]*o[8] + a[3]*o[12];
+    if(isInvertible) *isInvertible = (det != 0);
+    if(det == 0) return GLKMatrix4Identity;
+    
+    for(int i = 0; i < 16; i++)
+        o[i] /= det;
+    
+    return inv;
+}
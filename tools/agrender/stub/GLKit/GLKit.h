@@ -0,0 +1,3 @@
+// headless stand-in; see GLKMath.h
+#pragma once
+#include "GLKMath.h"
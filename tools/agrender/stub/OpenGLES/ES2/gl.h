@@ -0,0 +1,3 @@
+// headless stand-in; see AGHeadlessGL.h
+#pragma once
+#include "../../AGHeadlessGL.h"